@@ -0,0 +1,669 @@
+/*
+ *  logger_bench.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This program measures the throughput, per-call latency, and heap
+ *      allocations of each of the Logger's logging paths.  Each path is
+ *      measured with each logging facility and with a number of threads
+ *      logging concurrently, producing a baseline against which changes to
+ *      the Logger may be compared.
+ *
+ *      Usage: logger_bench [-m messages] [-f filter] [-a] [-s]
+ *                          [-b octets] [-y ms] [-u]
+ *          -m  Number of messages logged by each thread (default 10000)
+ *          -f  Run only cases whose name contains the given text
+ *          -a  Enable asynchronous logging on the root Logger
+ *          -s  Enable asynchronous logging with a queue for each thread
+ *          -b  Buffer the given number of octets of file output
+ *          -y  Sync file output to the device at the given interval
+ *          -u  Write file and console output through io_uring, if available
+ *
+ *      Console output is redirected to the null device while measured.
+ *
+ *  Portability Issues:
+ *      Redirecting console output uses POSIX or Windows descriptor functions.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "cantina/logger.h"
+
+namespace
+{
+
+// Count of heap allocations made by the program
+std::atomic<std::uint64_t> allocations{0};
+
+// Thread counts with which each case is measured
+constexpr unsigned Thread_Counts[] = {1, 2, 4, 8, 16};
+
+// Capacity of the asynchronous queue (or of each thread's queue)
+constexpr std::size_t Queue_Capacity = 8192;
+
+// Deepest child Logger hierarchy measured
+constexpr unsigned Max_Child_Depth = 5;
+
+// Name of the file used with LogFacility::File
+constexpr const char *Bench_Filename = "logger_bench.log";
+
+// Facilities with which each logging path is measured
+enum class BenchFacility
+{
+    None,
+    Console,
+    File,
+    Custom
+};
+
+// Benchmark options given on the command line
+struct BenchOptions
+{
+    unsigned messages = 10000;          // Messages logged by each thread
+    std::string filter;                 // Substring of case names to run
+    bool async = false;                 // Log asynchronously?
+    bool sharded = false;               // Give each thread its own queue?
+    cantina::LogFlushPolicy flush_policy;
+                                        // File (and console) output policy
+};
+
+// Results of measuring a single case
+struct BenchResult
+{
+    double messages_per_second;         // Overall throughput
+    double percentiles[4];              // 50th, 90th, 99th, 99.9th (ns)
+    double max_latency;                 // Maximum latency (ns)
+    double allocations_per_message;     // Heap allocations per message
+};
+
+// Function that logs message number "i" using a given Logger
+using BenchFunction = std::function<void(cantina::Logger *, unsigned)>;
+
+/*
+ *  FacilityName
+ *
+ *  Description:
+ *      Return the name of the given benchmark facility.
+ *
+ *  Parameters:
+ *      facility [in]
+ *          The benchmark facility.
+ *
+ *  Returns:
+ *      The name of the facility.
+ *
+ *  Comments:
+ *      None.
+ */
+const char *FacilityName(BenchFacility facility)
+{
+    switch (facility)
+    {
+        case BenchFacility::None:
+            return "None";
+
+        case BenchFacility::Console:
+            return "Console";
+
+        case BenchFacility::File:
+            return "File";
+
+        case BenchFacility::Custom:
+            return "Custom";
+    }
+
+    return "Unknown";
+}
+
+/*
+ *  CreateRootLogger
+ *
+ *  Description:
+ *      Create the root Logger using the given benchmark facility.
+ *
+ *  Parameters:
+ *      facility [in]
+ *          The benchmark facility.
+ *
+ *      options [in]
+ *          The benchmark options.
+ *
+ *  Returns:
+ *      A pointer to the root Logger.
+ *
+ *  Comments:
+ *      None.
+ */
+cantina::LoggerPointer CreateRootLogger(BenchFacility facility,
+                                        const BenchOptions &options)
+{
+    cantina::LoggerPointer logger;
+
+    if (facility == BenchFacility::Custom)
+    {
+        logger = std::make_shared<cantina::CustomLogger>(
+            [](cantina::LogLevel, const std::string &message, bool)
+            {
+                // Touch the message so that the call is not optimized away
+                static std::atomic<std::size_t> length{0};
+                length.fetch_add(message.size(), std::memory_order_relaxed);
+            });
+    }
+    else
+    {
+        logger = std::make_shared<cantina::Logger>("Bench");
+    }
+
+    switch (facility)
+    {
+        case BenchFacility::None:
+            logger->SetLogFacility(cantina::LogFacility::None);
+            break;
+
+        case BenchFacility::File:
+            logger->SetLogFacility(cantina::LogFacility::File,
+                                   Bench_Filename,
+                                   options.flush_policy);
+            break;
+
+        case BenchFacility::Console:
+            // Replace the default console sink to apply the policy
+            logger->SetLogFacility(cantina::LogFacility::None);
+            logger->SetLogFacility(cantina::LogFacility::Console,
+                                   {},
+                                   options.flush_policy);
+            break;
+
+        case BenchFacility::Custom:
+            logger->SetLogFacility(cantina::LogFacility::Console);
+            break;
+    }
+
+    logger->Colorize(false);
+    if (options.async)
+    {
+        cantina::LogQueuePolicy policy;
+        policy.sharded = options.sharded;
+        logger->SetAsync(Queue_Capacity, policy);
+    }
+
+    return logger;
+}
+
+/*
+ *  RedirectConsole
+ *
+ *  Description:
+ *      Redirect the standard error descriptor, used for console logging, to
+ *      the null device or restore it.
+ *
+ *  Parameters:
+ *      redirect [in]
+ *          True to redirect output to the null device, false to restore it.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void RedirectConsole(bool redirect)
+{
+    static int saved_descriptor = -1;
+
+    std::clog.flush();
+    std::fflush(stderr);
+
+#ifdef _WIN32
+    if (redirect)
+    {
+        int null_descriptor = _open("NUL", _O_WRONLY);
+        saved_descriptor = _dup(2);
+        _dup2(null_descriptor, 2);
+        _close(null_descriptor);
+    }
+    else if (saved_descriptor >= 0)
+    {
+        _dup2(saved_descriptor, 2);
+        _close(saved_descriptor);
+        saved_descriptor = -1;
+    }
+#else
+    if (redirect)
+    {
+        int null_descriptor = open("/dev/null", O_WRONLY);
+        saved_descriptor = dup(2);
+        dup2(null_descriptor, 2);
+        close(null_descriptor);
+    }
+    else if (saved_descriptor >= 0)
+    {
+        dup2(saved_descriptor, 2);
+        close(saved_descriptor);
+        saved_descriptor = -1;
+    }
+#endif
+}
+
+/*
+ *  RunCase
+ *
+ *  Description:
+ *      Measure a single case, with each of the given number of threads
+ *      logging the given number of messages.
+ *
+ *  Parameters:
+ *      logger [in]
+ *          The Logger with which to log messages.
+ *
+ *      root_logger [in]
+ *          The root Logger, which is flushed before the time is measured.
+ *
+ *      function [in]
+ *          The function that logs each message.
+ *
+ *      thread_count [in]
+ *          The number of threads logging concurrently.
+ *
+ *      messages [in]
+ *          The number of messages logged by each thread.
+ *
+ *  Returns:
+ *      The results of the measurement.
+ *
+ *  Comments:
+ *      Latencies cover only the logging call itself, while throughput also
+ *      covers the time to write any queued messages.
+ */
+BenchResult RunCase(cantina::Logger *logger,
+                    cantina::Logger *root_logger,
+                    const BenchFunction &function,
+                    unsigned thread_count,
+                    unsigned messages)
+{
+    std::vector<std::vector<std::uint32_t>> latencies(thread_count);
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> start{false};
+    BenchResult result{};
+
+    for (auto &thread_latencies : latencies) thread_latencies.resize(messages);
+
+    // Warm up per-thread buffers and caches outside of the measurement
+    for (unsigned i = 0; i < 16; i++) function(logger, i);
+    root_logger->Flush();
+
+    for (unsigned t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                auto &thread_latencies = latencies[t];
+
+                function(logger, 0);
+                ready++;
+                while (!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+
+                for (unsigned i = 0; i < messages; i++)
+                {
+                    auto begin = std::chrono::steady_clock::now();
+                    function(logger, i);
+                    auto end = std::chrono::steady_clock::now();
+                    thread_latencies[i] = static_cast<std::uint32_t>(
+                        std::min<std::int64_t>(
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(end - begin).count(),
+                            UINT32_MAX));
+                }
+            });
+    }
+
+    while (ready < thread_count) std::this_thread::yield();
+    root_logger->Flush();
+
+    std::uint64_t initial_allocations = allocations.load();
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+
+    for (auto &thread : threads) thread.join();
+    root_logger->Flush();
+
+    auto end = std::chrono::steady_clock::now();
+    std::uint64_t final_allocations = allocations.load();
+
+    // Compute the results
+    double total_messages = static_cast<double>(thread_count) * messages;
+    double seconds = std::chrono::duration<double>(end - begin).count();
+
+    std::vector<std::uint32_t> all_latencies;
+    all_latencies.reserve(thread_count * messages);
+    for (auto &thread_latencies : latencies)
+    {
+        all_latencies.insert(all_latencies.end(),
+                             thread_latencies.begin(),
+                             thread_latencies.end());
+    }
+    std::sort(all_latencies.begin(), all_latencies.end());
+
+    const double fractions[4] = {0.50, 0.90, 0.99, 0.999};
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        auto index = static_cast<std::size_t>(fractions[i] *
+                                              (all_latencies.size() - 1));
+        result.percentiles[i] = all_latencies[index];
+    }
+    result.max_latency = all_latencies.back();
+    result.messages_per_second = total_messages / seconds;
+    result.allocations_per_message =
+        static_cast<double>(final_allocations - initial_allocations) /
+        total_messages;
+
+    return result;
+}
+
+/*
+ *  PrintResult
+ *
+ *  Description:
+ *      Print a single line of results.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the case.
+ *
+ *      thread_count [in]
+ *          The number of threads logging concurrently.
+ *
+ *      result [in]
+ *          The results of the measurement.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PrintResult(const std::string &name,
+                 unsigned thread_count,
+                 const BenchResult &result)
+{
+    std::printf("%-28s %3u %12.0f %8.0f %8.0f %8.0f %9.0f %10.0f %8.2f\n",
+                name.c_str(),
+                thread_count,
+                result.messages_per_second,
+                result.percentiles[0],
+                result.percentiles[1],
+                result.percentiles[2],
+                result.percentiles[3],
+                result.max_latency,
+                result.allocations_per_message);
+    std::fflush(stdout);
+}
+
+/*
+ *  ParseOptions
+ *
+ *  Description:
+ *      Parse the command-line options.
+ *
+ *  Parameters:
+ *      argc [in]
+ *          The number of command-line arguments.
+ *
+ *      argv [in]
+ *          The command-line arguments.
+ *
+ *      options [out]
+ *          The parsed options.
+ *
+ *  Returns:
+ *      True if the options were parsed, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+
+        if ((option == "-m") && (i + 1 < argc))
+        {
+            options.messages =
+                static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            if (options.messages == 0) return false;
+        }
+        else if ((option == "-f") && (i + 1 < argc))
+        {
+            options.filter = argv[++i];
+        }
+        else if (option == "-a")
+        {
+            options.async = true;
+        }
+        else if (option == "-s")
+        {
+            options.async = true;
+            options.sharded = true;
+        }
+        else if ((option == "-b") && (i + 1 < argc))
+        {
+            options.flush_policy.buffer_size =
+                static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((option == "-y") && (i + 1 < argc))
+        {
+            options.flush_policy.sync_interval = std::chrono::milliseconds(
+                std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (option == "-u")
+        {
+            options.flush_policy.async_io = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+// Count every heap allocation made by the program
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *pointer = std::malloc(size ? size : 1)) return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    std::vector<std::pair<std::string, BenchFunction>> paths;
+
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-m messages] [-f filter] [-a] [-s]"
+                  << " [-b octets] [-y ms] [-u]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Messages given to Log() are built before measuring, so that only the
+    // Logger's own allocations are counted
+    std::vector<std::string> log_messages(options.messages);
+    for (unsigned i = 0; i < options.messages; i++)
+    {
+        log_messages[i] = "Benchmark message " + std::to_string(i);
+    }
+
+    // Logging paths measured using the root Logger
+    paths.emplace_back("Log",
+        [&log_messages](cantina::Logger *logger, unsigned i)
+        {
+            logger->Log(log_messages[i % log_messages.size()]);
+        });
+    paths.emplace_back("Stream",
+        [](cantina::Logger *logger, unsigned i)
+        {
+            logger->info << "Benchmark message " << i << std::flush;
+        });
+    paths.emplace_back("Macro",
+        [](cantina::Logger *logger, unsigned i)
+        {
+            LOGGER_INFO(logger, "Benchmark message " << i);
+        });
+    paths.emplace_back("MacroDisabled",
+        [](cantina::Logger *logger, unsigned i)
+        {
+            LOGGER_DEBUG(logger, "Benchmark message " << i);
+        });
+    paths.emplace_back("Format",
+        [](cantina::Logger *logger, unsigned i)
+        {
+            logger->Info("Benchmark message {}", i);
+        });
+    paths.emplace_back("Binary",
+        [](cantina::Logger *logger, unsigned i)
+        {
+            LOGGER_INFO_BINARY(logger, "Benchmark message {}", i);
+        });
+
+    std::printf("%-28s %3s %12s %8s %8s %8s %9s %10s %8s\n",
+                "Case", "Thr", "Msgs/sec", "p50(ns)", "p90(ns)", "p99(ns)",
+                "p99.9(ns)", "max(ns)", "Alloc/msg");
+
+    for (auto facility : {BenchFacility::None,
+                          BenchFacility::Console,
+                          BenchFacility::File,
+                          BenchFacility::Custom})
+    {
+        // Cases are named by facility, path, and (for children) depth
+        std::vector<std::pair<std::string, BenchFunction>> cases;
+        std::vector<unsigned> depths;
+
+        for (auto &path : paths)
+        {
+            cases.emplace_back(std::string(FacilityName(facility)) + "/" +
+                                   path.first,
+                               path.second);
+            depths.push_back(0);
+        }
+        for (unsigned depth = 1; depth <= Max_Child_Depth; depth++)
+        {
+            cases.emplace_back(std::string(FacilityName(facility)) +
+                                   "/Child" + std::to_string(depth),
+                               paths.front().second);
+            depths.push_back(depth);
+        }
+
+        for (std::size_t c = 0; c < cases.size(); c++)
+        {
+            if (cases[c].first.find(options.filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            for (auto thread_count : Thread_Counts)
+            {
+                auto root_logger = CreateRootLogger(facility, options);
+                cantina::LoggerPointer logger = root_logger;
+
+                for (unsigned depth = 0; depth < depths[c]; depth++)
+                {
+                    logger = std::make_shared<cantina::Logger>(
+                        "Child" + std::to_string(depth + 1), logger);
+                }
+
+                if (facility == BenchFacility::Console) RedirectConsole(true);
+
+                BenchResult result = RunCase(logger.get(),
+                                             root_logger.get(),
+                                             cases[c].second,
+                                             thread_count,
+                                             options.messages);
+
+                if (facility == BenchFacility::Console) RedirectConsole(false);
+
+                PrintResult(cases[c].first, thread_count, result);
+            }
+        }
+    }
+
+    std::remove(Bench_Filename);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,743 @@
+/*
+ *  async_log_queue.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the AsyncLogQueue class, which pairs a bounded MPSCQueue
+ *      with a background writer thread.  Any number of threads may push
+ *      values into the queue, while the writer thread removes each value
+ *      and passes it to a writer function.  When the queue is empty, the
+ *      writer thread calls an optional idle task (e.g., to write buffered
+ *      output once a flush interval elapses) and then waits for a signal.
+ *
+ *      Producers signal the writer only when it is waiting, so a busy
+ *      writer is not woken for every value.  What a producer does when the
+ *      queue is full is governed by a LogQueuePolicy: it may wait for the
+ *      writer to make space (indefinitely or for a bounded time), discard
+ *      the value, discard the oldest queued value, or discard Debug and
+ *      Info values once the queue is three quarters full so that the
+ *      remaining space is kept for Warning and more severe values.
+ *
+ *      Values discarded are counted per level.  Before the writer next
+ *      writes a value, it calls a notice function with the number of
+ *      values discarded since the last notice, so that a "dropped"
+ *      marker may be placed in the output.  Values must have a "level"
+ *      member of type LogLevel.
+ *
+ *      If the policy requests a sharded queue, each producing thread is
+ *      instead given its own SPSCQueue when it first pushes a value, so
+ *      producers never write to a shared cache line.  The writer thread
+ *      takes a value from each thread's queue and writes the value having
+ *      the earliest time, as given by an order function.  Should a thread's
+ *      queue be empty, a value is held for up to the policy's reorder
+ *      window before being written, so that a value being pushed by that
+ *      thread at the same moment is written in order.  A thread's queue is
+ *      released once the thread has exited and the queue is drained.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "log_types.h"
+#include "mpsc_queue.h"
+#include "spsc_queue.h"
+
+namespace cantina
+{
+
+// Action taken when a value is pushed into a full queue
+enum class LogOverflowPolicy
+{
+    Block,                              // Wait for space
+    BlockWithTimeout,                   // Wait for space up to the timeout
+    DropNewest,                         // Discard the value being pushed
+    DropOldest,                         // Discard the oldest queued value
+    DropLowPriority                     // Discard Debug and Info first
+};
+
+// Policy governing a full queue
+struct LogQueuePolicy
+{
+    // Action taken when the queue is full
+    LogOverflowPolicy overflow = LogOverflowPolicy::Block;
+
+    // Longest wait for space with BlockWithTimeout or, for Warning and more
+    // severe values, DropLowPriority (0 discards without waiting)
+    std::chrono::microseconds timeout{0};
+
+    // Give each producing thread its own queue of the requested capacity,
+    // merging the values in time order (DropOldest then acts as DropNewest)
+    bool sharded = false;
+
+    // Longest time a value is held to be merged with values being pushed
+    // by other threads when sharded
+    std::chrono::microseconds reorder_window{1000};
+};
+
+// Order key of a value having the given time (see AsyncLogQueue::OrderKey)
+inline std::int64_t LogQueueOrder(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               time.time_since_epoch())
+        .count();
+}
+
+// Number of values discarded at each level
+using LogDropCounts = std::array<std::uint64_t, Log_Level_Count>;
+
+// Text of the marker noting that values were discarded
+inline std::string LogDropMarker(std::uint64_t count)
+{
+    return "Dropped " + std::to_string(count) +
+           ((count == 1) ? " message" : " messages");
+}
+
+// Bounded queue drained by a background writer thread
+template<typename T>
+class AsyncLogQueue
+{
+    public:
+        // Function called by the writer thread for each value
+        using Writer = std::function<void(T &)>;
+
+        // Function called when the queue is empty, returning the longest
+        // time to wait before calling it again
+        using IdleTask = std::function<std::chrono::milliseconds()>;
+
+        // Function called by the writer thread before writing the given
+        // value when values have been discarded, with the number discarded
+        using DropNotice = std::function<void(T &, std::uint64_t)>;
+
+        // Function returning the time of a value in nanoseconds since the
+        // epoch, by which values from each thread's queue are merged
+        using OrderKey = std::function<std::int64_t(const T &)>;
+
+        AsyncLogQueue() :
+            started(false),
+            generation(0),
+            staged_count(0),
+            shards_version(0),
+            sources_version(0),
+            next_stage(0),
+            running(false),
+            writer_waiting(false),
+            writer_idle(false),
+            producers_waiting(0),
+            max_depth(0),
+            dropped{},
+            unreported_drops(0)
+        {
+        }
+
+        AsyncLogQueue(const AsyncLogQueue &) = delete;
+        AsyncLogQueue &operator=(const AsyncLogQueue &) = delete;
+
+        ~AsyncLogQueue() { Stop(); }
+
+        // Create the queue and start the writer thread
+        void Start(std::size_t capacity,
+                   Writer writer_function,
+                   IdleTask idle_function = {},
+                   const LogQueuePolicy &queue_policy = {},
+                   DropNotice notice_function = {},
+                   OrderKey order_function = {})
+        {
+            static std::atomic<std::uint64_t> next_generation{1};
+
+            Stop();
+
+            writer = std::move(writer_function);
+            idle_task = std::move(idle_function);
+            policy = queue_policy;
+            drop_notice = std::move(notice_function);
+            order_key = std::move(order_function);
+            if (policy.sharded)
+            {
+                shard_capacity = 2;
+                while (shard_capacity < capacity) shard_capacity <<= 1;
+                low_priority_limit = shard_capacity - shard_capacity / 4;
+                generation = next_generation++;
+            }
+            else
+            {
+                queue = std::make_unique<MPSCQueue<T>>(capacity);
+                low_priority_limit = queue->Capacity() - queue->Capacity() / 4;
+            }
+            started = true;
+            max_depth = 0;
+            writer_idle = false;
+            running = true;
+            thread = std::thread(&AsyncLogQueue::Run, this);
+        }
+
+        // Write all queued values, then stop the writer thread
+        void Stop()
+        {
+            if (!started) return;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                running = false;
+                signal.notify_one();
+            }
+
+            if (thread.joinable()) thread.join();
+
+            queue.reset();
+
+            // Producing threads forget the queues of a stopped queue
+            std::lock_guard<std::mutex> lock(shard_mutex);
+            for (auto &shard : shards) shard->retired = true;
+            shards.clear();
+            sources.clear();
+            started = false;
+        }
+
+        // Is the writer thread running?
+        bool IsRunning() const { return started; }
+
+        // Place a value into the queue, applying the policy if it is full;
+        // returns false if the value was discarded
+        bool Push(T &&value)
+        {
+            bool pushed = policy.sharded ?
+                              PushTo(GetShard().queue, std::move(value)) :
+                              PushTo(*queue, std::move(value));
+            if (!pushed) return false;
+
+            // Wake the writer thread if it is waiting for values
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writer_waiting)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                signal.notify_one();
+            }
+
+            return true;
+        }
+
+        // Number of values discarded at each level
+        LogDropCounts GetDropCounts() const
+        {
+            LogDropCounts counts;
+
+            for (std::size_t i = 0; i < counts.size(); i++)
+            {
+                counts[i] = dropped[i].load(std::memory_order_relaxed);
+            }
+
+            return counts;
+        }
+
+        // Approximate number of values presently in the queue
+        std::size_t GetDepth() const
+        {
+            if (queue) return queue->Size();
+
+            std::lock_guard<std::mutex> lock(shard_mutex);
+            std::size_t depth = staged_count.load(std::memory_order_relaxed);
+            for (const auto &shard : shards) depth += shard->queue.Size();
+
+            return depth;
+        }
+
+        // Most values observed in the queue by the writer thread
+        std::size_t GetMaxDepth() const
+        {
+            return max_depth.load(std::memory_order_relaxed);
+        }
+
+        // Wait until the writer thread has written all queued values
+        void Flush()
+        {
+            if (!started) return;
+
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (!writer_idle || !IsEmpty())
+            {
+                // Ensure the writer thread notices the queued values
+                signal.notify_one();
+                idle_signal.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+
+    protected:
+        static constexpr std::chrono::milliseconds Max_Idle_Wait{100};
+        static constexpr std::chrono::milliseconds Max_Space_Wait{10};
+
+        // Queue given to a producing thread in sharded mode
+        struct Shard
+        {
+            Shard(std::size_t capacity, std::uint64_t generation) :
+                queue(capacity),
+                generation(generation),
+                abandoned(false),
+                retired(false)
+            {
+            }
+
+            SPSCQueue<T> queue;             // Values pushed by the thread
+            std::uint64_t generation;       // Identifies the Start() call
+            std::atomic<bool> abandoned;    // The thread has exited
+            std::atomic<bool> retired;      // The queue has stopped
+        };
+
+        // Shards used by the current thread, abandoned when it exits
+        struct ThreadShards
+        {
+            ~ThreadShards()
+            {
+                for (auto &shard : shards)
+                {
+                    shard->abandoned.store(true, std::memory_order_release);
+                }
+            }
+
+            std::vector<std::shared_ptr<Shard>> shards;
+        };
+
+        // Shard and the value taken from it by the writer thread
+        struct Source
+        {
+            std::shared_ptr<Shard> shard;
+            T value;                        // Value taken from the shard
+            bool staged;                    // Is a value held?
+            std::int64_t key;               // Time of the value
+        };
+
+        // Place a value into the given queue, applying the policy;
+        // returns false if the value was discarded
+        template<typename Queue>
+        bool PushTo(Queue &ring, T &&value)
+        {
+            LogLevel level = value.level;
+
+            // Keep the remaining space for more severe values
+            if ((policy.overflow == LogOverflowPolicy::DropLowPriority) &&
+                (level >= LogLevel::Info) &&
+                (ring.Size() >= low_priority_limit))
+            {
+                CountDrop(level);
+                return false;
+            }
+
+            if (!ring.TryPush(std::move(value)) &&
+                !PushFull(ring, std::move(value)))
+            {
+                CountDrop(level);
+                return false;
+            }
+
+            return true;
+        }
+
+        // Apply the policy to a value that did not fit in the queue;
+        // returns false if the value is to be discarded
+        template<typename Queue>
+        bool PushFull(Queue &ring, T &&value)
+        {
+            switch (policy.overflow)
+            {
+                case LogOverflowPolicy::DropNewest:
+                    return false;
+
+                case LogOverflowPolicy::DropOldest:
+                {
+                    // Only the writer thread removes values from a shard
+                    if constexpr (std::is_same_v<Queue, SPSCQueue<T>>)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        T oldest;
+                        do
+                        {
+                            if (ring.TryPop(oldest)) CountDrop(oldest.level);
+                        } while (!ring.TryPush(std::move(value)));
+                        return true;
+                    }
+                }
+
+                case LogOverflowPolicy::Block:
+                    return WaitToPush(ring, std::move(value), false);
+
+                default:
+                    return WaitToPush(ring, std::move(value), true);
+            }
+        }
+
+        // Return the calling thread's shard, creating it on first use
+        Shard &GetShard()
+        {
+            static thread_local ThreadShards thread_shards;
+            auto &owned = thread_shards.shards;
+
+            for (auto &shard : owned)
+            {
+                if (shard->generation == generation) return *shard;
+            }
+
+            // Forget the shards of queues that have stopped
+            owned.erase(std::remove_if(owned.begin(),
+                                       owned.end(),
+                                       [](const std::shared_ptr<Shard> &shard)
+                                       {
+                                           return shard->retired.load();
+                                       }),
+                        owned.end());
+
+            auto shard = std::make_shared<Shard>(shard_capacity, generation);
+            {
+                std::lock_guard<std::mutex> lock(shard_mutex);
+                shards.push_back(shard);
+                shards_version.fetch_add(1, std::memory_order_release);
+            }
+            owned.push_back(shard);
+
+            return *shard;
+        }
+
+        // Is every queue empty?
+        bool IsEmpty() const
+        {
+            if (queue) return queue->Empty();
+
+            if (staged_count.load(std::memory_order_relaxed) > 0) return false;
+
+            std::lock_guard<std::mutex> lock(shard_mutex);
+            for (const auto &shard : shards)
+            {
+                if (!shard->queue.Empty()) return false;
+            }
+
+            return true;
+        }
+
+        // Remove the next value to be written; hold is set to the time to
+        // wait should values be held for the reorder window
+        bool Pop(T &value, bool drain, std::chrono::nanoseconds &hold)
+        {
+            if (queue) return queue->TryPop(value);
+
+            UpdateSources();
+
+            Source *next = nullptr;
+            bool all_staged = true;
+
+            // Take a value from each shard lacking one, noting the earliest
+            for (auto &source : sources)
+            {
+                if (!source.staged && source.shard->queue.TryPop(source.value))
+                {
+                    source.staged = true;
+                    source.key = order_key ? order_key(source.value) :
+                                             next_stage++;
+                    staged_count.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                if (!source.staged)
+                {
+                    all_staged = false;
+                    continue;
+                }
+
+                if ((next == nullptr) || (source.key < next->key))
+                {
+                    next = &source;
+                }
+            }
+
+            if (next == nullptr) return false;
+
+            // A thread with an empty queue may be pushing an earlier value
+            if (!drain && !all_staged && order_key)
+            {
+                auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch());
+                auto age = now - std::chrono::nanoseconds(next->key);
+                if (age < policy.reorder_window)
+                {
+                    hold = policy.reorder_window - age;
+                    return false;
+                }
+            }
+
+            value = std::move(next->value);
+            next->staged = false;
+            staged_count.fetch_sub(1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Add sources for new shards and release drained shards of threads
+        // that have exited (called only by the writer thread)
+        void UpdateSources()
+        {
+            bool added = (shards_version.load(std::memory_order_acquire) !=
+                          sources_version);
+
+            for (auto it = sources.begin(); it != sources.end();)
+            {
+                if (it->staged ||
+                    !it->shard->abandoned.load(std::memory_order_acquire) ||
+                    !it->shard->queue.Empty())
+                {
+                    it++;
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> lock(shard_mutex);
+                shards.erase(std::find(shards.begin(),
+                                       shards.end(),
+                                       it->shard));
+                it = sources.erase(it);
+            }
+
+            if (!added) return;
+
+            std::lock_guard<std::mutex> lock(shard_mutex);
+            sources_version = shards_version.load(std::memory_order_relaxed);
+            for (auto &shard : shards)
+            {
+                if (std::none_of(sources.begin(),
+                                 sources.end(),
+                                 [&](const Source &source)
+                                 {
+                                     return source.shard == shard;
+                                 }))
+                {
+                    sources.push_back(Source{shard, T{}, false, 0});
+                }
+            }
+        }
+
+        // Wait for the writer to make space for the value, up to the
+        // policy's timeout if bounded
+        template<typename Queue>
+        bool WaitToPush(Queue &ring, T &&value, bool bounded)
+        {
+            auto deadline = std::chrono::steady_clock::now() + policy.timeout;
+
+            do
+            {
+                auto wait = std::chrono::duration_cast<
+                    std::chrono::steady_clock::duration>(Max_Space_Wait);
+                if (bounded)
+                {
+                    auto remaining =
+                        deadline - std::chrono::steady_clock::now();
+                    if (remaining <= remaining.zero()) return false;
+                    wait = std::min(wait, remaining);
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                producers_waiting++;
+                space_signal.wait_for(lock, wait);
+                producers_waiting--;
+            } while (!ring.TryPush(std::move(value)));
+
+            return true;
+        }
+
+        // Count a discarded value
+        void CountDrop(LogLevel level)
+        {
+            dropped[static_cast<std::size_t>(level)].fetch_add(
+                1,
+                std::memory_order_relaxed);
+            unreported_drops.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Writer thread function, which exits only once the queue is empty
+        // and it has been asked to stop
+        void Run()
+        {
+            T value;
+            std::chrono::nanoseconds hold{0};
+
+            while (true)
+            {
+                // Only this thread updates the maximum depth
+                if (!queue) UpdateMaxDepth(GetDepth());
+
+                // Write all values presently in the queue
+                hold = hold.zero();
+                while (Pop(value, !running, hold))
+                {
+                    if (queue) UpdateMaxDepth(queue->Size() + 1);
+
+                    // Note any values discarded since the last notice
+                    if (unreported_drops.load(std::memory_order_relaxed) > 0)
+                    {
+                        auto count = unreported_drops.exchange(0);
+                        if (drop_notice) drop_notice(value, count);
+                    }
+
+                    writer(value);
+
+                    // Let any producers waiting for space proceed
+                    if (producers_waiting)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        space_signal.notify_all();
+                    }
+                }
+
+                // Perform any idle work, such as flushing buffered output
+                auto wait_interval = Max_Idle_Wait;
+                if (idle_task)
+                {
+                    auto interval = idle_task();
+                    if ((interval.count() > 0) && (interval < wait_interval))
+                    {
+                        wait_interval = interval;
+                    }
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+
+                // Indicate that the writer is waiting for more values
+                writer_waiting = true;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (IsEmpty())
+                {
+                    // Let any thread waiting in Flush() know it is drained
+                    writer_idle = true;
+                    idle_signal.notify_all();
+
+                    if (!running) break;
+
+                    signal.wait_for(lock,
+                                    wait_interval,
+                                    [&]() -> bool
+                                    {
+                                        return !IsEmpty() || !running;
+                                    });
+
+                    writer_idle = false;
+                }
+                else if ((hold > hold.zero()) && running)
+                {
+                    // Wait for values held for the reorder window to age
+                    signal.wait_for(lock, std::min<std::chrono::nanoseconds>(
+                                              hold,
+                                              wait_interval));
+                }
+
+                writer_waiting = false;
+            }
+
+            writer_waiting = false;
+        }
+
+        // Note the number of values observed in the queue
+        void UpdateMaxDepth(std::size_t depth)
+        {
+            if (depth > max_depth.load(std::memory_order_relaxed))
+            {
+                max_depth.store(depth, std::memory_order_relaxed);
+            }
+        }
+
+        bool started;                   // Has Start() been called?
+        std::unique_ptr<MPSCQueue<T>> queue;
+                                        // Queue of values to be written, if
+                                        // not sharded
+        std::size_t shard_capacity;     // Capacity of each shard
+        std::uint64_t generation;       // Identifies shards of this Start()
+        mutable std::mutex shard_mutex; // Protects shards
+        std::vector<std::shared_ptr<Shard>> shards;
+                                        // Queue of each producing thread
+        std::vector<Source> sources;    // Shards read by the writer thread
+        std::atomic<std::size_t> staged_count;
+                                        // Values taken from shards but not
+                                        // yet written
+        std::atomic<std::uint64_t> shards_version;
+                                        // Incremented as shards are added
+        std::uint64_t sources_version;  // Version of shards in sources
+        std::int64_t next_stage;        // Order of values without a key
+        OrderKey order_key;             // Time of each value
+        Writer writer;                  // Writes each value
+        IdleTask idle_task;             // Called when the queue is empty
+        DropNotice drop_notice;         // Called after values are discarded
+        LogQueuePolicy policy;          // Action taken when the queue is full
+        std::size_t low_priority_limit; // Size beyond which Debug and Info
+                                        // values are discarded
+        std::thread thread;             // Background writer thread
+        std::mutex mutex;               // Mutex used with signals
+        std::condition_variable signal; // Signal new values or shutdown
+        std::condition_variable space_signal;
+                                        // Signal that space is available
+        std::condition_variable idle_signal;
+                                        // Signal that the writer is idle
+        std::atomic<bool> running;      // Writer thread should run
+        std::atomic<bool> writer_waiting;
+                                        // Writer waiting for values
+        std::atomic<bool> writer_idle;  // Writer drained the queue
+        std::atomic<unsigned> producers_waiting;
+                                        // Producers waiting for space
+        std::atomic<std::size_t> max_depth;
+                                        // Most values observed in the queue
+        std::atomic<std::uint64_t> dropped[Log_Level_Count];
+                                        // Values discarded at each level
+        std::atomic<std::uint64_t> unreported_drops;
+                                        // Values discarded since the last
+                                        // notice
+};
+
+} // namespace cantina
@@ -0,0 +1,407 @@
+/*
+ *  basic_logger.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the BasicLogger class template, a logger whose sink and
+ *      line format are chosen at compile time.  The Logger writes each
+ *      message through a virtual EmitLog() to sinks selected at run time,
+ *      which suits most programs.  A program that knows where its messages
+ *      go can instead use a BasicLogger, whose calls to the format policy
+ *      and the sink policy are direct and may be inlined.  A message less
+ *      severe than the template's minimum level is rejected with
+ *      "if constexpr", so the call compiles to nothing, while SetLogLevel()
+ *      filters at run time within that bound.
+ *
+ *      A format policy provides a static Format() function that writes the
+ *      line for a message into a string and returns the message text that
+ *      sinks not writing lines (e.g., syslog) should use.  Text and JSON
+ *      Lines policies are defined here, with the timestamp format and
+ *      precision as template arguments.  A sink policy is any type with
+ *      Write(const LogMessage &) and Flush() member functions that are safe
+ *      to call from multiple threads.  Policies for standard error, for a
+ *      file written through a LogFile, and for the system's syslog() are
+ *      defined here.
+ *
+ *          cantina::BasicLogger<cantina::LogFileSinkPolicy,
+ *                               cantina::LogTextFormatPolicy<>,
+ *                               cantina::LogLevel::Info> logger("app.log");
+ *          logger.Info("Started with {} workers", workers);
+ *
+ *  Portability Issues:
+ *      LogSyslogSinkPolicy is available only where <syslog.h> exists.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <syslog.h>
+#define LOGGER_SYSLOG_POLICY_SUPPORTED
+#endif
+#include "log_types.h"
+#include "log_format.h"
+#include "log_fields.h"
+#include "log_file.h"
+#include "log_sink.h"
+
+namespace cantina
+{
+
+// Format policy producing "<timestamp> [LEVEL] text"
+template<LogTimeFormat Time_Format = LogTimeFormat::LocalTime,
+         LogTimePrecision Time_Precision = LogTimePrecision::Microseconds>
+struct LogTextFormatPolicy
+{
+    static constexpr LogOutputFormat Output_Format = LogOutputFormat::Text;
+
+    // Write the line into the string, returning the text within it
+    static std::string_view Format(
+                            std::string &line,
+                            LogLevel level,
+                            const std::chrono::system_clock::time_point &time,
+                            std::string_view text)
+    {
+        char timestamp[Max_Timestamp_Length];
+
+        line.assign(timestamp,
+                    FormatLogTimestamp(time,
+                                       Time_Format,
+                                       Time_Precision,
+                                       timestamp));
+        line += " [";
+        line += LogLevelName(level);
+        line += "] ";
+        std::size_t text_offset = line.size();
+        line += text;
+
+        return std::string_view(line).substr(text_offset);
+    }
+};
+
+// Format policy producing one JSON object per line
+template<LogTimeFormat Time_Format = LogTimeFormat::UTC,
+         LogTimePrecision Time_Precision = LogTimePrecision::Microseconds>
+struct LogJsonFormatPolicy
+{
+    static constexpr LogOutputFormat Output_Format =
+        LogOutputFormat::JsonLines;
+
+    // Write the line into the string, returning the text unchanged
+    static std::string_view Format(
+                            std::string &line,
+                            LogLevel level,
+                            const std::chrono::system_clock::time_point &time,
+                            std::string_view text)
+    {
+        char timestamp[Max_Timestamp_Length];
+
+        line.clear();
+        AppendJsonLine(line,
+                       std::string_view(timestamp,
+                                        FormatLogTimestamp(time,
+                                                           Time_Format,
+                                                           Time_Precision,
+                                                           timestamp)),
+                       LogLevelName(level),
+                       text,
+                       LogTextLayout{});
+
+        return text;
+    }
+};
+
+// Sink policy writing lines to standard error
+class LogConsoleSinkPolicy
+{
+    public:
+        void Write(const LogMessage &message)
+        {
+            LogTextBuffer buffer;
+            std::string &output = buffer.Get();
+
+            // Assemble the line so that it is written with a single call
+            output.assign(message.line);
+            output += '\n';
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::fwrite(output.data(), 1, output.size(), stderr);
+        }
+
+        void Flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::fflush(stderr);
+        }
+
+    protected:
+        std::mutex mutex;               // Keeps lines whole
+};
+
+// Sink policy writing lines to a file according to a LogFlushPolicy
+class LogFileSinkPolicy
+{
+    public:
+        LogFileSinkPolicy(const std::string &filename,
+                          const LogFlushPolicy &flush_policy = {})
+        {
+            file.Open(filename, flush_policy);
+        }
+
+        // Was the file opened?
+        bool IsOpen() const { return file.IsOpen(); }
+
+        void Write(const LogMessage &message)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            file.WriteLine(message.line.data(),
+                           message.line.size(),
+                           message.level <= LogLevel::Error);
+        }
+
+        void Flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            file.Flush();
+        }
+
+    protected:
+        std::mutex mutex;               // Protects the file
+        LogFile file;                   // File to which lines are written
+};
+
+#ifdef LOGGER_SYSLOG_POLICY_SUPPORTED
+// Sink policy passing message text to the system's syslog()
+class LogSyslogSinkPolicy
+{
+    public:
+        // Open the system log, as with openlog(); the identity must remain
+        // valid while the sink exists
+        LogSyslogSinkPolicy(const char *identity = nullptr,
+                            int option = LOG_PID,
+                            int facility = LOG_USER)
+        {
+            ::openlog(identity, option, facility);
+        }
+
+        LogSyslogSinkPolicy(const LogSyslogSinkPolicy &) = delete;
+
+        ~LogSyslogSinkPolicy() { ::closelog(); }
+
+        void Write(const LogMessage &message)
+        {
+            ::syslog(Priority(message.level),
+                     "%.*s",
+                     static_cast<int>(message.text.size()),
+                     message.text.data());
+        }
+
+        void Flush() {}
+
+    protected:
+        static constexpr int Priority(LogLevel level)
+        {
+            switch (level)
+            {
+                case LogLevel::Critical:
+                    return LOG_CRIT;
+
+                case LogLevel::Error:
+                    return LOG_ERR;
+
+                case LogLevel::Warning:
+                    return LOG_WARNING;
+
+                case LogLevel::Info:
+                    return LOG_INFO;
+
+                default:
+                    return LOG_DEBUG;
+            }
+        }
+};
+#endif
+
+// Logger whose sink and format are fixed at compile time, which rejects
+// messages less severe than Minimum_Level without generating any code
+template<typename SinkPolicy,
+         typename FormatPolicy = LogTextFormatPolicy<>,
+         LogLevel Minimum_Level = LogLevel::Debug>
+class BasicLogger
+{
+    public:
+        // Least severe level that may be logged
+        static constexpr LogLevel Compiled_Level = Minimum_Level;
+
+        // Construct the sink from the given arguments
+        template<typename... SinkArgs>
+        explicit BasicLogger(SinkArgs &&...sink_args) :
+            sink(std::forward<SinkArgs>(sink_args)...),
+            log_level(LogLevel::Info)
+        {
+        }
+
+        BasicLogger(const BasicLogger &) = delete;
+        BasicLogger &operator=(const BasicLogger &) = delete;
+
+        ~BasicLogger() { sink.Flush(); }
+
+        // Set the log level to be output (default is LogLevel::Info), which
+        // is bounded by Minimum_Level
+        void SetLogLevel(LogLevel level)
+        {
+            log_level.store(level, std::memory_order_relaxed);
+        }
+
+        // Get the current log level
+        LogLevel GetLogLevel() const
+        {
+            return log_level.load(std::memory_order_relaxed);
+        }
+
+        // Check to see if messages at the given level are to be logged
+        bool ShouldLog(LogLevel level) const
+        {
+            return (level <= Minimum_Level) && (level <= GetLogLevel());
+        }
+
+        // As above, for a level known at compile time
+        template<LogLevel Level>
+        bool ShouldLog() const
+        {
+            if constexpr (Level > Minimum_Level)
+            {
+                return false;
+            }
+            else
+            {
+                return Level <= GetLogLevel();
+            }
+        }
+
+        // Log a message at a level known at compile time
+        template<LogLevel Level, typename... Args>
+        void Log(LogFormat<Args...> format, const Args &...args)
+        {
+            if constexpr (Level <= Minimum_Level)
+            {
+                if (Level > GetLogLevel()) return;
+
+                LogTextBuffer buffer;
+                std::string &text = buffer.Get();
+                text.clear();
+                FormatLogMessage(text, format.Get(), args...);
+
+                Write(Level, text);
+            }
+        }
+
+        // Log a message at a level known only at run time
+        void Log(LogLevel level, std::string_view message)
+        {
+            if (ShouldLog(level)) Write(level, message);
+        }
+
+        // Functions to log messages using format strings
+        template<typename... Args>
+        void Critical(LogFormat<Args...> format, const Args &...args)
+        {
+            Log<LogLevel::Critical, Args...>(format, args...);
+        }
+
+        template<typename... Args>
+        void Error(LogFormat<Args...> format, const Args &...args)
+        {
+            Log<LogLevel::Error, Args...>(format, args...);
+        }
+
+        template<typename... Args>
+        void Warning(LogFormat<Args...> format, const Args &...args)
+        {
+            Log<LogLevel::Warning, Args...>(format, args...);
+        }
+
+        template<typename... Args>
+        void Info(LogFormat<Args...> format, const Args &...args)
+        {
+            Log<LogLevel::Info, Args...>(format, args...);
+        }
+
+        template<typename... Args>
+        void Debug(LogFormat<Args...> format, const Args &...args)
+        {
+            Log<LogLevel::Debug, Args...>(format, args...);
+        }
+
+        // Write any output buffered by the sink
+        void Flush() { sink.Flush(); }
+
+        // Sink to which messages are written
+        SinkPolicy &GetSink() { return sink; }
+
+    protected:
+        // Format the line and give it to the sink
+        void Write(LogLevel level, std::string_view message)
+        {
+            LogTextBuffer buffer;
+            std::string &line = buffer.Get();
+            auto time = std::chrono::system_clock::now();
+
+            std::string_view text =
+                FormatPolicy::Format(line, level, time, message);
+
+            sink.Write(LogMessage{level,
+                                  false,
+                                  time,
+                                  line,
+                                  text,
+                                  FormatPolicy::Output_Format});
+        }
+
+        SinkPolicy sink;                // Destination of messages
+        std::atomic<LogLevel> log_level;// Log level to be logged
+};
+
+} // namespace cantina
@@ -0,0 +1,275 @@
+/*
+ *  binary_log.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the types and functions used for deferred binary
+ *      logging.  Rather than formatting a message as text, each binary
+ *      logging call site defines a static BinaryFormat describing the
+ *      message and the hot path records only the format's identifier, a
+ *      timestamp, and the raw bytes of each argument.  Conversion to text
+ *      happens later, either on the Logger's background writer thread or
+ *      offline when reading a binary log.
+ *
+ *      Format strings use "{}" as the placeholder for each argument, while
+ *      "{{" and "}}" produce literal braces.  Each argument is encoded as a
+ *      one-octet BinaryArgumentType followed by its value: eight octets for
+ *      integers and floating point values, one octet for bool and char, and
+ *      a four-octet length followed by the characters for strings.  All
+ *      multi-octet values use the host's byte order.
+ *
+ *      A binary log consists of a sequence of memory-mapped segments (see
+ *      mapped_log_file.h) containing message records, plus a file with the
+ *      suffix ".formats" that contains a format record for each BinaryFormat
+ *      used.  Every record begins with a BinaryRecordHeader.  A message
+ *      record's header is followed by the component prefix and the encoded
+ *      arguments.  A format record's header is followed by a
+ *      BinaryFormatBody, the source file name, and the format string.
+ *
+ *      The formats file also holds clock records and index records.  An
+ *      index record is written for the message record spanning each
+ *      Binary_Index_Interval boundary of a segment, giving its offset and
+ *      timestamp, so that a reader may seek to the messages logged at a
+ *      given time rather than scanning every segment (see
+ *      binary_log_reader.h).
+ *      A record length of zero marks the unused tail of a segment that is
+ *      still being written.
+ *
+ *      Message timestamps are in nanoseconds since the epoch unless the
+ *      Logger reads another clock (see log_clock.h), in which case they are
+ *      raw clock values and the formats file also holds clock records.
+ *      Each clock record's header is followed by a BinaryClockBody; a raw
+ *      value is converted using the last clock record whose raw value does
+ *      not exceed it (or the first clock record), as is done by
+ *      LogClockCalibration::ToNanoseconds().
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "log_format.h"
+
+namespace cantina
+{
+
+// Log level enumeration (defined in logger.h)
+enum class LogLevel;
+
+// Types of arguments recorded in binary log messages
+enum class BinaryArgumentType : std::uint8_t
+{
+    Signed = 1,
+    Unsigned,
+    Floating,
+    Boolean,
+    Character,
+    String
+};
+
+// Types of records found in a binary log
+enum class BinaryRecordType : std::uint8_t
+{
+    Message = 1,
+    Format,
+    Clock,
+    Index
+};
+
+// Header that begins every binary log record
+struct BinaryRecordHeader
+{
+    std::uint32_t length;               // Length of the record in octets
+    std::uint8_t type;                  // BinaryRecordType
+    std::uint8_t level;                 // LogLevel of the message
+    std::uint16_t prefix_length;        // Length of the component prefix
+    std::uint64_t format_id;            // Identifier of the BinaryFormat
+    std::int64_t timestamp;             // Nanoseconds since the epoch, or
+                                        // raw clock value of a message
+};
+
+// Body of a format record, followed by the file name and format string
+struct BinaryFormatBody
+{
+    std::uint32_t line;                 // Source line of the call site
+    std::uint32_t file_length;          // Length of the file name
+    std::uint32_t format_length;        // Length of the format string
+};
+
+// Body of a clock record, whose header gives the LogClockSource as its
+// level and the system time at the calibration as its timestamp
+struct BinaryClockBody
+{
+    std::uint64_t ticks;                // Raw clock value at calibration
+    double nanoseconds_per_tick;        // Rate of the raw clock
+};
+
+// Body of an index record, whose header gives the segment's sequence
+// number as its format_id and the message's timestamp
+struct BinaryIndexBody
+{
+    std::uint64_t offset;               // Offset of the message record
+};
+
+// Static description of a binary logging call site
+struct BinaryFormat
+{
+    LogLevel level;                     // Level of the message
+    const char *format;                 // Format string
+    const char *file;                   // Source file of the call site
+    unsigned line;                      // Source line of the call site
+    std::uint64_t id;                   // Identifier of the format
+    mutable std::atomic<std::uint64_t> generation;
+                                        // Binary log holding this format
+};
+
+// Suffix of the file holding format records
+constexpr std::string_view Binary_Formats_Suffix = ".formats";
+
+// Octets of each segment between index records
+constexpr std::size_t Binary_Index_Interval = 64 * 1024;
+
+// Produce a format identifier that is stable across program runs
+constexpr std::uint64_t BinaryFormatId(const char *format,
+                                       const char *file,
+                                       unsigned line)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (const char *p = format; *p != '\0'; p++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*p)) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ 0xff) * 0x100000001b3ULL;
+    for (const char *p = file; *p != '\0'; p++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*p)) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ line) * 0x100000001b3ULL;
+
+    return hash;
+}
+
+// Used to reject unsupported argument types at compile time
+template<typename T>
+struct UnsupportedBinaryArgument : std::false_type
+{
+};
+
+// Append the encoded form of a single argument to the buffer
+template<typename T>
+void EncodeBinaryArgument(std::string &buffer, const T &value)
+{
+    using Type = std::decay_t<T>;
+
+    auto append = [&](BinaryArgumentType type, const void *data,
+                      std::size_t length)
+    {
+        buffer.push_back(static_cast<char>(type));
+        buffer.append(static_cast<const char *>(data), length);
+    };
+
+    if constexpr (std::is_same_v<Type, bool>)
+    {
+        std::uint8_t octet = value ? 1 : 0;
+        append(BinaryArgumentType::Boolean, &octet, 1);
+    }
+    else if constexpr (std::is_same_v<Type, char>)
+    {
+        append(BinaryArgumentType::Character, &value, 1);
+    }
+    else if constexpr (std::is_enum_v<Type>)
+    {
+        EncodeBinaryArgument(buffer,
+                             static_cast<std::underlying_type_t<Type>>(value));
+    }
+    else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+    {
+        std::int64_t integer = value;
+        append(BinaryArgumentType::Signed, &integer, sizeof(integer));
+    }
+    else if constexpr (std::is_integral_v<Type>)
+    {
+        std::uint64_t integer = value;
+        append(BinaryArgumentType::Unsigned, &integer, sizeof(integer));
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+        double floating = static_cast<double>(value);
+        append(BinaryArgumentType::Floating, &floating, sizeof(floating));
+    }
+    else if constexpr (std::is_same_v<Type, const char *> ||
+                       std::is_same_v<Type, char *>)
+    {
+        EncodeBinaryArgument(buffer, LogStringArgument(value));
+    }
+    else if constexpr (std::is_convertible_v<const Type &, std::string_view>)
+    {
+        std::string_view string = value;
+        auto length = static_cast<std::uint32_t>(string.size());
+        append(BinaryArgumentType::String, &length, sizeof(length));
+        buffer.append(string.data(), length);
+    }
+    else
+    {
+        static_assert(UnsupportedBinaryArgument<Type>::value,
+                      "Unsupported binary log argument type");
+    }
+}
+
+// Convert encoded arguments to text using the given format string
+std::string DecodeBinaryArguments(std::string_view format,
+                                  std::string_view arguments);
+
+// Append the text of encoded arguments using the given format string
+void AppendBinaryArguments(std::string &output,
+                           std::string_view format,
+                           std::string_view arguments);
+
+// Append the text of the next encoded argument, advancing past it
+bool DecodeBinaryArgument(std::string_view &arguments, std::string &output);
+
+} // namespace cantina
@@ -0,0 +1,191 @@
+/*
+ *  binary_log_reader.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the BinaryLogReader class, which decodes the messages
+ *      in a binary log (see binary_log.h) back to text.  Open() reads the
+ *      format, clock, and index records from the log's formats file and
+ *      finds its segments; Refresh() reads any added since, so that a log
+ *      still being written may be followed.
+ *
+ *      Messages are selected using a BinaryLogFilter giving a time range,
+ *      the least severe level, and a component.  The index records locate
+ *      the message spanning each Binary_Index_Interval of a segment, so
+ *      reading a time range starts and stops near the range rather than
+ *      scanning the whole segment.  Since threads time messages just before
+ *      writing them, the times of records are not strictly ordered; one
+ *      additional interval is read on each side of the range to allow for
+ *      this.  Read() decodes the segments in parallel, one thread per
+ *      segment, and gives the messages from each segment in order.
+ *
+ *      Raw clock values recorded by a Logger using a clock other than the
+ *      system time are converted using the clock records most recently
+ *      written for that clock.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "binary_log.h"
+#include "log_clock.h"
+#include "log_types.h"
+
+namespace cantina
+{
+
+// Message decoded from a binary log
+struct BinaryLogEntry
+{
+    std::int64_t time;                  // Nanoseconds since the epoch
+    LogLevel level;                     // Level of the message
+    std::string prefix;                 // Component prefix
+    std::string text;                   // Text of the message
+};
+
+// Criteria selecting the messages read from a binary log
+struct BinaryLogFilter
+{
+    // Earliest and latest times of messages, in nanoseconds since the epoch
+    std::int64_t start = std::numeric_limits<std::int64_t>::min();
+    std::int64_t end = std::numeric_limits<std::int64_t>::max();
+
+    // Least severe level of messages
+    LogLevel level = LogLevel::Debug;
+
+    // Component path of messages (e.g., "Foo.Bar"), or empty for all
+    std::string component;
+};
+
+// Function receiving the messages read from one segment
+using BinaryLogCallback =
+    std::function<void(std::size_t segment,
+                       std::vector<BinaryLogEntry> &entries)>;
+
+// Binary log reader declaration
+class BinaryLogReader
+{
+    public:
+        // Offset meaning the end of a segment
+        static constexpr std::size_t End_Offset =
+            std::numeric_limits<std::size_t>::max();
+
+        BinaryLogReader();
+        BinaryLogReader(const BinaryLogReader &) = delete;
+        BinaryLogReader &operator=(const BinaryLogReader &) = delete;
+        ~BinaryLogReader() = default;
+
+        // Open the binary log given the name passed to SetBinaryLog()
+        bool Open(const std::string &base_name);
+
+        // Read records and segments added since the last call
+        void Refresh();
+
+        // Number of segments found
+        std::size_t GetSegmentCount() const { return segment_count; }
+
+        // Present size of a segment
+        std::size_t GetSegmentSize(std::size_t segment) const;
+
+        // Time of the first message, if there is one
+        bool GetStartTime(std::int64_t &time) const;
+
+        // Convert a message timestamp to nanoseconds since the epoch
+        std::int64_t ToNanoseconds(std::int64_t timestamp) const;
+
+        // Range of a segment to be read for the filter's time range
+        void Seek(std::size_t segment,
+                  const BinaryLogFilter &filter,
+                  std::size_t &begin,
+                  std::size_t &stop) const;
+
+        // Read matching messages from records starting at offsets from
+        // begin up to stop, returning the offset after the last read
+        std::size_t ReadSegment(std::size_t segment,
+                                std::size_t begin,
+                                std::size_t stop,
+                                const BinaryLogFilter &filter,
+                                std::vector<BinaryLogEntry> &entries,
+                                bool live = false) const;
+
+        // Read matching messages from every segment using the given number
+        // of threads (0 for one per processor), returning the offset after
+        // the last record read from the last segment
+        std::size_t Read(const BinaryLogFilter &filter,
+                         const BinaryLogCallback &callback,
+                         unsigned threads = 0) const;
+
+    protected:
+        struct IndexEntry
+        {
+            std::size_t offset;                 // Offset of the message
+            std::int64_t timestamp;             // Timestamp of the message
+        };
+
+        bool Exists(std::size_t segment) const;
+        void ReadFormats();
+        void AddRecord(const BinaryRecordHeader &header, const char *body);
+        bool Matches(const BinaryRecordHeader &header,
+                     std::string_view prefix,
+                     const BinaryLogFilter &filter,
+                     std::string_view component_prefix,
+                     std::int64_t &time) const;
+
+        std::string base_name;                  // Name given to Open()
+        std::size_t formats_offset;             // Octets of formats read
+        std::size_t segment_count;              // Segments found
+        std::unordered_map<std::uint64_t, std::string> formats;
+                                                // Format strings by ID
+        LogClockSource clock_source;            // Clock timing messages
+        std::vector<LogClockCalibration> calibrations;
+                                                // Calibrations of the clock
+        std::vector<std::vector<IndexEntry>> index;
+                                                // Index of each segment
+};
+
+} // namespace cantina
@@ -0,0 +1,156 @@
+/*
+ *  flight_recorder.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the FlightRecorder class, a fixed-size ring holding the
+ *      most recent log messages at every level, including those below the
+ *      Logger's log level.  Adding a message copies at most
+ *      Max_Record_Length octets of text into a slot reserved with an
+ *      atomic increment; no timestamp string is formatted and no I/O is
+ *      performed.  Each slot is guarded by a sequence number so that the
+ *      ring may be read while messages are being added.  If a thread finds
+ *      a slot still being written by a thread that has wrapped around the
+ *      ring, its message is discarded rather than waiting.
+ *
+ *      The recorded messages may be retrieved with Drain() or written to a
+ *      file descriptor with DumpToDescriptor(), which is safe to call from
+ *      a signal handler.  InstallSignalHandlers() arranges for the ring to
+ *      be written to a file descriptor when the process receives a fatal
+ *      signal.
+ *
+ *  Portability Issues:
+ *      Signal handlers are installed only on POSIX systems.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "log_types.h"
+
+namespace cantina
+{
+
+// Message retrieved from the flight recorder
+struct FlightRecord
+{
+    std::uint64_t sequence;             // Order in which it was added
+    LogLevel level;                     // Level of the message
+    std::chrono::system_clock::time_point time;
+                                        // Time the message was added
+    std::string text;                   // Prefix followed by message text
+    std::size_t prefix_length;          // Octets of text that are the prefix
+    bool written;                       // Already written when it was added
+};
+
+// Flight recorder declaration
+class FlightRecorder
+{
+    public:
+        // Longest message text retained (longer text is truncated)
+        static constexpr std::size_t Max_Record_Length = 240;
+
+        FlightRecorder(std::size_t capacity);
+        FlightRecorder(const FlightRecorder &) = delete;
+        ~FlightRecorder();
+
+        // Number of messages retained
+        std::size_t GetCapacity() const;
+
+        // Add a message made of a prefix and text, noting whether it was
+        // written when logged (safe for concurrent use)
+        void Add(LogLevel level,
+                 std::string_view prefix,
+                 std::string_view text,
+                 bool written);
+
+        // Retrieve, oldest first, messages not previously drained
+        std::vector<FlightRecord> Drain();
+
+        // Write messages not previously drained (async-signal-safe)
+        void DumpToDescriptor(int fd);
+
+        // Dump the recorder to the descriptor upon a fatal signal
+        static bool InstallSignalHandlers(FlightRecorder *recorder, int fd);
+
+    protected:
+        static constexpr std::size_t Words_Per_Slot =
+            (Max_Record_Length + sizeof(std::uint64_t) - 1) /
+            sizeof(std::uint64_t);
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> sequence{0};
+                                        // Even when stable, odd if writing
+            std::atomic<std::uint64_t> ticket{0};
+                                        // Position in the ring plus one
+            std::atomic<std::int64_t> time{0};
+                                        // Nanoseconds since the epoch
+            std::atomic<std::uint32_t> level{0};
+                                        // Level of the message
+            std::atomic<std::uint32_t> length{0};
+                                        // Octets of text
+            std::atomic<std::uint32_t> prefix_length{0};
+                                        // Octets of text that are the prefix
+            std::atomic<std::uint32_t> written{0};
+                                        // Non-zero if already written
+            std::atomic<std::uint64_t> words[Words_Per_Slot];
+                                        // Text, stored as words
+        };
+
+        bool ReadSlot(std::uint64_t ticket,
+                      FlightRecord &record,
+                      char *text,
+                      std::size_t &length) const;
+        std::uint64_t TakeUndrained(std::uint64_t &end);
+
+        std::size_t capacity;           // Number of slots (power of two)
+        std::unique_ptr<Slot[]> slots;  // Ring of slots
+        std::atomic<std::uint64_t> head;// Next ticket to assign
+        std::atomic<std::uint64_t> drained;
+                                        // Tickets before this were drained
+};
+
+} // namespace cantina
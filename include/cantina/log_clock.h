@@ -0,0 +1,205 @@
+/*
+ *  log_clock.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogClock class, which reads the clock used to time
+ *      messages queued for the Logger's background writer thread or written
+ *      to a binary log.  Rather than reading the system time, which may
+ *      involve a system call, the clock may record the raw value of the
+ *      CPU's invariant time stamp counter (TSC) or of CLOCK_MONOTONIC_COARSE,
+ *      deferring conversion to the time of day until the message is written
+ *      or decoded.
+ *
+ *      Raw values are converted using a calibration that relates them to
+ *      the system time.  The clock is calibrated when its source is set and
+ *      again periodically, when a value read is found to be past the time
+ *      of the next calibration, so conversion follows any drift of the
+ *      counter relative to the system time.  Calibrations are published
+ *      using a sequence lock, so converting a value takes no lock.
+ *
+ *  Portability Issues:
+ *      The TSC is read only on x86 processors and CLOCK_MONOTONIC_COARSE only
+ *      where it is defined (e.g., Linux).  Elsewhere, these sources are not
+ *      available and the system time is read.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define LOGGER_TSC_SUPPORTED
+#endif
+#include <time.h>
+
+namespace cantina
+{
+
+// Clock read when a message is recorded
+enum class LogClockSource : std::uint8_t
+{
+    System,                             // Nanoseconds since the epoch
+    Tsc,                                // Invariant time stamp counter
+    MonotonicCoarse                     // CLOCK_MONOTONIC_COARSE
+};
+
+// Relation of raw clock values to nanoseconds since the epoch
+struct LogClockCalibration
+{
+    std::uint64_t ticks;                // Raw value at the calibration
+    std::int64_t nanoseconds;           // System time at the calibration
+    double nanoseconds_per_tick;        // Rate of the raw clock
+
+    // Convert a raw clock value to nanoseconds since the epoch
+    std::int64_t ToNanoseconds(std::uint64_t value) const
+    {
+        auto delta = static_cast<std::int64_t>(value - ticks);
+
+        if (nanoseconds_per_tick == 1.0) return nanoseconds + delta;
+
+        return nanoseconds + static_cast<std::int64_t>(
+                                 static_cast<double>(delta) *
+                                 nanoseconds_per_tick);
+    }
+};
+
+class LogClock
+{
+    public:
+        // Interval between calibrations against the system time
+        static constexpr std::chrono::seconds Calibration_Interval{10};
+
+        LogClock();
+        LogClock(const LogClock &) = delete;
+        LogClock &operator=(const LogClock &) = delete;
+        ~LogClock() = default;
+
+        // Is the given source usable on this system?
+        static bool IsAvailable(LogClockSource source);
+
+        // Read and calibrate the given source, if available
+        bool SetSource(LogClockSource source);
+
+        // Source read by Now()
+        LogClockSource GetSource() const
+        {
+            return source.load(std::memory_order_relaxed);
+        }
+
+        // Read the raw value of the clock
+        std::uint64_t Now() const
+        {
+            return Read(source.load(std::memory_order_relaxed));
+        }
+
+        // Is the raw value at or beyond the time of the next calibration?
+        bool IsCalibrationDue(std::uint64_t ticks) const
+        {
+            return ticks >= next_calibration.load(std::memory_order_relaxed);
+        }
+
+        // Calibrate the clock, unless another thread is doing so
+        bool Calibrate();
+
+        // Calibration most recently published
+        LogClockCalibration GetCalibration() const;
+
+        // Convert a raw value using the most recent calibration
+        std::chrono::system_clock::time_point ToTime(std::uint64_t ticks) const
+        {
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<
+                    std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(
+                        GetCalibration().ToNanoseconds(ticks))));
+        }
+
+    protected:
+        // Read the raw value of the given source
+        static std::uint64_t Read(LogClockSource source)
+        {
+            switch (source)
+            {
+#ifdef LOGGER_TSC_SUPPORTED
+                case LogClockSource::Tsc:
+                    return __rdtsc();
+#endif
+#ifdef CLOCK_MONOTONIC_COARSE
+                case LogClockSource::MonotonicCoarse:
+                {
+                    struct timespec now;
+                    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+                    return static_cast<std::uint64_t>(now.tv_sec) *
+                               1000000000ULL +
+                           static_cast<std::uint64_t>(now.tv_nsec);
+                }
+#endif
+                default:
+                    return static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now()
+                                .time_since_epoch())
+                            .count());
+            }
+        }
+
+        // Read the source and the system time at about the same instant
+        static LogClockCalibration Sample(LogClockSource source);
+
+        // Publish a calibration (called with calibration_mutex held)
+        void Publish(const LogClockCalibration &calibration);
+
+        std::atomic<LogClockSource> source;     // Source read by Now()
+        std::atomic<std::uint64_t> next_calibration;
+                                                // Raw value when due
+        std::mutex calibration_mutex;           // Serializes calibration
+        std::atomic<std::uint32_t> sequence;    // Odd while publishing
+        std::atomic<std::uint64_t> ticks;       // Published calibration
+        std::atomic<std::int64_t> nanoseconds;
+        std::atomic<double> nanoseconds_per_tick;
+};
+
+} // namespace cantina
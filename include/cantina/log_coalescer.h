@@ -0,0 +1,140 @@
+/*
+ *  log_coalescer.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogCoalescer class, which the Logger uses to count,
+ *      rather than write, consecutive repeats of a message.  Each component
+ *      and level is given a slot recording a hash of the last message
+ *      written, and a message whose hash and length match the slot's is a
+ *      repeat.  A run of repeats ends when a different message is logged by
+ *      the same component at the same level, when no repeat has been seen
+ *      for the timeout, or when the run has lasted for the timeout, and the
+ *      Logger then writes one line summarizing the run.
+ *
+ *      Slots are chosen by hashing the component prefix and level, so two
+ *      components sharing a slot end each other's runs.  This only causes
+ *      repeats to be written in full, never a message to be lost.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "log_types.h"
+
+namespace cantina
+{
+
+// Run of repeated messages to be summarized
+struct LogRepeat
+{
+    LogLevel level;                     // Level of the messages
+    std::string prefix;                 // Component prefix of the messages
+    bool console;                       // Also write to the console?
+    std::uint64_t count;                // Number of repeats counted
+    std::chrono::system_clock::time_point first;
+                                        // Time of the first repeat
+    std::chrono::system_clock::time_point last;
+                                        // Time of the last repeat
+};
+
+// Repeated message coalescer declaration
+class LogCoalescer
+{
+    public:
+        // Number of component and level slots
+        static constexpr std::size_t Slot_Count = 64;
+
+        LogCoalescer(std::chrono::milliseconds timeout);
+        LogCoalescer(const LogCoalescer &) = delete;
+        ~LogCoalescer() = default;
+
+        // Longest time a run of repeats is held before it is summarized
+        std::chrono::milliseconds GetTimeout() const { return timeout; }
+
+        // Is the message a repeat of the previous message logged by its
+        // component at its level?  Runs to be summarized are added to ended.
+        bool IsRepeat(LogLevel level,
+                      std::string_view prefix,
+                      std::string_view message,
+                      bool console,
+                      std::chrono::system_clock::time_point now,
+                      std::vector<LogRepeat> &ended);
+
+        // Add every run of repeats to ended
+        void TakeAll(std::vector<LogRepeat> &ended);
+
+    protected:
+        struct Slot
+        {
+            bool used = false;          // Has a message been written?
+            LogLevel level;             // Level of the message
+            std::string prefix;         // Component prefix of the message
+            std::uint64_t hash;         // Hash of the message text
+            std::size_t length;         // Length of the message text
+            bool console;               // Also written to the console?
+            std::uint64_t repeats;      // Repeats not yet summarized
+            std::chrono::system_clock::time_point first;
+                                        // Time of the first repeat
+            std::chrono::system_clock::time_point last;
+                                        // Time of the last repeat
+        };
+
+        static std::uint64_t Hash(std::string_view text);
+        void TakeIdle(std::chrono::system_clock::time_point now,
+                      std::vector<LogRepeat> &ended);
+        static void TakeRun(Slot &slot, std::vector<LogRepeat> &ended);
+
+        std::mutex mutex;               // Protects the slots
+        std::chrono::milliseconds timeout;
+                                        // Longest time a run is held
+        std::chrono::system_clock::time_point next_idle;
+                                        // Earliest time a run may be idle
+        Slot slots[Slot_Count];         // Last message of each component
+};
+
+} // namespace cantina
@@ -0,0 +1,108 @@
+/*
+ *  log_compressor.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogCompressor class, which compresses blocks of log
+ *      file output.  Each block given to Compress() is written as a complete
+ *      frame of the chosen format (a gzip member, a Zstandard frame, or an
+ *      LZ4 frame), and the formats' decoders accept frames concatenated in
+ *      a single file.  Thus everything written before the last complete
+ *      frame can be recovered from a file that was being written when the
+ *      process ended, and frames may be appended to an existing file.
+ *
+ *      The codecs available depend on the libraries found when the Logger
+ *      is built (see the logger_ENABLE_COMPRESSION option).
+ *
+ *  Portability Issues:
+ *      Each format requires zlib, libzstd, or liblz4, respectively.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace cantina
+{
+
+// Format in which log file output is compressed
+enum class LogCompression : std::uint8_t
+{
+    None,                               // Output is not compressed
+    Gzip,                               // gzip members, using zlib
+    Zstd,                               // Zstandard frames
+    Lz4                                 // LZ4 frames
+};
+
+// Block compressor declaration
+class LogCompressor
+{
+    public:
+        LogCompressor();
+        LogCompressor(const LogCompressor &) = delete;
+        LogCompressor &operator=(const LogCompressor &) = delete;
+        ~LogCompressor();
+
+        // Is the given format supported by this build?
+        static bool IsAvailable(LogCompression compression);
+
+        // Prepare to compress in the given format at the given level (0
+        // selects the format's default level)
+        bool Start(LogCompression compression, int level = 0);
+
+        // Release the compression context
+        void Stop();
+
+        // Format in which blocks are compressed (None if not started)
+        LogCompression GetCompression() const { return compression; }
+
+        // Compress the given parts as one frame, appending it to output
+        bool Compress(const std::string_view *parts,
+                      std::size_t count,
+                      std::vector<char> &output);
+
+    protected:
+        LogCompression compression;     // Format of compressed output
+        int level;                      // Compression level
+        void *context;                  // State of the format's library
+};
+
+} // namespace cantina
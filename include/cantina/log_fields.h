@@ -0,0 +1,177 @@
+/*
+ *  log_fields.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the functions used to log structured fields along with
+ *      a message and to write messages as JSON Lines.  Fields are given as
+ *      pairs of names and values, as in:
+ *
+ *          LOGGER_INFO_KV(logger, "rx", "seq", seq, "bytes", length)
+ *
+ *      Each field is appended directly to the message's text buffer as
+ *      " name=value", where strings are quoted and escaped as in JSON and
+ *      other values are written as JSON literals, so that the fields are
+ *      readable in text output and may be written as JSON members without
+ *      being escaped again.  Field names should not contain spaces or "=".
+ *
+ *      When writing JSON Lines, each message becomes an object having the
+ *      members "time", "level", "component" (an array of the component
+ *      names from the parent chain, if any), "msg", and one member per
+ *      field.  If the call site is shown (see Logger::ShowSourceLocation()),
+ *      the members "file", "line", and "function" precede "msg".  Escaping
+ *      uses a table indexed by character, copying runs of characters that
+ *      need no escaping at once.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "log_format.h"
+#include "log_site.h"
+
+namespace cantina
+{
+
+// Location of the component prefix and the structured fields, which are
+// the leading and trailing parts of a message's text, and the call site
+// to be written with the message, if any
+struct LogTextLayout
+{
+    std::size_t prefix_length = 0;      // Length of the component prefix
+    std::size_t fields_length = 0;      // Length of the trailing fields
+    const LogSite *site = nullptr;      // Call site written with the text
+};
+
+// Append text, escaping those characters that JSON strings must escape
+void AppendJsonEscaped(std::string &buffer, std::string_view text);
+
+// Append text as a quoted field value
+void AppendLogFieldString(std::string &buffer, std::string_view text);
+
+// Append the value of a field; strings are quoted and escaped and other
+// values are written as JSON literals
+template<typename T>
+void AppendLogFieldValue(std::string &buffer, const T &value)
+{
+    using Type = std::decay_t<T>;
+
+    if constexpr (std::is_same_v<Type, char>)
+    {
+        AppendLogFieldString(buffer, std::string_view(&value, 1));
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+        // JSON has no literals for infinity or NaN
+        if (std::isfinite(value))
+        {
+            AppendLogArgument(buffer, value);
+        }
+        else
+        {
+            buffer += '"';
+            AppendLogArgument(buffer, value);
+            buffer += '"';
+        }
+    }
+    else if constexpr (std::is_arithmetic_v<Type> || std::is_enum_v<Type>)
+    {
+        AppendLogArgument(buffer, value);
+    }
+    else if constexpr (!std::is_array_v<T> &&
+                       (std::is_same_v<Type, const char *> ||
+                        std::is_same_v<Type, char *>))
+    {
+        if (value == nullptr)
+        {
+            buffer += "null";
+        }
+        else
+        {
+            AppendLogFieldString(buffer, value);
+        }
+    }
+    else if constexpr (std::is_convertible_v<const Type &, std::string_view>)
+    {
+        AppendLogFieldString(buffer, std::string_view(value));
+    }
+    else
+    {
+        static_assert(UnsupportedLogArgument<Type>::value,
+                      "Unsupported log field type");
+    }
+}
+
+// Append no fields, ending the recursion below
+inline void FormatLogFields(std::string &)
+{
+}
+
+// Append each field, given as pairs of names and values, as " name=value"
+template<typename Value, typename... Fields>
+void FormatLogFields(std::string &buffer,
+                     std::string_view name,
+                     const Value &value,
+                     const Fields &...fields)
+{
+    static_assert(sizeof...(Fields) % 2 == 0,
+                  "Fields must be given as pairs of names and values");
+
+    buffer += ' ';
+    buffer += name;
+    buffer += '=';
+    AppendLogFieldValue(buffer, value);
+
+    FormatLogFields(buffer, fields...);
+}
+
+// Append a JSON object representing a message, without a newline
+void AppendJsonLine(std::string &line,
+                    std::string_view timestamp,
+                    std::string_view level,
+                    std::string_view text,
+                    const LogTextLayout &layout);
+
+} // namespace cantina
@@ -0,0 +1,174 @@
+/*
+ *  log_file.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogFile class, which is used by the Logger to write
+ *      log messages to a file.  Messages are collected in a user-space
+ *      buffer and written to the file according to a LogFlushPolicy, which
+ *      allows the file to be written once per line (the default), once a
+ *      given number of octets are buffered, or at a given time interval.
+ *      Error and Critical messages may additionally force the buffer to be
+ *      written immediately so that the messages most relevant to a crash
+ *      are not lost.
+ *
+ *      The policy may also ask that output be compressed, in which case each
+ *      block of buffered output (of buffer_size octets, or Default_Block_Size
+ *      if none is given) is written as a complete compressed frame.  Error
+ *      and Critical messages and the flush interval write the frame early,
+ *      so that as with uncompressed output, the file can be decoded up to
+ *      the last message written.
+ *
+ *      On Linux, the policy may ask that writes be submitted through an
+ *      io_uring (async_io), in which case output is buffered directly in
+ *      buffers registered with the kernel and each full buffer is submitted
+ *      without waiting for the write to complete.  The policy may also ask
+ *      that output be synced to the device at a given interval.
+ *
+ *  Portability Issues:
+ *      Where io_uring is not available, async_io has no effect.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "log_compressor.h"
+#include "log_uring.h"
+
+namespace cantina
+{
+
+// Policy controlling when buffered log file output is written
+struct LogFlushPolicy
+{
+    // Write when this many octets are buffered (0 writes every line)
+    std::size_t buffer_size = 0;
+
+    // Write buffered output at least this often (0 disables the timer)
+    std::chrono::milliseconds interval{0};
+
+    // Write Error and Critical messages (and those before them) immediately
+    bool flush_on_error = true;
+
+    // Format in which output is compressed
+    LogCompression compression = LogCompression::None;
+
+    // Compression level (0 selects the format's default)
+    int compression_level = 0;
+
+    // Submit writes through io_uring where available, so that output is
+    // written without waiting for the kernel (see LogUring)
+    bool async_io = false;
+
+    // Write output to the device (as fdatasync()) at least this often
+    // (0 leaves this to the system)
+    std::chrono::milliseconds sync_interval{0};
+};
+
+// Buffered log file declaration
+class LogFile
+{
+    public:
+        LogFile();
+        LogFile(const LogFile &) = delete;
+        ~LogFile();
+
+        // Open the file for appending
+        bool Open(const std::string &filename,
+                  const LogFlushPolicy &flush_policy = {});
+
+        // Is the file open?
+        bool IsOpen() const;
+
+        // Write any buffered output and close the file
+        void Close();
+
+        // Maximum number of parts that may be given to Write()
+        static constexpr std::size_t Max_Parts = 8;
+
+        // Octets compressed as a frame if the policy gives no buffer size
+        static constexpr std::size_t Default_Block_Size = 64 * 1024;
+
+        // Write a line of output, adding a trailing newline
+        void WriteLine(const char *data, std::size_t length, bool urgent);
+
+        // Write a record made of the given parts
+        void Write(const std::string_view *parts,
+                   std::size_t count,
+                   bool urgent);
+
+        // Write any buffered output to the file, waiting for any writes
+        // submitted asynchronously to complete
+        void Flush();
+
+        // Write buffered output if the flush interval has elapsed
+        void FlushIfDue();
+
+        // Interval at which buffered output is written or synced (0 if
+        // neither)
+        std::chrono::milliseconds GetFlushInterval() const;
+
+    protected:
+        bool WritesEachRecord() const;
+        void WriteBuffer();
+        void WriteVector(const std::string_view *parts, std::size_t count);
+        void WriteFrame(const std::string_view *parts, std::size_t count);
+        void WriteFully(const char *data, std::size_t length);
+        void SyncIfDue();
+
+        int fd;                                 // File descriptor
+        LogFlushPolicy flush_policy;            // When to write output
+        std::vector<char> buffer;               // Storage of block
+        char *block;                            // Buffered output
+        std::size_t block_size;                 // Size of block
+        std::size_t buffered;                   // Octets buffered
+        LogUring uring;                         // Submits writes if async
+        bool unsynced;                          // Written since last sync?
+        LogCompressor compressor;               // Compresses each block
+        std::vector<char> frame;                // Compressed block
+        std::chrono::steady_clock::time_point last_flush;
+                                                // Time of last write
+        std::chrono::steady_clock::time_point last_sync;
+                                                // Time of last sync
+};
+
+} // namespace cantina
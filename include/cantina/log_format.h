@@ -0,0 +1,421 @@
+/*
+ *  log_format.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the functions used to format log messages from a format
+ *      string and a list of arguments without the use of std::ostream.
+ *      Format strings use "{}" as the placeholder for each argument, while
+ *      "{{" and "}}" produce literal braces.  Text is appended directly to
+ *      a caller-provided std::string so that a buffer may be reused from
+ *      one message to the next.
+ *
+ *      When compiled as C++20 or later, a LogFormatString is checked at
+ *      compile time to ensure that the number of placeholders matches
+ *      the number of arguments.  Otherwise, a placeholder for which there
+ *      is no argument is reproduced as is, while arguments for which there
+ *      is no placeholder are ignored.
+ *
+ *      The timestamp and level names written by the Logger and BasicLogger
+ *      are also produced here.
+ *
+ *  Portability Issues:
+ *      Compile-time checking of format strings requires C++20.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "log_types.h"
+
+// Format strings are checked at compile time where consteval is supported
+#if defined(__cpp_consteval)
+#define LOGGER_FORMAT_CONSTEVAL consteval
+#else
+#define LOGGER_FORMAT_CONSTEVAL constexpr
+#endif
+
+namespace cantina
+{
+
+// Define the logging precision
+enum class LogTimePrecision
+{
+    Milliseconds,
+    Microseconds
+};
+
+// Define the timestamp format
+enum class LogTimeFormat
+{
+    LocalTime,                          // YYYY-MM-DDTHH:MM:SS in local time
+    UTC,                                // YYYY-MM-DDTHH:MM:SS in UTC
+    Epoch                               // Seconds since the Unix epoch
+};
+
+// Maximum length of a timestamp produced by the Logger
+constexpr std::size_t Max_Timestamp_Length = 32;
+
+// Name of the given level as written in log lines
+constexpr std::string_view LogLevelName(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::Critical:
+            return "CRITICAL";
+
+        case LogLevel::Error:
+            return "ERROR";
+
+        case LogLevel::Warning:
+            return "WARNING";
+
+        case LogLevel::Info:
+            return "INFO";
+
+        case LogLevel::Debug:
+            return "DEBUG";
+
+        default:
+            return "UNKNOWN";
+    }
+}
+
+// Write the decimal digits of a value, padded with zeros to the width
+std::size_t FormatLogUnsigned(std::uint64_t value,
+                              unsigned width,
+                              char *buffer);
+
+// Write a timestamp of at most Max_Timestamp_Length octets (not terminated)
+std::size_t FormatLogTimestamp(
+    const std::chrono::system_clock::time_point &time,
+    LogTimeFormat format,
+    LogTimePrecision precision,
+    char *buffer);
+
+// Count the number of "{}" placeholders in a format string
+constexpr std::size_t CountLogPlaceholders(std::string_view format)
+{
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < format.size(); i++)
+    {
+        if ((i + 1 < format.size()) &&
+            (((format[i] == '{') && (format[i + 1] == '{')) ||
+             ((format[i] == '}') && (format[i + 1] == '}'))))
+        {
+            i++;
+            continue;
+        }
+
+        if ((format[i] == '{') && (i + 1 < format.size()) &&
+            (format[i + 1] == '}'))
+        {
+            count++;
+            i++;
+        }
+    }
+
+    return count;
+}
+
+// Called only when a format string does not match its arguments; since it
+// is not constexpr, reaching it during constant evaluation is an error
+inline void LogFormatPlaceholderCountMismatch()
+{
+}
+
+// Prevents template argument deduction from a LogFormatString parameter
+template<typename T>
+struct LogFormatIdentity
+{
+    using type = T;
+};
+
+// Format string for a message having arguments of the given types
+template<typename... Args>
+class LogFormatString
+{
+    public:
+        LOGGER_FORMAT_CONSTEVAL LogFormatString(const char *format) :
+            format(format)
+        {
+            if (CountLogPlaceholders(this->format) != sizeof...(Args))
+            {
+                LogFormatPlaceholderCountMismatch();
+            }
+        }
+
+        constexpr std::string_view Get() const { return format; }
+
+    protected:
+        std::string_view format;
+};
+
+// Format string type used in function parameters
+template<typename... Args>
+using LogFormat = LogFormatString<typename LogFormatIdentity<Args>::type...>;
+
+// Borrows one of the calling thread's reusable text buffers, or uses a
+// buffer of its own should they all be in use (e.g., if a message is
+// logged while another is being written)
+class LogTextBuffer
+{
+    public:
+        LogTextBuffer();
+        LogTextBuffer(const LogTextBuffer &) = delete;
+        LogTextBuffer &operator=(const LogTextBuffer &) = delete;
+        ~LogTextBuffer();
+
+        std::string &Get() { return *text; }
+
+    protected:
+        static constexpr std::size_t Max_Thread_Buffers = 4;
+
+        struct ThreadBuffers
+        {
+            std::string text[Max_Thread_Buffers];
+                                        // Reusable text buffers
+            std::size_t depth;          // Number of buffers in use
+        };
+
+        static ThreadBuffers &GetThreadBuffers();
+
+        std::string *text;              // Borrowed buffer, or local
+        std::string local;              // Used if all buffers are in use
+};
+
+// Text held in a fixed-capacity buffer within the object, so that text
+// placed into a queue entry reuses the entry's storage; only text longer
+// than the buffer is held on the heap
+class LogRecordText
+{
+    public:
+        static constexpr std::size_t Inline_Capacity = 256;
+
+        LogRecordText() : length(0) {}
+        LogRecordText(std::string_view text) : length(0) { Append(text); }
+        LogRecordText(const LogRecordText &other) : length(0)
+        {
+            Append(other.View());
+        }
+        LogRecordText(LogRecordText &&other) noexcept : length(0)
+        {
+            *this = std::move(other);
+        }
+        ~LogRecordText() = default;
+
+        LogRecordText &operator=(const LogRecordText &other)
+        {
+            if (this != &other) Assign(other.View());
+            return *this;
+        }
+
+        // Exchange heap buffers so that each retains an allocation
+        LogRecordText &operator=(LogRecordText &&other) noexcept
+        {
+            if (this == &other) return *this;
+
+            if (other.length > Inline_Capacity)
+            {
+                heap.swap(other.heap);
+            }
+            else
+            {
+                std::memcpy(inline_text, other.inline_text, other.length);
+            }
+            length = other.length;
+            other.length = 0;
+
+            return *this;
+        }
+
+        void Assign(std::string_view text)
+        {
+            length = 0;
+            Append(text);
+        }
+
+        void Append(std::string_view text)
+        {
+            std::size_t total = length + text.size();
+
+            if (total <= Inline_Capacity)
+            {
+                std::memcpy(inline_text + length, text.data(), text.size());
+            }
+            else
+            {
+                if (length <= Inline_Capacity) heap.assign(inline_text, length);
+                heap.append(text.data(), text.size());
+            }
+            length = total;
+        }
+
+        std::string_view View() const
+        {
+            return (length <= Inline_Capacity) ?
+                       std::string_view(inline_text, length) :
+                       std::string_view(heap);
+        }
+
+        std::size_t Size() const { return length; }
+
+    protected:
+        std::size_t length;             // Length of the text
+        std::string heap;               // Text longer than the buffer
+        char inline_text[Inline_Capacity];
+                                        // Text that fits in the buffer
+};
+
+// Append the literal text of the format string starting at the given
+// position up to the next placeholder, returning the position following
+// the placeholder or std::string_view::npos if there is none
+std::size_t AppendLogLiteral(std::string &buffer,
+                             std::string_view format,
+                             std::size_t position);
+
+// Append the text representation of values of the supported types
+void AppendLogValue(std::string &buffer, std::int64_t value);
+void AppendLogValue(std::string &buffer, std::uint64_t value);
+void AppendLogValue(std::string &buffer, double value);
+void AppendLogValue(std::string &buffer, bool value);
+void AppendLogValue(std::string &buffer, char value);
+void AppendLogValue(std::string &buffer, std::string_view value);
+
+// Used to reject unsupported argument types at compile time
+template<typename T>
+struct UnsupportedLogArgument : std::false_type
+{
+};
+
+// Return the text of a string argument given either as a pointer, which may
+// be null, or as an array of characters, which is never tested for null
+template<typename T>
+std::string_view LogStringArgument(const T &value)
+{
+    if constexpr (std::is_array_v<T>)
+    {
+        return std::string_view(value);
+    }
+    else
+    {
+        return (value != nullptr) ? std::string_view(value) :
+                                    std::string_view("(null)");
+    }
+}
+
+// Append the text representation of a single argument to the buffer
+template<typename T>
+void AppendLogArgument(std::string &buffer, const T &value)
+{
+    using Type = std::decay_t<T>;
+
+    if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, char>)
+    {
+        AppendLogValue(buffer, value);
+    }
+    else if constexpr (std::is_enum_v<Type>)
+    {
+        AppendLogArgument(buffer,
+                          static_cast<std::underlying_type_t<Type>>(value));
+    }
+    else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+    {
+        AppendLogValue(buffer, static_cast<std::int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<Type>)
+    {
+        AppendLogValue(buffer, static_cast<std::uint64_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+        AppendLogValue(buffer, static_cast<double>(value));
+    }
+    else if constexpr (std::is_same_v<Type, const char *> ||
+                       std::is_same_v<Type, char *>)
+    {
+        AppendLogValue(buffer, LogStringArgument(value));
+    }
+    else if constexpr (std::is_convertible_v<const Type &, std::string_view>)
+    {
+        AppendLogValue(buffer, std::string_view(value));
+    }
+    else
+    {
+        static_assert(UnsupportedLogArgument<Type>::value,
+                      "Unsupported log argument type");
+    }
+}
+
+// Append the message produced from the format string and arguments
+template<typename... Args>
+void FormatLogMessage(std::string &buffer,
+                      std::string_view format,
+                      const Args &...args)
+{
+    std::size_t position = 0;
+
+    // Append the text preceding each placeholder, then the argument (unused
+    // if there are no arguments)
+    [[maybe_unused]] auto append = [&](const auto &value)
+    {
+        if (position == std::string_view::npos) return;
+        position = AppendLogLiteral(buffer, format, position);
+        if (position != std::string_view::npos)
+        {
+            AppendLogArgument(buffer, value);
+        }
+    };
+    (append(args), ...);
+
+    // Append the remaining text, reproducing any unused placeholders
+    while (position != std::string_view::npos)
+    {
+        position = AppendLogLiteral(buffer, format, position);
+        if (position != std::string_view::npos) buffer += "{}";
+    }
+}
+
+} // namespace cantina
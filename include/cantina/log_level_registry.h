@@ -0,0 +1,172 @@
+/*
+ *  log_level_registry.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogLevelRegistry class, which holds log levels for
+ *      components given by their path of component names, as in
+ *      "Foo.Bar=debug, *=info".  A rule applies to the named component and
+ *      to every component beneath it, with the longest matching rule taking
+ *      precedence and "*" matching every component.
+ *
+ *      Each change to the rules advances the registry's epoch, as does each
+ *      change to a log level that applies where no rule does.  A
+ *      LogComponentLevel caches the level resolved for one component along
+ *      with the epoch at which it was resolved, so checking the level
+ *      requires only comparing the cached epoch with the registry's epoch
+ *      until the rules or levels change.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "log_types.h"
+
+namespace cantina
+{
+
+// Convert a level name (e.g., "debug"), ignoring case, to a LogLevel
+bool ParseLogLevel(std::string_view name, LogLevel &level);
+
+// Log levels for components, keyed by path of component names
+class LogLevelRegistry
+{
+    public:
+        LogLevelRegistry();
+        LogLevelRegistry(const LogLevelRegistry &) = delete;
+        LogLevelRegistry &operator=(const LogLevelRegistry &) = delete;
+        ~LogLevelRegistry() = default;
+
+        // Replace the rules with those given (e.g., "Foo.Bar=debug, *=info"),
+        // leaving them unchanged if the string is invalid
+        bool SetLevels(std::string_view levels);
+
+        // Rules presently in effect, in the form given to SetLevels()
+        std::string GetLevels() const;
+
+        // Number of times the rules or levels have changed
+        std::uint64_t GetEpoch() const
+        {
+            return epoch.load(std::memory_order_relaxed);
+        }
+
+        // Advance the epoch so that every cached level is resolved again,
+        // called after changing a level that applies where no rule does
+        void AdvanceEpoch()
+        {
+            epoch.fetch_add(1, std::memory_order_release);
+        }
+
+        // Level given to the component path, or -1 if no rule applies,
+        // and the epoch of the rules consulted
+        int Resolve(const std::string &path, std::uint64_t &rules_epoch) const;
+
+    protected:
+        struct Rule
+        {
+            std::string path;           // Component path (empty for "*")
+            LogLevel level;             // Level for matching components
+        };
+
+        mutable std::shared_mutex rules_mutex;
+                                        // Protects the rules
+        std::vector<Rule> rules;        // Rules in the order given
+        std::atomic<std::uint64_t> epoch;
+                                        // Number of times rules or levels
+                                        // changed
+};
+
+// Level of one component resolved from a LogLevelRegistry and cached
+// until the registry's epoch changes
+class LogComponentLevel
+{
+    public:
+        LogComponentLevel() : state(Unresolved) {}
+        LogComponentLevel(const LogComponentLevel &) = delete;
+        LogComponentLevel &operator=(const LogComponentLevel &) = delete;
+        ~LogComponentLevel() = default;
+
+        // Level given to the component path, or the level returned by
+        // default_level() if no rule applies
+        template<typename DefaultLevel>
+        int Get(const LogLevelRegistry &registry,
+                const std::string &path,
+                const DefaultLevel &default_level) const
+        {
+            std::uint64_t cached = state.load(std::memory_order_relaxed);
+
+            if ((cached >> Level_Bits) == registry.GetEpoch())
+            {
+                return static_cast<int>(cached & Level_Mask) - 1;
+            }
+
+            // Threads resolving the level at once each store the same
+            // result, and a result from rules or levels that have since
+            // changed holds an older epoch, so it is resolved again
+            std::uint64_t rules_epoch;
+            int level = registry.Resolve(path, rules_epoch);
+            if (level < 0) level = default_level();
+
+            state.store((rules_epoch << Level_Bits) |
+                            static_cast<std::uint64_t>(level + 1),
+                        std::memory_order_relaxed);
+
+            return level;
+        }
+
+    protected:
+        static constexpr unsigned Level_Bits = 8;
+        static constexpr std::uint64_t Level_Mask =
+            (std::uint64_t(1) << Level_Bits) - 1;
+        static constexpr std::uint64_t Unresolved = ~std::uint64_t(0);
+
+        // The epoch and level are held together so that they are always
+        // read and written as a consistent pair
+        mutable std::atomic<std::uint64_t> state;
+                                        // Epoch << Level_Bits | (level + 1)
+};
+
+} // namespace cantina
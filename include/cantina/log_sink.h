@@ -0,0 +1,329 @@
+/*
+ *  log_sink.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogSink class, which is a destination to which the
+ *      root Logger writes log messages, along with sinks for each of the
+ *      logging facilities.  The root Logger holds a list of sinks, each of
+ *      which has its own log level and, optionally, its own background
+ *      writer thread.  The timestamp and log level text of each message are
+ *      formatted once by the Logger and shared by all of the sinks.
+ *
+ *      To write log messages elsewhere, one may derive a class from LogSink
+ *      and implement the Write() function, or use a CallbackSink.  A Write()
+ *      function may be called from several threads at once, so sinks that
+ *      require serialization provide their own locking.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "log_types.h"
+#include "log_file.h"
+#include "mapped_log_file.h"
+#include "syslog_interface.h"
+#include "async_log_queue.h"
+#include "log_stats.h"
+#include "log_format.h"
+
+namespace cantina
+{
+
+// Forward declaration of the Logger to which sinks belong
+class Logger;
+
+// Log message as presented to each sink
+struct LogMessage
+{
+    LogLevel level;                     // Level of the message
+    bool console;                       // Also requested for the console
+    std::chrono::system_clock::time_point time;
+                                        // Time the message was logged
+    std::string_view line;              // Timestamp, level, and text
+    std::string_view text;              // Text, including component prefix
+    LogOutputFormat format = LogOutputFormat::Text;
+                                        // Format of the line
+};
+
+// Destination to which log messages are written
+class LogSink
+{
+    public:
+        LogSink(LogLevel level = LogLevel::Debug);
+        LogSink(const LogSink &) = delete;
+        LogSink &operator=(const LogSink &) = delete;
+        virtual ~LogSink();
+
+        // Set the most verbose level written to this sink
+        void SetLogLevel(LogLevel level);
+
+        // Get the most verbose level written to this sink
+        LogLevel GetLogLevel() const;
+
+        // Check to see if messages at the given level are to be written
+        bool ShouldLog(LogLevel level) const
+        {
+            return level <= log_level.load(std::memory_order_relaxed);
+        }
+
+        // Write messages from a background thread (0 to disable)
+        void SetAsync(std::size_t queue_capacity = 8192,
+                      const LogQueuePolicy &policy = {});
+
+        // Are messages written from a background thread?
+        bool IsAsync() const;
+
+        // Number of messages discarded at each level due to a full queue
+        LogDropCounts GetDropCounts() const;
+
+        // Facility implemented by this sink (None if not a facility)
+        virtual LogFacility GetFacility() const;
+
+        // Write the message now or queue it to be written
+        void Submit(const LogMessage &message);
+
+        // Wait until queued messages and buffered output are written
+        void Flush();
+
+        // Write buffered output if due, returning the flush interval
+        virtual std::chrono::milliseconds FlushIfDue();
+
+    protected:
+        friend class Logger;
+
+        // Message copied into the sink's queue
+        struct QueuedMessage
+        {
+            LogLevel level;
+            bool console;
+            std::chrono::system_clock::time_point time;
+            LogRecordText line;         // Line, followed by the text if
+                                        // the text is not within the line
+            std::size_t line_length;
+            std::size_t text_offset;
+            LogOutputFormat format;
+        };
+
+        // Write a message to the destination
+        virtual void Write(const LogMessage &message) = 0;
+
+        // Write a warning noting messages discarded before the given one
+        void WriteDropMarker(const QueuedMessage &next, std::uint64_t count);
+
+        // Write any buffered output to the destination
+        virtual void FlushOutput();
+
+        // Statistics of the Logger to which the sink belongs, if any
+        LogStatsCollector *GetStatsCollector() const;
+
+        // Acquire a deferred lock, recording the time spent waiting in the
+        // statistics of the Logger to which the sink belongs
+        template<typename Lock>
+        void AcquireLock(Lock &lock) const
+        {
+            if (LogStatsCollector *stats = GetStatsCollector())
+            {
+                stats->Acquire(lock);
+            }
+            else
+            {
+                lock.lock();
+            }
+        }
+
+        std::atomic<LogLevel> log_level;
+                                        // Most verbose level written
+        std::atomic<Logger *> owner;    // Logger to which the sink belongs
+        AsyncLogQueue<QueuedMessage> async_queue;
+                                        // Queue used when asynchronous
+};
+
+// Sink writing to the console (standard error)
+class ConsoleSink : public LogSink
+{
+    public:
+        // Escape sequences preceding a colorized line, indexed by level
+        static constexpr std::string_view Color_Prefix[] =
+        {
+            "\033[1m\033[31m",          // Critical: bold, red
+            "\033[1m\033[35m",          // Error: bold, magenta
+            "\033[1m\033[33m",          // Warning: bold, yellow
+            "\033[39m",                 // Info: default color
+            "\033[32m"                  // Debug: green
+        };
+
+        // Escape sequence and newline ending a colorized line
+        static constexpr std::string_view Color_Suffix = "\033[0m\n";
+
+        // Size of each buffer when writing asynchronously, if the flush
+        // policy gives none
+        static constexpr std::size_t Default_Buffer_Size = 4096;
+
+        ConsoleSink(bool colorize,
+                    LogLevel level = LogLevel::Debug,
+                    const LogFlushPolicy &flush_policy = {});
+        virtual ~ConsoleSink();
+
+        void Colorize(bool colorize_output);
+        bool IsColorized() const;
+
+        virtual LogFacility GetFacility() const override;
+
+    protected:
+        virtual void Write(const LogMessage &message) override;
+        virtual void FlushOutput() override;
+
+        std::mutex console_mutex;       // Serializes console output
+        std::atomic<bool> colorize;     // Colorize console output
+        LogUring uring;                 // Submits writes if async
+        bool flush_on_error;            // Wait for Error and Critical?
+};
+
+// Sink writing to a log file
+class FileSink : public LogSink
+{
+    public:
+        FileSink(LogLevel level = LogLevel::Debug);
+        virtual ~FileSink();
+
+        bool Open(const std::string &filename,
+                  const LogFlushPolicy &flush_policy = {});
+        void Close();
+
+        virtual LogFacility GetFacility() const override;
+        virtual std::chrono::milliseconds FlushIfDue() override;
+
+    protected:
+        virtual void Write(const LogMessage &message) override;
+        virtual void FlushOutput() override;
+
+        std::mutex file_mutex;          // Serializes file output
+        LogFile log_file;               // File to which to write
+};
+
+// Sink writing to memory-mapped log file segments
+class MappedFileSink : public LogSink
+{
+    public:
+        MappedFileSink(LogLevel level = LogLevel::Debug);
+        virtual ~MappedFileSink();
+
+        bool Open(const std::string &base_name,
+                  std::size_t segment_size =
+                      MappedLogFile::Default_Segment_Size);
+        void Close();
+
+        virtual LogFacility GetFacility() const override;
+
+    protected:
+        virtual void Write(const LogMessage &message) override;
+
+        MappedLogFile mapped_file;      // Segments to which to write
+};
+
+// Sink writing to syslog via a SyslogInterface
+class SyslogSink : public LogSink
+{
+    public:
+        SyslogSink(SyslogInterface &syslog_interface,
+                   LogLevel level = LogLevel::Debug);
+        SyslogSink(std::shared_ptr<SyslogInterface> syslog_interface,
+                   LogLevel level = LogLevel::Debug);
+        virtual ~SyslogSink();
+
+        virtual LogFacility GetFacility() const override;
+        virtual std::chrono::milliseconds FlushIfDue() override;
+
+        // Map a log level to a syslog priority
+        static int MapLogLevel(LogLevel level);
+
+    protected:
+        virtual void Write(const LogMessage &message) override;
+        virtual void FlushOutput() override;
+
+        std::shared_ptr<SyslogInterface> shared_interface;
+                                        // Owned interface, if any
+        SyslogInterface &syslog_interface;
+                                        // Interface used to call syslog()
+};
+
+// Sink writing to the Android log
+class AndroidSink : public LogSink
+{
+    public:
+        AndroidSink(const std::string &tag, LogLevel level = LogLevel::Debug);
+        virtual ~AndroidSink();
+
+        virtual LogFacility GetFacility() const override;
+
+    protected:
+        virtual void Write(const LogMessage &message) override;
+
+        std::string tag;                // Tag given with each message
+};
+
+// Sink passing each message's text to a callback function
+class CallbackSink : public LogSink
+{
+    public:
+        using Callback = std::function<void(LogLevel,
+                                            const std::string &,
+                                            bool)>;
+
+        CallbackSink(Callback callback, LogLevel level = LogLevel::Debug);
+        virtual ~CallbackSink();
+
+    protected:
+        virtual void Write(const LogMessage &message) override;
+
+        Callback callback;              // Function to call for each message
+};
+
+} // namespace cantina
@@ -0,0 +1,207 @@
+/*
+ *  log_site.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogSite structure, which describes a logging call
+ *      site by its level, source file, line, and function.  The logging
+ *      macros define a static constexpr LogSite at each call site, so the
+ *      file name (without its directory) and the function name are found
+ *      at compile time and messages refer to the site by its address.
+ *
+ *      This also defines the LogStreamBuffer class, which borrows one of the
+ *      calling thread's reusable output streams so that the streaming
+ *      logging macros may format a message without allocating memory once
+ *      the stream's text has grown to fit.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include "log_types.h"
+
+// Name of the enclosing function, which is usable in a constant expression
+#if defined(__GNUC__) || defined(__clang__)
+#define LOGGER_FUNCTION_NAME __PRETTY_FUNCTION__
+#else
+#define LOGGER_FUNCTION_NAME __func__
+#endif
+
+// Initializer of a LogSite describing the current source location
+#define LOGGER_SITE(level) \
+    cantina::LogSite{level, \
+                     cantina::LogSiteFile(__FILE__), \
+                     __LINE__, \
+                     cantina::LogSiteFunction(LOGGER_FUNCTION_NAME)}
+
+namespace cantina
+{
+
+// Static description of a logging call site
+struct LogSite
+{
+    LogLevel level;                     // Level of the message
+    std::string_view file;              // Source file, without directory
+    std::uint32_t line;                 // Source line
+    std::string_view function;          // Enclosing function
+};
+
+// Return the name of a source file without its directory
+constexpr std::string_view LogSiteFile(std::string_view path)
+{
+    std::size_t separator = path.find_last_of("/\\");
+
+    return (separator == std::string_view::npos) ?
+               path : path.substr(separator + 1);
+}
+
+// Return the qualified name of a function given its decorated name (e.g.,
+// "int Foo::Bar(int)::<lambda()>" produces "Foo::Bar"), removing the
+// lambda introduced by the logging macros, the parameters, and the
+// return type
+constexpr std::string_view LogSiteFunction(std::string_view name)
+{
+    constexpr std::string_view Lambda_Markers[] =
+    {
+        "::<lambda",                    // GCC
+        "::(lambda",                    // Clang
+        "::(anonymous class)"           // Older Clang
+    };
+
+    for (auto marker : Lambda_Markers)
+    {
+        std::size_t position = name.find(marker);
+        if (position != std::string_view::npos)
+        {
+            name = name.substr(0, position);
+        }
+    }
+
+    // Remove the parameters, along with any qualifiers following them
+    std::size_t close = name.rfind(')');
+    if (close != std::string_view::npos)
+    {
+        int depth = 0;
+        for (std::size_t i = close + 1; i-- > 0;)
+        {
+            if (name[i] == ')') depth++;
+            if ((name[i] == '(') && (--depth == 0))
+            {
+                name = name.substr(0, i);
+                break;
+            }
+        }
+    }
+
+    // Remove the return type, which ends at the last space outside of any
+    // template arguments
+    std::size_t start = 0;
+    int depth = 0;
+    for (std::size_t i = 0; i < name.size(); i++)
+    {
+        if ((name[i] == '<') || (name[i] == '(')) depth++;
+        if (((name[i] == '>') || (name[i] == ')')) && (depth > 0)) depth--;
+        if ((name[i] == ' ') && (depth == 0)) start = i + 1;
+    }
+
+    return name.substr(start);
+}
+
+// Borrows one of the calling thread's reusable output streams, or uses a
+// stream of its own should they all be in use (e.g., if a message is
+// logged while another is being formatted)
+class LogStreamBuffer
+{
+    public:
+        LogStreamBuffer();
+        LogStreamBuffer(const LogStreamBuffer &) = delete;
+        LogStreamBuffer &operator=(const LogStreamBuffer &) = delete;
+        ~LogStreamBuffer();
+
+        // Stream to which the message is written
+        std::ostream &Stream() { return entry->stream; }
+
+        // Text written to the stream
+        const std::string &Text() const { return entry->buffer.text; }
+
+    protected:
+        static constexpr std::size_t Max_Thread_Streams = 4;
+
+        // Stream buffer appending to a string
+        class StringBuf : public std::streambuf
+        {
+            public:
+                std::string text;       // Text written to the stream
+
+            protected:
+                virtual int_type overflow(int_type c) override;
+                virtual std::streamsize xsputn(const char *c,
+                                               std::streamsize n) override;
+        };
+
+        struct Entry
+        {
+            Entry() : stream(&buffer) {}
+
+            StringBuf buffer;
+            std::ostream stream;
+        };
+
+        struct ThreadStreams
+        {
+            std::unique_ptr<Entry> entries[Max_Thread_Streams];
+                                        // Reusable streams, made as needed
+            std::size_t depth;          // Number of streams in use
+        };
+
+        static ThreadStreams &GetThreadStreams();
+
+        Entry *entry;                   // Borrowed stream, or local
+        std::unique_ptr<Entry> local;   // Used if all streams are in use
+};
+
+} // namespace cantina
@@ -0,0 +1,159 @@
+/*
+ *  log_site_limiter.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogSiteLimiter class, which the rate limiting and
+ *      sampling macros (e.g., LOGGER_WARNING_EVERY_N()) define statically
+ *      at each call site to decide whether a message is to be logged.  All
+ *      state is held in atomic variables, so the decision never requires a
+ *      lock.  The number of messages suppressed since the previous message
+ *      was logged is also maintained, allowing a summary to be appended to
+ *      the next message that is logged.
+ *
+ *      Rate limiting uses a token bucket that holds up to one second of
+ *      messages, implemented as a "theoretical arrival time" that advances
+ *      by the interval between messages each time a message is allowed.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+namespace cantina
+{
+
+// Per-call-site state used to rate limit or sample log messages
+class LogSiteLimiter
+{
+    public:
+        constexpr LogSiteLimiter() : count(0), suppressed(0), arrival_time(0)
+        {
+        }
+
+        LogSiteLimiter(const LogSiteLimiter &) = delete;
+        LogSiteLimiter &operator=(const LogSiteLimiter &) = delete;
+
+        ~LogSiteLimiter() = default;
+
+        // Allow the first of every n messages
+        bool EveryN(std::uint64_t n)
+        {
+            std::uint64_t previous =
+                count.fetch_add(1, std::memory_order_relaxed);
+
+            if ((n <= 1) || ((previous % n) == 0)) return true;
+
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+
+            return false;
+        }
+
+        // Allow only the first n messages (later messages are not counted as
+        // suppressed, since no message follows to report them)
+        bool FirstN(std::uint64_t n)
+        {
+            // Avoid writing to the counter once the limit is reached
+            if (count.load(std::memory_order_relaxed) >= n) return false;
+
+            return count.fetch_add(1, std::memory_order_relaxed) < n;
+        }
+
+        // Allow up to the given number of messages per second
+        bool RateLimited(double per_second)
+        {
+            if (per_second <= 0.0) return false;
+
+            std::int64_t now =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+            auto interval = static_cast<std::int64_t>(1e9 / per_second);
+            std::int64_t burst =
+                per_second > 1.0 ? Nanoseconds_Per_Second : interval;
+            std::int64_t expected =
+                arrival_time.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                std::int64_t next =
+                    (expected > now ? expected : now) + interval;
+
+                // Suppress the message if the bucket is empty
+                if (next - now > burst)
+                {
+                    suppressed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                if (arrival_time.compare_exchange_weak(
+                        expected,
+                        next,
+                        std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Return and reset the number of messages suppressed
+        std::uint64_t TakeSuppressed()
+        {
+            if (suppressed.load(std::memory_order_relaxed) == 0) return 0;
+
+            return suppressed.exchange(0, std::memory_order_relaxed);
+        }
+
+    protected:
+        static constexpr std::int64_t Nanoseconds_Per_Second = 1000000000;
+
+        std::atomic<std::uint64_t> count;
+                                        // Messages seen at this call site
+        std::atomic<std::uint64_t> suppressed;
+                                        // Messages suppressed since the last
+                                        // one was logged
+        std::atomic<std::int64_t> arrival_time;
+                                        // Time at which the bucket is full
+};
+
+} // namespace cantina
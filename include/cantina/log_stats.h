@@ -0,0 +1,261 @@
+/*
+ *  log_stats.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogStatsCollector class, which counts the messages
+ *      logged at each level, the messages rejected by the log level, and
+ *      the octets written to each facility, and maintains histograms of the
+ *      time taken to emit each message and the time spent waiting for
+ *      locks.  The counters are divided among a fixed number of shards,
+ *      each on its own cache lines, and each thread updates only the shard
+ *      assigned to it, so collecting statistics does not introduce
+ *      contention between threads.  Reading the statistics sums the shards.
+ *
+ *      Histograms use power-of-two buckets of nanoseconds, so recording a
+ *      duration requires only a few instructions.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "log_types.h"
+#include "async_log_queue.h"
+
+namespace cantina
+{
+
+// Histogram of durations in power-of-two buckets of nanoseconds
+struct LogHistogram
+{
+    // Bucket i counts durations of at least 2^(i-1) and less than 2^i
+    // nanoseconds (bucket 0 counts zero durations); the last bucket also
+    // counts all longer durations
+    static constexpr std::size_t Bucket_Count = 32;
+
+    std::array<std::uint64_t, Bucket_Count> buckets{};
+                                        // Durations in each bucket
+    std::uint64_t count = 0;            // Number of durations
+    std::chrono::nanoseconds total{0};  // Sum of all durations
+
+    // Index of the bucket counting the given duration
+    static std::size_t Bucket(std::uint64_t nanoseconds)
+    {
+        if (nanoseconds == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+        std::size_t bits = 64 - __builtin_clzll(nanoseconds);
+#else
+        std::size_t bits = 0;
+        while (nanoseconds > 0)
+        {
+            nanoseconds >>= 1;
+            bits++;
+        }
+#endif
+        return (bits < Bucket_Count) ? bits : Bucket_Count - 1;
+    }
+
+    // Upper bound of the duration not exceeded by the given fraction
+    // (e.g., 0.99) of durations
+    std::chrono::nanoseconds Percentile(double fraction) const;
+};
+
+// Statistics describing the activity of a Logger (see Logger::GetStats())
+struct LogStats
+{
+    std::array<std::uint64_t, Log_Level_Count> messages{};
+                                        // Messages logged at each level
+    std::array<std::uint64_t, Log_Level_Count> filtered{};
+                                        // Messages rejected by log level
+    std::array<std::uint64_t, Log_Facility_Count> bytes{};
+                                        // Octets written to each facility
+    LogDropCounts drops{};              // Messages discarded at each level
+    std::size_t queue_depth = 0;        // Messages presently queued
+    std::size_t max_queue_depth = 0;    // Most messages queued at once
+    LogHistogram emit_time;             // Time taken to emit each message
+    LogHistogram lock_wait;             // Time spent waiting for locks
+};
+
+// Collects statistics in shards so that threads do not contend
+class LogStatsCollector
+{
+    public:
+        static constexpr std::size_t Shard_Count = 16;
+
+        LogStatsCollector();
+        LogStatsCollector(const LogStatsCollector &) = delete;
+        LogStatsCollector &operator=(const LogStatsCollector &) = delete;
+        ~LogStatsCollector() = default;
+
+        // Enable or disable the collection of statistics
+        void Enable(bool enable)
+        {
+            enabled.store(enable, std::memory_order_relaxed);
+        }
+
+        // Are statistics being collected?
+        bool IsEnabled() const
+        {
+            return enabled.load(std::memory_order_relaxed);
+        }
+
+        // Time at which emitting a message begins, if collecting
+        std::chrono::steady_clock::time_point StartEmit() const
+        {
+            if (!IsEnabled()) return {};
+
+            return std::chrono::steady_clock::now();
+        }
+
+        // Count a message whose emission began at the given time
+        void CountEmitted(LogLevel level,
+                          std::chrono::steady_clock::time_point start)
+        {
+            if (!IsEnabled()) return;
+
+            Shard &shard = GetShard();
+            Add(shard.messages[static_cast<std::size_t>(level)], 1);
+            if (start != std::chrono::steady_clock::time_point{})
+            {
+                Record(shard.emit_time,
+                       std::chrono::steady_clock::now() - start);
+            }
+        }
+
+        // Count a message rejected by the log level
+        void CountFiltered(LogLevel level)
+        {
+            if (!IsEnabled()) return;
+
+            Add(GetShard().filtered[static_cast<std::size_t>(level)], 1);
+        }
+
+        // Count octets written to a facility
+        void CountBytes(LogFacility facility, std::size_t octets)
+        {
+            if (!IsEnabled()) return;
+
+            Add(GetShard().bytes[static_cast<std::size_t>(facility)], octets);
+        }
+
+        // Acquire a deferred std::unique_lock or std::shared_lock, recording
+        // the time spent waiting if the mutex is held by another thread
+        template<typename Lock>
+        void Acquire(Lock &lock)
+        {
+            if (!IsEnabled())
+            {
+                lock.lock();
+                return;
+            }
+
+            if (lock.try_lock()) return;
+
+            auto start = std::chrono::steady_clock::now();
+            lock.lock();
+            Record(GetShard().lock_wait,
+                   std::chrono::steady_clock::now() - start);
+        }
+
+        // Add the sum of all shards to the given statistics
+        void Read(LogStats &stats) const;
+
+    protected:
+        // Counters of a histogram within a shard
+        struct HistogramCounters
+        {
+            std::atomic<std::uint64_t> buckets[LogHistogram::Bucket_Count];
+            std::atomic<std::uint64_t> total;
+        };
+
+        // Counters updated by the threads assigned to the shard, aligned
+        // so that no two shards share a cache line
+        struct alignas(64) Shard
+        {
+            std::atomic<std::uint64_t> messages[Log_Level_Count];
+            std::atomic<std::uint64_t> filtered[Log_Level_Count];
+            std::atomic<std::uint64_t> bytes[Log_Facility_Count];
+            HistogramCounters emit_time;
+            HistogramCounters lock_wait;
+        };
+
+        static void Add(std::atomic<std::uint64_t> &counter,
+                        std::uint64_t value)
+        {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        static void Record(HistogramCounters &histogram,
+                           std::chrono::steady_clock::duration duration)
+        {
+            auto nanoseconds = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                    .count());
+
+            Add(histogram.buckets[LogHistogram::Bucket(nanoseconds)], 1);
+            Add(histogram.total, nanoseconds);
+        }
+
+        static void Read(const HistogramCounters &counters,
+                         LogHistogram &histogram);
+
+        // Shard assigned to the calling thread
+        Shard &GetShard()
+        {
+            static std::atomic<std::size_t> next_shard{0};
+            static thread_local std::size_t shard =
+                next_shard.fetch_add(1, std::memory_order_relaxed) %
+                Shard_Count;
+
+            return shards[shard];
+        }
+
+        std::atomic<bool> enabled;      // Are statistics being collected?
+        std::unique_ptr<Shard[]> shards;
+                                        // Counters updated by threads
+};
+
+} // namespace cantina
@@ -0,0 +1,164 @@
+/*
+ *  log_uring.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LogUring class, which writes to a file descriptor
+ *      through a Linux io_uring so that the writing thread need not wait
+ *      for the kernel to complete each write.  Output is copied into one of
+ *      a small number of buffers registered with the kernel and submitted;
+ *      several buffers may be in flight at once, and each is reused once
+ *      its write completes.  Only when every buffer is in flight does the
+ *      writer wait.  A write (or data sync) submitted while another is in
+ *      flight starts only after it completes, so output appears in the
+ *      order written, even on pipes and terminals.
+ *
+ *      The ring is set up with the io_uring system calls directly, so no
+ *      library is required.  Where io_uring is not available, Start()
+ *      fails and the caller writes using write() as before.
+ *
+ *      A LogUring is not safe for concurrent use; its owner serializes
+ *      calls to it.
+ *
+ *  Portability Issues:
+ *      io_uring is available only on Linux 5.6 or later and may be disabled
+ *      by the system (e.g., by a seccomp policy).  Elsewhere, Start()
+ *      returns false.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cantina
+{
+
+// Writer of output through an io_uring declaration
+class LogUring
+{
+    public:
+        // Default number of buffers that may be in flight
+        static constexpr unsigned Default_Buffer_Count = 8;
+
+        LogUring();
+        LogUring(const LogUring &) = delete;
+        LogUring &operator=(const LogUring &) = delete;
+        ~LogUring();
+
+        // Can io_uring be used on this system?
+        static bool IsAvailable();
+
+        // Set up the ring and buffers for writing to the descriptor
+        bool Start(int fd,
+                   std::size_t buffer_size,
+                   unsigned buffer_count = Default_Buffer_Count);
+
+        // Wait for submitted writes and release the ring
+        void Stop();
+
+        // Is the ring set up?
+        bool IsRunning() const { return ring_fd >= 0; }
+
+        // Size of each buffer
+        std::size_t GetBufferSize() const { return buffer_size; }
+
+        // Take a free buffer, waiting for a write to complete if necessary
+        char *Acquire();
+
+        // Write the given length of a buffer taken via Acquire(), after
+        // which the buffer must not be used (a length of 0 releases it)
+        void Submit(char *buffer, std::size_t length);
+
+        // Copy data into buffers and write it
+        void Write(const char *data, std::size_t length);
+
+        // Write the data to the device (as fdatasync()) after prior writes,
+        // unless a sync is already in flight
+        bool Sync();
+
+        // Wait for every submitted write and sync to complete
+        void Wait();
+
+    protected:
+        // Portion of a buffer being written
+        struct BufferWrite
+        {
+            std::size_t offset;         // Octets already written
+            std::size_t length;         // Octets to write in all
+        };
+
+        bool Reap(bool wait);
+        void Complete(unsigned index, int result);
+        bool Queue(unsigned index);
+        void WriteDirect(unsigned index);
+        bool Enter(unsigned to_submit, unsigned min_complete);
+        void Release();
+
+        int fd;                         // Descriptor written
+        int ring_fd;                    // Descriptor of the ring
+        bool registered;                // Are the buffers registered?
+        std::size_t buffer_size;        // Size of each buffer
+        std::size_t buffer_stride;      // Distance between buffers
+        char *buffers;                  // Storage of all buffers
+        std::size_t buffers_length;     // Length of buffers' storage
+        std::vector<unsigned> free_buffers;
+                                        // Buffers not in flight or taken
+        std::vector<BufferWrite> writes;// Progress of each buffer's write
+        unsigned in_flight;             // Writes and syncs not complete
+        bool sync_pending;              // Is a sync in flight?
+
+        // Ring memory shared with the kernel
+        void *sq_ring;                  // Submission ring mapping
+        std::size_t sq_ring_length;     // Length of sq_ring
+        void *cq_ring;                  // Completion ring mapping
+        std::size_t cq_ring_length;     // Length of cq_ring (0 if shared)
+        void *sqes;                     // Submission queue entries
+        std::size_t sqes_length;        // Length of sqes
+        unsigned *sq_head;              // Consumed by the kernel
+        unsigned *sq_tail;              // Produced by this object
+        unsigned sq_mask;               // Mask for ring indices
+        unsigned *sq_array;             // Indices of entries to submit
+        unsigned *cq_head;              // Consumed by this object
+        unsigned *cq_tail;              // Produced by the kernel
+        unsigned cq_mask;               // Mask for ring indices
+        void *cqes;                     // Completion queue entries
+};
+
+} // namespace cantina
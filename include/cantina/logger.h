@@ -21,6 +21,14 @@
  *      until the root object is reached.  Each will contribute its
  *      component name to the output so that one can better see exactly
  *      what component and object hierarchy produced the message.
+ *      The combined component prefix is built once when a child Logger is
+ *      constructed and each message is handed directly to the root Logger.
+ *
+ *      Where a great many objects each want their own component name (e.g.,
+ *      one per connection), a LoggerHandle (see logger_handle.h) may be
+ *      used in place of a child Logger.  It holds only a pointer to its
+ *      parent, its component prefix, and its log level, yet offers the same
+ *      logging functions and streams.
  *
  *      The "root" Logger has an optional process name associated with it
  *      which is used only when calling syslog().
@@ -46,6 +54,16 @@
  *      The LogLevel parameter indicates the severity of the log.  Those may be
  *      Critical, Error, Warning, Info, or Debug.
  *
+ *      Each Logger's level may be set by calling SetLogLevel(), and messages
+ *      must also pass the level of each parent Logger.  Alternatively,
+ *      SetComponentLevels() may be given levels by component path, such as
+ *      "Foo.Bar=debug, *=info", which take precedence over levels given to
+ *      SetLogLevel().  A path names a component and every component beneath
+ *      it, the longest matching path applies, and "*" matches every
+ *      component.  Levels may be changed at any time; each Logger caches
+ *      its level until the levels next change, so checking the level does
+ *      not become any more costly.
+ *
  *      The LogLevel parameter indicates the severity of the log.
  *
  *      The logging facility indicates where logs are to be created.  At
@@ -66,9 +84,13 @@
  *      should not use std::endl, as that will result in unwanted linefeed
  *      characters in logging output.
  *
- *      IMPORTANT! Failing to call "std::flush" on streaming interfaces will
- *      result in logs being output in a timely manner, but will also cause
- *      other threads waiting to output log entries to be blocked.
+ *      Each thread writing to a streaming interface builds its message in
+ *      its own std::ostream and buffer, so threads do not wait on one
+ *      another while formatting messages, and manipulators such as std::hex
+ *      apply only to the message being constructed.  IMPORTANT! Failing to
+ *      call "std::flush" on streaming interfaces will result in the partial
+ *      message remaining in the thread's buffer until that thread next
+ *      flushes the same stream.
  *
  *      If you are this Logger as components in an existing project that
  *      already has logging facilities and want to continue using those
@@ -80,7 +102,10 @@
  *      as the "parent" Logger, setting the logging facility to "Console".
  *      To simplify this process, you may use the CustomLogger class defined
  *      below, passing a lambda function to invoke as each message to be logged
- *      is received.  See the test "test_custom_logger" for example usage.
+ *      is received.  See the test "CustomLoggerParts" for example usage.
+ *      CustomLogger may instead pass the parts of each message (level,
+ *      timestamp, component prefix, and body) without concatenating them,
+ *      or pass batches of messages' parts from a background thread.
  *
  *      By default, the Logger will use color if it detects that the output
  *      device may support color.  This may be disabled by calling the
@@ -88,7 +113,120 @@
  *
  *      The timestamps produced by the Logger use microseconds by default.
  *      One may change this to milliseconds by calling the SetTimePrecision()
- *      function.
+ *      function.  Timestamps use local time by default, though one may call
+ *      SetTimeFormat() to use UTC or seconds since the epoch instead, both
+ *      of which avoid the C library's time zone lock.
+ *
+ *      By default, the root Logger writes each message to the logging
+ *      facility on the thread that produced it.  Calling SetAsync() on the
+ *      root Logger will instead place each message into a bounded queue
+ *      that is drained by a background writer thread, so that the latency
+ *      of the console, file, or syslog does not impact the calling thread.
+ *      If the queue is full, the calling thread will wait for space unless
+ *      a LogQueuePolicy given to SetAsync() bounds the wait or discards
+ *      messages, in which case a "Dropped N messages" warning notes their
+ *      absence.  Call Flush() to wait until all queued messages have been
+ *      written.  Each queue entry holds up to 256 octets of text in place,
+ *      so that, once per-thread buffers have grown to fit, logging a message
+ *      does not allocate memory.
+ *
+ *      A sharded LogQueuePolicy gives each logging thread a queue of its own,
+ *      avoiding contention between threads.  The writer thread merges the
+ *      queues by the time each message was logged, holding a message for
+ *      up to the policy's reorder window while another thread's queue is
+ *      empty.
+ *
+ *      Queued and binary messages may be timed using the TSC or
+ *      CLOCK_MONOTONIC_COARSE rather than the system time (see
+ *      SetClockSource() and log_clock.h), in which case the raw value is
+ *      converted to the time of day only when the message is written or
+ *      decoded.
+ *
+ *      When logging to a file, a LogFlushPolicy may be given to
+ *      SetLogFacility() so that output is buffered and written once a given
+ *      number of octets are buffered or at a given time interval, rather
+ *      than once per line.  Error and Critical messages are written
+ *      immediately unless the policy indicates otherwise.  The policy may
+ *      also compress each block of output as a gzip, Zstandard, or LZ4
+ *      frame (see log_compressor.h), with the same events completing the
+ *      frame early.  On Linux, it may instead ask that writes be submitted
+ *      through an io_uring without waiting for them to complete, and that
+ *      output be synced to the device at a given interval (see
+ *      log_uring.h).
+ *
+ *      For very high message rates, LogFacility::MappedFile writes messages
+ *      into fixed-size, memory-mapped file segments (64 MiB by default; see
+ *      SetSegmentSize()).  Threads copy messages into the mapping without
+ *      locking the Logger's mutex, and each full segment is truncated to
+ *      the length used.  Segments are named by appending a six-digit number
+ *      to the filename given to SetLogFacility().
+ *
+ *      In addition to the logging facility, the root Logger may write
+ *      messages to any number of sinks (see log_sink.h), each having its
+ *      own log level, by calling AddSink().  The timestamp and level are
+ *      formatted once for all sinks and a message below the level of every
+ *      sink is rejected before it is formatted.  A sink may also be given
+ *      its own background writer thread by calling SetAsync() on the sink.
+ *
+ *      Syslog messages may be sent in batches directly to the local syslog
+ *      socket or to a remote collector, rather than by calling syslog()
+ *      for each message, by giving a SyslogSender to SetSyslogInterface().
+ *
+ *      EnableFlightRecorder() retains the most recent messages at every
+ *      level, including those below the log level, in memory.  Those not
+ *      already written are emitted when a Critical message is logged or
+ *      DumpFlightRecorder() is called, and all are optionally written to
+ *      standard error upon a fatal signal.
+ *
+ *      EnableCoalescing() counts, rather than writes, messages that repeat
+ *      the previous message logged by the same component at the same level
+ *      (see log_coalescer.h).  When the run of repeats ends, or once it has
+ *      lasted for the timeout, a "Last message repeated N times" line
+ *      giving the times of the first and last repeats is written instead.
+ *
+ *      Once EnableStats() is called, GetStats() reports the messages logged
+ *      and rejected at each level, the octets written to each facility,
+ *      messages dropped, the depth of the queue, and histograms of the time
+ *      taken to emit each message and the time spent waiting for locks.
+ *      Each thread updates its own shard of the counters, so collecting
+ *      statistics does not cause threads to contend with one another.
+ *
+ *      A program whose sink and format are known at compile time may use
+ *      a BasicLogger (see basic_logger.h) in place of a Logger.  Messages
+ *      less severe than its compiled minimum level generate no code, and
+ *      its format and sink are called without virtual dispatch.
+ *
+ *      Messages may also be logged using a format string having a "{}"
+ *      placeholder for each argument, bypassing std::ostream entirely:
+ *
+ *          logger->Info("rx seq={} len={}", seq, length);
+ *
+ *      The level is checked before any argument is formatted and the text
+ *      is written into a reusable per-thread buffer.  When compiled as
+ *      C++20 or later, the number of placeholders is checked against the
+ *      number of arguments at compile time.
+ *
+ *      Structured fields may follow a message, given as pairs of names and
+ *      values (see log_fields.h):
+ *
+ *          LOGGER_INFO_KV(logger, "rx", "seq", seq, "bytes", length);
+ *
+ *      Calling SetOutputFormat(LogOutputFormat::JsonLines) writes each
+ *      message to the console and to files as a JSON object on its own
+ *      line, with the component names as an array and each field as a
+ *      member.
+ *
+ *      The logging macros describe each call site with a static constexpr
+ *      LogSite (see log_site.h), so ShowSourceLocation() may write the file
+ *      and line of each message without any work at runtime to find them.
+ *
+ *      Where converting arguments to text is too costly, the binary logging
+ *      macros (e.g., LOGGER_INFO_BINARY()) record only a format identifier,
+ *      a timestamp, and the raw argument values.  If SetBinaryLog() has been
+ *      called, these records are written to a binary log to be decoded
+ *      offline (see binary_log_reader.h).  Otherwise, they are converted to
+ *      text, which happens on the background writer thread when logging
+ *      asynchronously.
  *
  *  Portability Issues:
  *      None.
@@ -133,41 +271,66 @@
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <vector>
 #include "syslog_interface.h"
+#include "syslog_sender.h"
+#include "log_types.h"
+#include "async_log_queue.h"
+#include "log_file.h"
+#include "mapped_log_file.h"
+#include "log_sink.h"
+#include "log_stats.h"
+#include "log_level_registry.h"
+#include "log_clock.h"
+#include "flight_recorder.h"
+#include "log_coalescer.h"
+#include "binary_log.h"
+#include "log_format.h"
+#include "log_fields.h"
+#include "log_site.h"
+#include "log_site_limiter.h"
 #include "logger_macros.h"
 
 namespace cantina
 {
 
-// Define log level enumeration
-enum class LogLevel
-{
-    Critical,
-    Error,
-    Warning,
-    Info,
-    Debug
-};
-
-// Define the logging facility enumeration
-enum class LogFacility
+// Log record passed to the background writer thread
+struct LogRecord
 {
-    None,
-    Console,
-    Syslog,
-    File,
-    AndroidLog
+    LogLevel level;
+    bool console;
+    std::chrono::system_clock::time_point time;
+                                        // Time logged, unless unset
+    LogRecordText text;                 // Message, or the component prefix
+                                        // and arguments of a binary message
+    const BinaryFormat *binary_format = nullptr;
+                                        // Format of a binary message
+    std::size_t prefix_length = 0;      // Length of the component prefix
+    std::size_t fields_length = 0;      // Length of the trailing fields
+    const LogSite *site = nullptr;      // Call site to be written, if any
+    std::uint64_t clock_ticks = 0;      // Raw clock value if time is unset
 };
 
-// Define the logging precision
-enum class LogTimePrecision
+// Message given to a CustomLogger as separate parts, without concatenating
+// the component prefix and the text
+struct LogMessageParts
 {
-    Milliseconds,
-    Microseconds
+    LogLevel level;                     // Level of the message
+    bool console;                       // Also requested for the console
+    std::chrono::system_clock::time_point time;
+                                        // Time the message was logged
+    std::string_view prefix;            // Component prefix (e.g., "[Foo] ")
+    std::string_view body;              // Text following the prefix
+    const LogSite *site = nullptr;      // Call site, if logged by a macro
 };
 
 // Forward declaration to support parent/child logging relationship
@@ -177,85 +340,187 @@ typedef std::shared_ptr<Logger> LoggerPointer;
 // Logger object declaration
 class Logger : protected SyslogInterface
 {
+    friend class LogSink;
+    friend class LoggerHandle;
+
     protected:
-        // Stream buffer used to capture log messages
-        class LoggingBuf : public std::stringbuf
+        // Stream buffer used to capture log messages.  Each thread writes to
+        // its own stream and buffer, which is handed to the Logger on sync().
+        class LoggingBuf : public std::streambuf
         {
             public:
                 LoggingBuf(Logger *logger,
                            LogLevel log_level,
                            bool console = false) :
-                    std::stringbuf(),
+                    std::streambuf(),
                     logger(logger),
                     log_level(log_level),
                     console(console),
-                    busy(false)
+                    buffer_id(NextBufferId())
                 {
                 }
 
+                // Return this thread's stream writing to this buffer
+                std::ostream &GetThreadStream()
+                {
+                    return *GetThreadMessage().stream;
+                }
+
             protected:
+                // Message being constructed by the current thread
+                struct ThreadMessage
+                {
+                    std::uint64_t id;   // buffer_id of the LoggingBuf
+                    std::string text;   // Text written so far
+                    std::unique_ptr<std::ostream> stream;
+                                        // Stream writing to the LoggingBuf
+                };
+
+                // Buffers belonging to the current thread
+                struct ThreadBuffers
+                {
+                    // Messages being constructed
+                    std::vector<ThreadMessage> active;
+
+                    // Previously used messages retained for their stream
+                    // and the capacity of their text
+                    std::vector<ThreadMessage> spare;
+                };
+
                 Logger *logger;
                 LogLevel log_level;
                 bool console;
-                std::atomic<bool> busy;
-                std::thread::id owning_thread;
-                std::mutex buffer_mutex;
-                std::condition_variable signal;
+                std::uint64_t buffer_id;
+
+                // Unique identifier so a reused address is never confused
+                // with a destroyed buffer
+                static std::uint64_t NextBufferId()
+                {
+                    static std::atomic<std::uint64_t> next_id{1};
+                    return next_id.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                static ThreadBuffers &GetThreadBuffers()
+                {
+                    static thread_local ThreadBuffers thread_buffers;
+                    return thread_buffers;
+                }
 
-                void thread_sync()
+                // Return this thread's message for this buffer, taking one
+                // with a stream in its default state if none is active
+                ThreadMessage &GetThreadMessage()
                 {
-                    bool wait_result;
-
-                    std::unique_lock<std::mutex> lock(buffer_mutex);
-                    wait_result = signal.wait_for(
-                        lock,
-                        std::chrono::seconds(1),
-                        [&]() -> bool
-                        {
-                            return (!busy ||
-                                    (busy && owning_thread ==
-                                                std::this_thread::get_id()));
-                        });
-
-                    if (!wait_result)
+                    auto &buffers = GetThreadBuffers();
+
+                    for (auto &message : buffers.active)
+                    {
+                        if (message.id == buffer_id) return message;
+                    }
+
+                    if (buffers.spare.empty())
                     {
-                        logger->Log(LogLevel::Error,
-                                    "Somebody forgot to call std::flush!?");
-                        busy = false;
+                        buffers.active.push_back(ThreadMessage{
+                            buffer_id,
+                            std::string(),
+                            std::make_unique<std::ostream>(this)});
+                        return buffers.active.back();
                     }
 
-                    if (!busy)
+                    buffers.active.push_back(std::move(buffers.spare.back()));
+                    buffers.spare.pop_back();
+
+                    ThreadMessage &message = buffers.active.back();
+                    std::ostream &stream = *message.stream;
+                    message.id = buffer_id;
+                    stream.rdbuf(this);
+                    stream.flags(std::ios_base::skipws | std::ios_base::dec);
+                    stream.precision(6);
+                    stream.width(0);
+                    stream.fill(' ');
+
+                    return message;
+                }
+
+                virtual int_type overflow(int_type c)
+                {
+                    if (!traits_type::eq_int_type(c, traits_type::eof()))
                     {
-                        busy = true;
-                        owning_thread = std::this_thread::get_id();
+                        GetThreadMessage().text.push_back(
+                            traits_type::to_char_type(c));
                     }
+
+                    return traits_type::not_eof(c);
                 }
 
                 virtual std::streamsize xsputn(const char *c, std::streamsize n)
                 {
-                    // Control thread access to the string buffer
-                    thread_sync();
-                    return std::stringbuf::xsputn(c, n);
+                    GetThreadMessage().text.append(c,
+                                                   static_cast<std::size_t>(n));
+                    return n;
                 }
 
                 virtual int sync()
                 {
-                    // Control thread access to the string buffer
-                    thread_sync();
+                    auto &buffers = GetThreadBuffers();
+                    ThreadMessage message{};
 
-                    logger->Log(log_level, str(), console);
-                    str("");
+                    // Take this thread's message, if any, so that logging
+                    // to other streams from within Log() is safe
+                    for (auto it = buffers.active.begin();
+                         it != buffers.active.end();
+                         it++)
+                    {
+                        if (it->id != buffer_id) continue;
+                        message = std::move(*it);
+                        buffers.active.erase(it);
+                        break;
+                    }
 
-                    // We're done with the buffer now
-                    busy = false;
+                    logger->Log(log_level, message.text, console);
 
-                    // Let another thread take control
-                    signal.notify_one();
+                    // Retain the message for its stream, which is being
+                    // flushed and so may not be destroyed, and its text's
+                    // capacity; the pool grows only to the number of
+                    // messages the thread constructs at once
+                    if (message.stream)
+                    {
+                        message.id = 0;
+                        message.text.clear();
+                        buffers.spare.push_back(std::move(message));
+                    }
 
                     return 0;
                 }
         };
 
+    public:
+        // Streaming interface at a given level, giving each thread its own
+        // std::ostream so that formatting state is never shared
+        class LoggingStream
+        {
+            public:
+                explicit LoggingStream(LoggingBuf *buffer) : buffer(buffer)
+                {
+                }
+                LoggingStream(const LoggingStream &) = delete;
+                LoggingStream &operator=(const LoggingStream &) = delete;
+
+                template<typename T>
+                std::ostream &operator<<(const T &value)
+                {
+                    return buffer->GetThreadStream() << value;
+                }
+
+                std::ostream &operator<<(
+                                std::ostream &(*manipulator)(std::ostream &))
+                {
+                    return buffer->GetThreadStream() << manipulator;
+                }
+
+            protected:
+                LoggingBuf *buffer;     // Buffer to which messages are written
+        };
+
     public:
         // Constructor
         Logger(bool output_to_console = false);
@@ -288,12 +553,111 @@ class Logger : protected SyslogInterface
         // Function to log messages using LogLevel::INFO
         void Log(const std::string &message);
 
+        // Function to log messages from a call site (see LOGGER_SITE)
+        void Log(const LogSite &site, const std::string &message);
+
+        // Functions to log formatted messages (e.g., Info("x={}", x))
+        template<typename... Args>
+        void Critical(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Critical, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Error(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Error, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Warning(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Warning, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Info(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Info, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Debug(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Debug, format.Get(), args...);
+        }
+
+        // Function to log a message followed by structured fields given
+        // as pairs of names and values (see LOGGER_INFO_KV)
+        template<typename... Fields>
+        void LogFields(LogLevel level,
+                       std::string_view message,
+                       const Fields &...fields)
+        {
+            LogFieldsFrom(level, nullptr, message, fields...);
+        }
+
+        // Function to log a message with structured fields from a call site
+        template<typename... Fields>
+        void LogFields(const LogSite &site,
+                       std::string_view message,
+                       const Fields &...fields)
+        {
+            LogFieldsFrom(site.level, &site, message, fields...);
+        }
+
+        // Function to log messages in binary form (see LOGGER_INFO_BINARY)
+        template<typename... Args>
+        void LogBinary(const BinaryFormat &format,
+                       const char *,
+                       const Args &...args)
+        {
+            static thread_local std::string arguments;
+
+            LogStatsCollector &collector = *root_logger->stats;
+
+            if (!IsLevelEnabled(format.level))
+            {
+                collector.CountFiltered(format.level);
+                return;
+            }
+
+            auto start = collector.StartEmit();
+
+            arguments.clear();
+            (EncodeBinaryArgument(arguments, args), ...);
+
+            root_logger->EmitBinary(format,
+                                    component_prefix,
+                                    arguments,
+                                    force_console);
+
+            collector.CountEmitted(format.level, start);
+        }
+
+        // Write binary messages to the named binary log (empty to close)
+        bool SetBinaryLog(const std::string &base_name = {});
+
         // Set the logging facility
-        void SetLogFacility(LogFacility facility, std::string filename = {});
+        void SetLogFacility(LogFacility facility,
+                            std::string filename = {},
+                            LogFlushPolicy flush_policy = {});
 
         // What is the current logging facility?
         LogFacility GetLogFacility() const;
 
+        // Add a sink for the given facility writing messages up to a level
+        std::shared_ptr<LogSink> AddSink(LogFacility facility,
+                                         LogLevel level,
+                                         const std::string &filename = {},
+                                         LogFlushPolicy flush_policy = {});
+
+        // Add a sink to which messages are written
+        bool AddSink(const std::shared_ptr<LogSink> &sink);
+
+        // Remove a sink added using AddSink()
+        void RemoveSink(const std::shared_ptr<LogSink> &sink);
+
         // Set the log level to be output (default is LogLevel::INFO)
         void SetLogLevel(LogLevel level);
 
@@ -304,9 +668,27 @@ class Logger : protected SyslogInterface
         LogLevel GetLogLevel() const;
         std::string GetLogLevelString() const;
 
+        // Set log levels by component path (e.g., "Foo.Bar=debug, *=info"),
+        // which take precedence over levels given to SetLogLevel()
+        bool SetComponentLevels(const std::string &levels);
+
+        // Get the log levels given to SetComponentLevels()
+        std::string GetComponentLevels() const;
+
+        // Path of component names used with SetComponentLevels()
+        const std::string &GetComponentPath() const { return component_path; }
+
         // Check to see if debug messages are to be logged
         bool IsDebugging() const;
 
+        // Check to see if messages at the given level are to be logged
+        bool ShouldLog(LogLevel level) const
+        {
+            return IsLevelEnabled(level) ||
+                   root_logger->flight_recording.load(
+                       std::memory_order_relaxed);
+        }
+
         // Enable/disable color console output
         void Colorize(bool colorize_output);
 
@@ -316,9 +698,73 @@ class Logger : protected SyslogInterface
         // Specify logging precision beyond seconds
         void SetTimePrecision(LogTimePrecision precision);
 
-        // Get the streaming logger interface
+        // Specify the timestamp format (default is LogTimeFormat::LocalTime)
+        void SetTimeFormat(LogTimeFormat format);
+
+        // Specify the format of lines written to the console and to files
+        // (default is LogOutputFormat::Text)
+        void SetOutputFormat(LogOutputFormat format);
+
+        // Get the format of lines written to the console and to files
+        LogOutputFormat GetOutputFormat() const;
+
+        // Write the source file and line of messages logged by the macros
+        // to the console and to files (default is false)
+        void ShowSourceLocation(bool show = true);
+
+        // Are source locations written?
+        bool IsShowingSourceLocation() const;
+
+        // Set the segment size used with LogFacility::MappedFile
+        void SetSegmentSize(std::size_t size);
+
+        // Set the interface used with LogFacility::Syslog (nullptr for the
+        // system's syslog)
+        bool SetSyslogInterface(
+                        std::shared_ptr<SyslogInterface> syslog_interface);
+
+        // Get the calling thread's stream for the given level, which is
+        // valid until std::flush is written to it
         std::ostream &GetLoggingStream(LogLevel log_level);
 
+        // Emit log messages from a background thread (0 to disable)
+        void SetAsync(std::size_t queue_capacity = 8192,
+                      const LogQueuePolicy &policy = {});
+
+        // Are log messages emitted from a background thread?
+        bool IsAsync() const;
+
+        // Set the clock read to time messages queued for the background
+        // thread or written to the binary log (default is System)
+        bool SetClockSource(LogClockSource source);
+
+        // Get the clock read to time queued and binary messages
+        LogClockSource GetClockSource() const;
+
+        // Number of messages discarded at each level due to a full queue
+        LogDropCounts GetDropCounts() const;
+
+        // Wait until all queued log messages have been written
+        virtual void Flush();
+
+        // Retain recent messages at every level in memory (0 to disable)
+        void EnableFlightRecorder(std::size_t capacity,
+                                  bool dump_on_fatal_signal = false);
+
+        // Emit messages retained by the flight recorder not already written
+        void DumpFlightRecorder();
+
+        // Count consecutive repeats of a message rather than writing them,
+        // summarizing each run after at most the timeout (0 to disable)
+        void EnableCoalescing(std::chrono::milliseconds timeout =
+                                  std::chrono::seconds(1));
+
+        // Enable/disable the collection of statistics
+        void EnableStats(bool enable = true);
+
+        // Statistics collected since statistics were first enabled
+        LogStats GetStats();
+
     protected:
         // Constructor called by other constructors
         Logger(const std::string &process_name,
@@ -326,23 +772,197 @@ class Logger : protected SyslogInterface
                const LoggerPointer &parent_logger,
                bool output_to_console = false);
 
+        // Do this logger and its parents log messages at this level?
+        bool IsLevelEnabled(LogLevel level) const
+        {
+            return (static_cast<int>(level) <= GetEffectiveLevel()) &&
+                   (static_cast<int>(level) <=
+                    root_logger->sink_level.load(std::memory_order_relaxed));
+        }
+
+        // Level given to this component by SetComponentLevels(), or else
+        // the least verbose of the levels of this logger and its parents
+        int GetEffectiveLevel() const
+        {
+            return component_level.Get(
+                root_logger->level_registry,
+                component_path,
+                [this]()
+                {
+                    int level = static_cast<int>(
+                        log_level.load(std::memory_order_relaxed));
+                    if (!parent_logger) return level;
+                    return std::min(level,
+                                    parent_logger->GetEffectiveLevel());
+                });
+        }
+
+        // Function to format and log a message
+        template<typename... Args>
+        void LogFormatted(LogLevel level,
+                          std::string_view format,
+                          const Args &...args)
+        {
+            // Check the level before formatting any argument
+            bool written = IsLevelEnabled(level);
+            if (!written)
+            {
+                root_logger->stats->CountFiltered(level);
+                if (!root_logger->flight_recording) return;
+            }
+
+            LogTextBuffer buffer;
+            buffer.Get().clear();
+            FormatLogMessage(buffer.Get(), format, args...);
+
+            Dispatch(level, component_prefix, buffer.Get(), force_console,
+                     written);
+        }
+
+        // Function to log a message with structured fields
+        template<typename... Fields>
+        void LogFieldsFrom(LogLevel level,
+                           const LogSite *site,
+                           std::string_view message,
+                           const Fields &...fields)
+        {
+            bool written = IsLevelEnabled(level);
+            if (!written)
+            {
+                root_logger->stats->CountFiltered(level);
+                if (!root_logger->flight_recording) return;
+            }
+
+            LogTextBuffer buffer;
+            std::string &text = buffer.Get();
+            text.assign(message);
+            std::size_t message_length = text.size();
+            FormatLogFields(text, fields...);
+
+            Dispatch(level, component_prefix, text, force_console, written,
+                     text.size() - message_length, site);
+        }
+
+        // Record a message in the flight recorder and emit it if written
+        void Dispatch(LogLevel level,
+                      std::string_view prefix,
+                      const std::string &message,
+                      bool console,
+                      bool written,
+                      std::size_t fields_length = 0,
+                      const LogSite *site = nullptr);
+
+        // Count a message that repeats the previous one, writing the
+        // summary of any run of repeats that ended; true if it repeats
+        bool Coalesce(LogLevel level,
+                      std::string_view prefix,
+                      const std::string &message,
+                      bool console);
+
+        // Write summaries of runs of repeated messages
+        void WriteRepeats(const std::vector<LogRepeat> &repeats);
+
+        // Write summaries of all runs of repeated messages
+        void FlushRepeats();
+
         // Function to emit the final log message
         virtual void EmitLog(LogLevel level,
                              const std::string &message,
                              bool console);
 
+        // Function to emit a message given as a component prefix and body
+        // ending with fields_length octets of fields, logged from the given
+        // call site (or nullptr), which by default are concatenated and
+        // passed to EmitLog() when writing text
+        virtual void EmitParts(LogLevel level,
+                               std::string_view prefix,
+                               const std::string &body,
+                               bool console,
+                               std::size_t fields_length,
+                               const LogSite *site);
+
+        // Write or queue a message logged at the given time
+        void EmitLogAt(LogLevel level,
+                       const std::string &message,
+                       bool console,
+                       const std::chrono::system_clock::time_point &time,
+                       const LogTextLayout &layout = {});
+
+        // Function to emit a binary log message
+        void EmitBinary(const BinaryFormat &format,
+                        const std::string &prefix,
+                        const std::string &arguments,
+                        bool console);
+
+        // Write a format record to the binary log
+        void WriteBinaryFormat(const BinaryFormat &format);
+
+        // Write an index record locating a binary message
+        void WriteBinaryIndex(const MappedLogPosition &position,
+                              std::int64_t timestamp);
+
+        // Write the clock's calibration to the binary log
+        void WriteBinaryClock();
+
+        // Read the clock, calibrating it if due
+        std::uint64_t ReadClock();
+
+        // Time at which a queued record was logged
+        std::chrono::system_clock::time_point GetRecordTime(
+                                        const LogRecord &record) const;
+
+        // Function to write a log message to the logging facility
+        void WriteLog(LogLevel level,
+                      std::string_view message,
+                      bool console,
+                      const std::chrono::system_clock::time_point &time,
+                      const LogTextLayout &layout = {});
+
+        // Function to write a record removed from the asynchronous queue
+        void WriteRecord(LogRecord &record);
+
+        // Create a sink for the given facility
+        std::shared_ptr<LogSink> CreateSink(LogFacility facility,
+                                            LogLevel level,
+                                            const std::string &filename,
+                                            const LogFlushPolicy &flush_policy);
+
+        // Release a sink that is no longer in the list of sinks
+        void ReleaseSink(std::shared_ptr<LogSink> sink);
+
+        // Recompute the most verbose level wanted by any sink
+        void UpdateSinkLevel();
+        int ComputeSinkLevel() const;
+
+        // Write buffered sink output if due, returning the interval
+        std::chrono::milliseconds FlushSinksIfDue();
+
+        // Interface used with LogFacility::Syslog
+        SyslogInterface &GetSyslogInterface();
+
         int MapLogLevelToSysLog(LogLevel level) const;
                                                 // Map log level to syslog level
-        std::string LogLevelString(LogLevel level) const;
+        std::string_view LogLevelString(LogLevel level) const;
                                                 // Log level string
-        std::string GetTimestamp() const;       // Return current timestamp
+        std::string GetTimestamp(
+            const std::chrono::system_clock::time_point &time) const;
+                                                // Return timestamp string
+        std::size_t FormatTimestamp(
+            const std::chrono::system_clock::time_point &time,
+            char *buffer) const;                // Write timestamp to buffer
         bool IsColorPossible() const;           // Is color output possible?
 
         std::string process_name;               // Program name for logging
         std::string component_name;             // Component name for logging
         LoggerPointer parent_logger;            // Parent logging object
+        Logger *root_logger;                    // Root of the parent chain
+        std::string component_prefix;           // Prefix of component names
+        std::string component_path;             // Component names joined
+                                                // by periods
         std::atomic<LogFacility> log_facility;  // Facility to which to log
         std::atomic<LogLevel> log_level;        // Log level to be logged
+        LogComponentLevel component_level;      // Level from the registry
+                                                // or the parent chain
 
         // Buffers used with streaming interface
         LoggingBuf info_buf;
@@ -352,61 +972,160 @@ class Logger : protected SyslogInterface
         LoggingBuf debug_buf;
         LoggingBuf console_buf;
 
-        std::mutex logger_mutex;        // Mutex to synchronize logging
-        std::ofstream log_file;         // Stream used for file logging
         bool output_to_console;         // Flag to force output to console
+        bool force_console;             // Any logger in chain forces console
         std::atomic<bool> colorize;     // Colorize console output
-        unsigned time_digits;           // Digits of precision beyond seconds
-        std::uint64_t time_modulo;      // Modulo to produce time digits
+        std::atomic<LogTimePrecision> time_precision;
+                                        // Digits of precision beyond seconds
+        std::atomic<LogTimeFormat> time_format;
+                                        // Format of the timestamp
+        std::atomic<LogOutputFormat> output_format;
+                                        // Format of lines written
+        std::atomic<bool> source_location;
+                                        // Write call sites with messages
+        std::size_t segment_size;       // Size of memory-mapped segments
+
+        // Sinks to which messages are written (root logger only)
+        std::shared_mutex sink_mutex;   // Protects the sinks
+        std::shared_ptr<LogSink> facility_sink;
+                                        // Sink for the logging facility
+        std::shared_ptr<ConsoleSink> console_sink;
+                                        // Sink for console messages
+        std::vector<std::shared_ptr<LogSink>> sinks;
+                                        // Sinks given to AddSink()
+        std::atomic<int> sink_level;    // Most verbose level of any sink,
+                                        // or -1 if there are no sinks
+        std::atomic<unsigned> syslog_users;
+                                        // Number of syslog sinks
+        std::shared_ptr<SyslogInterface> syslog_interface;
+                                        // Replaces the system's syslog
+
+        // Binary logging state (root logger only)
+        std::mutex binary_mutex;        // Mutex to open and close binary log
+        std::atomic<bool> binary_open;  // Is a binary log open?
+        std::atomic<std::uint64_t> binary_generation;
+                                        // Identifies the open binary log
+        MappedLogFile binary_file;      // Binary message segments
+        LogFile binary_formats;         // Binary format records
+
+        // Clock timing queued and binary messages (root logger only)
+        LogClock clock;
+
+        // Flight recorder state (root logger only)
+        std::unique_ptr<FlightRecorder> flight_recorder;
+                                        // Recent messages at every level
+        std::atomic<bool> flight_recording;
+                                        // Is the flight recorder enabled?
+
+        // Repeated message state (root logger only)
+        std::unique_ptr<LogCoalescer> coalescer;
+                                        // Counts repeated messages
+        std::atomic<bool> coalescing;   // Is coalescing enabled?
+
+        // Levels by component path (root logger only)
+        LogLevelRegistry level_registry;
+
+        // Statistics (root logger only)
+        std::unique_ptr<LogStatsCollector> stats;
+                                        // Counters updated by each thread
+
+        // Asynchronous logging state (root logger only)
+        AsyncLogQueue<LogRecord> async_queue;
+                                        // Records for the writer thread
 
     public:
         // Streaming interfaces
-        std::ostream info;
-        std::ostream warning;
-        std::ostream error;
-        std::ostream critical;
-        std::ostream debug;
-        std::ostream console;
+        LoggingStream info;
+        LoggingStream warning;
+        LoggingStream error;
+        LoggingStream critical;
+        LoggingStream debug;
+        LoggingStream console;
 };
 
 // CustomLogger used to help integrate with an existing logging system
 class CustomLogger : public Logger
 {
     public:
-        CustomLogger(std::function<void(LogLevel,
-                                        const std::string &,
-                                        bool)> callback) :
-            Logger(),
-            callback(callback)
-        {
-        }
+        // Receives each message's text, including the component prefix
+        using Callback = std::function<void(LogLevel,
+                                            const std::string &,
+                                            bool)>;
+
+        // Receives each message as separate parts
+        using PartsCallback = std::function<void(const LogMessageParts &)>;
+
+        // Receives messages in batches on a background thread
+        using BatchCallback = std::function<void(const LogMessageParts *,
+                                                 std::size_t)>;
+
+        static constexpr std::size_t Default_Queue_Capacity = 8192;
+        static constexpr std::size_t Default_Batch_Size = 256;
+
+        CustomLogger(Callback callback);
+        CustomLogger(const std::string &component_name, Callback callback);
+        CustomLogger(PartsCallback callback);
         CustomLogger(const std::string &component_name,
-                     std::function<void(LogLevel,
-                                        const std::string &,
-                                        bool)> callback) :
-            Logger(std::string(), component_name),
-            callback(callback)
-        {
-        }
-        virtual ~CustomLogger() = default;
+                     PartsCallback callback);
+        CustomLogger(BatchCallback callback,
+                     std::size_t queue_capacity = Default_Queue_Capacity,
+                     std::size_t batch_size = Default_Batch_Size,
+                     const LogQueuePolicy &policy = {});
+        CustomLogger(const std::string &component_name,
+                     BatchCallback callback,
+                     std::size_t queue_capacity = Default_Queue_Capacity,
+                     std::size_t batch_size = Default_Batch_Size,
+                     const LogQueuePolicy &policy = {});
+        virtual ~CustomLogger();
+
+        // Wait until all queued messages have been given to the callback
+        virtual void Flush() override;
+
+        // Number of messages discarded at each level due to a full queue
+        LogDropCounts GetBatchDropCounts() const;
 
     protected:
+        // Message copied into the batch queue
+        struct BatchRecord
+        {
+            LogLevel level;
+            bool console;
+            std::chrono::system_clock::time_point time;
+            LogRecordText text;         // Component prefix and body
+            std::size_t prefix_length;  // Length of the component prefix
+            const LogSite *site;        // Call site, if known
+        };
+
         virtual void EmitLog(LogLevel level,
                              const std::string &message,
-                             bool console) override
-        {
-            try
-            {
-                callback(level, message, console);
-            }
-            catch (...)
-            {
-                // Catch exceptions, but ignore since it's not safe to log
-            }
-        }
+                             bool console) override;
+
+        virtual void EmitParts(LogLevel level,
+                               std::string_view prefix,
+                               const std::string &body,
+                               bool console,
+                               std::size_t fields_length,
+                               const LogSite *site) override;
+
+        // Give a message to the parts callback or place it in the queue
+        void Deliver(const LogMessageParts &parts);
+
+        // Start the background thread delivering batches
+        void StartBatches(std::size_t queue_capacity,
+                          const LogQueuePolicy &policy);
+
+        // Give the messages collected so far to the batch callback
+        void DeliverBatch();
 
-        // Function to serve as a callback to receive logging output
-        std::function<void(LogLevel, const std::string &, bool)> callback;
+        Callback callback;              // Receives each message's text
+        PartsCallback parts_callback;   // Receives each message's parts
+        BatchCallback batch_callback;   // Receives batches of messages
+        std::size_t batch_size;         // Most messages in a batch
+        std::vector<BatchRecord> batch; // Messages collected for a batch
+        std::vector<LogMessageParts> batch_parts;
+                                        // Parts given to the batch callback
+        AsyncLogQueue<BatchRecord> batch_queue;
+                                        // Messages awaiting a batch
 };
 
 } // namespace cantina
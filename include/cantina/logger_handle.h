@@ -0,0 +1,351 @@
+/*
+ *  logger_handle.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the LoggerHandle class, a lightweight alternative to a
+ *      child Logger for applications that create a logger for each of a
+ *      great many components, such as one per session or per stream.
+ *
+ *      A LoggerHandle holds only its component prefix, its log level, and
+ *      a pointer to the Logger to which messages are given, sharing that
+ *      Logger's sinks and queue.  It has no stream buffers of its own.
+ *      Instead, the info, warning, error, critical, debug, and console
+ *      members are small objects that obtain a stream from a pool belonging
+ *      to the calling thread, which is returned to the pool when the
+ *      message is flushed:
+ *
+ *          LoggerHandle session_logger("Session 42", logger);
+ *          session_logger.info << "Joined" << std::flush;
+ *          session_logger.Info("rx seq={}", seq);
+ *
+ *      A LoggerHandle may be given to the logging macros by address (e.g.,
+ *      LOGGER_INFO(&session_logger, "Joined")).  A LoggerHandle created from
+ *      another LoggerHandle starts with that handle's log level, but does
+ *      not follow later changes to it.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+#include <string>
+#include "logger.h"
+
+namespace cantina
+{
+
+class LoggerHandle;
+
+// Streaming interface of a LoggerHandle at a given level
+template<LogLevel Level, bool Console = false>
+class LoggerHandleStream
+{
+    public:
+        explicit LoggerHandleStream(LoggerHandle *handle) : handle(handle) {}
+        LoggerHandleStream(const LoggerHandleStream &) = delete;
+        LoggerHandleStream &operator=(const LoggerHandleStream &) = delete;
+
+        template<typename T>
+        std::ostream &operator<<(const T &value)
+        {
+            return Stream() << value;
+        }
+
+        std::ostream &operator<<(std::ostream &(*manipulator)(std::ostream &))
+        {
+            return Stream() << manipulator;
+        }
+
+    protected:
+        std::ostream &Stream();
+
+        LoggerHandle *handle;           // Handle to which messages are given
+};
+
+// Lightweight component logger sharing the buffers and sinks of a Logger
+class LoggerHandle
+{
+    public:
+        LoggerHandle(const std::string &component_name,
+                     const LoggerPointer &parent_logger,
+                     bool output_to_console = false);
+        LoggerHandle(const std::string &component_name,
+                     const LoggerHandle &parent_handle,
+                     bool output_to_console = false);
+
+        // Streams refer to the handle, so it may not be copied
+        LoggerHandle(const LoggerHandle &) = delete;
+        LoggerHandle &operator=(const LoggerHandle &) = delete;
+
+        ~LoggerHandle() = default;
+
+        // Function to log messages
+        void Log(LogLevel level,
+                 const std::string &message,
+                 bool console = false);
+
+        // Function to log messages using LogLevel::INFO
+        void Log(const std::string &message);
+
+        // Function to log messages from a call site (see LOGGER_SITE)
+        void Log(const LogSite &site, const std::string &message);
+
+        // Functions to log formatted messages (e.g., Info("x={}", x))
+        template<typename... Args>
+        void Critical(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Critical, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Error(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Error, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Warning(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Warning, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Info(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Info, format.Get(), args...);
+        }
+
+        template<typename... Args>
+        void Debug(LogFormat<Args...> format, const Args &...args)
+        {
+            LogFormatted(LogLevel::Debug, format.Get(), args...);
+        }
+
+        // Function to log a message followed by structured fields given
+        // as pairs of names and values (see LOGGER_INFO_KV)
+        template<typename... Fields>
+        void LogFields(LogLevel level,
+                       std::string_view message,
+                       const Fields &...fields)
+        {
+            LogFieldsFrom(level, nullptr, message, fields...);
+        }
+
+        // Function to log a message with structured fields from a call site
+        template<typename... Fields>
+        void LogFields(const LogSite &site,
+                       std::string_view message,
+                       const Fields &...fields)
+        {
+            LogFieldsFrom(site.level, &site, message, fields...);
+        }
+
+        // Function to log messages in binary form (see LOGGER_INFO_BINARY)
+        template<typename... Args>
+        void LogBinary(const BinaryFormat &format,
+                       const char *,
+                       const Args &...args)
+        {
+            static thread_local std::string arguments;
+
+            Logger *root_logger = parent_logger->root_logger;
+            LogStatsCollector &collector = *root_logger->stats;
+
+            if (!IsLevelEnabled(format.level))
+            {
+                collector.CountFiltered(format.level);
+                return;
+            }
+
+            auto start = collector.StartEmit();
+
+            arguments.clear();
+            (EncodeBinaryArgument(arguments, args), ...);
+
+            root_logger->EmitBinary(format,
+                                    component_prefix,
+                                    arguments,
+                                    force_console);
+
+            collector.CountEmitted(format.level, start);
+        }
+
+        // Set the log level to be output (default is that of the parent)
+        void SetLogLevel(LogLevel level);
+
+        // Get the current log level
+        LogLevel GetLogLevel() const;
+
+        // Path of component names used with Logger::SetComponentLevels()
+        const std::string &GetComponentPath() const { return component_path; }
+
+        // Check to see if debug messages are to be logged
+        bool IsDebugging() const;
+
+        // Check to see if messages at the given level are to be logged
+        bool ShouldLog(LogLevel level) const
+        {
+            return IsLevelEnabled(level) ||
+                   parent_logger->root_logger->flight_recording.load(
+                       std::memory_order_relaxed);
+        }
+
+        // Get the streaming logger interface
+        std::ostream &GetLoggingStream(LogLevel level);
+
+        // Get the streaming interface for the given level and console flag
+        std::ostream &GetLoggingStream(LogLevel level, bool console);
+
+        // Wait until all queued log messages have been written
+        void Flush();
+
+    protected:
+        // Do this handle and its parent loggers log messages at this level?
+        bool IsLevelEnabled(LogLevel level) const
+        {
+            return (static_cast<int>(level) <= GetEffectiveLevel()) &&
+                   (static_cast<int>(level) <=
+                    parent_logger->root_logger->sink_level.load(
+                        std::memory_order_relaxed));
+        }
+
+        // Level given to this component by SetComponentLevels(), or else
+        // the least verbose of the levels of this handle and its parents
+        int GetEffectiveLevel() const
+        {
+            return component_level.Get(
+                parent_logger->root_logger->level_registry,
+                component_path,
+                [this]()
+                {
+                    return std::min(
+                        static_cast<int>(
+                            log_level.load(std::memory_order_relaxed)),
+                        parent_logger->GetEffectiveLevel());
+                });
+        }
+
+        // Function to format and log a message
+        template<typename... Args>
+        void LogFormatted(LogLevel level,
+                          std::string_view format,
+                          const Args &...args)
+        {
+            // Check the level before formatting any argument
+            bool written = IsLevelEnabled(level);
+            if (!written)
+            {
+                Logger *root_logger = parent_logger->root_logger;
+                root_logger->stats->CountFiltered(level);
+                if (!root_logger->flight_recording) return;
+            }
+
+            LogTextBuffer buffer;
+            buffer.Get().clear();
+            FormatLogMessage(buffer.Get(), format, args...);
+
+            parent_logger->Dispatch(level,
+                                    component_prefix,
+                                    buffer.Get(),
+                                    force_console,
+                                    written);
+        }
+
+        // Function to log a message with structured fields
+        template<typename... Fields>
+        void LogFieldsFrom(LogLevel level,
+                           const LogSite *site,
+                           std::string_view message,
+                           const Fields &...fields)
+        {
+            bool written = IsLevelEnabled(level);
+            if (!written)
+            {
+                Logger *root_logger = parent_logger->root_logger;
+                root_logger->stats->CountFiltered(level);
+                if (!root_logger->flight_recording) return;
+            }
+
+            LogTextBuffer buffer;
+            std::string &text = buffer.Get();
+            text.assign(message);
+            std::size_t message_length = text.size();
+            FormatLogFields(text, fields...);
+
+            parent_logger->Dispatch(level,
+                                    component_prefix,
+                                    text,
+                                    force_console,
+                                    written,
+                                    text.size() - message_length,
+                                    site);
+        }
+
+        LoggerPointer parent_logger;    // Logger to which messages are given
+        std::string component_prefix;   // Prefix of component names
+        std::string component_path;     // Component names joined by periods
+        std::atomic<LogLevel> log_level;
+                                        // Log level to be logged
+        LogComponentLevel component_level;
+                                        // Level from the registry
+        bool force_console;             // Any logger in chain forces console
+        std::uint64_t stream_id;        // Identifies the handle's streams
+
+    public:
+        // Streaming interfaces
+        LoggerHandleStream<LogLevel::Info> info;
+        LoggerHandleStream<LogLevel::Warning> warning;
+        LoggerHandleStream<LogLevel::Error> error;
+        LoggerHandleStream<LogLevel::Critical> critical;
+        LoggerHandleStream<LogLevel::Debug> debug;
+        LoggerHandleStream<LogLevel::Info, true> console;
+};
+
+template<LogLevel Level, bool Console>
+std::ostream &LoggerHandleStream<Level, Console>::Stream()
+{
+    return handle->GetLoggingStream(Level, Console);
+}
+
+} // namespace cantina
@@ -39,8 +39,49 @@
  *
  *          LOGGER_DEBUG(logger, "ID: " << id << ", Length: " << length)
  *
- *      Note that "std::flush" is appended, so there is no need to explicitly
- *      attempt to flush the output stream when using these macros.
+ *      Note that the message is formatted into one of the calling thread's
+ *      reusable streams (see log_site.h), whose formatting flags are reset
+ *      for each message, so there is no need to flush the stream or to
+ *      restore manipulators such as std::hex when using these macros.
+ *
+ *      Each macro other than LOGGER_X_BINARY() also defines a static
+ *      constexpr LogSite describing its call site (level, file, line, and
+ *      function), which is given to the Logger with the message.  The
+ *      source location is written with each message if enabled with
+ *      Logger::ShowSourceLocation() and is given to a CustomLogger's
+ *      callback in LogMessageParts::site.
+ *
+ *      Messages that are compiled in are also checked against the Logger's
+ *      current log level before the message expression is evaluated, so a
+ *      disabled debug message costs only a single comparison at runtime.
+ *      Since the logger parameter is evaluated more than once, it should
+ *      not be an expression with side effects.
+ *
+ *      The LOGGER_X_EVERY_N(), LOGGER_X_FIRST_N(), and LOGGER_X_RATE_LIMITED()
+ *      macros additionally limit how often a message at a single call site
+ *      is logged, using lock-free counters held statically at that site:
+ *          LOGGER_WARNING_EVERY_N(logger, 1000, "Bad packet from " << peer)
+ *          LOGGER_INFO_FIRST_N(logger, 10, "Unknown option " << option)
+ *          LOGGER_ERROR_RATE_LIMITED(logger, 5, "Send failed: " << error)
+ *
+ *      The message expression is not evaluated when a message is suppressed.
+ *      For LOGGER_X_EVERY_N() and LOGGER_X_RATE_LIMITED(), the number of
+ *      messages suppressed in the interim is appended to the next message
+ *      logged (e.g., "(suppressed 999 messages)"), so it is reported only
+ *      if another message gets through.  LOGGER_X_FIRST_N() never logs
+ *      again once its limit is reached, so it never reports suppression.
+ *
+ *      The LOGGER_X_BINARY() macros take a format string using "{}" as the
+ *      placeholder for each argument, followed by the arguments:
+ *          LOGGER_INFO_BINARY(logger, "Seq: {}, Length: {}", seq, length)
+ *
+ *      Only the raw argument values are recorded; conversion to text is
+ *      deferred (see binary_log.h and Logger::SetBinaryLog()).
+ *
+ *      The LOGGER_X_KV() macros take a message followed by pairs of field
+ *      names and values, which are appended to the message as structured
+ *      fields (see log_fields.h):
+ *          LOGGER_INFO_KV(logger, "rx", "seq", seq, "bytes", length)
  *
  *  Portability Issues:
  *      None.
@@ -91,73 +132,376 @@
 #define LOGGER_LEVEL LOGGER_LEVEL_DEBUG
 #endif
 
+// Stream the message only if the logger would log at the given level,
+// logging it with a description of the call site
+#define LOGGER_STREAM(logger, level, message) \
+    ((!(logger)->ShouldLog(level)) ? \
+        static_cast<void>(0) : \
+        [&]() \
+        { \
+            static constexpr cantina::LogSite logger_site = \
+                LOGGER_SITE(level); \
+            cantina::LogStreamBuffer logger_site_stream; \
+            logger_site_stream.Stream() << message; \
+            (logger)->Log(logger_site, logger_site_stream.Text()); \
+        }())
+
+// Stream the message only if the logger would log at the given level and
+// the call site's limiter allows it, noting any messages suppressed
+#define LOGGER_STREAM_LIMITED(logger, level, decision, message) \
+    ((!(logger)->ShouldLog(level)) ? \
+        static_cast<void>(0) : \
+        [&]() \
+        { \
+            static constexpr cantina::LogSite logger_site = \
+                LOGGER_SITE(level); \
+            static cantina::LogSiteLimiter logger_site_limiter; \
+            if (!logger_site_limiter.decision) return; \
+            auto logger_site_suppressed = \
+                logger_site_limiter.TakeSuppressed(); \
+            cantina::LogStreamBuffer logger_site_stream; \
+            logger_site_stream.Stream() << message; \
+            if (logger_site_suppressed > 0) \
+            { \
+                logger_site_stream.Stream() << " (suppressed " \
+                                            << logger_site_suppressed \
+                                            << " messages)"; \
+            } \
+            (logger)->Log(logger_site, logger_site_stream.Text()); \
+        }())
+
+// Return the first of the given macro arguments
+#define LOGGER_FIRST_ARGUMENT(first, ...) first
+
+// Log a binary message only if the logger would log at the given level; the
+// first variadic argument is the format string, which must be a literal
+#define LOGGER_BINARY(logger, level, ...) \
+    ((!(logger)->ShouldLog(level)) ? \
+        static_cast<void>(0) : \
+        [&]() \
+        { \
+            static const cantina::BinaryFormat binary_format{ \
+                level, \
+                LOGGER_FIRST_ARGUMENT(__VA_ARGS__, 0), \
+                __FILE__, \
+                __LINE__, \
+                cantina::BinaryFormatId(LOGGER_FIRST_ARGUMENT(__VA_ARGS__, 0), \
+                                        __FILE__, \
+                                        __LINE__), \
+                {0}}; \
+            (logger)->LogBinary(binary_format, __VA_ARGS__); \
+        }())
+
+// Log a message with structured fields only if the logger would log at the
+// given level; the message is followed by pairs of field names and values
+#define LOGGER_FIELDS(logger, level, ...) \
+    ((!(logger)->ShouldLog(level)) ? \
+        static_cast<void>(0) : \
+        [&]() \
+        { \
+            static constexpr cantina::LogSite logger_site = \
+                LOGGER_SITE(level); \
+            (logger)->LogFields(logger_site, __VA_ARGS__); \
+        }())
+
 #if LOGGER_LEVEL <= LOGGER_LEVEL_CRITICAL
 
 #define LOGGER_CRITICAL(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Critical) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Critical, message)
+#define LOGGER_CRITICAL_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          EveryN(n), message)
+#define LOGGER_CRITICAL_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          FirstN(n), message)
+#define LOGGER_CRITICAL_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          RateLimited(per_second), message)
 #define LOGGER_ERROR(logger, message)
+#define LOGGER_ERROR_BINARY(logger, ...)
+#define LOGGER_ERROR_KV(logger, ...)
+#define LOGGER_ERROR_EVERY_N(logger, n, message)
+#define LOGGER_ERROR_FIRST_N(logger, n, message)
+#define LOGGER_ERROR_RATE_LIMITED(logger, per_second, message)
 #define LOGGER_WARNING(logger, message)
+#define LOGGER_WARNING_BINARY(logger, ...)
+#define LOGGER_WARNING_KV(logger, ...)
+#define LOGGER_WARNING_EVERY_N(logger, n, message)
+#define LOGGER_WARNING_FIRST_N(logger, n, message)
+#define LOGGER_WARNING_RATE_LIMITED(logger, per_second, message)
 #define LOGGER_INFO(logger, message)
+#define LOGGER_INFO_BINARY(logger, ...)
+#define LOGGER_INFO_KV(logger, ...)
+#define LOGGER_INFO_EVERY_N(logger, n, message)
+#define LOGGER_INFO_FIRST_N(logger, n, message)
+#define LOGGER_INFO_RATE_LIMITED(logger, per_second, message)
 #define LOGGER_DEBUG(logger, message)
+#define LOGGER_DEBUG_BINARY(logger, ...)
+#define LOGGER_DEBUG_KV(logger, ...)
+#define LOGGER_DEBUG_EVERY_N(logger, n, message)
+#define LOGGER_DEBUG_FIRST_N(logger, n, message)
+#define LOGGER_DEBUG_RATE_LIMITED(logger, per_second, message)
 
 #elif LOGGER_LEVEL <= LOGGER_LEVEL_ERROR
 
 #define LOGGER_CRITICAL(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Critical) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Critical, message)
+#define LOGGER_CRITICAL_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          EveryN(n), message)
+#define LOGGER_CRITICAL_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          FirstN(n), message)
+#define LOGGER_CRITICAL_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          RateLimited(per_second), message)
 #define LOGGER_ERROR(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Error) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Error, message)
+#define LOGGER_ERROR_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          EveryN(n), message)
+#define LOGGER_ERROR_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          FirstN(n), message)
+#define LOGGER_ERROR_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          RateLimited(per_second), message)
 #define LOGGER_WARNING(logger, message)
+#define LOGGER_WARNING_BINARY(logger, ...)
+#define LOGGER_WARNING_KV(logger, ...)
+#define LOGGER_WARNING_EVERY_N(logger, n, message)
+#define LOGGER_WARNING_FIRST_N(logger, n, message)
+#define LOGGER_WARNING_RATE_LIMITED(logger, per_second, message)
 #define LOGGER_INFO(logger, message)
+#define LOGGER_INFO_BINARY(logger, ...)
+#define LOGGER_INFO_KV(logger, ...)
+#define LOGGER_INFO_EVERY_N(logger, n, message)
+#define LOGGER_INFO_FIRST_N(logger, n, message)
+#define LOGGER_INFO_RATE_LIMITED(logger, per_second, message)
 #define LOGGER_DEBUG(logger, message)
+#define LOGGER_DEBUG_BINARY(logger, ...)
+#define LOGGER_DEBUG_KV(logger, ...)
+#define LOGGER_DEBUG_EVERY_N(logger, n, message)
+#define LOGGER_DEBUG_FIRST_N(logger, n, message)
+#define LOGGER_DEBUG_RATE_LIMITED(logger, per_second, message)
 
 #elif LOGGER_LEVEL <= LOGGER_LEVEL_WARNING
 
 #define LOGGER_CRITICAL(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Critical) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Critical, message)
+#define LOGGER_CRITICAL_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          EveryN(n), message)
+#define LOGGER_CRITICAL_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          FirstN(n), message)
+#define LOGGER_CRITICAL_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          RateLimited(per_second), message)
 #define LOGGER_ERROR(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Error) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Error, message)
+#define LOGGER_ERROR_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          EveryN(n), message)
+#define LOGGER_ERROR_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          FirstN(n), message)
+#define LOGGER_ERROR_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          RateLimited(per_second), message)
 #define LOGGER_WARNING(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Warning) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Warning, message)
+#define LOGGER_WARNING_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Warning, __VA_ARGS__)
+#define LOGGER_WARNING_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Warning, __VA_ARGS__)
+#define LOGGER_WARNING_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          EveryN(n), message)
+#define LOGGER_WARNING_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          FirstN(n), message)
+#define LOGGER_WARNING_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          RateLimited(per_second), message)
 #define LOGGER_INFO(logger, message)
+#define LOGGER_INFO_BINARY(logger, ...)
+#define LOGGER_INFO_KV(logger, ...)
+#define LOGGER_INFO_EVERY_N(logger, n, message)
+#define LOGGER_INFO_FIRST_N(logger, n, message)
+#define LOGGER_INFO_RATE_LIMITED(logger, per_second, message)
 #define LOGGER_DEBUG(logger, message)
+#define LOGGER_DEBUG_BINARY(logger, ...)
+#define LOGGER_DEBUG_KV(logger, ...)
+#define LOGGER_DEBUG_EVERY_N(logger, n, message)
+#define LOGGER_DEBUG_FIRST_N(logger, n, message)
+#define LOGGER_DEBUG_RATE_LIMITED(logger, per_second, message)
 
 #elif LOGGER_LEVEL <= LOGGER_LEVEL_INFO
 
 #define LOGGER_CRITICAL(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Critical) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Critical, message)
+#define LOGGER_CRITICAL_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          EveryN(n), message)
+#define LOGGER_CRITICAL_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          FirstN(n), message)
+#define LOGGER_CRITICAL_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          RateLimited(per_second), message)
 #define LOGGER_ERROR(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Error) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Error, message)
+#define LOGGER_ERROR_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          EveryN(n), message)
+#define LOGGER_ERROR_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          FirstN(n), message)
+#define LOGGER_ERROR_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          RateLimited(per_second), message)
 #define LOGGER_WARNING(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Warning) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Warning, message)
+#define LOGGER_WARNING_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Warning, __VA_ARGS__)
+#define LOGGER_WARNING_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Warning, __VA_ARGS__)
+#define LOGGER_WARNING_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          EveryN(n), message)
+#define LOGGER_WARNING_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          FirstN(n), message)
+#define LOGGER_WARNING_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          RateLimited(per_second), message)
 #define LOGGER_INFO(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Info) << message << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Info, message)
+#define LOGGER_INFO_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Info, __VA_ARGS__)
+#define LOGGER_INFO_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Info, __VA_ARGS__)
+#define LOGGER_INFO_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Info, \
+                          EveryN(n), message)
+#define LOGGER_INFO_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Info, \
+                          FirstN(n), message)
+#define LOGGER_INFO_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Info, \
+                          RateLimited(per_second), message)
 #define LOGGER_DEBUG(logger, message)
+#define LOGGER_DEBUG_BINARY(logger, ...)
+#define LOGGER_DEBUG_KV(logger, ...)
+#define LOGGER_DEBUG_EVERY_N(logger, n, message)
+#define LOGGER_DEBUG_FIRST_N(logger, n, message)
+#define LOGGER_DEBUG_RATE_LIMITED(logger, per_second, message)
 
 #else
 
 #define LOGGER_CRITICAL(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Critical) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Critical, message)
+#define LOGGER_CRITICAL_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          EveryN(n), message)
+#define LOGGER_CRITICAL_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          FirstN(n), message)
+#define LOGGER_CRITICAL_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Critical, \
+                          RateLimited(per_second), message)
 #define LOGGER_ERROR(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Error) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Error, message)
+#define LOGGER_ERROR_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_ERROR_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          EveryN(n), message)
+#define LOGGER_ERROR_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          FirstN(n), message)
+#define LOGGER_ERROR_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Error, \
+                          RateLimited(per_second), message)
 #define LOGGER_WARNING(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Warning) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Warning, message)
+#define LOGGER_WARNING_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Warning, __VA_ARGS__)
+#define LOGGER_WARNING_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Warning, __VA_ARGS__)
+#define LOGGER_WARNING_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          EveryN(n), message)
+#define LOGGER_WARNING_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          FirstN(n), message)
+#define LOGGER_WARNING_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Warning, \
+                          RateLimited(per_second), message)
 #define LOGGER_INFO(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Info) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Info, message)
+#define LOGGER_INFO_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Info, __VA_ARGS__)
+#define LOGGER_INFO_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Info, __VA_ARGS__)
+#define LOGGER_INFO_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Info, \
+                          EveryN(n), message)
+#define LOGGER_INFO_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Info, \
+                          FirstN(n), message)
+#define LOGGER_INFO_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Info, \
+                          RateLimited(per_second), message)
 #define LOGGER_DEBUG(logger, message) \
-    (logger)->GetLoggingStream(cantina::LogLevel::Debug) << message \
-    << std::flush
+    LOGGER_STREAM(logger, cantina::LogLevel::Debug, message)
+#define LOGGER_DEBUG_BINARY(logger, ...) \
+    LOGGER_BINARY(logger, cantina::LogLevel::Debug, __VA_ARGS__)
+#define LOGGER_DEBUG_KV(logger, ...) \
+    LOGGER_FIELDS(logger, cantina::LogLevel::Debug, __VA_ARGS__)
+#define LOGGER_DEBUG_EVERY_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Debug, \
+                          EveryN(n), message)
+#define LOGGER_DEBUG_FIRST_N(logger, n, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Debug, \
+                          FirstN(n), message)
+#define LOGGER_DEBUG_RATE_LIMITED(logger, per_second, message) \
+    LOGGER_STREAM_LIMITED(logger, cantina::LogLevel::Debug, \
+                          RateLimited(per_second), message)
 
 #endif
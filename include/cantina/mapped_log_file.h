@@ -0,0 +1,143 @@
+/*
+ *  mapped_log_file.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the MappedLogFile class, which writes log output into
+ *      a sequence of fixed-size, memory-mapped file segments.  Each record
+ *      is copied into the mapping at an offset reserved with an atomic
+ *      addition, so multiple threads may write concurrently without a
+ *      mutex.  When a segment is full, writing continues in a new segment
+ *      and the full segment is truncated to the length actually used once
+ *      every thread writing to it has finished.  Getting the data to disk
+ *      is left to the operating system's page cache.
+ *
+ *      Segments are named by appending a six-digit sequence number to the
+ *      base name given to Open() (e.g., "app.log.000000").  Opening a base
+ *      name for which segments exist continues with the next number.
+ *
+ *  Portability Issues:
+ *      Memory-mapped segments are supported only on POSIX systems.  On other
+ *      platforms, Open() will fail.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cantina
+{
+
+// Location of a record written to a MappedLogFile
+struct MappedLogPosition
+{
+    std::size_t sequence;               // Sequence number of the segment
+    std::size_t offset;                 // Offset within the segment
+};
+
+// Memory-mapped, segmented log file declaration
+class MappedLogFile
+{
+    public:
+        // Default size of each segment
+        static constexpr std::size_t Default_Segment_Size = 64 * 1024 * 1024;
+
+        MappedLogFile();
+        MappedLogFile(const MappedLogFile &) = delete;
+        ~MappedLogFile();
+
+        // Open the first segment
+        bool Open(const std::string &base_name,
+                  std::size_t segment_size = Default_Segment_Size);
+
+        // Is the file open?
+        bool IsOpen() const;
+
+        // Close the file, truncating the current segment
+        void Close();
+
+        // Write a record made of the given parts (safe for concurrent use),
+        // optionally reporting where it was written
+        bool Write(const std::string_view *parts,
+                   std::size_t count,
+                   MappedLogPosition *position = nullptr);
+
+        // Write a line of output, adding a trailing newline
+        bool WriteLine(std::string_view line);
+
+        // Return the name of the segment with the given sequence number
+        static std::string SegmentName(const std::string &base_name,
+                                       std::size_t sequence);
+
+    protected:
+        struct Segment
+        {
+            int fd = -1;                        // File descriptor
+            char *base = nullptr;               // Address of the mapping
+            std::size_t size = 0;               // Size of the mapping
+            std::size_t sequence = 0;           // Sequence number
+            std::atomic<std::size_t> reserved{0};
+                                                // Octets reserved so far
+            std::atomic<std::size_t> used{0};   // Octets used once full
+            std::atomic<unsigned> writers{0};   // Threads writing now
+            std::atomic<bool> retired{false};   // No longer current
+            std::atomic<bool> finalizing{false};// Being finalized
+            std::atomic<bool> finalized{false}; // Unmapped and truncated
+        };
+
+        Segment *NewSegment();
+        void RetireSegment(Segment *segment);
+        void FinalizeSegment(Segment *segment);
+        void ReleaseSegment(Segment *segment);
+
+        std::string base_name;                  // Base name of segments
+        std::size_t segment_size;               // Size of each segment
+        std::size_t next_sequence;              // Next segment number
+        std::atomic<Segment *> current;         // Segment being written
+        std::mutex segment_mutex;               // Mutex to roll segments
+        std::vector<std::unique_ptr<Segment>> segments;
+                                                // All segments opened
+};
+
+} // namespace cantina
@@ -0,0 +1,223 @@
+/*
+ *  mpsc_queue.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines a bounded, lock-free multi-producer/single-consumer
+ *      queue used by the Logger to hand log records from application
+ *      threads to a background writer thread.
+ *
+ *      The queue is a ring of cells, each carrying a sequence number that
+ *      tells producers and the consumer whether the cell is free or holds a
+ *      value for the current lap around the ring.  Producers reserve a cell
+ *      by advancing the shared enqueue position with a compare-and-swap.
+ *      Values are normally removed by a single consumer, but the dequeue
+ *      position is also advanced with a compare-and-swap so that a
+ *      producer finding the queue full may discard the oldest value.  The
+ *      capacity is always rounded up to a power of two.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace cantina
+{
+
+// Bounded multi-producer/single-consumer queue
+template<typename T>
+class MPSCQueue
+{
+    public:
+        MPSCQueue(std::size_t capacity) :
+            capacity(RoundCapacity(capacity)),
+            mask(this->capacity - 1),
+            cells(new Cell[this->capacity]),
+            enqueue_position(0),
+            dequeue_position(0)
+        {
+            for (std::size_t i = 0; i < this->capacity; i++)
+            {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPSCQueue(const MPSCQueue &) = delete;
+        MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+        ~MPSCQueue() = default;
+
+        // Attempt to insert a value, which is moved only on success
+        bool TryPush(T &&value)
+        {
+            Cell *cell;
+            std::size_t position =
+                enqueue_position.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                cell = &cells[position & mask];
+                std::size_t sequence =
+                    cell->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence) -
+                                  static_cast<std::ptrdiff_t>(position);
+
+                if (difference == 0)
+                {
+                    if (enqueue_position.compare_exchange_weak(
+                            position,
+                            position + 1,
+                            std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // The queue is full
+                    return false;
+                }
+                else
+                {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(position + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Remove a value from the queue
+        bool TryPop(T &value)
+        {
+            Cell *cell;
+            std::size_t position =
+                dequeue_position.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                cell = &cells[position & mask];
+                std::size_t sequence =
+                    cell->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence) -
+                                  static_cast<std::ptrdiff_t>(position + 1);
+
+                if (difference == 0)
+                {
+                    if (dequeue_position.compare_exchange_weak(
+                            position,
+                            position + 1,
+                            std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // The queue is empty
+                    return false;
+                }
+                else
+                {
+                    position = dequeue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            value = std::move(cell->value);
+            cell->sequence.store(position + capacity,
+                                 std::memory_order_release);
+
+            return true;
+        }
+
+        // Is the queue empty?
+        bool Empty() const
+        {
+            std::size_t position =
+                dequeue_position.load(std::memory_order_relaxed);
+            const Cell *cell = &cells[position & mask];
+
+            return cell->sequence.load(std::memory_order_acquire) !=
+                   position + 1;
+        }
+
+        // Approximate number of values in the queue
+        std::size_t Size() const
+        {
+            auto head = enqueue_position.load(std::memory_order_relaxed);
+            auto tail = dequeue_position.load(std::memory_order_relaxed);
+
+            return (head > tail) ? head - tail : 0;
+        }
+
+        std::size_t Capacity() const { return capacity; }
+
+    protected:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static std::size_t RoundCapacity(std::size_t requested)
+        {
+            std::size_t rounded = 2;
+
+            while (rounded < requested) rounded <<= 1;
+
+            return rounded;
+        }
+
+        const std::size_t capacity;             // Number of cells (power of 2)
+        const std::size_t mask;                 // Mask to map position to cell
+        std::unique_ptr<Cell[]> cells;          // Ring of cells
+
+        // Producer and consumer positions live on separate cache lines
+        alignas(64) std::atomic<std::size_t> enqueue_position;
+        alignas(64) std::atomic<std::size_t> dequeue_position;
+};
+
+} // namespace cantina
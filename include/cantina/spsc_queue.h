@@ -0,0 +1,166 @@
+/*
+ *  spsc_queue.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines a bounded, lock-free single-producer/single-consumer
+ *      queue.  The Logger's sharded asynchronous mode gives each producing
+ *      thread its own such queue, so that pushing a value writes only to
+ *      state owned by that thread.
+ *
+ *      The producer alone advances the tail position and the consumer alone
+ *      advances the head position, each on its own cache line.  Each side
+ *      keeps a cached copy of the other side's position and reads the
+ *      shared position only when the cached copy suggests the queue is full
+ *      (or empty), so most operations touch no cache line written by the
+ *      other thread.  The capacity is always rounded up to a power of two.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace cantina
+{
+
+// Bounded single-producer/single-consumer queue
+template<typename T>
+class SPSCQueue
+{
+    public:
+        SPSCQueue(std::size_t capacity) :
+            capacity(RoundCapacity(capacity)),
+            mask(this->capacity - 1),
+            cells(new T[this->capacity]),
+            tail(0),
+            cached_head(0),
+            head(0),
+            cached_tail(0)
+        {
+        }
+
+        SPSCQueue(const SPSCQueue &) = delete;
+        SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+        ~SPSCQueue() = default;
+
+        // Attempt to insert a value, which is moved only on success (called
+        // only by the producer)
+        bool TryPush(T &&value)
+        {
+            std::size_t position = tail.load(std::memory_order_relaxed);
+
+            if (position - cached_head >= capacity)
+            {
+                cached_head = head.load(std::memory_order_acquire);
+
+                // The queue is full
+                if (position - cached_head >= capacity) return false;
+            }
+
+            cells[position & mask] = std::move(value);
+            tail.store(position + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Remove a value from the queue (called only by the consumer)
+        bool TryPop(T &value)
+        {
+            std::size_t position = head.load(std::memory_order_relaxed);
+
+            if (position == cached_tail)
+            {
+                cached_tail = tail.load(std::memory_order_acquire);
+
+                // The queue is empty
+                if (position == cached_tail) return false;
+            }
+
+            value = std::move(cells[position & mask]);
+            head.store(position + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Is the queue empty?
+        bool Empty() const
+        {
+            return head.load(std::memory_order_acquire) ==
+                   tail.load(std::memory_order_acquire);
+        }
+
+        // Approximate number of values in the queue
+        std::size_t Size() const
+        {
+            auto position = tail.load(std::memory_order_relaxed);
+            auto removed = head.load(std::memory_order_relaxed);
+
+            return (position > removed) ? position - removed : 0;
+        }
+
+        std::size_t Capacity() const { return capacity; }
+
+    protected:
+        static std::size_t RoundCapacity(std::size_t requested)
+        {
+            std::size_t rounded = 2;
+
+            while (rounded < requested) rounded <<= 1;
+
+            return rounded;
+        }
+
+        const std::size_t capacity;             // Number of cells (power of 2)
+        const std::size_t mask;                 // Mask to map position to cell
+        std::unique_ptr<T[]> cells;             // Ring of values
+
+        // Producer and consumer positions live on separate cache lines
+        alignas(64) std::atomic<std::size_t> tail;
+        std::size_t cached_head;                // Head last read by producer
+        alignas(64) std::atomic<std::size_t> head;
+        std::size_t cached_tail;                // Tail last read by consumer
+};
+
+} // namespace cantina
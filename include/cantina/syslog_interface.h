@@ -64,6 +64,8 @@ class SyslogInterface
         virtual void closelog(void);
 
         virtual void syslog(int priority, const char *format, ...);
+
+        virtual void flushlog(void);
 };
 
 } // namespace cantina
@@ -0,0 +1,151 @@
+/*
+ *  syslog_sender.h
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This defines the SyslogSender class, a SyslogInterface that sends
+ *      RFC 5424 messages directly over a Unix datagram socket (e.g.,
+ *      "/dev/log") or over UDP or TCP to a remote collector, rather than
+ *      calling the C library's syslog() for each message.  The message
+ *      header fields that do not change (host name, application name,
+ *      process ID) are formatted once by openlog() and the timestamp is
+ *      formatted once per second.  Messages are collected into a batch
+ *      that is sent with a single sendmmsg() call (or a single write for
+ *      TCP, using octet-counting framing per RFC 6587) when the batch is
+ *      full, when an Error or Critical message is logged, or when
+ *      flushlog() or closelog() is called.
+ *
+ *  Portability Issues:
+ *      Only POSIX systems are supported.  Where sendmmsg() is unavailable,
+ *      each message in a batch is sent with its own sendmsg() call.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "syslog_interface.h"
+
+namespace cantina
+{
+
+// Transport used to send syslog messages
+enum class SyslogTransport
+{
+    UnixDatagram,                       // Local Unix datagram socket
+    UDP,                                // UDP (RFC 5426)
+    TCP                                 // TCP (RFC 6587 octet counting)
+};
+
+// Batched RFC 5424 syslog sender declaration
+class SyslogSender : public SyslogInterface
+{
+    public:
+        // Default local syslog socket
+        static constexpr const char *Default_Socket_Path = "/dev/log";
+
+        // Default port for UDP and TCP
+        static constexpr std::uint16_t Default_Port = 514;
+
+        // Default number of messages sent at once
+        static constexpr std::size_t Default_Batch_Size = 32;
+
+        // Default longest time a message waits for its batch to be sent
+        static constexpr std::chrono::milliseconds Default_Max_Batch_Age{1000};
+
+        // Longest message sent, including the header
+        static constexpr std::size_t Max_Message_Length = 2048;
+
+        SyslogSender(SyslogTransport transport = SyslogTransport::UnixDatagram,
+                     const std::string &address = Default_Socket_Path,
+                     std::uint16_t port = Default_Port,
+                     std::size_t batch_size = Default_Batch_Size,
+                     std::chrono::milliseconds max_batch_age =
+                         Default_Max_Batch_Age);
+        SyslogSender(const SyslogSender &) = delete;
+        virtual ~SyslogSender();
+
+        // Format the message header and connect to the collector
+        virtual void openlog(const char *ident,
+                             int option,
+                             int facility) override;
+
+        // Send any batched messages and close the connection
+        virtual void closelog(void) override;
+
+        // Add a message to the batch
+        virtual void syslog(int priority, const char *format, ...) override;
+
+        // Send any batched messages
+        virtual void flushlog(void) override;
+
+        // Is the sender connected to the collector?
+        bool IsOpen() const;
+
+    protected:
+        bool Connect();
+        void Disconnect();
+        void AppendTimestamp(std::string &message);
+        void SendBatch();
+        bool SendDatagrams();
+        bool SendStream();
+
+        SyslogTransport transport;      // Transport to use
+        std::string address;            // Socket path or collector host
+        std::uint16_t port;             // Collector port
+        std::size_t batch_size;         // Messages sent at once
+        std::chrono::steady_clock::duration max_batch_age;
+                                        // Longest a batch is held
+        int facility;                   // Facility given to openlog()
+        std::string header;             // Host, application, process ID
+        int socket_fd;                  // Connected socket
+        std::vector<std::string> batch; // Messages to be sent
+        std::size_t batched;            // Number of messages in the batch
+        std::chrono::steady_clock::time_point batch_start;
+                                        // Time the batch was started
+        std::time_t timestamp_second;   // Second of the cached timestamp
+        std::string timestamp;          // Timestamp less the fraction
+        mutable std::mutex sender_mutex;// Serializes access to the batch
+};
+
+} // namespace cantina
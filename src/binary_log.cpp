@@ -0,0 +1,223 @@
+/*
+ *  binary_log.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the functions used to convert encoded binary
+ *      log arguments back to text.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <string>
+#include "cantina/binary_log.h"
+#include "cantina/log_format.h"
+
+namespace cantina
+{
+
+/*
+ *  DecodeBinaryArgument
+ *
+ *  Description:
+ *      Append the text representation of the next encoded argument to the
+ *      output string and advance past the argument.
+ *
+ *  Parameters:
+ *      arguments [in/out]
+ *          The remaining encoded arguments.
+ *
+ *      output [out]
+ *          The string to which the argument's text is appended.
+ *
+ *  Returns:
+ *      True if an argument was decoded, false if there are no further
+ *      arguments or the encoding is invalid.
+ *
+ *  Comments:
+ *      None.
+ */
+bool DecodeBinaryArgument(std::string_view &arguments, std::string &output)
+{
+    if (arguments.empty()) return false;
+
+    auto type = static_cast<BinaryArgumentType>(arguments[0]);
+    arguments.remove_prefix(1);
+
+    // Copy a fixed-size value out of the arguments
+    auto take = [&](void *value, std::size_t length) -> bool
+    {
+        if (arguments.size() < length) return false;
+        std::memcpy(value, arguments.data(), length);
+        arguments.remove_prefix(length);
+        return true;
+    };
+
+    switch (type)
+    {
+        case BinaryArgumentType::Signed:
+        {
+            std::int64_t value;
+            if (!take(&value, sizeof(value))) return false;
+            AppendLogValue(output, value);
+            return true;
+        }
+
+        case BinaryArgumentType::Unsigned:
+        {
+            std::uint64_t value;
+            if (!take(&value, sizeof(value))) return false;
+            AppendLogValue(output, value);
+            return true;
+        }
+
+        case BinaryArgumentType::Floating:
+        {
+            double value;
+            if (!take(&value, sizeof(value))) return false;
+            AppendLogValue(output, value);
+            return true;
+        }
+
+        case BinaryArgumentType::Boolean:
+        {
+            std::uint8_t value;
+            if (!take(&value, sizeof(value))) return false;
+            AppendLogValue(output, value != 0);
+            return true;
+        }
+
+        case BinaryArgumentType::Character:
+        {
+            char value;
+            if (!take(&value, sizeof(value))) return false;
+            AppendLogValue(output, value);
+            return true;
+        }
+
+        case BinaryArgumentType::String:
+        {
+            std::uint32_t length;
+            if (!take(&length, sizeof(length))) return false;
+            if (arguments.size() < length) return false;
+            AppendLogValue(output, arguments.substr(0, length));
+            arguments.remove_prefix(length);
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/*
+ *  DecodeBinaryArguments
+ *
+ *  Description:
+ *      Produce the text of a message by replacing each "{}" placeholder in
+ *      the format string with the next encoded argument.
+ *
+ *  Parameters:
+ *      format [in]
+ *          The format string.
+ *
+ *      arguments [in]
+ *          The encoded arguments.
+ *
+ *  Returns:
+ *      The text of the message.
+ *
+ *  Comments:
+ *      A placeholder for which there is no argument is reproduced as is,
+ *      while arguments for which there is no placeholder are ignored.
+ */
+std::string DecodeBinaryArguments(std::string_view format,
+                                  std::string_view arguments)
+{
+    std::string output;
+
+    output.reserve(format.size() + arguments.size());
+
+    AppendBinaryArguments(output, format, arguments);
+
+    return output;
+}
+
+/*
+ *  AppendBinaryArguments
+ *
+ *  Description:
+ *      Append the text of a message to the output by replacing each "{}"
+ *      placeholder in the format string with the next encoded argument.
+ *
+ *  Parameters:
+ *      output [out]
+ *          The string to which the text is appended.
+ *
+ *      format [in]
+ *          The format string.
+ *
+ *      arguments [in]
+ *          The encoded arguments.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This allows the text to be produced in a reusable buffer.
+ */
+void AppendBinaryArguments(std::string &output,
+                           std::string_view format,
+                           std::string_view arguments)
+{
+    std::size_t position = 0;
+
+    // Append the text preceding each placeholder, then the argument
+    while (position != std::string_view::npos)
+    {
+        position = AppendLogLiteral(output, format, position);
+        if ((position != std::string_view::npos) &&
+            !DecodeBinaryArgument(arguments, output))
+        {
+            output += "{}";
+        }
+    }
+}
+
+} // namespace cantina
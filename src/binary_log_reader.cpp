@@ -0,0 +1,786 @@
+/*
+ *  binary_log_reader.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the BinaryLogReader class, which decodes the
+ *      messages in a binary log back to text.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include "cantina/binary_log_reader.h"
+#include "cantina/mapped_log_file.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+// Octets read from a file at a time
+constexpr std::size_t Read_Chunk_Size = 1024 * 1024;
+
+/*
+ *  ReadMore
+ *
+ *  Description:
+ *      Discard the consumed part of a buffer and append the next chunk of
+ *      a file to it.
+ *
+ *  Parameters:
+ *      file [in]
+ *          The file being read.
+ *
+ *      buffer [in/out]
+ *          The buffer holding data read from the file.
+ *
+ *      position [in/out]
+ *          The position within the buffer of the first unconsumed octet,
+ *          which is zero upon return.
+ *
+ *  Returns:
+ *      True if any data was read, false at the end of the file.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ReadMore(std::ifstream &file, std::string &buffer, std::size_t &position)
+{
+    buffer.erase(0, position);
+    position = 0;
+
+    std::size_t length = buffer.size();
+    buffer.resize(length + Read_Chunk_Size);
+    file.read(buffer.data() + length,
+              static_cast<std::streamsize>(Read_Chunk_Size));
+    buffer.resize(length + static_cast<std::size_t>(file.gcount()));
+
+    return buffer.size() > length;
+}
+
+} // namespace
+
+/*
+ *  BinaryLogReader::BinaryLogReader
+ *
+ *  Description:
+ *      Constructor for the BinaryLogReader object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+BinaryLogReader::BinaryLogReader() :
+    formats_offset(0),
+    segment_count(0),
+    clock_source(LogClockSource::System)
+{
+}
+
+/*
+ *  BinaryLogReader::Open
+ *
+ *  Description:
+ *      Open a binary log, reading its formats file and finding its
+ *      segments.
+ *
+ *  Parameters:
+ *      base_name [in]
+ *          The name given to Logger::SetBinaryLog() when the log was
+ *          written.
+ *
+ *  Returns:
+ *      True if the formats file or the first segment exists, false
+ *      otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool BinaryLogReader::Open(const std::string &base_name)
+{
+    this->base_name = base_name;
+    formats_offset = 0;
+    segment_count = 0;
+    formats.clear();
+    clock_source = LogClockSource::System;
+    calibrations.clear();
+    index.clear();
+
+    Refresh();
+
+    return (formats_offset > 0) || (segment_count > 0) ||
+           std::ifstream(base_name + std::string(Binary_Formats_Suffix))
+               .good();
+}
+
+/*
+ *  BinaryLogReader::Refresh
+ *
+ *  Description:
+ *      Read any records added to the formats file and find any segments
+ *      added since the log was opened or last refreshed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This must not be called while another thread is reading messages.
+ */
+void BinaryLogReader::Refresh()
+{
+    ReadFormats();
+
+    while (Exists(segment_count)) segment_count++;
+
+    if (index.size() < segment_count) index.resize(segment_count);
+}
+
+/*
+ *  BinaryLogReader::GetSegmentSize
+ *
+ *  Description:
+ *      Return the present size of a segment.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The sequence number of the segment.
+ *
+ *  Returns:
+ *      The size of the segment's file, or zero if it does not exist.
+ *
+ *  Comments:
+ *      A segment being written has the full segment size until the Logger
+ *      moves on to the next segment, when it is truncated to the length
+ *      used.  A reader following the log has thus read all of a segment
+ *      once it has read this many octets and a later segment exists.
+ */
+std::size_t BinaryLogReader::GetSegmentSize(std::size_t segment) const
+{
+    std::ifstream file(MappedLogFile::SegmentName(base_name, segment),
+                       std::ios::binary | std::ios::ate);
+
+    if (!file.good()) return 0;
+
+    return static_cast<std::size_t>(file.tellg());
+}
+
+/*
+ *  BinaryLogReader::GetStartTime
+ *
+ *  Description:
+ *      Return the time of the first message in the log.
+ *
+ *  Parameters:
+ *      time [out]
+ *          The time of the first message in nanoseconds since the epoch.
+ *
+ *  Returns:
+ *      True if the log holds a message, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool BinaryLogReader::GetStartTime(std::int64_t &time) const
+{
+    for (std::size_t segment = 0; segment < segment_count; segment++)
+    {
+        std::ifstream file(MappedLogFile::SegmentName(base_name, segment),
+                           std::ios::binary);
+        BinaryRecordHeader header;
+
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            (header.length < sizeof(header)))
+        {
+            continue;
+        }
+
+        time = ToNanoseconds(header.timestamp);
+
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ *  BinaryLogReader::ToNanoseconds
+ *
+ *  Description:
+ *      Convert the timestamp in a message or index record to nanoseconds
+ *      since the epoch.
+ *
+ *  Parameters:
+ *      timestamp [in]
+ *          The recorded timestamp.
+ *
+ *  Returns:
+ *      The time of the record in nanoseconds since the epoch.
+ *
+ *  Comments:
+ *      A raw clock value is converted using the latest calibration taken
+ *      at or before it, or the first calibration if it precedes them all.
+ */
+std::int64_t BinaryLogReader::ToNanoseconds(std::int64_t timestamp) const
+{
+    if ((clock_source == LogClockSource::System) || calibrations.empty())
+    {
+        return timestamp;
+    }
+
+    auto ticks = static_cast<std::uint64_t>(timestamp);
+    auto next = std::upper_bound(calibrations.begin(),
+                                 calibrations.end(),
+                                 ticks,
+                                 [](std::uint64_t value,
+                                    const LogClockCalibration &calibration)
+                                 {
+                                     return value < calibration.ticks;
+                                 });
+    if (next != calibrations.begin()) --next;
+
+    return next->ToNanoseconds(ticks);
+}
+
+/*
+ *  BinaryLogReader::Seek
+ *
+ *  Description:
+ *      Use a segment's index to find the range of the segment that holds
+ *      messages in the filter's time range.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The sequence number of the segment.
+ *
+ *      filter [in]
+ *          The filter giving the time range.
+ *
+ *      begin [out]
+ *          The offset from which to read.
+ *
+ *      stop [out]
+ *          The offset at which to stop reading, or End_Offset.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Reading begins one index entry before the last entry timed before
+ *      the start of the range and stops one entry after the first entry
+ *      timed after its end, since a message may be timed slightly before
+ *      or after the messages written on either side of it.  Without an
+ *      index, the whole segment is read.
+ */
+void BinaryLogReader::Seek(std::size_t segment,
+                           const BinaryLogFilter &filter,
+                           std::size_t &begin,
+                           std::size_t &stop) const
+{
+    begin = 0;
+    stop = End_Offset;
+
+    if (segment >= index.size()) return;
+
+    const auto &entries = index[segment];
+    std::size_t first = 0;
+    bool before_start = false;
+
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        std::int64_t time = ToNanoseconds(entries[i].timestamp);
+
+        if (time < filter.start)
+        {
+            first = i;
+            before_start = true;
+        }
+        else if (time > filter.end)
+        {
+            if (i + 1 < entries.size()) stop = entries[i + 1].offset;
+            break;
+        }
+    }
+
+    if (before_start && (first > 0)) begin = entries[first - 1].offset;
+}
+
+/*
+ *  BinaryLogReader::ReadSegment
+ *
+ *  Description:
+ *      Read the matching messages from part of a segment.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The sequence number of the segment.
+ *
+ *      begin [in]
+ *          The offset of the first record to read.
+ *
+ *      stop [in]
+ *          The offset at or beyond which no record is read, or End_Offset.
+ *
+ *      filter [in]
+ *          The filter selecting messages.
+ *
+ *      entries [out]
+ *          The vector to which matching messages are appended.
+ *
+ *      live [in]
+ *          Whether the segment may still be written.  If so, reading stops
+ *          at a message whose format record has not yet been read, so that
+ *          it may be read again after Refresh().
+ *
+ *  Returns:
+ *      The offset following the last record read.
+ *
+ *  Comments:
+ *      Reading stops at the end of the file, at a record that is not
+ *      complete, or where no record has yet been written (the unused part
+ *      of a segment is zero-filled).  Messages whose format is unknown are
+ *      otherwise given a text naming the format's identifier.
+ */
+std::size_t BinaryLogReader::ReadSegment(
+                                    std::size_t segment,
+                                    std::size_t begin,
+                                    std::size_t stop,
+                                    const BinaryLogFilter &filter,
+                                    std::vector<BinaryLogEntry> &entries,
+                                    bool live) const
+{
+    std::ifstream file(MappedLogFile::SegmentName(base_name, segment),
+                       std::ios::binary);
+    std::string buffer;
+    std::size_t position = 0;
+    std::size_t offset = begin;
+    std::string component_prefix;
+
+    if (!file.good()) return offset;
+    file.seekg(static_cast<std::streamoff>(begin));
+
+    // Child loggers add "[Name] " to the prefix for each component
+    if (!filter.component.empty())
+    {
+        std::size_t start = 0;
+        while (start <= filter.component.size())
+        {
+            std::size_t dot = filter.component.find('.', start);
+            if (dot == std::string::npos) dot = filter.component.size();
+            component_prefix += '[';
+            component_prefix.append(filter.component, start, dot - start);
+            component_prefix += "] ";
+            start = dot + 1;
+        }
+    }
+
+    while (offset < stop)
+    {
+        BinaryRecordHeader header;
+
+        if (buffer.size() - position < sizeof(header))
+        {
+            if (!ReadMore(file, buffer, position)) break;
+            continue;
+        }
+
+        std::memcpy(&header, buffer.data() + position, sizeof(header));
+        if ((header.length < sizeof(header)) ||
+            (header.prefix_length > header.length - sizeof(header)))
+        {
+            break;
+        }
+
+        if (buffer.size() - position < header.length)
+        {
+            if (!ReadMore(file, buffer, position)) break;
+            continue;
+        }
+
+        std::string_view record(buffer.data() + position + sizeof(header),
+                                header.length - sizeof(header));
+        std::string_view prefix = record.substr(0, header.prefix_length);
+        std::int64_t time;
+
+        if (Matches(header, prefix, filter, component_prefix, time))
+        {
+            auto format = formats.find(header.format_id);
+
+            if (live && (format == formats.end())) break;
+
+            BinaryLogEntry entry{time,
+                                 static_cast<LogLevel>(header.level),
+                                 std::string(prefix),
+                                 {}};
+            if (format != formats.end())
+            {
+                AppendBinaryArguments(entry.text,
+                                      format->second,
+                                      record.substr(header.prefix_length));
+            }
+            else
+            {
+                entry.text = "(unknown format " +
+                             std::to_string(header.format_id) + ")";
+            }
+            entries.push_back(std::move(entry));
+        }
+
+        position += header.length;
+        offset += header.length;
+    }
+
+    return offset;
+}
+
+/*
+ *  BinaryLogReader::Read
+ *
+ *  Description:
+ *      Read the matching messages from every segment, decoding segments
+ *      in parallel.
+ *
+ *  Parameters:
+ *      filter [in]
+ *          The filter selecting messages.
+ *
+ *      callback [in]
+ *          The function given the messages from each segment, called for
+ *          the segments in order on the calling thread.
+ *
+ *      threads [in]
+ *          The number of segments decoded at once, each by its own thread,
+ *          or 0 for the number of processors.
+ *
+ *  Returns:
+ *      The offset following the last record read from the last segment,
+ *      from which a reader following the log may continue.
+ *
+ *  Comments:
+ *      Segments are decoded in batches of the given number, so that the
+ *      memory used is bounded by the messages of that many segments.
+ */
+std::size_t BinaryLogReader::Read(const BinaryLogFilter &filter,
+                                  const BinaryLogCallback &callback,
+                                  unsigned threads) const
+{
+    std::size_t last_offset = 0;
+
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(),
+                                         1U);
+
+    for (std::size_t first = 0; first < segment_count; first += threads)
+    {
+        std::size_t count = std::min<std::size_t>(threads,
+                                                  segment_count - first);
+        std::vector<std::vector<BinaryLogEntry>> results(count);
+        std::vector<std::size_t> offsets(count);
+        std::vector<std::thread> workers;
+
+        auto decode = [&](std::size_t i)
+        {
+            std::size_t begin;
+            std::size_t stop;
+
+            Seek(first + i, filter, begin, stop);
+            offsets[i] = ReadSegment(first + i,
+                                     begin,
+                                     stop,
+                                     filter,
+                                     results[i]);
+        };
+
+        // The calling thread decodes the last segment of each batch
+        for (std::size_t i = 0; i + 1 < count; i++)
+        {
+            workers.emplace_back(decode, i);
+        }
+        decode(count - 1);
+        for (auto &worker : workers) worker.join();
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            callback(first + i, results[i]);
+        }
+        last_offset = offsets[count - 1];
+    }
+
+    return last_offset;
+}
+
+/*
+ *  BinaryLogReader::Exists
+ *
+ *  Description:
+ *      Determine whether a segment exists.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The sequence number of the segment.
+ *
+ *  Returns:
+ *      True if the segment's file exists, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool BinaryLogReader::Exists(std::size_t segment) const
+{
+    return std::ifstream(MappedLogFile::SegmentName(base_name, segment),
+                         std::ios::binary).good();
+}
+
+/*
+ *  BinaryLogReader::ReadFormats
+ *
+ *  Description:
+ *      Read the complete records added to the formats file since it was
+ *      last read.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A record not yet completely written is read by a later call.
+ */
+void BinaryLogReader::ReadFormats()
+{
+    std::ifstream file(base_name + std::string(Binary_Formats_Suffix),
+                       std::ios::binary);
+    std::string buffer;
+    std::size_t position = 0;
+
+    if (!file.good()) return;
+    file.seekg(static_cast<std::streamoff>(formats_offset));
+
+    while (true)
+    {
+        BinaryRecordHeader header;
+
+        if (buffer.size() - position < sizeof(header))
+        {
+            if (!ReadMore(file, buffer, position)) break;
+            continue;
+        }
+
+        std::memcpy(&header, buffer.data() + position, sizeof(header));
+        if (header.length < sizeof(header)) break;
+
+        if (buffer.size() - position < header.length)
+        {
+            if (!ReadMore(file, buffer, position)) break;
+            continue;
+        }
+
+        AddRecord(header, buffer.data() + position + sizeof(header));
+
+        position += header.length;
+        formats_offset += header.length;
+    }
+}
+
+/*
+ *  BinaryLogReader::AddRecord
+ *
+ *  Description:
+ *      Add a format, clock, or index record read from the formats file.
+ *
+ *  Parameters:
+ *      header [in]
+ *          The record's header.
+ *
+ *      body [in]
+ *          The record's contents following the header, which are
+ *          header.length - sizeof(header) octets long.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Records of unknown types are ignored.
+ */
+void BinaryLogReader::AddRecord(const BinaryRecordHeader &header,
+                                const char *body)
+{
+    std::size_t length = header.length - sizeof(header);
+
+    switch (static_cast<BinaryRecordType>(header.type))
+    {
+        case BinaryRecordType::Format:
+        {
+            BinaryFormatBody format;
+
+            if (length < sizeof(format)) break;
+            std::memcpy(&format, body, sizeof(format));
+            if (sizeof(format) + std::size_t(format.file_length) +
+                    format.format_length > length)
+            {
+                break;
+            }
+
+            formats[header.format_id].assign(
+                body + sizeof(format) + format.file_length,
+                format.format_length);
+            break;
+        }
+
+        case BinaryRecordType::Clock:
+        {
+            BinaryClockBody clock;
+
+            if (length < sizeof(clock)) break;
+            std::memcpy(&clock, body, sizeof(clock));
+
+            // Only the calibrations of the latest clock apply
+            auto source = static_cast<LogClockSource>(header.level);
+            if (source != clock_source) calibrations.clear();
+            clock_source = source;
+
+            LogClockCalibration calibration{clock.ticks,
+                                            header.timestamp,
+                                            clock.nanoseconds_per_tick};
+            auto next = std::upper_bound(
+                calibrations.begin(),
+                calibrations.end(),
+                calibration.ticks,
+                [](std::uint64_t value, const LogClockCalibration &other)
+                {
+                    return value < other.ticks;
+                });
+            calibrations.insert(next, calibration);
+            break;
+        }
+
+        case BinaryRecordType::Index:
+        {
+            BinaryIndexBody entry;
+
+            if (length < sizeof(entry)) break;
+            std::memcpy(&entry, body, sizeof(entry));
+
+            // Threads may write index records slightly out of order
+            auto segment = static_cast<std::size_t>(header.format_id);
+            if (index.size() <= segment) index.resize(segment + 1);
+            auto &entries = index[segment];
+            auto offset = static_cast<std::size_t>(entry.offset);
+            auto next = std::upper_bound(
+                entries.begin(),
+                entries.end(),
+                offset,
+                [](std::size_t value, const IndexEntry &other)
+                {
+                    return value < other.offset;
+                });
+            entries.insert(next, {offset, header.timestamp});
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/*
+ *  BinaryLogReader::Matches
+ *
+ *  Description:
+ *      Determine whether a record is a message selected by the filter.
+ *
+ *  Parameters:
+ *      header [in]
+ *          The record's header.
+ *
+ *      prefix [in]
+ *          The message's component prefix.
+ *
+ *      filter [in]
+ *          The filter selecting messages.
+ *
+ *      component_prefix [in]
+ *          The prefix produced by the filter's component, or empty.
+ *
+ *      time [out]
+ *          The time of the message in nanoseconds since the epoch.
+ *
+ *  Returns:
+ *      True if the message is selected, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool BinaryLogReader::Matches(const BinaryRecordHeader &header,
+                              std::string_view prefix,
+                              const BinaryLogFilter &filter,
+                              std::string_view component_prefix,
+                              std::int64_t &time) const
+{
+    if ((header.type != static_cast<std::uint8_t>(BinaryRecordType::Message))
+        || (header.level > static_cast<std::uint8_t>(filter.level)))
+    {
+        return false;
+    }
+
+    if (!component_prefix.empty() &&
+        (prefix.find(component_prefix) == std::string_view::npos))
+    {
+        return false;
+    }
+
+    time = ToNanoseconds(header.timestamp);
+
+    return (time >= filter.start) && (time <= filter.end);
+}
+
+} // namespace cantina
@@ -0,0 +1,574 @@
+/*
+ *  custom_logger.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the CustomLogger class, which passes each message to
+ *      a function provided by the application so that messages may be
+ *      given to an existing logging system.  The function may receive the
+ *      text of each message, the parts of each message (level, timestamp,
+ *      component prefix, and body) without their being concatenated, or
+ *      batches of messages' parts gathered by a background thread.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include "cantina/logger.h"
+
+namespace cantina
+{
+
+/*
+ *  CustomLogger::CustomLogger
+ *
+ *  Description:
+ *      Constructor for a CustomLogger passing each message's text to the
+ *      given function.
+ *
+ *  Parameters:
+ *      callback [in]
+ *          The function receiving the level, the text including the
+ *          component prefix, and the console flag of each message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+CustomLogger::CustomLogger(Callback callback) :
+    Logger(),
+    callback(std::move(callback)),
+    batch_size(0)
+{
+}
+
+/*
+ *  CustomLogger::CustomLogger
+ *
+ *  Description:
+ *      Constructor for a CustomLogger having a component name and passing
+ *      each message's text to the given function.
+ *
+ *  Parameters:
+ *      component_name [in]
+ *          The name of the component to print in log messages.
+ *
+ *      callback [in]
+ *          The function receiving the level, the text including the
+ *          component prefix, and the console flag of each message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+CustomLogger::CustomLogger(const std::string &component_name,
+                           Callback callback) :
+    Logger(std::string(), component_name),
+    callback(std::move(callback)),
+    batch_size(0)
+{
+}
+
+/*
+ *  CustomLogger::CustomLogger
+ *
+ *  Description:
+ *      Constructor for a CustomLogger passing the parts of each message to
+ *      the given function on the thread that logged it.
+ *
+ *  Parameters:
+ *      callback [in]
+ *          The function receiving the parts of each message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The parts refer to buffers valid only during the call.
+ */
+CustomLogger::CustomLogger(PartsCallback callback) :
+    Logger(),
+    parts_callback(std::move(callback)),
+    batch_size(0)
+{
+}
+
+/*
+ *  CustomLogger::CustomLogger
+ *
+ *  Description:
+ *      Constructor for a CustomLogger having a component name and passing
+ *      the parts of each message to the given function on the thread that
+ *      logged it.
+ *
+ *  Parameters:
+ *      component_name [in]
+ *          The name of the component to print in log messages.
+ *
+ *      callback [in]
+ *          The function receiving the parts of each message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The parts refer to buffers valid only during the call.
+ */
+CustomLogger::CustomLogger(const std::string &component_name,
+                           PartsCallback callback) :
+    Logger(std::string(), component_name),
+    parts_callback(std::move(callback)),
+    batch_size(0)
+{
+}
+
+/*
+ *  CustomLogger::CustomLogger
+ *
+ *  Description:
+ *      Constructor for a CustomLogger placing each message into a queue
+ *      from which a background thread passes batches of messages to the
+ *      given function.
+ *
+ *  Parameters:
+ *      callback [in]
+ *          The function receiving an array of message parts and the number
+ *          of messages in the array.
+ *
+ *      queue_capacity [in]
+ *          The number of messages the queue holds.
+ *
+ *      batch_size [in]
+ *          The most messages given to the function at once.
+ *
+ *      policy [in]
+ *          The action taken when the queue is full.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A batch is delivered once it is full or the queue is empty.  The
+ *      parts refer to buffers valid only during the call.
+ */
+CustomLogger::CustomLogger(BatchCallback callback,
+                           std::size_t queue_capacity,
+                           std::size_t batch_size,
+                           const LogQueuePolicy &policy) :
+    Logger(),
+    batch_callback(std::move(callback)),
+    batch_size(std::max<std::size_t>(batch_size, 1))
+{
+    StartBatches(queue_capacity, policy);
+}
+
+/*
+ *  CustomLogger::CustomLogger
+ *
+ *  Description:
+ *      Constructor for a CustomLogger having a component name and placing
+ *      each message into a queue from which a background thread passes
+ *      batches of messages to the given function.
+ *
+ *  Parameters:
+ *      component_name [in]
+ *          The name of the component to print in log messages.
+ *
+ *      callback [in]
+ *          The function receiving an array of message parts and the number
+ *          of messages in the array.
+ *
+ *      queue_capacity [in]
+ *          The number of messages the queue holds.
+ *
+ *      batch_size [in]
+ *          The most messages given to the function at once.
+ *
+ *      policy [in]
+ *          The action taken when the queue is full.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A batch is delivered once it is full or the queue is empty.  The
+ *      parts refer to buffers valid only during the call.
+ */
+CustomLogger::CustomLogger(const std::string &component_name,
+                           BatchCallback callback,
+                           std::size_t queue_capacity,
+                           std::size_t batch_size,
+                           const LogQueuePolicy &policy) :
+    Logger(std::string(), component_name),
+    batch_callback(std::move(callback)),
+    batch_size(std::max<std::size_t>(batch_size, 1))
+{
+    StartBatches(queue_capacity, policy);
+}
+
+/*
+ *  CustomLogger::~CustomLogger
+ *
+ *  Description:
+ *      Destructor for the CustomLogger object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Runs of repeated messages are summarized and queued messages are
+ *      given to the callback here, rather than in ~Logger(), where the
+ *      summaries would no longer reach the callback.
+ */
+CustomLogger::~CustomLogger()
+{
+    if (!parent_logger)
+    {
+        FlushRepeats();
+        async_queue.Stop();
+    }
+
+    batch_queue.Stop();
+}
+
+/*
+ *  CustomLogger::Flush
+ *
+ *  Description:
+ *      Wait until all queued messages have been given to the callback.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Any partial batch is delivered once the queue is empty, so it is
+ *      delivered before this function returns.
+ */
+void CustomLogger::Flush()
+{
+    Logger::Flush();
+
+    batch_queue.Flush();
+}
+
+/*
+ *  CustomLogger::GetBatchDropCounts
+ *
+ *  Description:
+ *      Return the number of messages at each level discarded because the
+ *      batch queue was full.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of messages discarded, indexed by level.
+ *
+ *  Comments:
+ *      None.
+ */
+LogDropCounts CustomLogger::GetBatchDropCounts() const
+{
+    return batch_queue.GetDropCounts();
+}
+
+/*
+ *  CustomLogger::EmitLog
+ *
+ *  Description:
+ *      Give a message to the application's function.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      message [in]
+ *          The message to be logged, including any component prefix.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Exceptions thrown by the function are caught and ignored, since it
+ *      is not safe to log them.
+ */
+void CustomLogger::EmitLog(LogLevel level,
+                           const std::string &message,
+                           bool console)
+{
+    if (!callback)
+    {
+        Deliver(LogMessageParts{level,
+                                console,
+                                std::chrono::system_clock::now(),
+                                {},
+                                message});
+        return;
+    }
+
+    try
+    {
+        callback(level, message, console);
+    }
+    catch (...)
+    {
+        // Catch exceptions, but ignore since it's not safe to log
+    }
+}
+
+/*
+ *  CustomLogger::EmitParts
+ *
+ *  Description:
+ *      Give a message's parts to the application's function, or place them
+ *      into the queue to be given to the function in a batch.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      prefix [in]
+ *          The component prefix to precede the message, which may be empty.
+ *
+ *      body [in]
+ *          The text of the message following the prefix.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *      fields_length [in]
+ *          The length of the structured fields ending the body, which are
+ *          given to the function as part of the body.
+ *
+ *      site [in]
+ *          The call site from which the message was logged, or nullptr.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If the function receives each message's text, the parts are
+ *      concatenated and passed to EmitLog(), regardless of the output
+ *      format, and the call site is not given to it.
+ */
+void CustomLogger::EmitParts(LogLevel level,
+                             std::string_view prefix,
+                             const std::string &body,
+                             bool console,
+                             [[maybe_unused]] std::size_t fields_length,
+                             const LogSite *site)
+{
+    if (callback)
+    {
+        LogTextBuffer buffer;
+        buffer.Get().assign(prefix);
+        buffer.Get() += body;
+
+        EmitLog(level, buffer.Get(), console);
+        return;
+    }
+
+    Deliver(LogMessageParts{level,
+                            console,
+                            std::chrono::system_clock::now(),
+                            prefix,
+                            body,
+                            site});
+}
+
+/*
+ *  CustomLogger::Deliver
+ *
+ *  Description:
+ *      Give a message's parts to the parts callback or copy them into the
+ *      batch queue.
+ *
+ *  Parameters:
+ *      parts [in]
+ *          The parts of the message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The prefix and body are copied into the queue entry's own storage,
+ *      so queuing a message does not allocate memory unless it is long.
+ */
+void CustomLogger::Deliver(const LogMessageParts &parts)
+{
+    if (parts_callback)
+    {
+        try
+        {
+            parts_callback(parts);
+        }
+        catch (...)
+        {
+            // Catch exceptions, but ignore since it's not safe to log
+        }
+        return;
+    }
+
+    if (!batch_queue.IsRunning()) return;
+
+    BatchRecord record{parts.level,
+                       parts.console,
+                       parts.time,
+                       LogRecordText(parts.prefix),
+                       parts.prefix.size(),
+                       parts.site};
+    record.text.Append(parts.body);
+
+    batch_queue.Push(std::move(record));
+}
+
+/*
+ *  CustomLogger::StartBatches
+ *
+ *  Description:
+ *      Start the background thread that collects queued messages into
+ *      batches and gives each batch to the batch callback.
+ *
+ *  Parameters:
+ *      queue_capacity [in]
+ *          The number of messages the queue holds.
+ *
+ *      policy [in]
+ *          The action taken when the queue is full.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Discarded messages are noted by a "Dropped N messages" warning
+ *      delivered ahead of the next queued message.
+ */
+void CustomLogger::StartBatches(std::size_t queue_capacity,
+                                const LogQueuePolicy &policy)
+{
+    batch.reserve(batch_size);
+    batch_parts.reserve(batch_size);
+
+    batch_queue.Start(
+        std::max<std::size_t>(queue_capacity, 1),
+        [this](BatchRecord &record)
+        {
+            batch.push_back(std::move(record));
+            if (batch.size() >= batch_size) DeliverBatch();
+        },
+        [this]() -> std::chrono::milliseconds
+        {
+            DeliverBatch();
+            return std::chrono::milliseconds(0);
+        },
+        policy,
+        [this](BatchRecord &next, std::uint64_t count)
+        {
+            batch.push_back(BatchRecord{LogLevel::Warning,
+                                        false,
+                                        next.time,
+                                        LogRecordText(LogDropMarker(count)),
+                                        0,
+                                        nullptr});
+            if (batch.size() >= batch_size) DeliverBatch();
+        },
+        [](const BatchRecord &record) { return LogQueueOrder(record.time); });
+}
+
+/*
+ *  CustomLogger::DeliverBatch
+ *
+ *  Description:
+ *      Give the messages collected by the background thread to the batch
+ *      callback.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is called only by the background thread.  Exceptions thrown by
+ *      the function are caught and ignored.
+ */
+void CustomLogger::DeliverBatch()
+{
+    if (batch.empty()) return;
+
+    batch_parts.clear();
+    for (const auto &record : batch)
+    {
+        std::string_view text = record.text.View();
+        batch_parts.push_back(
+            LogMessageParts{record.level,
+                            record.console,
+                            record.time,
+                            text.substr(0, record.prefix_length),
+                            text.substr(record.prefix_length),
+                            record.site});
+    }
+
+    try
+    {
+        batch_callback(batch_parts.data(), batch_parts.size());
+    }
+    catch (...)
+    {
+        // Catch exceptions, but ignore since it's not safe to log
+    }
+
+    batch.clear();
+}
+
+} // namespace cantina
@@ -0,0 +1,680 @@
+/*
+ *  flight_recorder.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the FlightRecorder class, a lock-free ring of
+ *      recent log messages that may be dumped after a failure.
+ *
+ *  Portability Issues:
+ *      Signal handlers are installed only on POSIX systems.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include "cantina/flight_recorder.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+// Recorder dumped by the fatal signal handler and its file descriptor
+std::atomic<FlightRecorder *> signal_recorder{nullptr};
+std::atomic<int> signal_descriptor{2};
+
+// Signals upon which the recorder is dumped
+const int Fatal_Signals[] = {SIGSEGV, SIGFPE, SIGILL, SIGABRT
+#ifdef SIGBUS
+                             , SIGBUS
+#endif
+                            };
+
+// Level names used when dumping to a file descriptor
+const std::string_view Level_Names[] =
+{
+    "CRITICAL",
+    "ERROR",
+    "WARNING",
+    "INFO",
+    "DEBUG"
+};
+
+/*
+ *  WriteAll()
+ *
+ *  Description:
+ *      Write the entire buffer to the file descriptor.
+ *
+ *  Parameters:
+ *      fd [in]
+ *          The file descriptor to which to write.
+ *
+ *      data [in]
+ *          The data to write.
+ *
+ *      length [in]
+ *          The number of octets to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is async-signal-safe.
+ */
+void WriteAll(int fd, const char *data, std::size_t length)
+{
+    while (length > 0)
+    {
+#ifdef _WIN32
+        int written = _write(fd, data, static_cast<unsigned>(length));
+#else
+        ssize_t written = write(fd, data, length);
+#endif
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+    }
+}
+
+/*
+ *  AppendDigits()
+ *
+ *  Description:
+ *      Write the decimal digits of a value, with leading zeros, to a
+ *      buffer.
+ *
+ *  Parameters:
+ *      buffer [in/out]
+ *          Pointer to the buffer position, which is advanced past the
+ *          digits written.
+ *
+ *      value [in]
+ *          The value to write.
+ *
+ *      width [in]
+ *          The number of digits to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is async-signal-safe.
+ */
+void AppendDigits(char *&buffer, std::int64_t value, unsigned width)
+{
+    for (unsigned i = width; i > 0; i--)
+    {
+        buffer[i - 1] = static_cast<char>('0' + (value % 10));
+        value /= 10;
+    }
+    buffer += width;
+}
+
+/*
+ *  AppendTimestamp()
+ *
+ *  Description:
+ *      Write a UTC timestamp with microsecond precision to a buffer.
+ *
+ *  Parameters:
+ *      buffer [in/out]
+ *          Pointer to the buffer position, which is advanced past the
+ *          timestamp written.
+ *
+ *      nanoseconds [in]
+ *          Nanoseconds since the epoch.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The C library's time conversion functions are not async-signal-safe,
+ *      so the civil date is computed here.
+ */
+void AppendTimestamp(char *&buffer, std::int64_t nanoseconds)
+{
+    std::int64_t seconds = nanoseconds / 1'000'000'000;
+    std::int64_t microseconds = (nanoseconds % 1'000'000'000) / 1'000;
+    if (microseconds < 0)
+    {
+        seconds--;
+        microseconds += 1'000'000;
+    }
+
+    std::int64_t days = seconds / 86400;
+    std::int64_t second_of_day = seconds % 86400;
+    if (second_of_day < 0)
+    {
+        days--;
+        second_of_day += 86400;
+    }
+
+    // Convert days since the epoch to a civil date
+    std::int64_t z = days + 719468;
+    std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    std::int64_t day_of_era = z - era * 146097;
+    std::int64_t year_of_era = (day_of_era - day_of_era / 1460 +
+                                day_of_era / 36524 - day_of_era / 146096) /
+                               365;
+    std::int64_t day_of_year = day_of_era - (365 * year_of_era +
+                                             year_of_era / 4 -
+                                             year_of_era / 100);
+    std::int64_t month_index = (5 * day_of_year + 2) / 153;
+    std::int64_t day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    std::int64_t month = month_index < 10 ? month_index + 3 : month_index - 9;
+    std::int64_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+    AppendDigits(buffer, year, 4);
+    *buffer++ = '-';
+    AppendDigits(buffer, month, 2);
+    *buffer++ = '-';
+    AppendDigits(buffer, day, 2);
+    *buffer++ = 'T';
+    AppendDigits(buffer, second_of_day / 3600, 2);
+    *buffer++ = ':';
+    AppendDigits(buffer, (second_of_day / 60) % 60, 2);
+    *buffer++ = ':';
+    AppendDigits(buffer, second_of_day % 60, 2);
+    *buffer++ = '.';
+    AppendDigits(buffer, microseconds, 6);
+    *buffer++ = 'Z';
+}
+
+/*
+ *  FatalSignalHandler()
+ *
+ *  Description:
+ *      Dump the flight recorder upon a fatal signal and then raise the
+ *      signal again, so that the default action (e.g., a core dump) is
+ *      taken.
+ *
+ *  Parameters:
+ *      signal_number [in]
+ *          The signal received.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The handler was installed with SA_RESETHAND, so the default action
+ *      is restored before this is called.
+ */
+#ifndef _WIN32
+void FatalSignalHandler(int signal_number)
+{
+    FlightRecorder *recorder = signal_recorder.exchange(nullptr);
+
+    if (recorder != nullptr) recorder->DumpToDescriptor(signal_descriptor);
+
+    raise(signal_number);
+}
+#endif
+
+} // namespace
+
+/*
+ *  FlightRecorder::FlightRecorder
+ *
+ *  Description:
+ *      Constructor for the FlightRecorder object.
+ *
+ *  Parameters:
+ *      capacity [in]
+ *          The number of messages retained, which is rounded up to a power
+ *          of two.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      All slots are allocated here, so adding messages never allocates.
+ */
+FlightRecorder::FlightRecorder(std::size_t capacity) :
+    capacity(1),
+    head(0),
+    drained(0)
+{
+    while (this->capacity < capacity) this->capacity <<= 1;
+
+    slots = std::make_unique<Slot[]>(this->capacity);
+}
+
+/*
+ *  FlightRecorder::~FlightRecorder
+ *
+ *  Description:
+ *      Destructor for the FlightRecorder object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If this recorder is to be dumped upon a fatal signal, it no longer
+ *      will be.
+ */
+FlightRecorder::~FlightRecorder()
+{
+    FlightRecorder *self = this;
+    signal_recorder.compare_exchange_strong(self, nullptr);
+}
+
+/*
+ *  FlightRecorder::GetCapacity
+ *
+ *  Description:
+ *      Return the number of messages retained.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of messages retained.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t FlightRecorder::GetCapacity() const
+{
+    return capacity;
+}
+
+/*
+ *  FlightRecorder::Add
+ *
+ *  Description:
+ *      Add a message to the ring, replacing the oldest message.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The level of the message.
+ *
+ *      prefix [in]
+ *          Text preceding the message (e.g., the component prefix).
+ *
+ *      text [in]
+ *          The message text.
+ *
+ *      written [in]
+ *          Was the message written when it was logged?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This may be called concurrently by any number of threads.  Text
+ *      beyond Max_Record_Length octets is discarded.
+ */
+void FlightRecorder::Add(LogLevel level,
+                         std::string_view prefix,
+                         std::string_view text,
+                         bool written)
+{
+    std::uint64_t ticket = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[ticket & (capacity - 1)];
+
+    // Claim the slot, giving up if another thread is writing to it
+    std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) ||
+        !slot.sequence.compare_exchange_strong(sequence,
+                                               sequence + 1,
+                                               std::memory_order_relaxed))
+    {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // A thread that was delayed must not replace a newer message
+    if (slot.ticket.load(std::memory_order_relaxed) > ticket + 1)
+    {
+        slot.sequence.store(sequence, std::memory_order_release);
+        return;
+    }
+
+    char buffer[Words_Per_Slot * sizeof(std::uint64_t)];
+    std::size_t prefix_length = std::min(prefix.size(), Max_Record_Length);
+    std::size_t text_length = std::min(text.size(),
+                                       Max_Record_Length - prefix_length);
+    std::memcpy(buffer, prefix.data(), prefix_length);
+    std::memcpy(buffer + prefix_length, text.data(), text_length);
+    std::size_t length = prefix_length + text_length;
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+
+    slot.ticket.store(ticket + 1, std::memory_order_relaxed);
+    slot.time.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(),
+        std::memory_order_relaxed);
+    slot.level.store(static_cast<std::uint32_t>(level),
+                     std::memory_order_relaxed);
+    slot.length.store(static_cast<std::uint32_t>(length),
+                      std::memory_order_relaxed);
+    slot.prefix_length.store(static_cast<std::uint32_t>(prefix_length),
+                             std::memory_order_relaxed);
+    slot.written.store(written ? 1 : 0, std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i * sizeof(std::uint64_t) < length; i++)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, buffer + i * sizeof(word), sizeof(word));
+        slot.words[i].store(word, std::memory_order_relaxed);
+    }
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/*
+ *  FlightRecorder::Drain
+ *
+ *  Description:
+ *      Retrieve the messages added since the last call to Drain() or
+ *      DumpToDescriptor() that remain in the ring.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The messages, oldest first.
+ *
+ *  Comments:
+ *      Messages being written while the ring is read are omitted.
+ */
+std::vector<FlightRecord> FlightRecorder::Drain()
+{
+    std::vector<FlightRecord> records;
+    std::uint64_t end;
+    std::uint64_t ticket = TakeUndrained(end);
+
+    records.reserve(static_cast<std::size_t>(end - ticket));
+
+    for (; ticket < end; ticket++)
+    {
+        FlightRecord record{};
+        char text[Words_Per_Slot * sizeof(std::uint64_t)];
+        std::size_t length;
+
+        if (!ReadSlot(ticket, record, text, length)) continue;
+
+        record.text.assign(text, length);
+        records.push_back(std::move(record));
+    }
+
+    return records;
+}
+
+/*
+ *  FlightRecorder::DumpToDescriptor
+ *
+ *  Description:
+ *      Write the messages added since the last call to Drain() or
+ *      DumpToDescriptor() that remain in the ring to a file descriptor,
+ *      one line per message.
+ *
+ *  Parameters:
+ *      fd [in]
+ *          The file descriptor to which to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This does not allocate memory or take locks, so it may be called
+ *      from a signal handler.  Timestamps are written in UTC.
+ */
+void FlightRecorder::DumpToDescriptor(int fd)
+{
+    static constexpr std::string_view Begin = "Flight recorder dump begins\n";
+    static constexpr std::string_view End = "Flight recorder dump ends\n";
+
+    std::uint64_t end;
+    std::uint64_t ticket = TakeUndrained(end);
+
+    WriteAll(fd, Begin.data(), Begin.size());
+
+    for (; ticket < end; ticket++)
+    {
+        FlightRecord record{};
+        char text[Words_Per_Slot * sizeof(std::uint64_t)];
+        std::size_t length;
+
+        if (!ReadSlot(ticket, record, text, length)) continue;
+
+        char line[64 + sizeof(text)];
+        char *position = line;
+
+        AppendTimestamp(position,
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            record.time.time_since_epoch()).count());
+
+        std::string_view level_name =
+            Level_Names[static_cast<std::size_t>(record.level)];
+        *position++ = ' ';
+        *position++ = '[';
+        std::memcpy(position, level_name.data(), level_name.size());
+        position += level_name.size();
+        *position++ = ']';
+        *position++ = ' ';
+        std::memcpy(position, text, length);
+        position += length;
+        *position++ = '\n';
+
+        WriteAll(fd, line, static_cast<std::size_t>(position - line));
+    }
+
+    WriteAll(fd, End.data(), End.size());
+}
+
+/*
+ *  FlightRecorder::InstallSignalHandlers
+ *
+ *  Description:
+ *      Install handlers for fatal signals (SIGSEGV, SIGBUS, SIGFPE, SIGILL,
+ *      and SIGABRT) that write the recorder's messages to a file
+ *      descriptor before the default action is taken.
+ *
+ *  Parameters:
+ *      recorder [in]
+ *          The recorder to dump, or nullptr to restore the default actions.
+ *
+ *      fd [in]
+ *          The file descriptor to which to write (e.g., 2 for standard
+ *          error).
+ *
+ *  Returns:
+ *      True if the handlers were installed, false otherwise.
+ *
+ *  Comments:
+ *      Only one recorder is dumped upon a fatal signal.  Installing the
+ *      handlers for another recorder replaces the previous one.
+ */
+bool FlightRecorder::InstallSignalHandlers(
+                                    [[maybe_unused]] FlightRecorder *recorder,
+                                    [[maybe_unused]] int fd)
+{
+#ifdef _WIN32
+    return false;
+#else
+    signal_descriptor = fd;
+    signal_recorder = recorder;
+
+    struct sigaction action{};
+    sigemptyset(&action.sa_mask);
+    if (recorder != nullptr)
+    {
+        action.sa_handler = FatalSignalHandler;
+        action.sa_flags = SA_RESETHAND;
+    }
+    else
+    {
+        action.sa_handler = SIG_DFL;
+    }
+
+    for (int signal_number : Fatal_Signals)
+    {
+        if (sigaction(signal_number, &action, nullptr) != 0) return false;
+    }
+
+    return true;
+#endif
+}
+
+/*
+ *  FlightRecorder::ReadSlot
+ *
+ *  Description:
+ *      Read the message having the given ticket.
+ *
+ *  Parameters:
+ *      ticket [in]
+ *          The ticket assigned when the message was added.
+ *
+ *      record [out]
+ *          The sequence, level, time, prefix length, and written flag of
+ *          the message.  The text member is not assigned.
+ *
+ *      text [out]
+ *          Buffer of at least Max_Record_Length octets receiving the text.
+ *
+ *      length [out]
+ *          The length of the text.
+ *
+ *  Returns:
+ *      True if the message was read, false if it is being written or was
+ *      replaced.
+ *
+ *  Comments:
+ *      This is async-signal-safe.
+ */
+bool FlightRecorder::ReadSlot(std::uint64_t ticket,
+                              FlightRecord &record,
+                              char *text,
+                              std::size_t &length) const
+{
+    const Slot &slot = slots[ticket & (capacity - 1)];
+
+    std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) return false;
+    if (slot.ticket.load(std::memory_order_relaxed) != ticket + 1)
+    {
+        return false;
+    }
+
+    std::int64_t time = slot.time.load(std::memory_order_relaxed);
+    std::uint32_t level = slot.level.load(std::memory_order_relaxed);
+    std::uint32_t prefix_length =
+        slot.prefix_length.load(std::memory_order_relaxed);
+    std::uint32_t written = slot.written.load(std::memory_order_relaxed);
+    length = std::min<std::size_t>(slot.length.load(std::memory_order_relaxed),
+                                   Max_Record_Length);
+
+    for (std::size_t i = 0; i * sizeof(std::uint64_t) < length; i++)
+    {
+        std::uint64_t word = slot.words[i].load(std::memory_order_relaxed);
+        std::memcpy(text + i * sizeof(word), &word, sizeof(word));
+    }
+
+    // Ensure the slot was not changed while being read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) return false;
+
+    record.sequence = ticket;
+    record.level = static_cast<LogLevel>(std::min<std::uint32_t>(level, 4));
+    record.time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(time)));
+    record.prefix_length = std::min<std::size_t>(prefix_length, length);
+    record.written = (written != 0);
+
+    return true;
+}
+
+/*
+ *  FlightRecorder::TakeUndrained
+ *
+ *  Description:
+ *      Mark all messages added so far as drained, returning the range of
+ *      tickets not previously drained that remain in the ring.
+ *
+ *  Parameters:
+ *      end [out]
+ *          One past the last ticket to read.
+ *
+ *  Returns:
+ *      The first ticket to read.
+ *
+ *  Comments:
+ *      Concurrent callers receive disjoint ranges.
+ */
+std::uint64_t FlightRecorder::TakeUndrained(std::uint64_t &end)
+{
+    end = head.load(std::memory_order_acquire);
+
+    std::uint64_t begin = drained.load(std::memory_order_relaxed);
+    do
+    {
+        if (begin >= end)
+        {
+            end = begin;
+            return begin;
+        }
+    } while (!drained.compare_exchange_weak(begin,
+                                            end,
+                                            std::memory_order_relaxed));
+
+    // Older messages have been replaced
+    if (end - begin > capacity) begin = end - capacity;
+
+    return begin;
+}
+
+} // namespace cantina
@@ -0,0 +1,366 @@
+/*
+ *  log_clock.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogClock class, which reads the clock used to
+ *      time messages and converts its raw values to the time of day.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <limits>
+#include <thread>
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+#include "cantina/log_clock.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+// Time between the samples taken to find the rate of the TSC
+constexpr std::chrono::milliseconds Tsc_Sample_Interval{10};
+
+// Largest relative change in the rate accepted when recalibrating
+constexpr double Max_Rate_Change = 0.01;
+
+} // namespace
+
+/*
+ *  LogClock::LogClock
+ *
+ *  Description:
+ *      Constructor for the LogClock object, which reads the system time
+ *      until another source is set.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogClock::LogClock() :
+    source(LogClockSource::System),
+    next_calibration(std::numeric_limits<std::uint64_t>::max()),
+    sequence(0),
+    ticks(0),
+    nanoseconds(0),
+    nanoseconds_per_tick(1.0)
+{
+}
+
+/*
+ *  LogClock::IsAvailable
+ *
+ *  Description:
+ *      Determine whether the given source may be read on this system.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source to check.
+ *
+ *  Returns:
+ *      True if the source is available.
+ *
+ *  Comments:
+ *      The TSC is used only if the processor reports that it is invariant,
+ *      meaning that it runs at a constant rate regardless of power states
+ *      and is synchronized across cores.
+ */
+bool LogClock::IsAvailable(LogClockSource source)
+{
+    switch (source)
+    {
+        case LogClockSource::System:
+            return true;
+
+        case LogClockSource::Tsc:
+        {
+#if defined(LOGGER_TSC_SUPPORTED) && defined(_MSC_VER)
+            int registers[4];
+            __cpuid(registers, 0x80000000);
+            if (static_cast<unsigned>(registers[0]) < 0x80000007) return false;
+            __cpuid(registers, 0x80000007);
+            return (registers[3] & (1 << 8)) != 0;
+#elif defined(LOGGER_TSC_SUPPORTED)
+            unsigned eax, ebx, ecx, edx;
+            if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            {
+                return false;
+            }
+            return (edx & (1u << 8)) != 0;
+#else
+            return false;
+#endif
+        }
+
+        case LogClockSource::MonotonicCoarse:
+#ifdef CLOCK_MONOTONIC_COARSE
+            return true;
+#else
+            return false;
+#endif
+
+        default:
+            return false;
+    }
+}
+
+/*
+ *  LogClock::SetSource
+ *
+ *  Description:
+ *      Set the source read by Now() and calibrate it against the system
+ *      time.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source to read.
+ *
+ *  Returns:
+ *      True if the source was set, false if it is not available.
+ *
+ *  Comments:
+ *      Finding the rate of the TSC requires two samples, so setting it as
+ *      the source takes about ten milliseconds.  Values read from one
+ *      source are not meaningful once another has been set.
+ */
+bool LogClock::SetSource(LogClockSource source)
+{
+    if (!IsAvailable(source)) return false;
+
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+
+    LogClockCalibration calibration = Sample(source);
+
+    if (source == LogClockSource::Tsc)
+    {
+        LogClockCalibration first = calibration;
+        std::this_thread::sleep_for(Tsc_Sample_Interval);
+        calibration = Sample(source);
+        calibration.nanoseconds_per_tick =
+            static_cast<double>(calibration.nanoseconds - first.nanoseconds) /
+            static_cast<double>(calibration.ticks - first.ticks);
+    }
+
+    Publish(calibration);
+    this->source.store(source, std::memory_order_relaxed);
+
+    // The system time needs no calibration
+    if (source == LogClockSource::System)
+    {
+        next_calibration.store(std::numeric_limits<std::uint64_t>::max(),
+                               std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+/*
+ *  LogClock::Calibrate
+ *
+ *  Description:
+ *      Relate the current raw value of the clock to the system time,
+ *      updating the rate of the TSC from the time elapsed since the last
+ *      calibration.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if a new calibration was published, false if calibration was
+ *      not due or another thread was calibrating the clock.
+ *
+ *  Comments:
+ *      This is called by a thread that finds IsCalibrationDue() true.  If
+ *      the system time was stepped since the last calibration, so that the
+ *      measured rate changed by more than one percent, the previous rate is
+ *      retained.
+ */
+bool LogClock::Calibrate()
+{
+    std::unique_lock<std::mutex> lock(calibration_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+
+    LogClockSource current = source.load(std::memory_order_relaxed);
+
+    // Another thread may have just calibrated the clock
+    if ((current == LogClockSource::System) ||
+        !IsCalibrationDue(Read(current)))
+    {
+        return false;
+    }
+
+    LogClockCalibration previous = GetCalibration();
+    LogClockCalibration calibration = Sample(current);
+
+    if (current == LogClockSource::Tsc)
+    {
+        double rate =
+            static_cast<double>(calibration.nanoseconds -
+                                previous.nanoseconds) /
+            static_cast<double>(calibration.ticks - previous.ticks);
+        double change = (rate - previous.nanoseconds_per_tick) /
+                        previous.nanoseconds_per_tick;
+
+        calibration.nanoseconds_per_tick =
+            ((change > -Max_Rate_Change) && (change < Max_Rate_Change)) ?
+                rate : previous.nanoseconds_per_tick;
+    }
+
+    Publish(calibration);
+
+    return true;
+}
+
+/*
+ *  LogClock::GetCalibration
+ *
+ *  Description:
+ *      Return the calibration most recently published.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The calibration relating raw values to the system time.
+ *
+ *  Comments:
+ *      The values are read again should a calibration be published while
+ *      they are being read.
+ */
+LogClockCalibration LogClock::GetCalibration() const
+{
+    while (true)
+    {
+        std::uint32_t before = sequence.load(std::memory_order_acquire);
+
+        LogClockCalibration calibration{
+            ticks.load(std::memory_order_relaxed),
+            nanoseconds.load(std::memory_order_relaxed),
+            nanoseconds_per_tick.load(std::memory_order_relaxed)};
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (((before & 1) == 0) &&
+            (sequence.load(std::memory_order_relaxed) == before))
+        {
+            return calibration;
+        }
+    }
+}
+
+/*
+ *  LogClock::Sample
+ *
+ *  Description:
+ *      Read the given source and the system time at about the same instant.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source to read.
+ *
+ *  Returns:
+ *      A calibration relating the raw value to the system time, having a
+ *      rate of one nanosecond per tick.
+ *
+ *  Comments:
+ *      The source is read before and after the system time, and the mean
+ *      of the two raw values is used.
+ */
+LogClockCalibration LogClock::Sample(LogClockSource source)
+{
+    std::uint64_t before = Read(source);
+    std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    std::uint64_t after = Read(source);
+
+    return LogClockCalibration{before + (after - before) / 2, now, 1.0};
+}
+
+/*
+ *  LogClock::Publish
+ *
+ *  Description:
+ *      Publish a calibration to threads converting raw values and schedule
+ *      the next calibration.
+ *
+ *  Parameters:
+ *      calibration [in]
+ *          The calibration to publish.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This must be called with calibration_mutex held.  The sequence is
+ *      odd while the values are being stored.
+ */
+void LogClock::Publish(const LogClockCalibration &calibration)
+{
+    std::uint32_t current = sequence.load(std::memory_order_relaxed);
+
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ticks.store(calibration.ticks, std::memory_order_relaxed);
+    nanoseconds.store(calibration.nanoseconds, std::memory_order_relaxed);
+    nanoseconds_per_tick.store(calibration.nanoseconds_per_tick,
+                               std::memory_order_relaxed);
+
+    sequence.store(current + 2, std::memory_order_release);
+
+    auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        Calibration_Interval).count();
+    next_calibration.store(
+        calibration.ticks +
+            static_cast<std::uint64_t>(static_cast<double>(interval) /
+                                       calibration.nanoseconds_per_tick),
+        std::memory_order_relaxed);
+}
+
+} // namespace cantina
@@ -0,0 +1,283 @@
+/*
+ *  log_coalescer.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogCoalescer class, which counts consecutive
+ *      repeats of a message logged by a component at the same level so
+ *      that the Logger may write one line summarizing them.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include "cantina/log_coalescer.h"
+
+namespace cantina
+{
+
+/*
+ *  LogCoalescer::LogCoalescer
+ *
+ *  Description:
+ *      Constructor for the LogCoalescer object.
+ *
+ *  Parameters:
+ *      timeout [in]
+ *          The longest time a run of repeats is held before it is
+ *          summarized, both while repeats continue and after the last.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogCoalescer::LogCoalescer(std::chrono::milliseconds timeout) :
+    timeout(timeout),
+    next_idle(std::chrono::system_clock::time_point::max())
+{
+}
+
+/*
+ *  LogCoalescer::IsRepeat
+ *
+ *  Description:
+ *      Determine whether the message repeats the previous message logged by
+ *      its component at its level, in which case it is counted and is not
+ *      to be written.  Otherwise, the message becomes the one with which
+ *      the component's next message at that level is compared.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      prefix [in]
+ *          The component prefix of the message.
+ *
+ *      message [in]
+ *          The text of the message following the prefix.
+ *
+ *      console [in]
+ *          Is the message also to be written to the console?
+ *
+ *      now [in]
+ *          The current time.
+ *
+ *      ended [out]
+ *          Runs of repeats that have ended, or have lasted for the timeout,
+ *          are appended to this vector, to be summarized before the message
+ *          is written.
+ *
+ *  Returns:
+ *      True if the message is a repeat, false if it is to be written.
+ *
+ *  Comments:
+ *      Messages are compared by hash and length only.
+ */
+bool LogCoalescer::IsRepeat(LogLevel level,
+                            std::string_view prefix,
+                            std::string_view message,
+                            bool console,
+                            std::chrono::system_clock::time_point now,
+                            std::vector<LogRepeat> &ended)
+{
+    std::uint64_t hash = Hash(message);
+    std::uint64_t index = Hash(prefix) ^ static_cast<std::uint64_t>(level);
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot &slot = slots[index % Slot_Count];
+
+    // Summarize runs of other components that have gone quiet
+    if (now >= next_idle) TakeIdle(now, ended);
+
+    if (slot.used && (slot.level == level) && (slot.hash == hash) &&
+        (slot.length == message.size()) && (slot.prefix == prefix))
+    {
+        if (slot.repeats == 0) slot.first = now;
+        slot.repeats++;
+        slot.last = now;
+
+        // Summarize a long run periodically, continuing to count repeats
+        if (now - slot.first >= timeout)
+        {
+            TakeRun(slot, ended);
+        }
+        else
+        {
+            next_idle = std::min(next_idle, now + timeout);
+        }
+
+        return true;
+    }
+
+    if (slot.used && (slot.repeats > 0)) TakeRun(slot, ended);
+
+    slot.used = true;
+    slot.level = level;
+    slot.prefix.assign(prefix);
+    slot.hash = hash;
+    slot.length = message.size();
+    slot.console = console;
+    slot.repeats = 0;
+
+    return false;
+}
+
+/*
+ *  LogCoalescer::TakeAll
+ *
+ *  Description:
+ *      Add every run of repeats not yet summarized to the given vector.
+ *
+ *  Parameters:
+ *      ended [out]
+ *          The vector to which runs of repeats are appended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The next message from each component is written in full.
+ */
+void LogCoalescer::TakeAll(std::vector<LogRepeat> &ended)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    TakeIdle(std::chrono::system_clock::time_point::max(), ended);
+}
+
+/*
+ *  LogCoalescer::Hash
+ *
+ *  Description:
+ *      Compute the FNV-1a hash of the given text.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to hash.
+ *
+ *  Returns:
+ *      The hash of the text.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t LogCoalescer::Hash(std::string_view text)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (unsigned char c : text) hash = (hash ^ c) * 0x100000001b3ULL;
+
+    return hash;
+}
+
+/*
+ *  LogCoalescer::TakeIdle
+ *
+ *  Description:
+ *      Add runs of repeats for which no repeat has been seen within the
+ *      timeout to the given vector.  The mutex must be held.
+ *
+ *  Parameters:
+ *      now [in]
+ *          The current time.
+ *
+ *      ended [out]
+ *          The vector to which runs of repeats are appended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The slot of each run taken is cleared, so that a message logged
+ *      after a quiet period is written in full.
+ */
+void LogCoalescer::TakeIdle(std::chrono::system_clock::time_point now,
+                            std::vector<LogRepeat> &ended)
+{
+    next_idle = std::chrono::system_clock::time_point::max();
+
+    for (auto &slot : slots)
+    {
+        if (!slot.used || (slot.repeats == 0)) continue;
+
+        if ((now != std::chrono::system_clock::time_point::max()) &&
+            (now - slot.last < timeout))
+        {
+            next_idle = std::min(next_idle, slot.last + timeout);
+            continue;
+        }
+
+        TakeRun(slot, ended);
+        slot.used = false;
+    }
+}
+
+/*
+ *  LogCoalescer::TakeRun
+ *
+ *  Description:
+ *      Add the slot's run of repeats to the given vector and reset its
+ *      count of repeats.
+ *
+ *  Parameters:
+ *      slot [in/out]
+ *          The slot holding the run.
+ *
+ *      ended [out]
+ *          The vector to which the run is appended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogCoalescer::TakeRun(Slot &slot, std::vector<LogRepeat> &ended)
+{
+    ended.push_back(LogRepeat{slot.level,
+                              slot.prefix,
+                              slot.console,
+                              slot.repeats,
+                              slot.first,
+                              slot.last});
+    slot.repeats = 0;
+}
+
+} // namespace cantina
@@ -0,0 +1,626 @@
+/*
+ *  log_compressor.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogCompressor class, which compresses each block
+ *      of log file output as a complete gzip member, Zstandard frame, or
+ *      LZ4 frame.
+ *
+ *  Portability Issues:
+ *      Each format requires zlib, libzstd, or liblz4, respectively.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#ifdef LOGGER_ZLIB_ENABLED
+#include <zlib.h>
+#endif
+#ifdef LOGGER_ZSTD_ENABLED
+#include <zstd.h>
+#endif
+#ifdef LOGGER_LZ4_ENABLED
+#include <lz4frame.h>
+#endif
+#include <climits>
+#include "cantina/log_compressor.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+/*
+ *  Reserve
+ *
+ *  Description:
+ *      Grow the output so that at least the given number of octets follow
+ *      the portion already used.
+ *
+ *  Parameters:
+ *      output [in/out]
+ *          The output vector.
+ *
+ *      used [in]
+ *          The number of octets of output holding compressed data.
+ *
+ *      needed [in]
+ *          The number of octets required beyond those used.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Reserve(std::vector<char> &output, std::size_t used, std::size_t needed)
+{
+    if (output.size() < used + needed) output.resize(used + needed);
+}
+
+#ifdef LOGGER_ZLIB_ENABLED
+/*
+ *  CompressGzip
+ *
+ *  Description:
+ *      Compress the given parts as a single gzip member.
+ *
+ *  Parameters:
+ *      stream [in/out]
+ *          The zlib stream, initialized to write gzip members.
+ *
+ *      parts [in]
+ *          The data to compress.
+ *
+ *      count [in]
+ *          The number of parts.
+ *
+ *      output [in/out]
+ *          The vector to which the member is appended.
+ *
+ *  Returns:
+ *      True if the data was compressed, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool CompressGzip(z_stream *stream,
+                  const std::string_view *parts,
+                  std::size_t count,
+                  std::vector<char> &output)
+{
+    std::size_t used = output.size();
+    std::size_t length = 0;
+    int result = Z_OK;
+
+    for (std::size_t i = 0; i < count; i++) length += parts[i].size();
+    if (length > UINT_MAX) return false;
+
+    if (deflateReset(stream) != Z_OK) return false;
+    Reserve(output, used, deflateBound(stream, static_cast<uLong>(length)));
+
+    for (std::size_t i = 0; i <= count; i++)
+    {
+        int flush = (i < count) ? Z_NO_FLUSH : Z_FINISH;
+
+        if (i < count)
+        {
+            stream->next_in = reinterpret_cast<Bytef *>(
+                const_cast<char *>(parts[i].data()));
+            stream->avail_in = static_cast<uInt>(parts[i].size());
+        }
+
+        do
+        {
+            if (output.size() == used) Reserve(output, used, 256);
+
+            stream->next_out = reinterpret_cast<Bytef *>(output.data() + used);
+            stream->avail_out = static_cast<uInt>(output.size() - used);
+
+            result = deflate(stream, flush);
+            if ((result != Z_OK) && (result != Z_STREAM_END) &&
+                (result != Z_BUF_ERROR))
+            {
+                return false;
+            }
+
+            used = output.size() - stream->avail_out;
+        } while ((stream->avail_in > 0) ||
+                 ((flush == Z_FINISH) && (result != Z_STREAM_END)));
+    }
+
+    output.resize(used);
+
+    return true;
+}
+#endif
+
+#ifdef LOGGER_ZSTD_ENABLED
+/*
+ *  CompressZstd
+ *
+ *  Description:
+ *      Compress the given parts as a single Zstandard frame.
+ *
+ *  Parameters:
+ *      context [in/out]
+ *          The Zstandard compression context.
+ *
+ *      parts [in]
+ *          The data to compress.
+ *
+ *      count [in]
+ *          The number of parts.
+ *
+ *      output [in/out]
+ *          The vector to which the frame is appended.
+ *
+ *  Returns:
+ *      True if the data was compressed, false otherwise.
+ *
+ *  Comments:
+ *      The frame records its content size and a checksum.
+ */
+bool CompressZstd(ZSTD_CCtx *context,
+                  const std::string_view *parts,
+                  std::size_t count,
+                  std::vector<char> &output)
+{
+    std::size_t used = output.size();
+    std::size_t length = 0;
+    std::size_t remaining = 0;
+
+    for (std::size_t i = 0; i < count; i++) length += parts[i].size();
+
+    ZSTD_CCtx_reset(context, ZSTD_reset_session_only);
+    if (ZSTD_isError(ZSTD_CCtx_setPledgedSrcSize(context, length)))
+    {
+        return false;
+    }
+    Reserve(output, used, ZSTD_compressBound(length));
+
+    for (std::size_t i = 0; i <= count; i++)
+    {
+        ZSTD_EndDirective mode = (i < count) ? ZSTD_e_continue : ZSTD_e_end;
+        ZSTD_inBuffer input{nullptr, 0, 0};
+
+        if (i < count) input = {parts[i].data(), parts[i].size(), 0};
+
+        do
+        {
+            if (output.size() == used) Reserve(output, used, 256);
+
+            ZSTD_outBuffer frame{output.data(), output.size(), used};
+            remaining = ZSTD_compressStream2(context, &frame, &input, mode);
+            if (ZSTD_isError(remaining)) return false;
+
+            used = frame.pos;
+        } while ((input.pos < input.size) ||
+                 ((mode == ZSTD_e_end) && (remaining > 0)));
+    }
+
+    output.resize(used);
+
+    return true;
+}
+#endif
+
+#ifdef LOGGER_LZ4_ENABLED
+/*
+ *  CompressLz4
+ *
+ *  Description:
+ *      Compress the given parts as a single LZ4 frame.
+ *
+ *  Parameters:
+ *      context [in/out]
+ *          The LZ4 compression context.
+ *
+ *      level [in]
+ *          The compression level.
+ *
+ *      parts [in]
+ *          The data to compress.
+ *
+ *      count [in]
+ *          The number of parts.
+ *
+ *      output [in/out]
+ *          The vector to which the frame is appended.
+ *
+ *  Returns:
+ *      True if the data was compressed, false otherwise.
+ *
+ *  Comments:
+ *      The frame records its content size and a checksum.
+ */
+bool CompressLz4(LZ4F_cctx *context,
+                 int level,
+                 const std::string_view *parts,
+                 std::size_t count,
+                 std::vector<char> &output)
+{
+    LZ4F_preferences_t preferences{};
+    std::size_t used = output.size();
+    std::size_t length = 0;
+    std::size_t result;
+
+    for (std::size_t i = 0; i < count; i++) length += parts[i].size();
+
+    preferences.frameInfo.contentSize = length;
+    preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+    preferences.compressionLevel = level;
+
+    Reserve(output, used, LZ4F_HEADER_SIZE_MAX);
+    result = LZ4F_compressBegin(context,
+                                output.data() + used,
+                                output.size() - used,
+                                &preferences);
+    if (LZ4F_isError(result)) return false;
+    used += result;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        Reserve(output,
+                used,
+                LZ4F_compressBound(parts[i].size(), &preferences));
+        result = LZ4F_compressUpdate(context,
+                                     output.data() + used,
+                                     output.size() - used,
+                                     parts[i].data(),
+                                     parts[i].size(),
+                                     nullptr);
+        if (LZ4F_isError(result)) return false;
+        used += result;
+    }
+
+    Reserve(output, used, LZ4F_compressBound(0, &preferences));
+    result = LZ4F_compressEnd(context,
+                              output.data() + used,
+                              output.size() - used,
+                              nullptr);
+    if (LZ4F_isError(result)) return false;
+    used += result;
+
+    output.resize(used);
+
+    return true;
+}
+#endif
+
+} // namespace
+
+/*
+ *  LogCompressor::LogCompressor
+ *
+ *  Description:
+ *      Constructor for the LogCompressor object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogCompressor::LogCompressor() :
+    compression(LogCompression::None),
+    level(0),
+    context(nullptr)
+{
+}
+
+/*
+ *  LogCompressor::~LogCompressor
+ *
+ *  Description:
+ *      Destructor for the LogCompressor object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogCompressor::~LogCompressor()
+{
+    Stop();
+}
+
+/*
+ *  LogCompressor::IsAvailable
+ *
+ *  Description:
+ *      Indicates whether the given format is supported by this build.
+ *
+ *  Parameters:
+ *      compression [in]
+ *          The format in question.
+ *
+ *  Returns:
+ *      True if blocks may be compressed in the given format, false
+ *      otherwise.
+ *
+ *  Comments:
+ *      None is always available.
+ */
+bool LogCompressor::IsAvailable(LogCompression compression)
+{
+    switch (compression)
+    {
+        case LogCompression::None:
+            return true;
+
+#ifdef LOGGER_ZLIB_ENABLED
+        case LogCompression::Gzip:
+            return true;
+#endif
+
+#ifdef LOGGER_ZSTD_ENABLED
+        case LogCompression::Zstd:
+            return true;
+#endif
+
+#ifdef LOGGER_LZ4_ENABLED
+        case LogCompression::Lz4:
+            return true;
+#endif
+
+        default:
+            return false;
+    }
+}
+
+/*
+ *  LogCompressor::Start
+ *
+ *  Description:
+ *      Create the context used to compress blocks in the given format.
+ *
+ *  Parameters:
+ *      compression [in]
+ *          The format in which to compress blocks.
+ *
+ *      level [in]
+ *          The compression level, with the meaning given by the format's
+ *          library.  Zero selects the library's default level.
+ *
+ *  Returns:
+ *      True if the compressor is ready, false if the format is not
+ *      available or the context could not be created.
+ *
+ *  Comments:
+ *      Any previous context is released first.
+ */
+bool LogCompressor::Start(LogCompression compression, int level)
+{
+    Stop();
+
+    if (!IsAvailable(compression)) return false;
+
+    switch (compression)
+    {
+#ifdef LOGGER_ZLIB_ENABLED
+        case LogCompression::Gzip:
+        {
+            auto stream = new z_stream{};
+
+            // Adding 16 to the window size selects the gzip wrapper
+            if (deflateInit2(stream,
+                             (level == 0) ? Z_DEFAULT_COMPRESSION : level,
+                             Z_DEFLATED,
+                             MAX_WBITS + 16,
+                             8,
+                             Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                delete stream;
+                return false;
+            }
+            context = stream;
+            break;
+        }
+#endif
+
+#ifdef LOGGER_ZSTD_ENABLED
+        case LogCompression::Zstd:
+        {
+            ZSTD_CCtx *zstd_context = ZSTD_createCCtx();
+
+            if (zstd_context == nullptr) return false;
+            ZSTD_CCtx_setParameter(zstd_context,
+                                   ZSTD_c_compressionLevel,
+                                   level);
+            ZSTD_CCtx_setParameter(zstd_context, ZSTD_c_checksumFlag, 1);
+            context = zstd_context;
+            break;
+        }
+#endif
+
+#ifdef LOGGER_LZ4_ENABLED
+        case LogCompression::Lz4:
+        {
+            LZ4F_cctx *lz4_context = nullptr;
+
+            if (LZ4F_isError(LZ4F_createCompressionContext(&lz4_context,
+                                                           LZ4F_VERSION)))
+            {
+                return false;
+            }
+            context = lz4_context;
+            break;
+        }
+#endif
+
+        default:
+            break;
+    }
+
+    this->compression = compression;
+    this->level = level;
+
+    return true;
+}
+
+/*
+ *  LogCompressor::Stop
+ *
+ *  Description:
+ *      Release the compression context.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogCompressor::Stop()
+{
+    switch (compression)
+    {
+#ifdef LOGGER_ZLIB_ENABLED
+        case LogCompression::Gzip:
+            deflateEnd(static_cast<z_stream *>(context));
+            delete static_cast<z_stream *>(context);
+            break;
+#endif
+
+#ifdef LOGGER_ZSTD_ENABLED
+        case LogCompression::Zstd:
+            ZSTD_freeCCtx(static_cast<ZSTD_CCtx *>(context));
+            break;
+#endif
+
+#ifdef LOGGER_LZ4_ENABLED
+        case LogCompression::Lz4:
+            LZ4F_freeCompressionContext(static_cast<LZ4F_cctx *>(context));
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    compression = LogCompression::None;
+    context = nullptr;
+}
+
+/*
+ *  LogCompressor::Compress
+ *
+ *  Description:
+ *      Compress the given parts as a single frame, appending the frame to
+ *      the output.
+ *
+ *  Parameters:
+ *      parts [in]
+ *          The data to compress, which is treated as contiguous.
+ *
+ *      count [in]
+ *          The number of parts.
+ *
+ *      output [in/out]
+ *          The vector to which the frame is appended.  Its capacity is
+ *          reused, so that compressing blocks of a similar size does not
+ *          allocate memory.
+ *
+ *  Returns:
+ *      True if the data was compressed, false otherwise, in which case the
+ *      output is left as it was.
+ *
+ *  Comments:
+ *      With no compression, the parts are appended as given.
+ */
+bool LogCompressor::Compress(const std::string_view *parts,
+                             std::size_t count,
+                             std::vector<char> &output)
+{
+    std::size_t used = output.size();
+    bool result = false;
+
+    switch (compression)
+    {
+#ifdef LOGGER_ZLIB_ENABLED
+        case LogCompression::Gzip:
+            result = CompressGzip(static_cast<z_stream *>(context),
+                                  parts,
+                                  count,
+                                  output);
+            break;
+#endif
+
+#ifdef LOGGER_ZSTD_ENABLED
+        case LogCompression::Zstd:
+            result = CompressZstd(static_cast<ZSTD_CCtx *>(context),
+                                  parts,
+                                  count,
+                                  output);
+            break;
+#endif
+
+#ifdef LOGGER_LZ4_ENABLED
+        case LogCompression::Lz4:
+            result = CompressLz4(static_cast<LZ4F_cctx *>(context),
+                                 level,
+                                 parts,
+                                 count,
+                                 output);
+            break;
+#endif
+
+        default:
+            for (std::size_t i = 0; i < count; i++)
+            {
+                output.insert(output.end(), parts[i].begin(), parts[i].end());
+            }
+            result = true;
+            break;
+    }
+
+    if (!result) output.resize(used);
+
+    return result;
+}
+
+} // namespace cantina
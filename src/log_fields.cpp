@@ -0,0 +1,361 @@
+/*
+ *  log_fields.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the functions used to log structured fields and to
+ *      write messages as JSON Lines.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include <array>
+#include "cantina/log_fields.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+/*
+ *  MakeJsonEscapes
+ *
+ *  Description:
+ *      Build the table indicating how each character is to be escaped
+ *      within a JSON string.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A table indexed by character holding zero if the character needs no
+ *      escaping, the character following the backslash if it has a short
+ *      escape sequence, or 'u' if it must be written as "\u00XX".
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::array<char, 256> MakeJsonEscapes()
+{
+    std::array<char, 256> escapes{};
+
+    for (std::size_t i = 0; i < 0x20; i++) escapes[i] = 'u';
+
+    escapes['"'] = '"';
+    escapes['\\'] = '\\';
+    escapes['\b'] = 'b';
+    escapes['\f'] = 'f';
+    escapes['\n'] = 'n';
+    escapes['\r'] = 'r';
+    escapes['\t'] = 't';
+
+    return escapes;
+}
+
+constexpr std::array<char, 256> Json_Escapes = MakeJsonEscapes();
+
+/*
+ *  AppendJsonComponents
+ *
+ *  Description:
+ *      Append the component names in a component prefix (e.g.,
+ *      "[Foo] [Bar] ") as the elements of a JSON array.
+ *
+ *  Parameters:
+ *      line [out]
+ *          The string to which the elements are appended.
+ *
+ *      prefix [in]
+ *          The component prefix.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Parsing stops at any text not having the form of a prefix.
+ */
+void AppendJsonComponents(std::string &line, std::string_view prefix)
+{
+    std::size_t position = 0;
+
+    while ((position < prefix.size()) && (prefix[position] == '['))
+    {
+        std::size_t end = prefix.find("] ", position + 1);
+        if (end == std::string_view::npos) break;
+
+        if (position > 0) line += ',';
+        line += '"';
+        AppendJsonEscaped(line,
+                          prefix.substr(position + 1, end - position - 1));
+        line += '"';
+
+        position = end + 2;
+    }
+}
+
+/*
+ *  AppendJsonFields
+ *
+ *  Description:
+ *      Append structured fields, formatted as " name=value" by
+ *      FormatLogFields(), as members of a JSON object.
+ *
+ *  Parameters:
+ *      line [out]
+ *          The string to which the members are appended, each preceded by
+ *          a comma.
+ *
+ *      fields [in]
+ *          The formatted fields.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Values are already quoted and escaped as required by JSON, so each
+ *      is copied as is.
+ */
+void AppendJsonFields(std::string &line, std::string_view fields)
+{
+    std::size_t position = 0;
+
+    while (position < fields.size())
+    {
+        if (fields[position] == ' ')
+        {
+            position++;
+            continue;
+        }
+
+        std::size_t equals = fields.find('=', position);
+        if (equals == std::string_view::npos) break;
+
+        line += ",\"";
+        AppendJsonEscaped(line, fields.substr(position, equals - position));
+        line += "\":";
+
+        // Find the end of the value, which is a quoted string or a literal
+        std::size_t start = equals + 1;
+        std::size_t end = start;
+        if ((end < fields.size()) && (fields[end] == '"'))
+        {
+            for (end++; (end < fields.size()) && (fields[end] != '"'); end++)
+            {
+                if (fields[end] == '\\') end++;
+            }
+            end = std::min(end + 1, fields.size());
+        }
+        else
+        {
+            end = std::min(fields.find(' ', start), fields.size());
+        }
+
+        if (end == start)
+        {
+            line += "null";
+        }
+        else
+        {
+            line.append(fields.data() + start, end - start);
+        }
+
+        position = end;
+    }
+}
+
+} // namespace
+
+/*
+ *  AppendJsonEscaped
+ *
+ *  Description:
+ *      Append text to the buffer, escaping characters as required within a
+ *      JSON string.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          The string to which text is appended.
+ *
+ *      text [in]
+ *          The text to append.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Runs of characters needing no escaping are appended at once.
+ *      Characters beyond ASCII are copied as is, so UTF-8 text remains
+ *      UTF-8.
+ */
+void AppendJsonEscaped(std::string &buffer, std::string_view text)
+{
+    static constexpr char Hex_Digits[] = "0123456789abcdef";
+
+    std::size_t start = 0;
+
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        auto character = static_cast<unsigned char>(text[i]);
+        char escape = Json_Escapes[character];
+
+        if (escape == 0) continue;
+
+        buffer.append(text.data() + start, i - start);
+        buffer += '\\';
+        buffer += escape;
+        if (escape == 'u')
+        {
+            buffer += "00";
+            buffer += Hex_Digits[character >> 4];
+            buffer += Hex_Digits[character & 0x0f];
+        }
+
+        start = i + 1;
+    }
+
+    buffer.append(text.data() + start, text.size() - start);
+}
+
+/*
+ *  AppendLogFieldString
+ *
+ *  Description:
+ *      Append text as the quoted value of a field.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          The string to which the value is appended.
+ *
+ *      text [in]
+ *          The text of the value.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void AppendLogFieldString(std::string &buffer, std::string_view text)
+{
+    buffer += '"';
+    AppendJsonEscaped(buffer, text);
+    buffer += '"';
+}
+
+/*
+ *  AppendJsonLine
+ *
+ *  Description:
+ *      Append a JSON object representing a message to the line.
+ *
+ *  Parameters:
+ *      line [out]
+ *          The string to which the object is appended.
+ *
+ *      timestamp [in]
+ *          The formatted timestamp of the message.
+ *
+ *      level [in]
+ *          The name of the message's level.
+ *
+ *      text [in]
+ *          The text of the message, including any component prefix and
+ *          trailing fields.
+ *
+ *      layout [in]
+ *          The lengths of the component prefix and fields within the text,
+ *          and the call site to be written, if any.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The "component" member is omitted if there is no component prefix,
+ *      and the "file", "line", and "function" members if there is no call
+ *      site.
+ */
+void AppendJsonLine(std::string &line,
+                    std::string_view timestamp,
+                    std::string_view level,
+                    std::string_view text,
+                    const LogTextLayout &layout)
+{
+    std::size_t prefix_length = std::min(layout.prefix_length, text.size());
+    std::size_t fields_length = std::min(layout.fields_length,
+                                         text.size() - prefix_length);
+
+    line += "{\"time\":\"";
+    AppendJsonEscaped(line, timestamp);
+    line += "\",\"level\":\"";
+    line += level;
+    line += '"';
+
+    if (prefix_length > 0)
+    {
+        line += ",\"component\":[";
+        AppendJsonComponents(line, text.substr(0, prefix_length));
+        line += ']';
+    }
+
+    if (layout.site != nullptr)
+    {
+        line += ",\"file\":\"";
+        AppendJsonEscaped(line, layout.site->file);
+        line += "\",\"line\":";
+        AppendLogFieldValue(line, layout.site->line);
+        line += ",\"function\":\"";
+        AppendJsonEscaped(line, layout.site->function);
+        line += '"';
+    }
+
+    line += ",\"msg\":\"";
+    AppendJsonEscaped(line,
+                      text.substr(prefix_length,
+                                  text.size() - prefix_length -
+                                      fields_length));
+    line += '"';
+
+    AppendJsonFields(line, text.substr(text.size() - fields_length));
+
+    line += '}';
+}
+
+} // namespace cantina
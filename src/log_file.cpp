@@ -0,0 +1,711 @@
+/*
+ *  log_file.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the LogFile class, which buffers log output
+ *      and writes it to a file according to a LogFlushPolicy, optionally
+ *      compressing each block of output.
+ *
+ *  Portability Issues:
+ *      Uses POSIX file descriptors (or the equivalent functions in io.h on
+ *      Windows) so that buffered output is written with a single call.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "cantina/log_file.h"
+
+namespace cantina
+{
+
+/*
+ *  LogFile::LogFile
+ *
+ *  Description:
+ *      Constructor for the LogFile object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFile::LogFile() :
+    fd(-1),
+    block(nullptr),
+    block_size(0),
+    buffered(0),
+    unsynced(false)
+{
+}
+
+/*
+ *  LogFile::~LogFile
+ *
+ *  Description:
+ *      Destructor for the LogFile object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Any buffered output is written before the file is closed.
+ */
+LogFile::~LogFile()
+{
+    Close();
+}
+
+/*
+ *  LogFile::Open
+ *
+ *  Description:
+ *      Open the given file for appending log output.
+ *
+ *  Parameters:
+ *      filename [in]
+ *          The name of the file to open.
+ *
+ *      flush_policy [in]
+ *          The policy controlling when buffered output is written.
+ *
+ *  Returns:
+ *      True if the file was opened, false otherwise, including when the
+ *      requested compression is not available.
+ *
+ *  Comments:
+ *      Any previously opened file is closed first.  If asynchronous output
+ *      is requested but io_uring is not available, output is written
+ *      synchronously.
+ */
+bool LogFile::Open(const std::string &filename,
+                   const LogFlushPolicy &flush_policy)
+{
+    Close();
+
+#ifdef _WIN32
+    fd = _open(filename.c_str(),
+               _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY,
+               _S_IREAD | _S_IWRITE);
+#else
+    fd = open(filename.c_str(),
+              O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC,
+              0644);
+#endif
+    if (fd < 0) return false;
+
+    this->flush_policy = flush_policy;
+
+    if ((flush_policy.compression != LogCompression::None) &&
+        !compressor.Start(flush_policy.compression,
+                          flush_policy.compression_level))
+    {
+        Close();
+        return false;
+    }
+
+    // Buffer a block of output, or a typical line when writing each line
+    if (flush_policy.buffer_size > 0)
+    {
+        block_size = flush_policy.buffer_size;
+    }
+    else
+    {
+        block_size = WritesEachRecord() ? 1024 : Default_Block_Size;
+    }
+    buffered = 0;
+    unsynced = false;
+    last_flush = std::chrono::steady_clock::now();
+    last_sync = last_flush;
+
+    // When writing asynchronously, uncompressed output is buffered in the
+    // ring's buffers so that each block is submitted without a copy
+    if (flush_policy.async_io && uring.Start(fd, block_size) &&
+        (compressor.GetCompression() == LogCompression::None))
+    {
+        block = uring.Acquire();
+        if (block != nullptr) return true;
+
+        uring.Stop();
+    }
+
+    buffer.resize(block_size);
+    block = buffer.data();
+
+    return true;
+}
+
+/*
+ *  LogFile::IsOpen
+ *
+ *  Description:
+ *      Indicates whether the file is open.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the file is open, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool LogFile::IsOpen() const
+{
+    return fd >= 0;
+}
+
+/*
+ *  LogFile::Close
+ *
+ *  Description:
+ *      Write any buffered output and close the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogFile::Close()
+{
+    if (fd < 0) return;
+
+    Flush();
+    uring.Stop();
+
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+
+    fd = -1;
+    block = nullptr;
+    block_size = 0;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    compressor.Stop();
+    frame.clear();
+    frame.shrink_to_fit();
+}
+
+/*
+ *  LogFile::WriteLine
+ *
+ *  Description:
+ *      Write a line of log output to the file, appending a newline.  The
+ *      line is buffered and written according to the flush policy.
+ *
+ *  Parameters:
+ *      data [in]
+ *          The line to write.
+ *
+ *      length [in]
+ *          The length of the line.
+ *
+ *      urgent [in]
+ *          The line is an Error or Critical message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogFile::WriteLine(const char *data, std::size_t length, bool urgent)
+{
+    const std::string_view parts[2] = {std::string_view(data, length), "\n"};
+
+    Write(parts, 2, urgent);
+}
+
+/*
+ *  LogFile::Write
+ *
+ *  Description:
+ *      Write a record made of the given parts to the file.  The record is
+ *      buffered and written according to the flush policy.
+ *
+ *  Parameters:
+ *      parts [in]
+ *          The parts of the record to be written contiguously.
+ *
+ *      count [in]
+ *          The number of parts, which must not exceed Max_Parts.
+ *
+ *      urgent [in]
+ *          The record is an Error or Critical message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Records larger than the buffer are written (or compressed) directly
+ *      without copying, unless writing asynchronously, in which case they
+ *      are copied into the ring's buffers.
+ */
+void LogFile::Write(const std::string_view *parts,
+                    std::size_t count,
+                    bool urgent)
+{
+    std::size_t length = 0;
+
+    if ((fd < 0) || (count > Max_Parts)) return;
+
+    for (std::size_t i = 0; i < count; i++) length += parts[i].size();
+
+    // Make room for the record if the buffer is too full
+    if (buffered + length > block_size)
+    {
+        if (WritesEachRecord() && !uring.IsRunning())
+        {
+            // Grow the buffer, since each record is written individually
+            buffer.resize(buffered + length);
+            block = buffer.data();
+            block_size = buffer.size();
+        }
+        else
+        {
+            WriteBuffer();
+        }
+    }
+
+    if (length > block_size)
+    {
+        if (compressor.GetCompression() != LogCompression::None)
+        {
+            // Compress an oversized record as a frame of its own
+            WriteFrame(parts, count);
+            last_flush = std::chrono::steady_clock::now();
+            SyncIfDue();
+            return;
+        }
+
+        // Write an oversized record directly
+        WriteVector(parts, count);
+        last_flush = std::chrono::steady_clock::now();
+        SyncIfDue();
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::memcpy(block + buffered, parts[i].data(), parts[i].size());
+        buffered += parts[i].size();
+    }
+
+    // Error and Critical messages are not left in flight
+    if (urgent && flush_policy.flush_on_error)
+    {
+        Flush();
+        return;
+    }
+
+    if (WritesEachRecord() || (buffered >= block_size))
+    {
+        WriteBuffer();
+        return;
+    }
+
+    FlushIfDue();
+}
+
+/*
+ *  LogFile::WriteVector
+ *
+ *  Description:
+ *      Write the given parts to the file, using a single call to writev()
+ *      where possible and retrying any portion not written.
+ *
+ *  Parameters:
+ *      parts [in]
+ *          The parts to write contiguously.
+ *
+ *      count [in]
+ *          The number of parts, which must not exceed Max_Parts.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When writing asynchronously, each part is copied into the ring's
+ *      buffers instead.
+ */
+void LogFile::WriteVector(const std::string_view *parts, std::size_t count)
+{
+#ifndef _WIN32
+    if (!uring.IsRunning())
+    {
+        struct iovec iov[Max_Parts];
+        for (std::size_t i = 0; i < count; i++)
+        {
+            iov[i].iov_base = const_cast<char *>(parts[i].data());
+            iov[i].iov_len = parts[i].size();
+        }
+
+        ssize_t result;
+        do
+        {
+            result = writev(fd, iov, static_cast<int>(count));
+        } while ((result < 0) && (errno == EINTR));
+
+        // Write any remaining portion if the write was partial
+        std::size_t written = (result > 0) ? static_cast<std::size_t>(result) :
+                                             0;
+        for (std::size_t i = 0; (result >= 0) && (i < count); i++)
+        {
+            if (written >= parts[i].size())
+            {
+                written -= parts[i].size();
+                continue;
+            }
+
+            WriteFully(parts[i].data() + written, parts[i].size() - written);
+            written = 0;
+        }
+        unsynced = true;
+        return;
+    }
+#endif
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        WriteFully(parts[i].data(), parts[i].size());
+    }
+}
+
+/*
+ *  LogFile::Flush
+ *
+ *  Description:
+ *      Write any buffered output to the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When writing asynchronously, this waits for all submitted writes to
+ *      complete.
+ */
+void LogFile::Flush()
+{
+    WriteBuffer();
+    uring.Wait();
+}
+
+/*
+ *  LogFile::FlushIfDue
+ *
+ *  Description:
+ *      Write any buffered output to the file if the flush interval given
+ *      in the flush policy has elapsed since output was last written, and
+ *      sync the file if the sync interval has elapsed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Writes submitted asynchronously are not waited for.
+ */
+void LogFile::FlushIfDue()
+{
+    if ((buffered > 0) &&
+        (flush_policy.interval.count() > 0) &&
+        (std::chrono::steady_clock::now() - last_flush >=
+         flush_policy.interval))
+    {
+        WriteBuffer();
+        return;
+    }
+
+    SyncIfDue();
+}
+
+/*
+ *  LogFile::GetFlushInterval
+ *
+ *  Description:
+ *      Return the interval at which buffered output is written or the file
+ *      is synced, whichever is shorter.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The interval, which is zero if there is none.
+ *
+ *  Comments:
+ *      None.
+ */
+std::chrono::milliseconds LogFile::GetFlushInterval() const
+{
+    if (flush_policy.sync_interval.count() <= 0) return flush_policy.interval;
+    if (flush_policy.interval.count() <= 0) return flush_policy.sync_interval;
+
+    return std::min(flush_policy.interval, flush_policy.sync_interval);
+}
+
+/*
+ *  LogFile::WritesEachRecord
+ *
+ *  Description:
+ *      Indicates whether each record is written as soon as it is given,
+ *      which is the case when the flush policy gives no buffer size and no
+ *      compression.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if each record is written individually, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool LogFile::WritesEachRecord() const
+{
+    return (flush_policy.buffer_size == 0) &&
+           (flush_policy.compression == LogCompression::None);
+}
+
+/*
+ *  LogFile::WriteBuffer
+ *
+ *  Description:
+ *      Write any buffered output to the file, or submit it to be written
+ *      when writing asynchronously.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When compressing, the buffered output is written as a complete
+ *      frame.  When writing asynchronously, the buffer is submitted without
+ *      a copy and another of the ring's buffers takes its place.
+ */
+void LogFile::WriteBuffer()
+{
+    if ((fd >= 0) && (buffered > 0))
+    {
+        if (compressor.GetCompression() != LogCompression::None)
+        {
+            const std::string_view data(block, buffered);
+            WriteFrame(&data, 1);
+        }
+        else if (uring.IsRunning())
+        {
+            uring.Submit(block, buffered);
+            unsynced = true;
+
+            block = uring.Acquire();
+            if (block == nullptr)
+            {
+                // Write synchronously should the ring fail
+                uring.Stop();
+                buffer.resize(block_size);
+                block = buffer.data();
+            }
+        }
+        else
+        {
+            WriteFully(block, buffered);
+        }
+    }
+
+    buffered = 0;
+    last_flush = std::chrono::steady_clock::now();
+
+    SyncIfDue();
+}
+
+/*
+ *  LogFile::WriteFrame
+ *
+ *  Description:
+ *      Compress the given parts as a single frame and write the frame to
+ *      the file.
+ *
+ *  Parameters:
+ *      parts [in]
+ *          The data to compress.
+ *
+ *      count [in]
+ *          The number of parts.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Output is discarded if it cannot be compressed, as with output that
+ *      cannot be written.
+ */
+void LogFile::WriteFrame(const std::string_view *parts, std::size_t count)
+{
+    frame.clear();
+
+    if (compressor.Compress(parts, count, frame))
+    {
+        WriteFully(frame.data(), frame.size());
+    }
+}
+
+/*
+ *  LogFile::WriteFully
+ *
+ *  Description:
+ *      Write the given data to the file, retrying partial writes.
+ *
+ *  Parameters:
+ *      data [in]
+ *          The data to write.
+ *
+ *      length [in]
+ *          The length of the data.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Output is discarded on error, since there is no safe way to log
+ *      a failure to write log output.  When writing asynchronously, the
+ *      data is copied into the ring's buffers and submitted.
+ */
+void LogFile::WriteFully(const char *data, std::size_t length)
+{
+    unsynced = true;
+
+    if (uring.IsRunning())
+    {
+        uring.Write(data, length);
+        return;
+    }
+
+    while (length > 0)
+    {
+#ifdef _WIN32
+        int result = _write(fd, data, static_cast<unsigned>(length));
+#else
+        ssize_t result = write(fd, data, length);
+#endif
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        data += result;
+        length -= static_cast<std::size_t>(result);
+    }
+}
+
+/*
+ *  LogFile::SyncIfDue
+ *
+ *  Description:
+ *      Write the file's data to the device if output was written since the
+ *      last sync and the sync interval given in the flush policy has
+ *      elapsed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When writing asynchronously, the sync is submitted to follow the
+ *      writes already submitted.  Otherwise, this waits for the device.
+ */
+void LogFile::SyncIfDue()
+{
+    if (!unsynced || (flush_policy.sync_interval.count() <= 0)) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_sync < flush_policy.sync_interval) return;
+
+    if (uring.IsRunning())
+    {
+        // A sync already in flight is left to complete first
+        if (!uring.Sync()) return;
+    }
+    else
+    {
+#if defined(_WIN32)
+        _commit(fd);
+#elif defined(__APPLE__)
+        fsync(fd);
+#else
+        fdatasync(fd);
+#endif
+    }
+
+    unsynced = false;
+    last_sync = now;
+}
+
+} // namespace cantina
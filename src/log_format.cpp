@@ -0,0 +1,442 @@
+/*
+ *  log_format.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the functions used to format log messages
+ *      from a format string and a list of arguments.  Numeric values are
+ *      converted using std::to_chars, which is independent of the locale.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <string>
+#include "cantina/log_format.h"
+
+namespace cantina
+{
+
+/*
+ *  LogTextBuffer::LogTextBuffer
+ *
+ *  Description:
+ *      Constructor for the LogTextBuffer object, which borrows one of the
+ *      calling thread's reusable text buffers.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Buffers are borrowed and returned in last-in, first-out order, as
+ *      LogTextBuffer objects are only ever created on the stack.
+ */
+LogTextBuffer::LogTextBuffer() : text(&local)
+{
+    ThreadBuffers &buffers = GetThreadBuffers();
+
+    if (buffers.depth < Max_Thread_Buffers)
+    {
+        text = &buffers.text[buffers.depth++];
+    }
+}
+
+/*
+ *  LogTextBuffer::~LogTextBuffer
+ *
+ *  Description:
+ *      Destructor for the LogTextBuffer object, which returns the borrowed
+ *      buffer for reuse.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogTextBuffer::~LogTextBuffer()
+{
+    if (text != &local) GetThreadBuffers().depth--;
+}
+
+/*
+ *  LogTextBuffer::GetThreadBuffers
+ *
+ *  Description:
+ *      Return the calling thread's reusable text buffers.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the thread's buffers.
+ *
+ *  Comments:
+ *      None.
+ */
+LogTextBuffer::ThreadBuffers &LogTextBuffer::GetThreadBuffers()
+{
+    static thread_local ThreadBuffers thread_buffers{};
+
+    return thread_buffers;
+}
+
+/*
+ *  AppendLogLiteral
+ *
+ *  Description:
+ *      Append the literal text of the format string, starting at the given
+ *      position, up to the next "{}" placeholder.  Escaped braces ("{{" and
+ *      "}}") are appended as single braces.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          The string to which text is appended.
+ *
+ *      format [in]
+ *          The format string.
+ *
+ *      position [in]
+ *          The position in the format string at which to start.
+ *
+ *  Returns:
+ *      The position following the placeholder, or std::string_view::npos if
+ *      the end of the format string was reached without a placeholder.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t AppendLogLiteral(std::string &buffer,
+                             std::string_view format,
+                             std::size_t position)
+{
+    std::size_t start = position;
+
+    while (position < format.size())
+    {
+        char c = format[position];
+
+        if (((c == '{') || (c == '}')) && (position + 1 < format.size()))
+        {
+            char next = format[position + 1];
+
+            // Placeholder found
+            if ((c == '{') && (next == '}'))
+            {
+                buffer.append(format.data() + start, position - start);
+                return position + 2;
+            }
+
+            // Escaped brace; append text including one of the braces
+            if (next == c)
+            {
+                buffer.append(format.data() + start, position + 1 - start);
+                position += 2;
+                start = position;
+                continue;
+            }
+        }
+
+        position++;
+    }
+
+    buffer.append(format.data() + start, format.size() - start);
+
+    return std::string_view::npos;
+}
+
+/*
+ *  AppendLogValue
+ *
+ *  Description:
+ *      Append the text representation of the given value to the buffer.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          The string to which text is appended.
+ *
+ *      value [in]
+ *          The value to append.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Floating point values are written using the shortest representation
+ *      that converts back to the same value.
+ */
+void AppendLogValue(std::string &buffer, std::int64_t value)
+{
+    char text[24];
+
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, result.ptr);
+}
+
+void AppendLogValue(std::string &buffer, std::uint64_t value)
+{
+    char text[24];
+
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, result.ptr);
+}
+
+void AppendLogValue(std::string &buffer, double value)
+{
+    char text[32];
+
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, result.ptr);
+}
+
+void AppendLogValue(std::string &buffer, bool value)
+{
+    buffer += value ? "true" : "false";
+}
+
+void AppendLogValue(std::string &buffer, char value)
+{
+    buffer += value;
+}
+
+void AppendLogValue(std::string &buffer, std::string_view value)
+{
+    buffer.append(value.data(), value.size());
+}
+
+/*
+ *  FormatLogUnsigned
+ *
+ *  Description:
+ *      Write the decimal representation of an unsigned value into the
+ *      given buffer, padded with leading zeros to the given width.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The value to format.
+ *
+ *      width [in]
+ *          The minimum number of digits to produce.
+ *
+ *      buffer [out]
+ *          The buffer into which the digits are written, which must have
+ *          space for at least 20 digits or the given width.
+ *
+ *  Returns:
+ *      The number of digits written.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t FormatLogUnsigned(std::uint64_t value,
+                              unsigned width,
+                              char *buffer)
+{
+    char digits[20];
+    std::size_t length = 0;
+
+    do
+    {
+        digits[length++] = static_cast<char>('0' + (value % 10));
+        value /= 10;
+    } while (value > 0);
+
+    std::size_t padding = (width > length) ? width - length : 0;
+    std::fill(buffer, buffer + padding, '0');
+    std::reverse_copy(digits, digits + length, buffer + padding);
+
+    return padding + length;
+}
+
+/*
+ *  FormatLogTimestamp
+ *
+ *  Description:
+ *      Write a string representing the given time down to milliseconds
+ *      or microseconds into the given buffer.
+ *
+ *  Parameters:
+ *      time [in]
+ *          The time to represent as a string.
+ *
+ *      format [in]
+ *          The format of the timestamp.
+ *
+ *      precision [in]
+ *          The number of fractional digits to produce.
+ *
+ *      buffer [out]
+ *          The buffer into which the timestamp is written, which must be
+ *          at least Max_Timestamp_Length octets in length.  The timestamp
+ *          is not NULL-terminated.
+ *
+ *  Returns:
+ *      The length of the timestamp written to the buffer.
+ *
+ *  Comments:
+ *      The portion of the timestamp representing whole seconds changes
+ *      only once per second, so each thread caches that text and only the
+ *      fractional digits are formatted for each call.
+ *
+ *      Times before the epoch are rounded down to the whole second, so
+ *      the fractional digits are never negative.  In the Epoch format,
+ *      such times are instead written with a leading minus sign.
+ */
+std::size_t FormatLogTimestamp(
+    const std::chrono::system_clock::time_point &time,
+    LogTimeFormat format,
+    LogTimePrecision precision,
+    char *buffer)
+{
+    // Cache of the most recently formatted second for this thread
+    struct SecondsCache
+    {
+        bool valid = false;
+        std::int64_t seconds = 0;
+        LogTimeFormat format = LogTimeFormat::LocalTime;
+        std::size_t length = 0;
+        char text[Max_Timestamp_Length]{};
+    };
+    static thread_local SecondsCache cache;
+
+    // Round down so the fraction is never negative before the epoch
+    auto since_epoch = std::chrono::floor<std::chrono::microseconds>(
+                                                time.time_since_epoch());
+    auto whole_seconds = std::chrono::floor<std::chrono::seconds>(since_epoch);
+    std::int64_t seconds = whole_seconds.count();
+    std::uint32_t microseconds =
+        static_cast<std::uint32_t>((since_epoch - whole_seconds).count());
+    std::size_t length;
+
+    if ((format == LogTimeFormat::Epoch) && (seconds < 0))
+    {
+        // Times before the epoch are written as a negative number of
+        // seconds, with the fraction counted toward zero
+        std::uint64_t magnitude =
+            static_cast<std::uint64_t>(-since_epoch.count());
+        buffer[0] = '-';
+        length = 1 + FormatLogUnsigned(magnitude / 1'000'000, 0, buffer + 1);
+        microseconds = static_cast<std::uint32_t>(magnitude % 1'000'000);
+    }
+    else
+    {
+        // Format the whole seconds only if the second has changed
+        if (!cache.valid || (seconds != cache.seconds) ||
+            (format != cache.format))
+        {
+            cache.valid = true;
+            cache.seconds = seconds;
+            cache.format = format;
+
+            if (format == LogTimeFormat::Epoch)
+            {
+                cache.length = FormatLogUnsigned(
+                    static_cast<std::uint64_t>(seconds),
+                    0,
+                    cache.text);
+            }
+            else
+            {
+                std::time_t t = static_cast<std::time_t>(seconds);
+                struct tm tm_result{};
+#ifdef _WIN32
+                if (format == LogTimeFormat::UTC)
+                {
+                    gmtime_s(&tm_result, &t);
+                }
+                else
+                {
+                    localtime_s(&tm_result, &t);
+                }
+#else
+                if (format == LogTimeFormat::UTC)
+                {
+                    gmtime_r(&t, &tm_result);
+                }
+                else
+                {
+                    localtime_r(&t, &tm_result);
+                }
+#endif
+                // YYYY-MM-DDTHH:MM:SS
+                char *p = cache.text;
+                p += FormatLogUnsigned(tm_result.tm_year + 1900, 4, p);
+                *p++ = '-';
+                p += FormatLogUnsigned(tm_result.tm_mon + 1, 2, p);
+                *p++ = '-';
+                p += FormatLogUnsigned(tm_result.tm_mday, 2, p);
+                *p++ = 'T';
+                p += FormatLogUnsigned(tm_result.tm_hour, 2, p);
+                *p++ = ':';
+                p += FormatLogUnsigned(tm_result.tm_min, 2, p);
+                *p++ = ':';
+                p += FormatLogUnsigned(tm_result.tm_sec, 2, p);
+                cache.length = p - cache.text;
+            }
+        }
+
+        // Copy the seconds
+        std::copy(cache.text, cache.text + cache.length, buffer);
+        length = cache.length;
+    }
+
+    // Append the fractional digits
+    buffer[length] = '.';
+
+    if (precision == LogTimePrecision::Milliseconds)
+    {
+        return length + 1 + FormatLogUnsigned(microseconds / 1'000,
+                                              3,
+                                              buffer + length + 1);
+    }
+
+    return length + 1 + FormatLogUnsigned(microseconds,
+                                          6,
+                                          buffer + length + 1);
+}
+
+} // namespace cantina
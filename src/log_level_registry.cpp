@@ -0,0 +1,308 @@
+/*
+ *  log_level_registry.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogLevelRegistry class, which holds log levels
+ *      for components given by their path of component names.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <cctype>
+#include <mutex>
+#include "cantina/log_level_registry.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+// Names of each log level, in the order of the LogLevel enumeration
+constexpr std::string_view Level_Names[Log_Level_Count] =
+{
+    "CRITICAL", "ERROR", "WARNING", "INFO", "DEBUG"
+};
+
+/*
+ *  Trim
+ *
+ *  Description:
+ *      Remove leading and trailing whitespace from the given text.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to trim.
+ *
+ *  Returns:
+ *      The text without surrounding whitespace.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string_view Trim(std::string_view text)
+{
+    while (!text.empty() &&
+           std::isspace(static_cast<unsigned char>(text.front())))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() &&
+           std::isspace(static_cast<unsigned char>(text.back())))
+    {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+} // namespace
+
+/*
+ *  ParseLogLevel
+ *
+ *  Description:
+ *      Convert the name of a log level to a LogLevel value.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the level, which must be one of Critical, Error,
+ *          Warning, Info, or Debug, ignoring case.
+ *
+ *      level [out]
+ *          The level named, if the name is valid.
+ *
+ *  Returns:
+ *      True if the name is valid, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ParseLogLevel(std::string_view name, LogLevel &level)
+{
+    for (std::size_t i = 0; i < Log_Level_Count; i++)
+    {
+        const std::string_view candidate = Level_Names[i];
+
+        if (candidate.size() != name.size()) continue;
+
+        bool match = true;
+        for (std::size_t j = 0; match && (j < name.size()); j++)
+        {
+            match = (std::toupper(static_cast<unsigned char>(name[j])) ==
+                     candidate[j]);
+        }
+
+        if (match)
+        {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ *  LogLevelRegistry::LogLevelRegistry
+ *
+ *  Description:
+ *      Constructor for the LogLevelRegistry object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The registry initially has no rules.
+ */
+LogLevelRegistry::LogLevelRegistry() : epoch(0)
+{
+}
+
+/*
+ *  LogLevelRegistry::SetLevels
+ *
+ *  Description:
+ *      Replace the rules in the registry with those given.
+ *
+ *  Parameters:
+ *      levels [in]
+ *          A comma-separated list of rules, each of the form "path=level",
+ *          where path is a list of component names separated by periods
+ *          (e.g., "Foo.Bar") or "*" to match every component.  A path
+ *          ending in ".*" is the same as the path without it.  An empty
+ *          string removes every rule.
+ *
+ *  Returns:
+ *      True if the rules were replaced, false if the string is invalid, in
+ *      which case the rules are unchanged.
+ *
+ *  Comments:
+ *      Replacing the rules advances the epoch, which causes each component
+ *      to resolve its level again when it next logs a message.
+ */
+bool LogLevelRegistry::SetLevels(std::string_view levels)
+{
+    std::vector<Rule> new_rules;
+
+    while (!Trim(levels).empty())
+    {
+        std::size_t comma = levels.find(',');
+        std::string_view rule = Trim(levels.substr(0, comma));
+        levels = (comma == std::string_view::npos) ?
+                     std::string_view() : levels.substr(comma + 1);
+
+        std::size_t equals = rule.find('=');
+        if (equals == std::string_view::npos) return false;
+
+        std::string_view path = Trim(rule.substr(0, equals));
+        LogLevel level;
+        if (!ParseLogLevel(Trim(rule.substr(equals + 1)), level)) return false;
+
+        if (path == "*")
+        {
+            path = std::string_view();
+        }
+        else if ((path.size() > 2) && (path.substr(path.size() - 2) == ".*"))
+        {
+            path.remove_suffix(2);
+        }
+        else if (path.empty())
+        {
+            return false;
+        }
+
+        new_rules.push_back({std::string(path), level});
+    }
+
+    std::unique_lock<std::shared_mutex> lock(rules_mutex);
+
+    rules.swap(new_rules);
+    epoch.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+/*
+ *  LogLevelRegistry::GetLevels
+ *
+ *  Description:
+ *      Return the rules presently in the registry.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The rules in the form accepted by SetLevels(), or an empty string
+ *      if there are none.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string LogLevelRegistry::GetLevels() const
+{
+    std::string levels;
+
+    std::shared_lock<std::shared_mutex> lock(rules_mutex);
+
+    for (const auto &rule : rules)
+    {
+        if (!levels.empty()) levels += ", ";
+        levels += rule.path.empty() ? std::string("*") : rule.path;
+        levels += '=';
+        levels += Level_Names[static_cast<std::size_t>(rule.level)];
+    }
+
+    return levels;
+}
+
+/*
+ *  LogLevelRegistry::Resolve
+ *
+ *  Description:
+ *      Determine the level given to a component by the rules.
+ *
+ *  Parameters:
+ *      path [in]
+ *          The component's path of component names separated by periods.
+ *
+ *      rules_epoch [out]
+ *          The epoch of the rules consulted.
+ *
+ *  Returns:
+ *      The level of the longest rule matching the path as an integer, or
+ *      -1 if no rule matches.
+ *
+ *  Comments:
+ *      A rule matches the component it names and each component beneath
+ *      it.  If several rules have the same path, the last one applies.
+ */
+int LogLevelRegistry::Resolve(const std::string &path,
+                              std::uint64_t &rules_epoch) const
+{
+    const Rule *match = nullptr;
+
+    std::shared_lock<std::shared_mutex> lock(rules_mutex);
+
+    // Levels read after this are at least as recent as the epoch
+    rules_epoch = epoch.load(std::memory_order_acquire);
+
+    for (const auto &rule : rules)
+    {
+        if (match && (rule.path.size() < match->path.size())) continue;
+
+        if (!rule.path.empty() &&
+            ((path.compare(0, rule.path.size(), rule.path) != 0) ||
+             ((path.size() > rule.path.size()) &&
+              (path[rule.path.size()] != '.'))))
+        {
+            continue;
+        }
+
+        match = &rule;
+    }
+
+    return match ? static_cast<int>(match->level) : -1;
+}
+
+} // namespace cantina
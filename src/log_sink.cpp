@@ -0,0 +1,1385 @@
+/*
+ *  log_sink.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the LogSink class and the sinks for each of
+ *      the logging facilities.
+ *
+ *  Portability Issues:
+ *      The AndroidSink writes to the Android log only on the Android platform.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#ifdef __ANDROID_API__
+#include <android/log.h>
+#endif
+#ifdef LOGGER_SYSLOG_ENABLED
+#include <syslog.h>
+#endif
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include "cantina/log_sink.h"
+#include "cantina/logger.h"
+
+namespace cantina
+{
+
+/*
+ *  LogSink::LogSink
+ *
+ *  Description:
+ *      Constructor for the LogSink object.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogSink::LogSink(LogLevel level) : log_level(level), owner(nullptr)
+{
+}
+
+/*
+ *  LogSink::~LogSink
+ *
+ *  Description:
+ *      Destructor for the LogSink object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Since the background writer thread calls Write(), a derived class
+ *      must call SetAsync(0) from its own destructor if the sink might be
+ *      asynchronous.
+ */
+LogSink::~LogSink()
+{
+}
+
+/*
+ *  LogSink::SetLogLevel
+ *
+ *  Description:
+ *      Set the most verbose level of messages written to this sink.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The most verbose level of messages to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The Logger to which the sink belongs is informed so that messages
+ *      not wanted by any sink may be rejected before they are formatted.
+ */
+void LogSink::SetLogLevel(LogLevel level)
+{
+    log_level = level;
+
+    if (Logger *logger = owner.load()) logger->UpdateSinkLevel();
+}
+
+/*
+ *  LogSink::GetStatsCollector
+ *
+ *  Description:
+ *      Return the statistics of the Logger to which the sink belongs.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The Logger's statistics, or nullptr if the sink belongs to no Logger.
+ *
+ *  Comments:
+ *      None.
+ */
+LogStatsCollector *LogSink::GetStatsCollector() const
+{
+    Logger *logger = owner.load(std::memory_order_relaxed);
+
+    return logger ? logger->stats.get() : nullptr;
+}
+
+/*
+ *  LogSink::GetLogLevel
+ *
+ *  Description:
+ *      Get the most verbose level of messages written to this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The most verbose level of messages written.
+ *
+ *  Comments:
+ *      None.
+ */
+LogLevel LogSink::GetLogLevel() const
+{
+    return log_level;
+}
+
+/*
+ *  LogSink::SetAsync
+ *
+ *  Description:
+ *      Enable writing messages from a background thread, so that a slow
+ *      destination does not delay the thread writing to the other sinks.
+ *
+ *  Parameters:
+ *      queue_capacity [in]
+ *          The maximum number of messages that may be queued, which is
+ *          rounded up to a power of two.  A value of zero will disable
+ *          asynchronous writing after writing any queued messages.
+ *
+ *      policy [in]
+ *          The action taken when the queue is full.  By default, the thread
+ *          logging the message waits for space.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This should be called before the sink is given to a Logger, as
+ *      changing the mode while messages are written is not synchronized.
+ *      When messages have been discarded, a Warning message noting the
+ *      number discarded is written before the next queued message.
+ */
+void LogSink::SetAsync(std::size_t queue_capacity,
+                       const LogQueuePolicy &policy)
+{
+    async_queue.Stop();
+
+    if (queue_capacity == 0) return;
+
+    async_queue.Start(
+        queue_capacity,
+        [this](QueuedMessage &queued)
+        {
+            std::string_view line = queued.line.View();
+            Write(LogMessage{queued.level,
+                             queued.console,
+                             queued.time,
+                             line.substr(0, queued.line_length),
+                             line.substr(queued.text_offset),
+                             queued.format});
+        },
+        [this]() -> std::chrono::milliseconds
+        {
+            return FlushIfDue();
+        },
+        policy,
+        [this](QueuedMessage &next, std::uint64_t count)
+        {
+            WriteDropMarker(next, count);
+        },
+        [](const QueuedMessage &queued)
+        {
+            return LogQueueOrder(queued.time);
+        });
+}
+
+/*
+ *  LogSink::WriteDropMarker
+ *
+ *  Description:
+ *      Write a Warning message noting the number of messages discarded
+ *      because the queue was full.
+ *
+ *  Parameters:
+ *      next [in]
+ *          The queued message following those discarded, whose timestamp
+ *          and format are used for the warning.
+ *
+ *      count [in]
+ *          The number of messages discarded.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogSink::WriteDropMarker(const QueuedMessage &next, std::uint64_t count)
+{
+    std::string_view next_line = next.line.View();
+    std::string text = LogDropMarker(count);
+    std::string line;
+
+    if (next.format == LogOutputFormat::JsonLines)
+    {
+        line.assign(next_line.substr(0, next_line.find(",\"level\"")));
+        line += ",\"level\":\"WARNING\",\"msg\":\"";
+        line += text;
+        line += "\"}";
+    }
+    else
+    {
+        line.assign(next_line.substr(0, next_line.find(" [")));
+        line += " [WARNING] ";
+        line += text;
+    }
+
+    Write(LogMessage{LogLevel::Warning,
+                     false,
+                     next.time,
+                     line,
+                     text,
+                     next.format});
+}
+
+/*
+ *  LogSink::IsAsync
+ *
+ *  Description:
+ *      Indicates whether messages are written from a background thread.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if writing is asynchronous, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool LogSink::IsAsync() const
+{
+    return async_queue.IsRunning();
+}
+
+/*
+ *  LogSink::GetDropCounts
+ *
+ *  Description:
+ *      Return the number of messages at each level discarded because the
+ *      queue was full.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of messages discarded, indexed by level.
+ *
+ *  Comments:
+ *      None.
+ */
+LogDropCounts LogSink::GetDropCounts() const
+{
+    return async_queue.GetDropCounts();
+}
+
+/*
+ *  LogSink::GetFacility
+ *
+ *  Description:
+ *      Return the logging facility implemented by this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The logging facility, or LogFacility::None if the sink does not
+ *      correspond to one of the Logger's facilities.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility LogSink::GetFacility() const
+{
+    return LogFacility::None;
+}
+
+/*
+ *  LogSink::Submit
+ *
+ *  Description:
+ *      Write the message to the destination or, if asynchronous, place a
+ *      copy of the message into the queue.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The Logger checks the sink's log level before calling this.
+ */
+void LogSink::Submit(const LogMessage &message)
+{
+    if (!async_queue.IsRunning())
+    {
+        Write(message);
+        return;
+    }
+
+    QueuedMessage queued{message.level,
+                         message.console,
+                         message.time,
+                         LogRecordText(message.line),
+                         message.line.size(),
+                         0,
+                         message.format};
+
+    // The text of a JSON line is held after the line
+    if (message.format == LogOutputFormat::Text)
+    {
+        queued.text_offset = static_cast<std::size_t>(message.text.data() -
+                                                      message.line.data());
+    }
+    else
+    {
+        queued.text_offset = message.line.size();
+        queued.line.Append(message.text);
+    }
+
+    async_queue.Push(std::move(queued));
+}
+
+/*
+ *  LogSink::Flush
+ *
+ *  Description:
+ *      Wait until all queued messages have been written and then write
+ *      any buffered output.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogSink::Flush()
+{
+    async_queue.Flush();
+    FlushOutput();
+}
+
+/*
+ *  LogSink::FlushIfDue
+ *
+ *  Description:
+ *      Write any buffered output if the flush interval has elapsed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The flush interval, or zero if there is none.
+ *
+ *  Comments:
+ *      None.
+ */
+std::chrono::milliseconds LogSink::FlushIfDue()
+{
+    return std::chrono::milliseconds(0);
+}
+
+/*
+ *  LogSink::FlushOutput
+ *
+ *  Description:
+ *      Write any buffered output to the destination.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogSink::FlushOutput()
+{
+}
+
+/*
+ *  ConsoleSink::ConsoleSink
+ *
+ *  Description:
+ *      Constructor for the ConsoleSink object.
+ *
+ *  Parameters:
+ *      colorize [in]
+ *          Should console output be colorized?
+ *
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *      flush_policy [in]
+ *          If async_io is set, output is written through io_uring where
+ *          available, using buffers of buffer_size octets.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Other output written directly to standard error is not ordered with
+ *      respect to output submitted through io_uring.
+ */
+ConsoleSink::ConsoleSink(bool colorize,
+                         LogLevel level,
+                         const LogFlushPolicy &flush_policy) :
+    LogSink(level),
+    colorize(colorize),
+    flush_on_error(flush_policy.flush_on_error)
+{
+#ifndef _WIN32
+    if (flush_policy.async_io)
+    {
+        uring.Start(STDERR_FILENO,
+                    (flush_policy.buffer_size > 0) ? flush_policy.buffer_size :
+                                                     Default_Buffer_Size);
+    }
+#endif
+}
+
+/*
+ *  ConsoleSink::~ConsoleSink
+ *
+ *  Description:
+ *      Destructor for the ConsoleSink object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+ConsoleSink::~ConsoleSink()
+{
+    SetAsync(0);
+}
+
+/*
+ *  ConsoleSink::Colorize
+ *
+ *  Description:
+ *      Enable or disable colorized console output.
+ *
+ *  Parameters:
+ *      colorize_output [in]
+ *          Indicates whether console output should be colorized or not.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ConsoleSink::Colorize(bool colorize_output)
+{
+    colorize = colorize_output;
+}
+
+/*
+ *  ConsoleSink::IsColorized
+ *
+ *  Description:
+ *      Indicates whether console output is colorized.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if console output is colorized, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ConsoleSink::IsColorized() const
+{
+    return colorize;
+}
+
+/*
+ *  ConsoleSink::GetFacility
+ *
+ *  Description:
+ *      Return the logging facility implemented by this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      LogFacility::Console.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility ConsoleSink::GetFacility() const
+{
+    return LogFacility::Console;
+}
+
+/*
+ *  ConsoleSink::Write
+ *
+ *  Description:
+ *      Write the message to the console (standard error), colorized
+ *      according to its level if colorization is enabled.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The escape sequences, line, and newline are written with one call
+ *      to write(), bypassing std::clog, so that the line is not split by
+ *      other output to standard error.  When writing asynchronously, the
+ *      line is instead submitted through io_uring.
+ */
+void ConsoleSink::Write(const LogMessage &message)
+{
+    LogTextBuffer buffer;
+    std::string &output = buffer.Get();
+
+    // Assemble the entire line so it is written with a single call; JSON
+    // lines are never colorized
+    if (colorize && (message.format == LogOutputFormat::Text))
+    {
+        output = Color_Prefix[static_cast<std::size_t>(message.level)];
+        output += message.line;
+        output += Color_Suffix;
+    }
+    else
+    {
+        output = message.line;
+        output += '\n';
+    }
+
+    std::unique_lock<std::mutex> lock(console_mutex, std::defer_lock);
+    AcquireLock(lock);
+
+#ifdef _WIN32
+    std::fwrite(output.data(), 1, output.size(), stderr);
+    std::fflush(stderr);
+#else
+    if (uring.IsRunning())
+    {
+        uring.Write(output.data(), output.size());
+
+        // Error and Critical messages are not left in flight
+        if (flush_on_error && (message.level <= LogLevel::Error))
+        {
+            uring.Wait();
+        }
+        return;
+    }
+
+    const char *data = output.data();
+    std::size_t remaining = output.size();
+
+    while (remaining > 0)
+    {
+        ssize_t written = write(STDERR_FILENO, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+#endif
+}
+
+/*
+ *  ConsoleSink::FlushOutput
+ *
+ *  Description:
+ *      Wait for any output submitted asynchronously to be written.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ConsoleSink::FlushOutput()
+{
+    std::lock_guard<std::mutex> lock(console_mutex);
+
+    uring.Wait();
+}
+
+/*
+ *  FileSink::FileSink
+ *
+ *  Description:
+ *      Constructor for the FileSink object.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Open() must be called before messages are written.
+ */
+FileSink::FileSink(LogLevel level) : LogSink(level)
+{
+}
+
+/*
+ *  FileSink::~FileSink
+ *
+ *  Description:
+ *      Destructor for the FileSink object, which closes the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+FileSink::~FileSink()
+{
+    SetAsync(0);
+    Close();
+}
+
+/*
+ *  FileSink::Open
+ *
+ *  Description:
+ *      Open the given file for appending log output.
+ *
+ *  Parameters:
+ *      filename [in]
+ *          The name of the file to open.
+ *
+ *      flush_policy [in]
+ *          Controls when buffered output is written to the file.  By
+ *          default, each line is written immediately.
+ *
+ *  Returns:
+ *      True if the file was opened, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool FileSink::Open(const std::string &filename,
+                    const LogFlushPolicy &flush_policy)
+{
+    std::lock_guard<std::mutex> lock(file_mutex);
+
+    return log_file.Open(filename, flush_policy);
+}
+
+/*
+ *  FileSink::Close
+ *
+ *  Description:
+ *      Write any buffered output and close the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void FileSink::Close()
+{
+    std::lock_guard<std::mutex> lock(file_mutex);
+
+    log_file.Close();
+}
+
+/*
+ *  FileSink::GetFacility
+ *
+ *  Description:
+ *      Return the logging facility implemented by this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      LogFacility::File.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility FileSink::GetFacility() const
+{
+    return LogFacility::File;
+}
+
+/*
+ *  FileSink::FlushIfDue
+ *
+ *  Description:
+ *      Write any buffered output if the flush interval has elapsed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The flush interval, or zero if there is none.
+ *
+ *  Comments:
+ *      None.
+ */
+std::chrono::milliseconds FileSink::FlushIfDue()
+{
+    std::lock_guard<std::mutex> lock(file_mutex);
+
+    log_file.FlushIfDue();
+
+    return log_file.GetFlushInterval();
+}
+
+/*
+ *  FileSink::Write
+ *
+ *  Description:
+ *      Write the message to the file as a single line.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Error and Critical messages are written immediately unless the
+ *      flush policy indicates otherwise.
+ */
+void FileSink::Write(const LogMessage &message)
+{
+    std::unique_lock<std::mutex> lock(file_mutex, std::defer_lock);
+    AcquireLock(lock);
+
+    log_file.WriteLine(message.line.data(),
+                       message.line.size(),
+                       message.level <= LogLevel::Error);
+}
+
+/*
+ *  FileSink::FlushOutput
+ *
+ *  Description:
+ *      Write any buffered output to the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void FileSink::FlushOutput()
+{
+    std::lock_guard<std::mutex> lock(file_mutex);
+
+    log_file.Flush();
+}
+
+/*
+ *  MappedFileSink::MappedFileSink
+ *
+ *  Description:
+ *      Constructor for the MappedFileSink object.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Open() must be called before messages are written.
+ */
+MappedFileSink::MappedFileSink(LogLevel level) : LogSink(level)
+{
+}
+
+/*
+ *  MappedFileSink::~MappedFileSink
+ *
+ *  Description:
+ *      Destructor for the MappedFileSink object, which closes the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+MappedFileSink::~MappedFileSink()
+{
+    SetAsync(0);
+    Close();
+}
+
+/*
+ *  MappedFileSink::Open
+ *
+ *  Description:
+ *      Open memory-mapped log file segments having the given base name.
+ *
+ *  Parameters:
+ *      base_name [in]
+ *          The name to which segment sequence numbers are appended.
+ *
+ *      segment_size [in]
+ *          The size of each segment.
+ *
+ *  Returns:
+ *      True if the first segment was opened, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool MappedFileSink::Open(const std::string &base_name,
+                          std::size_t segment_size)
+{
+    return mapped_file.Open(base_name, segment_size);
+}
+
+/*
+ *  MappedFileSink::Close
+ *
+ *  Description:
+ *      Close the memory-mapped log file, truncating the last segment to the
+ *      length used.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void MappedFileSink::Close()
+{
+    mapped_file.Close();
+}
+
+/*
+ *  MappedFileSink::GetFacility
+ *
+ *  Description:
+ *      Return the logging facility implemented by this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      LogFacility::MappedFile.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility MappedFileSink::GetFacility() const
+{
+    return LogFacility::MappedFile;
+}
+
+/*
+ *  MappedFileSink::Write
+ *
+ *  Description:
+ *      Copy the message into the current memory-mapped segment.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Multiple threads may write concurrently without locking.
+ */
+void MappedFileSink::Write(const LogMessage &message)
+{
+    mapped_file.WriteLine(message.line);
+}
+
+/*
+ *  SyslogSink::SyslogSink
+ *
+ *  Description:
+ *      Constructor for the SyslogSink object.
+ *
+ *  Parameters:
+ *      syslog_interface [in]
+ *          The interface through which syslog() is called, which must
+ *          outlive the sink.
+ *
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The caller is responsible for calling openlog() and closelog().
+ */
+SyslogSink::SyslogSink(SyslogInterface &syslog_interface, LogLevel level) :
+    LogSink(level),
+    syslog_interface(syslog_interface)
+{
+}
+
+/*
+ *  SyslogSink::SyslogSink
+ *
+ *  Description:
+ *      Constructor for the SyslogSink object that shares ownership of the
+ *      interface through which syslog() is called (e.g., a SyslogSender).
+ *
+ *  Parameters:
+ *      syslog_interface [in]
+ *          The interface through which syslog() is called.
+ *
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The caller is responsible for calling openlog() and closelog().
+ */
+SyslogSink::SyslogSink(std::shared_ptr<SyslogInterface> syslog_interface,
+                       LogLevel level) :
+    LogSink(level),
+    shared_interface(std::move(syslog_interface)),
+    syslog_interface(*shared_interface)
+{
+}
+
+/*
+ *  SyslogSink::~SyslogSink
+ *
+ *  Description:
+ *      Destructor for the SyslogSink object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+SyslogSink::~SyslogSink()
+{
+    SetAsync(0);
+}
+
+/*
+ *  SyslogSink::GetFacility
+ *
+ *  Description:
+ *      Return the logging facility implemented by this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      LogFacility::Syslog.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility SyslogSink::GetFacility() const
+{
+    return LogFacility::Syslog;
+}
+
+/*
+ *  SyslogSink::MapLogLevel
+ *
+ *  Description:
+ *      Map the Logger log level value to syslog priority level values.
+ *
+ *  Parameters:
+ *      level [in]
+ *          Log level value to map to syslog priority values.
+ *
+ *  Returns:
+ *      The syslog priority level corresponding to the internal log level value
+ *
+ *  Comments:
+ *      None.
+ */
+int SyslogSink::MapLogLevel([[maybe_unused]] LogLevel level)
+{
+#ifndef LOGGER_SYSLOG_ENABLED
+    return 0;
+#else
+    int priority;
+
+    switch (level)
+    {
+        case LogLevel::Critical:
+            priority = LOG_CRIT;
+            break;
+
+        case LogLevel::Error:
+            priority = LOG_ERR;
+            break;
+
+        case LogLevel::Warning:
+            priority = LOG_WARNING;
+            break;
+
+        case LogLevel::Info:
+            priority = LOG_INFO;
+            break;
+
+        case LogLevel::Debug:
+            priority = LOG_DEBUG;
+            break;
+
+        default:
+            priority = LOG_INFO;
+            break;
+    }
+
+    return priority;
+#endif
+}
+
+/*
+ *  SyslogSink::Write
+ *
+ *  Description:
+ *      Write the message text, without the timestamp, to syslog.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void SyslogSink::Write(const LogMessage &message)
+{
+    syslog_interface.syslog(MapLogLevel(message.level),
+                            "%.*s",
+                            static_cast<int>(message.text.size()),
+                            message.text.data());
+}
+
+/*
+ *  SyslogSink::FlushIfDue
+ *
+ *  Description:
+ *      Send any messages the syslog interface has batched.  This is called
+ *      when there are no more queued messages to write.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Zero, as there is no flush interval.
+ *
+ *  Comments:
+ *      None.
+ */
+std::chrono::milliseconds SyslogSink::FlushIfDue()
+{
+    syslog_interface.flushlog();
+
+    return std::chrono::milliseconds(0);
+}
+
+/*
+ *  SyslogSink::FlushOutput
+ *
+ *  Description:
+ *      Send any messages the syslog interface has batched.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void SyslogSink::FlushOutput()
+{
+    syslog_interface.flushlog();
+}
+
+/*
+ *  AndroidSink::AndroidSink
+ *
+ *  Description:
+ *      Constructor for the AndroidSink object.
+ *
+ *  Parameters:
+ *      tag [in]
+ *          The tag given with each message (e.g., the process name).
+ *
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+AndroidSink::AndroidSink(const std::string &tag, LogLevel level) :
+    LogSink(level),
+    tag(tag)
+{
+}
+
+/*
+ *  AndroidSink::~AndroidSink
+ *
+ *  Description:
+ *      Destructor for the AndroidSink object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+AndroidSink::~AndroidSink()
+{
+    SetAsync(0);
+}
+
+/*
+ *  AndroidSink::GetFacility
+ *
+ *  Description:
+ *      Return the logging facility implemented by this sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      LogFacility::AndroidLog.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility AndroidSink::GetFacility() const
+{
+    return LogFacility::AndroidLog;
+}
+
+/*
+ *  AndroidSink::Write
+ *
+ *  Description:
+ *      Write the message to the Android log.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      An exception is thrown if this is not the Android platform.
+ */
+void AndroidSink::Write([[maybe_unused]] const LogMessage &message)
+{
+#ifdef __ANDROID_API__
+    auto android_level = ANDROID_LOG_INFO;
+    switch (message.level)
+    {
+        case LogLevel::Debug:
+            android_level = ANDROID_LOG_DEBUG;
+            break;
+        case LogLevel::Info:
+            android_level = ANDROID_LOG_INFO;
+            break;
+        case LogLevel::Warning:
+            android_level = ANDROID_LOG_WARN;
+            break;
+        case LogLevel::Error:
+            android_level = ANDROID_LOG_ERROR;
+            break;
+        case LogLevel::Critical:
+            android_level = ANDROID_LOG_FATAL;
+            break;
+    }
+    __android_log_print(android_level,
+                        tag.c_str(),
+                        "%.*s",
+                        static_cast<int>(message.line.size()),
+                        message.line.data());
+#else
+    throw std::runtime_error("Android LogLevel only supported on "
+                             "Android platform");
+#endif
+}
+
+/*
+ *  CallbackSink::CallbackSink
+ *
+ *  Description:
+ *      Constructor for the CallbackSink object.
+ *
+ *  Parameters:
+ *      callback [in]
+ *          The function to call with the level, text (without timestamp),
+ *          and console flag of each message.
+ *
+ *      level [in]
+ *          The most verbose level of messages written to this sink.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+CallbackSink::CallbackSink(Callback callback, LogLevel level) :
+    LogSink(level),
+    callback(callback)
+{
+}
+
+/*
+ *  CallbackSink::~CallbackSink
+ *
+ *  Description:
+ *      Destructor for the CallbackSink object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+CallbackSink::~CallbackSink()
+{
+    SetAsync(0);
+}
+
+/*
+ *  CallbackSink::Write
+ *
+ *  Description:
+ *      Pass the message text to the callback function.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The text is copied into one of the thread's reusable buffers, as the
+ *      callback receives a std::string.
+ */
+void CallbackSink::Write(const LogMessage &message)
+{
+    LogTextBuffer buffer;
+
+    buffer.Get().assign(message.text.data(), message.text.size());
+
+    callback(message.level, buffer.Get(), message.console);
+}
+
+} // namespace cantina
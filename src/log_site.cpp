@@ -0,0 +1,195 @@
+/*
+ *  log_site.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogStreamBuffer class, which borrows one of the
+ *      calling thread's reusable output streams.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include "cantina/log_site.h"
+
+namespace cantina
+{
+
+/*
+ *  LogStreamBuffer::LogStreamBuffer
+ *
+ *  Description:
+ *      Constructor for the LogStreamBuffer object, which borrows one of the
+ *      calling thread's reusable output streams.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Streams are borrowed and returned in last-in, first-out order, as
+ *      LogStreamBuffer objects are only ever created on the stack.  The
+ *      stream's text is emptied and its formatting state is restored to
+ *      the defaults, so manipulators used with one message do not affect
+ *      the next.
+ */
+LogStreamBuffer::LogStreamBuffer() : entry(nullptr)
+{
+    ThreadStreams &streams = GetThreadStreams();
+
+    if (streams.depth < Max_Thread_Streams)
+    {
+        auto &borrowed = streams.entries[streams.depth++];
+        if (!borrowed) borrowed = std::make_unique<Entry>();
+        entry = borrowed.get();
+    }
+    else
+    {
+        local = std::make_unique<Entry>();
+        entry = local.get();
+    }
+
+    std::ostream &stream = entry->stream;
+    entry->buffer.text.clear();
+    stream.clear();
+    stream.flags(std::ios_base::skipws | std::ios_base::dec);
+    stream.precision(6);
+    stream.width(0);
+    stream.fill(' ');
+}
+
+/*
+ *  LogStreamBuffer::~LogStreamBuffer
+ *
+ *  Description:
+ *      Destructor for the LogStreamBuffer object, which returns the borrowed
+ *      stream for reuse.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+LogStreamBuffer::~LogStreamBuffer()
+{
+    if (!local) GetThreadStreams().depth--;
+}
+
+/*
+ *  LogStreamBuffer::GetThreadStreams
+ *
+ *  Description:
+ *      Return the calling thread's reusable output streams.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the thread's streams.
+ *
+ *  Comments:
+ *      None.
+ */
+LogStreamBuffer::ThreadStreams &LogStreamBuffer::GetThreadStreams()
+{
+    static thread_local ThreadStreams thread_streams{};
+
+    return thread_streams;
+}
+
+/*
+ *  LogStreamBuffer::StringBuf::overflow
+ *
+ *  Description:
+ *      Append a character written to the stream to the text.
+ *
+ *  Parameters:
+ *      c [in]
+ *          The character written, or end-of-file.
+ *
+ *  Returns:
+ *      A value other than end-of-file, indicating success.
+ *
+ *  Comments:
+ *      None.
+ */
+LogStreamBuffer::StringBuf::int_type
+    LogStreamBuffer::StringBuf::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        text.push_back(traits_type::to_char_type(c));
+    }
+
+    return traits_type::not_eof(c);
+}
+
+/*
+ *  LogStreamBuffer::StringBuf::xsputn
+ *
+ *  Description:
+ *      Append characters written to the stream to the text.
+ *
+ *  Parameters:
+ *      c [in]
+ *          The characters written.
+ *
+ *      n [in]
+ *          The number of characters written.
+ *
+ *  Returns:
+ *      The number of characters written.
+ *
+ *  Comments:
+ *      None.
+ */
+std::streamsize LogStreamBuffer::StringBuf::xsputn(const char *c,
+                                                   std::streamsize n)
+{
+    text.append(c, static_cast<std::size_t>(n));
+
+    return n;
+}
+
+} // namespace cantina
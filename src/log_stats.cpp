@@ -0,0 +1,195 @@
+/*
+ *  log_stats.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogStatsCollector class, which maintains
+ *      statistics describing the activity of a Logger in shards updated
+ *      independently by each thread.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include "cantina/log_stats.h"
+
+namespace cantina
+{
+
+/*
+ *  LogHistogram::Percentile
+ *
+ *  Description:
+ *      Estimate the duration not exceeded by the given fraction of the
+ *      durations in the histogram.
+ *
+ *  Parameters:
+ *      fraction [in]
+ *          The fraction of durations, between 0.0 and 1.0 (e.g., 0.99 for
+ *          the 99th percentile).
+ *
+ *  Returns:
+ *      The upper bound of the bucket containing the given fraction of
+ *      durations, or zero if the histogram is empty.
+ *
+ *  Comments:
+ *      Since buckets are powers of two, the result may be as much as twice
+ *      the actual duration.
+ */
+std::chrono::nanoseconds LogHistogram::Percentile(double fraction) const
+{
+    if (count == 0) return std::chrono::nanoseconds(0);
+
+    auto target = static_cast<std::uint64_t>(fraction *
+                                             static_cast<double>(count));
+    std::uint64_t seen = 0;
+
+    for (std::size_t i = 0; i < Bucket_Count; i++)
+    {
+        seen += buckets[i];
+        if ((seen > 0) && (seen >= target))
+        {
+            return std::chrono::nanoseconds(
+                (i == 0) ? 0 : (std::int64_t(1) << i));
+        }
+    }
+
+    return std::chrono::nanoseconds(std::int64_t(1) << (Bucket_Count - 1));
+}
+
+/*
+ *  LogStatsCollector::LogStatsCollector
+ *
+ *  Description:
+ *      Constructor for the LogStatsCollector object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Statistics are not collected until enabled.  The shards are value
+ *      initialized, so every counter begins at zero.
+ */
+LogStatsCollector::LogStatsCollector() :
+    enabled(false),
+    shards(std::make_unique<Shard[]>(Shard_Count))
+{
+}
+
+/*
+ *  LogStatsCollector::Read
+ *
+ *  Description:
+ *      Add the counters of every shard to the given statistics.
+ *
+ *  Parameters:
+ *      stats [out]
+ *          The statistics to which the counters are added.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Threads may update the shards while they are being read, so the
+ *      counters are not a consistent snapshot of a single instant.
+ */
+void LogStatsCollector::Read(LogStats &stats) const
+{
+    for (std::size_t i = 0; i < Shard_Count; i++)
+    {
+        const Shard &shard = shards[i];
+
+        for (std::size_t level = 0; level < Log_Level_Count; level++)
+        {
+            stats.messages[level] +=
+                shard.messages[level].load(std::memory_order_relaxed);
+            stats.filtered[level] +=
+                shard.filtered[level].load(std::memory_order_relaxed);
+        }
+
+        for (std::size_t facility = 0;
+             facility < Log_Facility_Count;
+             facility++)
+        {
+            stats.bytes[facility] +=
+                shard.bytes[facility].load(std::memory_order_relaxed);
+        }
+
+        Read(shard.emit_time, stats.emit_time);
+        Read(shard.lock_wait, stats.lock_wait);
+    }
+}
+
+/*
+ *  LogStatsCollector::Read
+ *
+ *  Description:
+ *      Add the counters of a histogram within a shard to the given
+ *      histogram.
+ *
+ *  Parameters:
+ *      counters [in]
+ *          The histogram counters within a shard.
+ *
+ *      histogram [out]
+ *          The histogram to which the counters are added.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogStatsCollector::Read(const HistogramCounters &counters,
+                             LogHistogram &histogram)
+{
+    for (std::size_t i = 0; i < LogHistogram::Bucket_Count; i++)
+    {
+        auto count = counters.buckets[i].load(std::memory_order_relaxed);
+        histogram.buckets[i] += count;
+        histogram.count += count;
+    }
+
+    histogram.total += std::chrono::nanoseconds(
+        counters.total.load(std::memory_order_relaxed));
+}
+
+} // namespace cantina
@@ -0,0 +1,863 @@
+/*
+ *  log_uring.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LogUring class, which writes to a file
+ *      descriptor through a Linux io_uring using registered buffers.
+ *
+ *  Portability Issues:
+ *      io_uring is used only when built for Linux with <linux/io_uring.h>
+ *      available.  Elsewhere, Start() returns false.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#if defined(LOGGER_IO_URING_ENABLED) && defined(__linux__) && \
+    __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+    defined(__NR_io_uring_register)
+#define LOGGER_IO_URING_SUPPORTED
+#endif
+#endif
+#include <algorithm>
+#include <cstring>
+#include "cantina/log_uring.h"
+
+namespace cantina
+{
+
+#ifdef LOGGER_IO_URING_SUPPORTED
+namespace
+{
+
+// Identifies the completion of a sync rather than of a buffer's write
+constexpr std::uint64_t Sync_Request = ~std::uint64_t(0);
+
+/*
+ *  SetupRing
+ *
+ *  Description:
+ *      Create an io_uring with the given number of entries.
+ *
+ *  Parameters:
+ *      entries [in]
+ *          The number of submission queue entries.
+ *
+ *      params [out]
+ *          The parameters of the ring returned by the kernel.
+ *
+ *  Returns:
+ *      The ring's descriptor, or -1 on failure.
+ *
+ *  Comments:
+ *      The ring must support writing at the file's current position, since
+ *      output is appended to files and written to pipes and terminals.
+ */
+int SetupRing(unsigned entries, io_uring_params &params)
+{
+    std::memset(&params, 0, sizeof(params));
+
+    int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup,
+                                           entries,
+                                           &params));
+    if (ring_fd < 0) return -1;
+
+    if (!(params.features & IORING_FEAT_RW_CUR_POS))
+    {
+        close(ring_fd);
+        return -1;
+    }
+
+    return ring_fd;
+}
+
+} // namespace
+#endif
+
+/*
+ *  LogUring::LogUring
+ *
+ *  Description:
+ *      Constructor for the LogUring object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Start() must be called before output is written.
+ */
+LogUring::LogUring() :
+    fd(-1),
+    ring_fd(-1),
+    registered(false),
+    buffer_size(0),
+    buffer_stride(0),
+    buffers(nullptr),
+    buffers_length(0),
+    in_flight(0),
+    sync_pending(false),
+    sq_ring(nullptr),
+    sq_ring_length(0),
+    cq_ring(nullptr),
+    cq_ring_length(0),
+    sqes(nullptr),
+    sqes_length(0),
+    sq_head(nullptr),
+    sq_tail(nullptr),
+    sq_mask(0),
+    sq_array(nullptr),
+    cq_head(nullptr),
+    cq_tail(nullptr),
+    cq_mask(0),
+    cqes(nullptr)
+{
+}
+
+/*
+ *  LogUring::~LogUring
+ *
+ *  Description:
+ *      Destructor for the LogUring object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Submitted writes are completed before the ring is released.
+ */
+LogUring::~LogUring()
+{
+    Stop();
+}
+
+/*
+ *  LogUring::IsAvailable
+ *
+ *  Description:
+ *      Determine whether io_uring may be used on this system.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if a ring can be created, false otherwise.
+ *
+ *  Comments:
+ *      The system is probed once, on the first call.
+ */
+bool LogUring::IsAvailable()
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    static const bool available = []()
+    {
+        io_uring_params params;
+        int probe_fd = SetupRing(1, params);
+
+        if (probe_fd < 0) return false;
+        close(probe_fd);
+
+        return true;
+    }();
+
+    return available;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  LogUring::Start
+ *
+ *  Description:
+ *      Set up a ring and buffers for writing to the given descriptor.
+ *
+ *  Parameters:
+ *      fd [in]
+ *          The descriptor to which output is written.  It must remain open
+ *          until Stop() is called.
+ *
+ *      buffer_size [in]
+ *          The size of each buffer.
+ *
+ *      buffer_count [in]
+ *          The number of buffers, which bounds the writes in flight.
+ *
+ *  Returns:
+ *      True if the ring was set up, false if io_uring is not available.
+ *
+ *  Comments:
+ *      If the buffers cannot be registered with the kernel (e.g., due to
+ *      the limit on locked memory), they are written without registration.
+ */
+bool LogUring::Start([[maybe_unused]] int fd,
+                     [[maybe_unused]] std::size_t buffer_size,
+                     [[maybe_unused]] unsigned buffer_count)
+{
+    Stop();
+
+#ifdef LOGGER_IO_URING_SUPPORTED
+    if ((fd < 0) || (buffer_size == 0) || (buffer_count == 0)) return false;
+
+    // Every buffer and a sync may be in flight at once
+    unsigned entries = 1;
+    while (entries < buffer_count + 1) entries <<= 1;
+
+    io_uring_params params;
+    ring_fd = SetupRing(entries, params);
+    if (ring_fd < 0) return false;
+
+    sq_ring_length = params.sq_off.array +
+                     params.sq_entries * sizeof(unsigned);
+    std::size_t cq_length = params.cq_off.cqes +
+                            params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mapping) sq_ring_length = std::max(sq_ring_length, cq_length);
+
+    sq_ring = mmap(nullptr,
+                   sq_ring_length,
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE,
+                   ring_fd,
+                   IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+    {
+        sq_ring = nullptr;
+        Release();
+        return false;
+    }
+
+    if (single_mapping)
+    {
+        cq_ring = sq_ring;
+    }
+    else
+    {
+        cq_ring = mmap(nullptr,
+                       cq_length,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       ring_fd,
+                       IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+        {
+            cq_ring = nullptr;
+            Release();
+            return false;
+        }
+        cq_ring_length = cq_length;
+    }
+
+    sqes_length = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = mmap(nullptr,
+                sqes_length,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE,
+                ring_fd,
+                IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        sqes = nullptr;
+        Release();
+        return false;
+    }
+
+    char *sq = static_cast<char *>(sq_ring);
+    char *cq = static_cast<char *>(cq_ring);
+    sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+
+    // Allocate page-aligned buffers and register them if permitted
+    long page_size = sysconf(_SC_PAGESIZE);
+    std::size_t page = (page_size > 0) ? static_cast<std::size_t>(page_size) :
+                                         4096;
+    this->buffer_size = buffer_size;
+    std::size_t stride = (buffer_size + page - 1) / page * page;
+    buffers_length = stride * buffer_count;
+    void *storage = mmap(nullptr,
+                         buffers_length,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1,
+                         0);
+    if (storage == MAP_FAILED)
+    {
+        buffers_length = 0;
+        Release();
+        return false;
+    }
+    buffers = static_cast<char *>(storage);
+
+    std::vector<struct iovec> iovecs(buffer_count);
+    for (unsigned i = 0; i < buffer_count; i++)
+    {
+        iovecs[i].iov_base = buffers + i * stride;
+        iovecs[i].iov_len = buffer_size;
+        free_buffers.push_back(buffer_count - 1 - i);
+    }
+    writes.assign(buffer_count, BufferWrite{0, 0});
+    registered = syscall(__NR_io_uring_register,
+                         ring_fd,
+                         IORING_REGISTER_BUFFERS,
+                         iovecs.data(),
+                         buffer_count) == 0;
+
+    this->fd = fd;
+    buffer_stride = stride;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  LogUring::Stop
+ *
+ *  Description:
+ *      Wait for all submitted writes to complete and release the ring and
+ *      its buffers.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The descriptor being written is not closed.
+ */
+void LogUring::Stop()
+{
+    if (ring_fd < 0) return;
+
+    Wait();
+    Release();
+}
+
+/*
+ *  LogUring::Acquire
+ *
+ *  Description:
+ *      Take a buffer into which output may be placed before it is given to
+ *      Submit().
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A buffer of GetBufferSize() octets, or nullptr if the ring is not
+ *      running.
+ *
+ *  Comments:
+ *      If every buffer is in flight, this waits for a write to complete.
+ */
+char *LogUring::Acquire()
+{
+    if (ring_fd < 0) return nullptr;
+
+    // Recycle the buffers of any completed writes without waiting
+    Reap(false);
+
+    while (free_buffers.empty())
+    {
+        if (!Reap(true)) return nullptr;
+    }
+
+    unsigned index = free_buffers.back();
+    free_buffers.pop_back();
+
+    return buffers + index * buffer_stride;
+}
+
+/*
+ *  LogUring::Submit
+ *
+ *  Description:
+ *      Submit the write of a buffer taken via Acquire().
+ *
+ *  Parameters:
+ *      buffer [in]
+ *          The buffer holding the output.
+ *
+ *      length [in]
+ *          The number of octets of the buffer to write, which may be zero
+ *          to return the buffer unwritten.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The buffer is reused once the write completes.  Should the write
+ *      not be submitted, it is made using write() instead.  As with
+ *      write(), output that cannot be written is discarded.
+ */
+void LogUring::Submit([[maybe_unused]] char *buffer,
+                      [[maybe_unused]] std::size_t length)
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    if ((ring_fd < 0) || (buffer == nullptr)) return;
+
+    auto index = static_cast<unsigned>((buffer - buffers) /
+                                       buffer_stride);
+
+    if (length == 0)
+    {
+        free_buffers.push_back(index);
+        return;
+    }
+
+    writes[index] = BufferWrite{0, length};
+
+    if (Queue(index)) return;
+
+    WriteDirect(index);
+#endif
+}
+
+/*
+ *  LogUring::Write
+ *
+ *  Description:
+ *      Copy data into buffers and submit their writes.
+ *
+ *  Parameters:
+ *      data [in]
+ *          The data to write.
+ *
+ *      length [in]
+ *          The length of the data.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Data longer than a buffer is written using several buffers.
+ */
+void LogUring::Write(const char *data, std::size_t length)
+{
+    while (length > 0)
+    {
+        char *buffer = Acquire();
+        if (buffer == nullptr) return;
+
+        std::size_t part = std::min(length, buffer_size);
+        std::memcpy(buffer, data, part);
+        Submit(buffer, part);
+
+        data += part;
+        length -= part;
+    }
+}
+
+/*
+ *  LogUring::Sync
+ *
+ *  Description:
+ *      Submit a request to write the data of the descriptor to the device,
+ *      as with fdatasync(), once previously submitted writes complete.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the sync was submitted (or performed), false if the ring is
+ *      not running or a sync is already in flight.
+ *
+ *  Comments:
+ *      Should the sync not be submitted, fdatasync() is called instead.
+ */
+bool LogUring::Sync()
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    if ((ring_fd < 0) || sync_pending) return false;
+
+    unsigned tail = *sq_tail;
+    unsigned slot = tail & sq_mask;
+    auto *sqe = static_cast<io_uring_sqe *>(sqes) + slot;
+
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->flags = (in_flight > 0) ? IOSQE_IO_DRAIN : 0;
+    sqe->fd = fd;
+    sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    sqe->user_data = Sync_Request;
+    sq_array[slot] = slot;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    if (Enter(1, 0))
+    {
+        in_flight++;
+        sync_pending = true;
+        return true;
+    }
+
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+    fdatasync(fd);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  LogUring::Wait
+ *
+ *  Description:
+ *      Wait for every submitted write and sync to complete.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LogUring::Wait()
+{
+    while ((ring_fd >= 0) && (in_flight > 0))
+    {
+        if (!Reap(true)) break;
+    }
+}
+
+/*
+ *  LogUring::Reap
+ *
+ *  Description:
+ *      Process the completions of writes and syncs, recycling the buffers
+ *      of completed writes.
+ *
+ *  Parameters:
+ *      wait [in]
+ *          Whether to wait for a completion if there is none.
+ *
+ *  Returns:
+ *      True unless waiting failed.
+ *
+ *  Comments:
+ *      None.
+ */
+bool LogUring::Reap([[maybe_unused]] bool wait)
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    unsigned head = *cq_head;
+
+    if (wait && (in_flight > 0) &&
+        (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) &&
+        !Enter(0, 1))
+    {
+        return false;
+    }
+
+    while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+    {
+        const auto &cqe = static_cast<io_uring_cqe *>(cqes)[head & cq_mask];
+        std::uint64_t user_data = cqe.user_data;
+        int result = cqe.res;
+
+        // Release the entry before any write is resubmitted
+        head++;
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        in_flight--;
+
+        if (user_data == Sync_Request)
+        {
+            sync_pending = false;
+        }
+        else
+        {
+            Complete(static_cast<unsigned>(user_data), result);
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  LogUring::Complete
+ *
+ *  Description:
+ *      Account for the completion of a buffer's write, writing whatever
+ *      remains of the buffer or recycling it once it is fully written.
+ *
+ *  Parameters:
+ *      index [in]
+ *          The index of the buffer written.
+ *
+ *      result [in]
+ *          The number of octets written, or the negated error number.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The remainder of a short write, or of one that was interrupted or
+ *      would have blocked, is submitted again.  Output submitted after the
+ *      buffer may then be written ahead of its remainder.  Should the
+ *      write fail otherwise, the remainder is written using write(), as in
+ *      LogFile, and discarded if that also fails.
+ */
+void LogUring::Complete([[maybe_unused]] unsigned index,
+                        [[maybe_unused]] int result)
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    BufferWrite &write = writes[index];
+
+    if (result > 0)
+    {
+        write.offset += std::min(static_cast<std::size_t>(result),
+                                 write.length - write.offset);
+    }
+
+    if (write.offset >= write.length)
+    {
+        free_buffers.push_back(index);
+        return;
+    }
+
+    bool retry = (result > 0) || (result == -EAGAIN) || (result == -EINTR);
+    if (retry && Queue(index)) return;
+
+    WriteDirect(index);
+#endif
+}
+
+/*
+ *  LogUring::Queue
+ *
+ *  Description:
+ *      Submit the write of the portion of a buffer not yet written.
+ *
+ *  Parameters:
+ *      index [in]
+ *          The index of the buffer to write.
+ *
+ *  Returns:
+ *      True if the write was submitted, false otherwise.
+ *
+ *  Comments:
+ *      The write waits for the writes and syncs already in flight.
+ */
+bool LogUring::Queue([[maybe_unused]] unsigned index)
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    const BufferWrite &write = writes[index];
+    unsigned tail = *sq_tail;
+    unsigned slot = tail & sq_mask;
+    auto *sqe = static_cast<io_uring_sqe *>(sqes) + slot;
+
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->flags = (in_flight > 0) ? IOSQE_IO_DRAIN : 0;
+    sqe->fd = fd;
+    sqe->off = ~std::uint64_t(0);
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffers +
+                                                index * buffer_stride +
+                                                write.offset);
+    sqe->len = static_cast<std::uint32_t>(write.length - write.offset);
+    sqe->buf_index = static_cast<std::uint16_t>(registered ? index : 0);
+    sqe->user_data = index;
+    sq_array[slot] = slot;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    if (Enter(1, 0))
+    {
+        in_flight++;
+        return true;
+    }
+
+    // Withdraw the entry
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+    return false;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  LogUring::WriteDirect
+ *
+ *  Description:
+ *      Write the portion of a buffer not yet written using write() and
+ *      recycle the buffer.
+ *
+ *  Parameters:
+ *      index [in]
+ *          The index of the buffer to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      As with write() in LogFile, output that cannot be written is
+ *      discarded.
+ */
+void LogUring::WriteDirect([[maybe_unused]] unsigned index)
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    BufferWrite &write = writes[index];
+    const char *buffer = buffers + index * buffer_stride;
+
+    while (write.offset < write.length)
+    {
+        ssize_t result = ::write(fd,
+                                 buffer + write.offset,
+                                 write.length - write.offset);
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        write.offset += static_cast<std::size_t>(result);
+    }
+
+    free_buffers.push_back(index);
+#endif
+}
+
+/*
+ *  LogUring::Enter
+ *
+ *  Description:
+ *      Submit entries to the kernel and optionally wait for completions.
+ *
+ *  Parameters:
+ *      to_submit [in]
+ *          The number of entries added to the submission queue.
+ *
+ *      min_complete [in]
+ *          The number of completions to wait for.
+ *
+ *  Returns:
+ *      True if the call succeeded, false otherwise.
+ *
+ *  Comments:
+ *      Interrupted calls are retried.
+ */
+bool LogUring::Enter([[maybe_unused]] unsigned to_submit,
+                     [[maybe_unused]] unsigned min_complete)
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    unsigned flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+
+    while (true)
+    {
+        long result = syscall(__NR_io_uring_enter,
+                              ring_fd,
+                              to_submit,
+                              min_complete,
+                              flags,
+                              nullptr,
+                              0);
+        if (result >= 0) return true;
+        if (errno != EINTR) return false;
+    }
+#else
+    return false;
+#endif
+}
+
+/*
+ *  LogUring::Release
+ *
+ *  Description:
+ *      Unmap the ring and buffers and close the ring.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Closing the ring unregisters the buffers.
+ */
+void LogUring::Release()
+{
+#ifdef LOGGER_IO_URING_SUPPORTED
+    if (buffers != nullptr) munmap(buffers, buffers_length);
+    if (sqes != nullptr) munmap(sqes, sqes_length);
+    if ((cq_ring != nullptr) && (cq_ring != sq_ring))
+    {
+        munmap(cq_ring, cq_ring_length);
+    }
+    if (sq_ring != nullptr) munmap(sq_ring, sq_ring_length);
+    if (ring_fd >= 0) close(ring_fd);
+#endif
+
+    fd = -1;
+    ring_fd = -1;
+    registered = false;
+    buffer_size = 0;
+    buffer_stride = 0;
+    buffers = nullptr;
+    buffers_length = 0;
+    free_buffers.clear();
+    writes.clear();
+    in_flight = 0;
+    sync_pending = false;
+    sq_ring = nullptr;
+    cq_ring = nullptr;
+    sqes = nullptr;
+}
+
+} // namespace cantina
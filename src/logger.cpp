@@ -60,12 +60,10 @@
 #endif
 #include <stdio.h>
 #include <iostream>
-#include <iomanip>
 #include <algorithm>
 #include <time.h>
 #include <ctime>
 #include "cantina/logger.h"
-#include "cantina/ansi.h"
 
 namespace cantina
 {
@@ -207,6 +205,7 @@ Logger::Logger(const std::string &process_name,
     process_name(process_name),
     component_name(component_name),
     parent_logger(parent_logger),
+    root_logger(parent_logger ? parent_logger->root_logger : this),
     log_facility(LogFacility::Console),
     log_level(parent_logger ? parent_logger->GetLogLevel() : LogLevel::Info),
     info_buf(this, LogLevel::Info),
@@ -216,9 +215,20 @@ Logger::Logger(const std::string &process_name,
     debug_buf(this, LogLevel::Debug),
     console_buf(this, LogLevel::Info, true),
     output_to_console(output_to_console),
+    force_console(false),
     colorize(parent_logger ? parent_logger->IsColorized() : IsColorPossible()),
-    time_digits(6),
-    time_modulo(1'000'000),
+    time_precision(LogTimePrecision::Microseconds),
+    time_format(LogTimeFormat::LocalTime),
+    output_format(LogOutputFormat::Text),
+    source_location(false),
+    segment_size(MappedLogFile::Default_Segment_Size),
+    sink_level(-1),
+    syslog_users(0),
+    binary_open(false),
+    binary_generation(0),
+    flight_recording(false),
+    coalescing(false),
+    stats(parent_logger ? nullptr : std::make_unique<LogStatsCollector>()),
     info(&info_buf),
     warning(&warning_buf),
     error(&error_buf),
@@ -226,6 +236,30 @@ Logger::Logger(const std::string &process_name,
     debug(&debug_buf),
     console(&console_buf)
 {
+    // Construct the component prefix from the parent chain once
+    if (parent_logger)
+    {
+        component_prefix = parent_logger->component_prefix;
+        component_path = parent_logger->component_path;
+        force_console = parent_logger->force_console;
+    }
+    if (!component_name.empty())
+    {
+        component_prefix += "[" + component_name + "] ";
+        if (!component_path.empty()) component_path += '.';
+        component_path += component_name;
+    }
+    force_console = force_console || output_to_console;
+
+    // The root logger writes to the console by default
+    if (!parent_logger)
+    {
+        console_sink = std::make_shared<ConsoleSink>(colorize);
+        console_sink->owner = this;
+        facility_sink = console_sink;
+        UpdateSinkLevel();
+    }
+
 #ifdef ANDROID
     SetLogFacility(LogFacility::ANDROIDLOG);
 #endif
@@ -251,11 +285,20 @@ Logger::~Logger()
     // Only the root logger deals with actual facilities
     if (!parent_logger)
     {
-        // Close the syslog if it is open
-        if (log_facility == LogFacility::Syslog) closelog();
-
-        // Close the open log file
-        if (log_facility == LogFacility::File) log_file.close();
+        // Summarize repeated messages, emit any queued messages, and stop
+        // the writer thread
+        FlushRepeats();
+        async_queue.Stop();
+
+        // Release all sinks, closing any files and syslog
+        ReleaseSink(std::move(facility_sink));
+        for (auto &sink : sinks) ReleaseSink(std::move(sink));
+        sinks.clear();
+        console_sink.reset();
+
+        // Close the binary log
+        binary_file.Close();
+        binary_formats.Close();
     }
 }
 
@@ -283,37 +326,135 @@ Logger::~Logger()
  */
 void Logger::Log(LogLevel level, const std::string &message, bool console)
 {
-    std::string formatted_message;              // Formatted message to log
-    std::string formatted_console_message;      // Formatted console message
-
-    console = console || output_to_console;
-
-    // If not logging, return. Ask the parent about the facility facility
-    // since only the root knows the actual facility.
-    if (GetLogFacility() == LogFacility::None) return;
+    // Do not log higher level (i.e., lesser importance) messages or
+    // messages that no sink would write, unless the flight recorder
+    // retains them
+    bool written = IsLevelEnabled(level);
+    if (!written)
+    {
+        root_logger->stats->CountFiltered(level);
+        if (!root_logger->flight_recording) return;
+    }
 
-    // Do not log higher level (i.e., lesser importance) messages
-    if (level > log_level) return;
+    Dispatch(level, component_prefix, message, console || force_console,
+             written);
+}
 
-    // Prepare the formatted message to produce
-    if (component_name.length() > 0)
+/*
+ *  Logger::Log
+ *
+ *  Description:
+ *      This function will log messages from the call site described by the
+ *      given LogSite, which is defined by the logging macros.
+ *
+ *  Parameters:
+ *      site [in]
+ *          The call site, which gives the logging level for the message.
+ *          It must remain valid until the message is written (e.g., it has
+ *          static storage duration).
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Logger::Log(const LogSite &site, const std::string &message)
+{
+    bool written = IsLevelEnabled(site.level);
+    if (!written)
     {
-        formatted_message = "[" + component_name + "] " + message;
+        root_logger->stats->CountFiltered(site.level);
+        if (!root_logger->flight_recording) return;
     }
-    else
+
+    Dispatch(site.level, component_prefix, message, force_console, written,
+             0, &site);
+}
+
+/*
+ *  Logger::Dispatch
+ *
+ *  Description:
+ *      Add a message to the flight recorder, if enabled, and emit it via
+ *      the root logger if it passes the log levels.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      prefix [in]
+ *          The component prefix to precede the message.
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *      written [in]
+ *          Does the message pass the log levels?
+ *
+ *      fields_length [in]
+ *          The length of the structured fields ending the message.
+ *
+ *      site [in]
+ *          The call site from which the message was logged, or nullptr.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The flight recorder is dumped after a Critical message is emitted.
+ *      The time taken by EmitLog() is recorded if collecting statistics.
+ *      Repeated messages counted while coalescing are not emitted, though
+ *      the flight recorder retains them.
+ */
+void Logger::Dispatch(LogLevel level,
+                      std::string_view prefix,
+                      const std::string &message,
+                      bool console,
+                      bool written,
+                      std::size_t fields_length,
+                      const LogSite *site)
+{
+    bool recording = root_logger->flight_recording;
+
+    if (recording)
     {
-        formatted_message = message;
+        root_logger->flight_recorder->Add(level, prefix, message, written);
     }
 
-    // If there is a parent logger, send the logging message to it
-    if (parent_logger)
+    if (!written) return;
+
+    // Count, rather than emit, a repeat of the previous message
+    if (root_logger->coalescing &&
+        root_logger->Coalesce(level, prefix, message, console))
     {
-        parent_logger->Log(level, formatted_message, console);
         return;
     }
 
-    // Emit the log message
-    EmitLog(level, formatted_message, console);
+    LogStatsCollector &collector = *root_logger->stats;
+    auto start = collector.StartEmit();
+
+    // Emit the log message via the root logger with the component prefix
+    root_logger->EmitParts(level,
+                           prefix,
+                           message,
+                           console,
+                           fields_length,
+                           site);
+
+    collector.CountEmitted(level, start);
+
+    if (recording && (level == LogLevel::Critical))
+    {
+        root_logger->DumpFlightRecorder();
+    }
 }
 
 /*
@@ -339,103 +480,269 @@ void Logger::Log(LogLevel level, const std::string &message, bool console)
  *      Nothing.
  *
  *  Comments:
- *      None.
+ *      If asynchronous logging is enabled, the message is placed into the
+ *      queue and written by the background writer thread.
  */
 void Logger::EmitLog(LogLevel level, const std::string &message, bool console)
 {
-    std::string stamped_message;                // Timestamped log message
+    EmitLogAt(level, message, console, {});
+}
+
+/*
+ *  Logger::EmitParts
+ *
+ *  Description:
+ *      This function will emit a log message given as a component prefix
+ *      and the text following it.  By default, the two are concatenated and
+ *      passed to EmitLog(), or directly to the sinks when writing JSON
+ *      Lines so that the prefix and fields may be located in the text.
+ *      If source locations are shown, the call site's file and line
+ *      precede the prefix in text (e.g., "main.cpp:42 [Foo] text").
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      prefix [in]
+ *          The component prefix to precede the message, which may be empty.
+ *
+ *      body [in]
+ *          The text of the message following the prefix.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *      fields_length [in]
+ *          The length of the structured fields ending the body.
+ *
+ *      site [in]
+ *          The call site from which the message was logged, or nullptr.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The text is concatenated in one of the thread's reusable buffers.
+ *      Custom loggers may override this function to receive the parts
+ *      without their being concatenated.  When writing JSON Lines,
+ *      messages do not pass through EmitLog(), as the output format
+ *      applies only to the Logger's own sinks.
+ */
+void Logger::EmitParts(LogLevel level,
+                       std::string_view prefix,
+                       const std::string &body,
+                       bool console,
+                       std::size_t fields_length,
+                       const LogSite *site)
+{
+    bool text_output = (output_format == LogOutputFormat::Text);
+
+    if (!source_location) site = nullptr;
 
-    // Log to the terminal or syslog as appropriate
-    if (log_facility == LogFacility::Syslog)
+    if (prefix.empty() && text_output && (site == nullptr))
     {
-        syslog(MapLogLevelToSysLog(level), "%s", message.c_str());
+        EmitLog(level, body, console);
+        return;
     }
 
-    if ((log_facility != LogFacility::Syslog) || (console))
+    LogTextBuffer buffer;
+    std::string &text = buffer.Get();
+    text.clear();
+
+    if (text_output)
     {
-        // Get the current time in human-readable form
-        std::string timestamp = GetTimestamp();
+        if (site != nullptr)
+        {
+            char digits[20];
+            text += site->file;
+            text += ':';
+            text.append(digits, FormatLogUnsigned(site->line, 0, digits));
+            text += ' ';
+        }
+        text += prefix;
+        text += body;
 
-        // Lock the mutex to ensure only one thread is writing
-        std::lock_guard<std::mutex> lock(logger_mutex);
+        EmitLog(level, text, console);
+        return;
+    }
 
-        // Update the formatted message to include the log level
-        stamped_message = timestamp + " [" + LogLevelString(level) + "] " +
-                          message;
+    text.assign(prefix);
+    text += body;
 
-        // Output the log message to the appropriate facility
-        if (log_facility == LogFacility::File)
-        {
-            log_file << stamped_message << std::endl;
-        }
+    EmitLogAt(level,
+              text,
+              console,
+              {},
+              LogTextLayout{prefix.size(), fields_length, site});
+}
 
-        if ((log_facility == LogFacility::Console) || console)
-        {
-            bool colorize_log = colorize;
+/*
+ *  Logger::EmitLogAt
+ *
+ *  Description:
+ *      Write a message logged at the given time to the sinks, or queue it
+ *      to be written by the background writer thread.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *      time [in]
+ *          The time at which the message was logged, or a default
+ *          time_point if the message is being logged now.
+ *
+ *      layout [in]
+ *          The lengths of the component prefix and fields in the message.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A message being logged now is timed by reading the system time if
+ *      it is written directly, or else by reading the clock given to
+ *      SetClockSource(), whose raw value is converted to the time of day
+ *      by the background writer thread.
+ */
+void Logger::EmitLogAt(LogLevel level,
+                       const std::string &message,
+                       bool console,
+                       const std::chrono::system_clock::time_point &time,
+                       const LogTextLayout &layout)
+{
+    // Write the message directly if not logging asynchronously
+    if (!async_queue.IsRunning())
+    {
+        WriteLog(level,
+                 message,
+                 console,
+                 (time == std::chrono::system_clock::time_point{}) ?
+                     std::chrono::system_clock::now() : time,
+                 layout);
+        return;
+    }
 
-            if (colorize_log)
-            {
-                switch (level)
-                {
-                    case LogLevel::Critical:
-                        std::clog << ansi::bold_on << ansi::fg_red;
-                        break;
-
-                    case LogLevel::Error:
-                        std::clog << ansi::bold_on << ansi::fg_magenta;
-                        break;
-
-                    case LogLevel::Warning:
-                        std::clog << ansi::bold_on << ansi::fg_yellow;
-                        break;
-
-                    case LogLevel::Debug:
-                        std::clog << ansi::fg_green;
-                        break;
-
-                    default:
-                        std::clog << ansi::fg_reset;
-                        break;
-                }
-            }
+    LogRecord record{level,
+                     console,
+                     time,
+                     LogRecordText(message),
+                     nullptr,
+                     layout.prefix_length,
+                     layout.fields_length,
+                     layout.site};
 
-            std::clog << stamped_message;
+    if (time == std::chrono::system_clock::time_point{})
+    {
+        record.clock_ticks = ReadClock();
+    }
 
-            if (colorize_log) std::clog << ansi::reset;
+    async_queue.Push(std::move(record));
+}
 
-            std::clog << std::endl;
-        }
+/*
+ *  Logger::WriteLog
+ *
+ *  Description:
+ *      This function will format the timestamp and level of a log message
+ *      once and write the message to each sink wanting messages at its
+ *      level.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *      time [in]
+ *          The time at which the message was logged.
+ *
+ *      layout [in]
+ *          The lengths of the component prefix and fields in the message,
+ *          used when writing JSON Lines.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The line is formatted into one of the thread's reusable buffers.
+ *      The octets submitted to each sink include the newline the sink
+ *      appends.  Sinks that do not write lines (e.g., syslog) are given
+ *      the message as text regardless of the output format.
+ */
+void Logger::WriteLog(LogLevel level,
+                      std::string_view message,
+                      bool console,
+                      const std::chrono::system_clock::time_point &time,
+                      const LogTextLayout &layout)
+{
+    char timestamp[Max_Timestamp_Length];
+    std::size_t timestamp_length = FormatTimestamp(time, timestamp);
+    LogTextBuffer buffer;
+    std::string &line = buffer.Get();
+    LogOutputFormat format = output_format;
+    std::string_view text;
+
+    // Format the timestamp and log level once for all sinks
+    if (format == LogOutputFormat::JsonLines)
+    {
+        line.clear();
+        AppendJsonLine(line,
+                       std::string_view(timestamp, timestamp_length),
+                       LogLevelString(level),
+                       message,
+                       layout);
+        text = message;
+    }
+    else
+    {
+        line.assign(timestamp, timestamp_length);
+        line += " [";
+        line += LogLevelString(level);
+        line += "] ";
+        std::size_t text_offset = line.size();
+        line += message;
+        text = std::string_view(line).substr(text_offset);
     }
 
-    if (log_facility == LogFacility::AndroidLog)
+    const LogMessage log_message{level, console, time, line, text, format};
+
+    std::shared_lock<std::shared_mutex> lock(sink_mutex, std::defer_lock);
+    stats->Acquire(lock);
+
+    auto submit = [&](LogSink &sink)
     {
-#ifdef __ANDROID_API__
-        auto android_level = ANDROID_LOG_INFO;
-        switch (level)
+        sink.Submit(log_message);
+
+        if (stats->IsEnabled())
         {
-            case LogLevel::Debug:
-                android_level = ANDROID_LOG_DEBUG;
-                break;
-            case LogLevel::Info:
-                android_level = ANDROID_LOG_INFO;
-                break;
-            case LogLevel::Warning:
-                android_level = ANDROID_LOG_WARN;
-                break;
-            case LogLevel::Error:
-                android_level = ANDROID_LOG_ERROR;
-                break;
-            case LogLevel::Critical:
-                android_level = ANDROID_LOG_FATAL;
-                break;
+            stats->CountBytes(sink.GetFacility(), line.size() + 1);
         }
-        __android_log_print(android_level, process_name.c_str(), "%s",
-                            stamped_message.c_str());
-#else
-        throw std::runtime_error("Android LogLevel only supported on "
-                                 "Android platform");
-#endif
+    };
+
+    if (facility_sink && facility_sink->ShouldLog(level))
+    {
+        submit(*facility_sink);
     }
+
+    for (auto &sink : sinks)
+    {
+        if (sink->ShouldLog(level)) submit(*sink);
+    }
+
+    // Write to the console if requested and not already written there
+    if (console && (facility_sink != console_sink)) submit(*console_sink);
 }
 
 /*
@@ -472,376 +779,1927 @@ void Logger::Log(const std::string &message)
  *          The logging facility to utilize.
  *
  *      filename [in]
- *          The filename to open for logging.
+ *          The filename to open for logging.  For LogFacility::MappedFile,
+ *          this is the base name to which segment numbers are appended.
+ *
+ *      flush_policy [in]
+ *          When using LogFacility::File, this controls when buffered output
+ *          is written to the file.  By default, each line is written
+ *          immediately.  When using LogFacility::Console, it may ask that
+ *          output be written asynchronously.
  *
  *  Returns:
  *      Nothing.
  *
  *  Comments:
  *      This function has no effect on child logger objects.
+ *
+ *      If a flush interval is given, buffered output is written from the
+ *      background writer thread when logging asynchronously.  Otherwise,
+ *      the interval is checked only as each message is logged, so Flush()
+ *      should be called if output might otherwise remain buffered.
  */
-void Logger::SetLogFacility(LogFacility facility, std::string filename)
+void Logger::SetLogFacility(LogFacility facility,
+                            std::string filename,
+                            LogFlushPolicy flush_policy)
 {
     // Just return if this is a child Logger object
     if (parent_logger) return;
 
     // Make a change only if the facility changed
-    if (log_facility != facility)
+    if (log_facility == facility) return;
+
+#ifndef LOGGER_SYSLOG_ENABLED
+    if (facility == LogFacility::Syslog)
     {
-        // Stop logging to syslog if we were
-        if (log_facility == LogFacility::Syslog) closelog();
+        error << "Syslog is not supported on this platform" << std::flush;
+        return;
+    }
+#endif
 
-        // Stop logging to a file if we were
-        if (log_facility == LogFacility::File) log_file.close();
+    // Write any queued messages to the current facility
+    Flush();
 
-        // Open syslog if appropriate
-        if (facility == LogFacility::Syslog)
+    // Create the sink for the new facility (messages are filtered by the
+    // Logger's log level, so the sink accepts all levels)
+    std::shared_ptr<LogSink> sink;
+    if (facility != LogFacility::None)
+    {
+        sink = CreateSink(facility, LogLevel::Debug, filename, flush_policy);
+        if (sink)
         {
-#ifndef LOGGER_SYSLOG_ENABLED
-            error << "Syslog is not supported on this platform" << std::flush;
-            return;
-#else
-            openlog(process_name.c_str(),
-                    LOG_PID,
-                    LOG_DAEMON);
-#endif
+            sink->owner = this;
         }
-
-        // Open logging file if appropriate
-        if (facility == LogFacility::File)
+        else
         {
-            log_file.open(filename, std::ios::out | std::ios::app);
-            if (!log_file.is_open())
-            {
-                std::cerr << "ERROR: Logger unable to open log file for "
-                             "writing: "
-                          << filename
-                          << std::endl;
-                facility = LogFacility::None;
-            }
+            facility = LogFacility::None;
         }
+    }
 
-        // Set the logging facility
+    // Replace the current facility's sink
+    {
+        std::unique_lock<std::shared_mutex> lock(sink_mutex);
+        std::swap(facility_sink, sink);
         log_facility = facility;
+        sink_level = ComputeSinkLevel();
     }
+
+    ReleaseSink(std::move(sink));
 }
 
 /*
- *  Logger::GetLogFacility
+ *  Logger::AddSink
  *
  *  Description:
- *      Return the current logging facility employed.
+ *      Create a sink for the given facility and add it to the sinks to
+ *      which messages are written, in addition to the logging facility.
  *
  *  Parameters:
- *      None.
+ *      facility [in]
+ *          The facility to which the sink writes.
+ *
+ *      level [in]
+ *          The most verbose level of messages written to the sink.
+ *
+ *      filename [in]
+ *          The filename to open for LogFacility::File or the base name of
+ *          the segments for LogFacility::MappedFile.
+ *
+ *      flush_policy [in]
+ *          When using LogFacility::File, this controls when buffered output
+ *          is written to the file.  When using LogFacility::Console, it may
+ *          ask that output be written asynchronously.
  *
  *  Returns:
- *      The current logging facility.
+ *      The sink, which may be given to RemoveSink(), or nullptr if the sink
+ *      could not be created.
  *
  *  Comments:
- *      None.
+ *      This function has no effect on child logger objects.  Messages are
+ *      written to the sink only if the Logger's log level also permits.
  */
-LogFacility Logger::GetLogFacility() const
+std::shared_ptr<LogSink> Logger::AddSink(LogFacility facility,
+                                         LogLevel level,
+                                         const std::string &filename,
+                                         LogFlushPolicy flush_policy)
 {
-    if (parent_logger) return parent_logger->GetLogFacility();
+    // Just return if this is a child Logger object
+    if (parent_logger) return nullptr;
+
+    if (facility == LogFacility::None) return nullptr;
+
+#ifndef LOGGER_SYSLOG_ENABLED
+    if (facility == LogFacility::Syslog)
+    {
+        error << "Syslog is not supported on this platform" << std::flush;
+        return nullptr;
+    }
+#endif
 
-    return log_facility;
+    auto sink = CreateSink(facility, level, filename, flush_policy);
+
+    if (sink && !AddSink(sink))
+    {
+        ReleaseSink(std::move(sink));
+        return nullptr;
+    }
+
+    return sink;
 }
 
 /*
- *  Logger::SetLogLevel
+ *  Logger::AddSink
  *
  *  Description:
- *      This function will set the log level for messages to be logged.
+ *      Add a sink to the sinks to which messages are written, in addition
+ *      to the logging facility.
  *
  *  Parameters:
- *      level [in]
- *          Log level of log messages to be logged.
+ *      sink [in]
+ *          The sink to add.
  *
  *  Returns:
- *      Nothing.
+ *      True if the sink was added, false if this is a child Logger or the
+ *      sink already belongs to a Logger.
  *
  *  Comments:
- *      Note that if there is a parent logger, the ultimate log level used
- *      will be that of the root logger.  The child logger merely passes the
- *      messages to be logged to its parent and the root logger's log level
- *      ultimately determines what does and does not get logged.
+ *      Messages are written to the sink only if the Logger's log level also
+ *      permits.
  */
-void Logger::SetLogLevel(LogLevel level)
+bool Logger::AddSink(const std::shared_ptr<LogSink> &sink)
 {
-    log_level = level;
+    // Just return if this is a child Logger object
+    if (parent_logger || !sink) return false;
+
+    Logger *no_owner = nullptr;
+    if (!sink->owner.compare_exchange_strong(no_owner, this)) return false;
+
+    std::unique_lock<std::shared_mutex> lock(sink_mutex);
+    sinks.push_back(sink);
+    sink_level = ComputeSinkLevel();
+
+    return true;
 }
 
 /*
- *  Logger::SetLogLevel
+ *  Logger::RemoveSink
  *
  *  Description:
- *      This function will set the log level for messages to be logged
- *      given a string, which must be one of: Critical, Error, Warning,
- *      Info, or Debug.
+ *      Remove a sink given to AddSink(), after writing any messages queued
+ *      for it.
  *
  *  Parameters:
- *      level [in]
- *          Log level of log messages to be logged.
+ *      sink [in]
+ *          The sink to remove.
  *
  *  Returns:
  *      Nothing.
  *
  *  Comments:
- *      Note that if there is a parent logger, the ultimate log level used
- *      will be that of the root logger.  The child logger merely passes the
- *      messages to be logged to its parent and the root logger's log level
- *      ultimately determines what does and does not get logged.
- *
- *      Note, also, that if the LogLevel string is invalid, an error
- *      message will be logged.
+ *      None.
  */
-void Logger::SetLogLevel(const std::string level)
+void Logger::RemoveSink(const std::shared_ptr<LogSink> &sink)
 {
-    std::string level_comparator = level;
+    // Just return if this is a child Logger object
+    if (parent_logger) return;
 
-    // Convert the level string to uppercase
-    std::transform(level.begin(),
-                   level.end(),
-                   level_comparator.begin(),
-                   ::toupper);
+    // Messages queued for the Logger may still be destined for the sink
+    Flush();
 
-    if (level_comparator == "INFO")
-    {
-        log_level = LogLevel::Info;
-    }
-    else if (level_comparator == "ERROR")
-    {
-        log_level = LogLevel::Error;
-    }
-    else if (level_comparator == "WARNING")
+    std::shared_ptr<LogSink> removed;
     {
-        log_level = LogLevel::Warning;
+        std::unique_lock<std::shared_mutex> lock(sink_mutex);
+        auto it = std::find(sinks.begin(), sinks.end(), sink);
+        if (it == sinks.end()) return;
+        removed = std::move(*it);
+        sinks.erase(it);
+        sink_level = ComputeSinkLevel();
     }
-    else if (level_comparator == "CRITICAL")
+
+    ReleaseSink(std::move(removed));
+}
+
+/*
+ *  Logger::CreateSink
+ *
+ *  Description:
+ *      Create and open a sink for the given facility.
+ *
+ *  Parameters:
+ *      facility [in]
+ *          The facility to which the sink writes.
+ *
+ *      level [in]
+ *          The most verbose level of messages written to the sink.
+ *
+ *      filename [in]
+ *          The filename to open for LogFacility::File or the base name of
+ *          the segments for LogFacility::MappedFile.
+ *
+ *      flush_policy [in]
+ *          When using LogFacility::File, this controls when buffered output
+ *          is written to the file.  When using LogFacility::Console, it may
+ *          ask that output be written asynchronously.
+ *
+ *  Returns:
+ *      The sink, or nullptr if it could not be created.
+ *
+ *  Comments:
+ *      Syslog is opened when the first syslog sink is created.
+ */
+std::shared_ptr<LogSink> Logger::CreateSink(LogFacility facility,
+                                            LogLevel level,
+                                            const std::string &filename,
+                                            const LogFlushPolicy &flush_policy)
+{
+    switch (facility)
+    {
+        case LogFacility::Console:
+            return std::make_shared<ConsoleSink>(colorize,
+                                                 level,
+                                                 flush_policy);
+
+        case LogFacility::Syslog:
+#ifdef LOGGER_SYSLOG_ENABLED
+            if (syslog_users++ == 0)
+            {
+                GetSyslogInterface().openlog(process_name.c_str(),
+                                             LOG_PID,
+                                             LOG_DAEMON);
+            }
+#endif
+            if (syslog_interface)
+            {
+                return std::make_shared<SyslogSink>(syslog_interface, level);
+            }
+            return std::make_shared<SyslogSink>(
+                static_cast<SyslogInterface &>(*this),
+                level);
+
+        case LogFacility::File:
+        {
+            auto sink = std::make_shared<FileSink>(level);
+            if (!sink->Open(filename, flush_policy))
+            {
+                std::cerr << "ERROR: Logger unable to open log file for "
+                             "writing: "
+                          << filename
+                          << std::endl;
+                return nullptr;
+            }
+            return sink;
+        }
+
+        case LogFacility::MappedFile:
+        {
+            auto sink = std::make_shared<MappedFileSink>(level);
+            if (!sink->Open(filename, segment_size))
+            {
+                std::cerr << "ERROR: Logger unable to open memory-mapped log "
+                             "file for writing: "
+                          << filename
+                          << std::endl;
+                return nullptr;
+            }
+            return sink;
+        }
+
+        case LogFacility::AndroidLog:
+            return std::make_shared<AndroidSink>(process_name, level);
+
+        default:
+            return nullptr;
+    }
+}
+
+/*
+ *  Logger::ReleaseSink
+ *
+ *  Description:
+ *      Release a sink that has been removed from the list of sinks, writing
+ *      any buffered output.
+ *
+ *  Parameters:
+ *      sink [in]
+ *          The sink to release.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Syslog is closed when the last syslog sink is released.  The sink's
+ *      files are closed once no other references to the sink remain.
+ */
+void Logger::ReleaseSink(std::shared_ptr<LogSink> sink)
+{
+    if (!sink) return;
+
+    sink->Flush();
+
+    // The console sink is retained for messages sent to the console
+    if (sink == console_sink) return;
+
+    Logger *self = this;
+    sink->owner.compare_exchange_strong(self, nullptr);
+
+    if ((sink->GetFacility() == LogFacility::Syslog) && (--syslog_users == 0))
+    {
+        GetSyslogInterface().closelog();
+    }
+}
+
+/*
+ *  Logger::UpdateSinkLevel
+ *
+ *  Description:
+ *      Recompute the most verbose level of messages wanted by any sink,
+ *      which is used to reject messages before they are formatted.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is called when the level of a sink changes.
+ */
+void Logger::UpdateSinkLevel()
+{
+    std::shared_lock<std::shared_mutex> lock(sink_mutex);
+
+    sink_level = ComputeSinkLevel();
+}
+
+/*
+ *  Logger::ComputeSinkLevel
+ *
+ *  Description:
+ *      Compute the most verbose level of messages wanted by any sink.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The most verbose level as an integer, or -1 if there are no sinks.
+ *
+ *  Comments:
+ *      The sink mutex must be held by the caller.  An open binary log
+ *      accepts messages at every level.
+ */
+int Logger::ComputeSinkLevel() const
+{
+    int level = binary_open ? static_cast<int>(LogLevel::Debug) : -1;
+
+    if (facility_sink)
+    {
+        level = std::max(level, static_cast<int>(facility_sink->GetLogLevel()));
+    }
+
+    for (auto &sink : sinks)
     {
-        log_level = LogLevel::Critical;
+        level = std::max(level, static_cast<int>(sink->GetLogLevel()));
     }
-    else if (level_comparator == "DEBUG")
+
+    return level;
+}
+
+/*
+ *  Logger::FlushSinksIfDue
+ *
+ *  Description:
+ *      Write the buffered output of each synchronous sink if its flush
+ *      interval has elapsed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The shortest flush interval of any sink, or zero if there is none.
+ *
+ *  Comments:
+ *      Asynchronous sinks are flushed by their own writer threads.
+ */
+std::chrono::milliseconds Logger::FlushSinksIfDue()
+{
+    std::chrono::milliseconds interval(0);
+
+    std::shared_lock<std::shared_mutex> lock(sink_mutex);
+
+    auto flush = [&](const std::shared_ptr<LogSink> &sink)
+    {
+        if (!sink || sink->IsAsync()) return;
+
+        auto sink_interval = sink->FlushIfDue();
+        if ((sink_interval.count() > 0) &&
+            ((interval.count() == 0) || (sink_interval < interval)))
+        {
+            interval = sink_interval;
+        }
+    };
+
+    flush(facility_sink);
+    for (auto &sink : sinks) flush(sink);
+
+    return interval;
+}
+
+/*
+ *  Logger::GetLogFacility
+ *
+ *  Description:
+ *      Return the current logging facility employed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The current logging facility.
+ *
+ *  Comments:
+ *      None.
+ */
+LogFacility Logger::GetLogFacility() const
+{
+    return root_logger->log_facility;
+}
+
+/*
+ *  Logger::SetLogLevel
+ *
+ *  Description:
+ *      This function will set the log level for messages to be logged.
+ *
+ *  Parameters:
+ *      level [in]
+ *          Log level of log messages to be logged.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Note that if there is a parent logger, the ultimate log level used
+ *      will be that of the root logger.  The child logger merely passes the
+ *      messages to be logged to its parent and the root logger's log level
+ *      ultimately determines what does and does not get logged.
+ *
+ *      The levels cached by this logger and the loggers beneath it are
+ *      resolved again, as they are limited by this logger's level.
+ */
+void Logger::SetLogLevel(LogLevel level)
+{
+    log_level = level;
+    root_logger->level_registry.AdvanceEpoch();
+}
+
+/*
+ *  Logger::SetLogLevel
+ *
+ *  Description:
+ *      This function will set the log level for messages to be logged
+ *      given a string, which must be one of: Critical, Error, Warning,
+ *      Info, or Debug.
+ *
+ *  Parameters:
+ *      level [in]
+ *          Log level of log messages to be logged.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Note that if there is a parent logger, the ultimate log level used
+ *      will be that of the root logger.  The child logger merely passes the
+ *      messages to be logged to its parent and the root logger's log level
+ *      ultimately determines what does and does not get logged.
+ *
+ *      Note, also, that if the LogLevel string is invalid, an error
+ *      message will be logged.
+ */
+void Logger::SetLogLevel(const std::string level)
+{
+    LogLevel parsed_level;
+
+    if (ParseLogLevel(level, parsed_level))
     {
-        log_level = LogLevel::Debug;
+        SetLogLevel(parsed_level);
     }
     else
     {
-        std::string level_error = "Unknown log level \"" + level +
-                                  "\"; setting log level to \"INFO\"";
-        Log(LogLevel::Error, level_error, true);
-        log_level = LogLevel::Info;
+        std::string level_error = "Unknown log level \"" + level +
+                                  "\"; setting log level to \"INFO\"";
+        Log(LogLevel::Error, level_error, true);
+        SetLogLevel(LogLevel::Info);
+    }
+}
+
+/*
+ *  Logger::GetLogLevel
+ *
+ *  Description:
+ *      Returns the current log level used by the logger.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The logger's current log level.
+ *
+ *  Comments:
+ *      Note that if there is a parent logger, the ultimate log level used
+ *      will be that of the root logger.  The child logger merely passes the
+ *      messages to be logged to its parent and the root logger's log level
+ *      ultimately determines what does and does not get logged.
+ */
+LogLevel Logger::GetLogLevel() const
+{
+    return log_level;
+}
+
+/*
+ *  Logger::GetLogLevelString
+ *
+ *  Description:
+ *      Returns the current log level used by the logger.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The logger's current log level as a string
+ *
+ *  Comments:
+ *      Note that if there is a parent logger, the ultimate log level used
+ *      will be that of the root logger.  The child logger merely passes the
+ *      messages to be logged to its parent and the root logger's log level
+ *      ultimately determines what does and does not get logged.
+ */
+std::string Logger::GetLogLevelString() const
+{
+    return std::string(LogLevelString(log_level));
+}
+
+/*
+ *  Logger::SetComponentLevels
+ *
+ *  Description:
+ *      Set log levels for components by their path of component names.
+ *
+ *  Parameters:
+ *      levels [in]
+ *          A comma-separated list of rules of the form "path=level", such
+ *          as "Foo.Bar=debug, *=info", where path is the component names
+ *          of a Logger and its parents separated by periods or "*" to match
+ *          every component.  An empty string removes every rule.
+ *
+ *  Returns:
+ *      True if the levels were set, false if the string is invalid.
+ *
+ *  Comments:
+ *      The levels are held by the root logger and apply to every Logger
+ *      and LoggerHandle beneath it, including those already constructed.
+ *      A rule applies to the component it names and every component
+ *      beneath it, with the longest matching path taking precedence.  The
+ *      level given by a rule replaces the levels given to SetLogLevel() by
+ *      the component and its parents.  If the string is invalid, an error
+ *      message will be logged and the levels are unchanged.
+ */
+bool Logger::SetComponentLevels(const std::string &levels)
+{
+    if (root_logger->level_registry.SetLevels(levels)) return true;
+
+    Log(LogLevel::Error, "Invalid component log levels \"" + levels + "\"",
+        true);
+
+    return false;
+}
+
+/*
+ *  Logger::GetComponentLevels
+ *
+ *  Description:
+ *      Return the log levels given to SetComponentLevels().
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The rules presently in effect, or an empty string if there are none.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string Logger::GetComponentLevels() const
+{
+    return root_logger->level_registry.GetLevels();
+}
+
+/*
+ *  Logger::IsDebugging
+ *
+ *  Description:
+ *      Check to see if debug messages are to be logged.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the log level currently set would result in debug messages
+ *      being logged.
+ *
+ *  Comments:
+ *      Note that if there is a parent logger, debug messages are logged
+ *      only if the parent loggers also log them, unless a level given by
+ *      SetComponentLevels() applies.  This does not consider whether any
+ *      sink accepts debug messages.
+ */
+bool Logger::IsDebugging() const
+{
+    return GetEffectiveLevel() >= static_cast<int>(LogLevel::Debug);
+}
+
+/*
+ *  Logger::Colorize
+ *
+ *  Description:
+ *      Enable or disable colorized console output.
+ *
+ *  Parameters:
+ *      colorize_output [in]
+ *          Indicates whether console output should be colorized or not.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Note.
+ */
+void Logger::Colorize(bool colorize_output)
+{
+    // Color will be enabled only if possible
+    if (colorize_output && IsColorPossible())
+    {
+        colorize = true;
+    }
+    else
+    {
+        colorize = false;
+    }
+
+    // Apply the setting to the console sink
+    if (console_sink) console_sink->Colorize(colorize);
+}
+
+/*
+ *  Logger::IsColorized
+ *
+ *  Description:
+ *      Indicates whether logging is currently colorized or not.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if logging output is in color, false otherwise.
+ *
+ *  Comments:
+ *      Note.
+ */
+bool Logger::IsColorized() const
+{
+    // Root logger controls color
+    return root_logger->colorize;
+}
+
+/*
+ *  Logger::SetTimePrecision
+ *
+ *  Description:
+ *      By default, the Logger produces timestamps using microsecond-level
+ *      precision.  One may use this function to change that precision to
+ *      milliseconds.
+ *
+ *  Parameters:
+ *      precision [in]
+ *          The precision with which timestamps should be produced.
+ *
+ *  Returns:
+ *      None.
+ *
+ *  Comments:
+ *      Note.
+ */
+void Logger::SetTimePrecision(LogTimePrecision precision)
+{
+    time_precision = precision;
+}
+
+/*
+ *  Logger::SetTimeFormat
+ *
+ *  Description:
+ *      By default, the Logger produces timestamps using the local time.
+ *      One may use this function to produce timestamps in UTC or as the
+ *      number of seconds since the Unix epoch.
+ *
+ *  Parameters:
+ *      format [in]
+ *          The format with which timestamps should be produced.
+ *
+ *  Returns:
+ *      None.
+ *
+ *  Comments:
+ *      Both UTC and epoch timestamps avoid the time zone lock taken by the
+ *      C library when converting to local time.
+ */
+void Logger::SetTimeFormat(LogTimeFormat format)
+{
+    time_format = format;
+}
+
+/*
+ *  Logger::SetOutputFormat
+ *
+ *  Description:
+ *      By default, the Logger writes lines of text to the console and to
+ *      files.  One may use this function to instead write each message as
+ *      a JSON object on its own line (JSON Lines).
+ *
+ *  Parameters:
+ *      format [in]
+ *          The format of lines written to the console and to files.
+ *
+ *  Returns:
+ *      None.
+ *
+ *  Comments:
+ *      The format is that of the root logger and applies to every sink
+ *      that writes lines, including the Console, File, and MappedFile
+ *      facilities.  Syslog, the Android log, and callback sinks are given
+ *      the text of the message in either case.  JSON lines are not
+ *      colorized.  Messages are not passed to EmitLog() when writing JSON
+ *      Lines, so this should not be used with a Logger that overrides
+ *      EmitLog() to redirect logging output elsewhere.
+ */
+void Logger::SetOutputFormat(LogOutputFormat format)
+{
+    root_logger->output_format = format;
+}
+
+/*
+ *  Logger::GetOutputFormat
+ *
+ *  Description:
+ *      Return the format of lines written to the console and to files.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The output format.
+ *
+ *  Comments:
+ *      None.
+ */
+LogOutputFormat Logger::GetOutputFormat() const
+{
+    return root_logger->output_format;
+}
+
+/*
+ *  Logger::ShowSourceLocation
+ *
+ *  Description:
+ *      Enable or disable writing the source file and line of each message
+ *      logged using the logging macros.
+ *
+ *  Parameters:
+ *      show [in]
+ *          Should source locations be written?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The setting is that of the root logger.  Text lines give the file
+ *      and line before the component prefix, while JSON lines have the
+ *      members "file", "line", and "function".  The call site is always
+ *      given to a CustomLogger's parts and batch callbacks.
+ */
+void Logger::ShowSourceLocation(bool show)
+{
+    root_logger->source_location = show;
+}
+
+/*
+ *  Logger::IsShowingSourceLocation
+ *
+ *  Description:
+ *      Return whether source locations are written with messages.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if source locations are written.
+ *
+ *  Comments:
+ *      None.
+ */
+bool Logger::IsShowingSourceLocation() const
+{
+    return root_logger->source_location;
+}
+
+/*
+ *  Logger::SetSegmentSize
+ *
+ *  Description:
+ *      Set the size of each segment used with LogFacility::MappedFile.
+ *
+ *  Parameters:
+ *      size [in]
+ *          The size of each segment in octets.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This takes effect the next time LogFacility::MappedFile is set.
+ */
+void Logger::SetSegmentSize(std::size_t size)
+{
+    segment_size = size;
+}
+
+/*
+ *  Logger::SetSyslogInterface
+ *
+ *  Description:
+ *      Set the interface through which messages are sent when using
+ *      LogFacility::Syslog, such as a SyslogSender that sends batches of
+ *      RFC 5424 messages rather than calling the system's syslog() for
+ *      each message.
+ *
+ *  Parameters:
+ *      syslog_interface [in]
+ *          The interface to use, or nullptr to use the system's syslog.
+ *
+ *  Returns:
+ *      True if the interface was set, false if this is a child Logger or
+ *      a syslog sink presently exists.
+ *
+ *  Comments:
+ *      The Logger calls openlog() on the interface when the first syslog
+ *      sink is created and closelog() when the last one is released.
+ */
+bool Logger::SetSyslogInterface(
+                        std::shared_ptr<SyslogInterface> syslog_interface)
+{
+    // Just return if this is a child Logger object
+    if (parent_logger) return false;
+
+    if (syslog_users > 0) return false;
+
+    this->syslog_interface = std::move(syslog_interface);
+
+    return true;
+}
+
+/*
+ *  Logger::GetLoggingStream
+ *
+ *  Description:
+ *      Return a reference to the calling thread's logging output stream for
+ *      the given log level.
+ *
+ *  Parameters:
+ *      level [in]
+ *          Log level of the output stream
+ *
+ *  Returns:
+ *      A reference to the output stream for the given log level, which is
+ *      valid until std::flush is written to it.
+ *
+ *  Comments:
+ *      None.
+ */
+std::ostream &Logger::GetLoggingStream(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::Critical:
+            return critical_buf.GetThreadStream();
+            break;
+
+        case LogLevel::Error:
+            return error_buf.GetThreadStream();
+            break;
+
+        case LogLevel::Warning:
+            return warning_buf.GetThreadStream();
+            break;
+
+        case LogLevel::Info:
+            return info_buf.GetThreadStream();
+            break;
+
+        case LogLevel::Debug:
+            return debug_buf.GetThreadStream();
+            break;
+
+        default:
+            return info_buf.GetThreadStream();
+            break;
+    }
+}
+
+/*
+ *  Logger::SetBinaryLog
+ *
+ *  Description:
+ *      Open a binary log to which messages logged via LogBinary() (e.g.,
+ *      using the LOGGER_INFO_BINARY() macro) are written without being
+ *      converted to text.
+ *
+ *  Parameters:
+ *      base_name [in]
+ *          The name to which segment sequence numbers are appended.  The
+ *          format records are written to a file named by appending
+ *          ".formats" to this name.  An empty name closes the binary log,
+ *          after which binary messages are converted to text and written to
+ *          the logging facility.
+ *
+ *  Returns:
+ *      True if the binary log was opened (or closed), false otherwise.
+ *
+ *  Comments:
+ *      This function has no effect on child logger objects.  Segments use
+ *      the size given to SetSegmentSize().
+ */
+bool Logger::SetBinaryLog(const std::string &base_name)
+{
+    // Just return if this is a child Logger object
+    if (parent_logger) return false;
+
+    std::lock_guard<std::mutex> lock(binary_mutex);
+
+    binary_open = false;
+    binary_file.Close();
+    binary_formats.Close();
+
+    if (base_name.empty()) return true;
+
+    if (!binary_formats.Open(base_name + std::string(Binary_Formats_Suffix)) ||
+        !binary_file.Open(base_name, segment_size))
+    {
+        binary_formats.Close();
+        std::cerr << "ERROR: Logger unable to open binary log for writing: "
+                  << base_name
+                  << std::endl;
+        return false;
+    }
+
+    // Format records must be written again for the new binary log
+    static std::atomic<std::uint64_t> next_generation{1};
+    binary_generation = next_generation++;
+    binary_open = true;
+
+    // Raw clock values require a calibration to be decoded
+    if (clock.GetSource() != LogClockSource::System) WriteBinaryClock();
+
+    return true;
+}
+
+/*
+ *  Logger::EmitBinary
+ *
+ *  Description:
+ *      This function will write a binary message to the binary log or, if
+ *      there is no binary log, convert it to text and emit it to the
+ *      logging facility.
+ *
+ *  Parameters:
+ *      format [in]
+ *          The format describing the message.
+ *
+ *      prefix [in]
+ *          The component prefix of the logger producing the message.
+ *
+ *      arguments [in]
+ *          The encoded message arguments.
+ *
+ *      console [in]
+ *          Request to log the specific message to the console in addition to
+ *          the default logging facility.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When logging asynchronously, conversion to text is performed on the
+ *      background writer thread.  Messages written to the binary log or
+ *      queued are timed using the clock given to SetClockSource().
+ */
+void Logger::EmitBinary(const BinaryFormat &format,
+                        const std::string &prefix,
+                        const std::string &arguments,
+                        bool console)
+{
+    if (binary_open)
+    {
+        // Write the format record the first time this format is used
+        if (format.generation.load(std::memory_order_acquire) !=
+            binary_generation)
+        {
+            WriteBinaryFormat(format);
+        }
+
+        // The prefix is truncated to what its length field can represent,
+        // so the record length matches the octets written
+        std::size_t prefix_length =
+            std::min<std::size_t>(prefix.size(), UINT16_MAX);
+
+        BinaryRecordHeader header{};
+        header.length = static_cast<std::uint32_t>(
+                            sizeof(header) + prefix_length + arguments.size());
+        header.type = static_cast<std::uint8_t>(BinaryRecordType::Message);
+        header.level = static_cast<std::uint8_t>(format.level);
+        header.prefix_length = static_cast<std::uint16_t>(prefix_length);
+        header.format_id = format.id;
+        header.timestamp = static_cast<std::int64_t>(ReadClock());
+
+        const std::string_view parts[3] =
+        {
+            std::string_view(reinterpret_cast<const char *>(&header),
+                             sizeof(header)),
+            std::string_view(prefix.data(), prefix_length),
+            arguments
+        };
+
+        MappedLogPosition position;
+        if (binary_file.Write(parts, 3, &position) &&
+            ((position.offset == 0) ||
+             ((position.offset - 1) / Binary_Index_Interval !=
+              (position.offset + header.length - 1) / Binary_Index_Interval)))
+        {
+            WriteBinaryIndex(position, header.timestamp);
+        }
+
+        return;
+    }
+
+    if (static_cast<int>(format.level) > sink_level) return;
+
+    // Defer conversion to text to the background writer thread
+    if (async_queue.IsRunning())
+    {
+        LogRecord record{format.level,
+                         console,
+                         {},
+                         LogRecordText(prefix),
+                         &format,
+                         prefix.size()};
+        record.text.Append(arguments);
+        record.clock_ticks = ReadClock();
+        async_queue.Push(std::move(record));
+        return;
+    }
+
+    LogTextBuffer buffer;
+    buffer.Get().clear();
+    AppendBinaryArguments(buffer.Get(), format.format, arguments);
+
+    EmitParts(format.level, prefix, buffer.Get(), console, 0, nullptr);
+}
+
+/*
+ *  Logger::WriteBinaryFormat
+ *
+ *  Description:
+ *      Write the format record describing a binary message to the binary
+ *      log's format file.
+ *
+ *  Parameters:
+ *      format [in]
+ *          The format to be written.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Should two threads write the same format concurrently, the format
+ *      record is simply written twice.
+ */
+void Logger::WriteBinaryFormat(const BinaryFormat &format)
+{
+    std::lock_guard<std::mutex> lock(binary_mutex);
+
+    if (!binary_open) return;
+
+    std::string_view file(format.file);
+    std::string_view format_string(format.format);
+
+    BinaryFormatBody body{};
+    body.line = format.line;
+    body.file_length = static_cast<std::uint32_t>(file.size());
+    body.format_length = static_cast<std::uint32_t>(format_string.size());
+
+    BinaryRecordHeader header{};
+    header.length = static_cast<std::uint32_t>(sizeof(header) + sizeof(body) +
+                                               file.size() +
+                                               format_string.size());
+    header.type = static_cast<std::uint8_t>(BinaryRecordType::Format);
+    header.level = static_cast<std::uint8_t>(format.level);
+    header.format_id = format.id;
+
+    const std::string_view parts[4] =
+    {
+        std::string_view(reinterpret_cast<const char *>(&header),
+                         sizeof(header)),
+        std::string_view(reinterpret_cast<const char *>(&body), sizeof(body)),
+        file,
+        format_string
+    };
+
+    binary_formats.Write(parts, 4, false);
+
+    format.generation.store(binary_generation, std::memory_order_release);
+}
+
+/*
+ *  Logger::WriteBinaryIndex
+ *
+ *  Description:
+ *      Write an index record to the binary log's format file, giving the
+ *      location and time of a message record that spans a boundary of
+ *      Binary_Index_Interval octets within its segment.
+ *
+ *  Parameters:
+ *      position [in]
+ *          The segment and offset at which the message was written.
+ *
+ *      timestamp [in]
+ *          The timestamp of the message, as recorded in its header.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The first message in each segment is always indexed.
+ */
+void Logger::WriteBinaryIndex(const MappedLogPosition &position,
+                              std::int64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(binary_mutex);
+
+    if (!binary_open) return;
+
+    BinaryIndexBody body{};
+    body.offset = position.offset;
+
+    BinaryRecordHeader header{};
+    header.length = static_cast<std::uint32_t>(sizeof(header) + sizeof(body));
+    header.type = static_cast<std::uint8_t>(BinaryRecordType::Index);
+    header.format_id = position.sequence;
+    header.timestamp = timestamp;
+
+    const std::string_view parts[2] =
+    {
+        std::string_view(reinterpret_cast<const char *>(&header),
+                         sizeof(header)),
+        std::string_view(reinterpret_cast<const char *>(&body), sizeof(body))
+    };
+
+    binary_formats.Write(parts, 2, false);
+}
+
+/*
+ *  Logger::WriteBinaryClock
+ *
+ *  Description:
+ *      Write a clock record giving the clock's most recent calibration to
+ *      the binary log, so that raw clock values may be decoded.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This must be called with binary_mutex held.
+ */
+void Logger::WriteBinaryClock()
+{
+    if (!binary_open) return;
+
+    LogClockCalibration calibration = clock.GetCalibration();
+
+    BinaryClockBody body{};
+    body.ticks = calibration.ticks;
+    body.nanoseconds_per_tick = calibration.nanoseconds_per_tick;
+
+    BinaryRecordHeader header{};
+    header.length = static_cast<std::uint32_t>(sizeof(header) + sizeof(body));
+    header.type = static_cast<std::uint8_t>(BinaryRecordType::Clock);
+    header.level = static_cast<std::uint8_t>(clock.GetSource());
+    header.timestamp = calibration.nanoseconds;
+
+    const std::string_view parts[2] =
+    {
+        std::string_view(reinterpret_cast<const char *>(&header),
+                         sizeof(header)),
+        std::string_view(reinterpret_cast<const char *>(&body), sizeof(body))
+    };
+
+    binary_formats.Write(parts, 2, false);
+}
+
+/*
+ *  Logger::ReadClock
+ *
+ *  Description:
+ *      Read the raw value of the clock given to SetClockSource(),
+ *      calibrating the clock if a calibration is due.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The raw value of the clock.
+ *
+ *  Comments:
+ *      Checking whether a calibration is due requires only a comparison,
+ *      so the calling thread seldom does more than read the clock.  A new
+ *      calibration is recorded in an open binary log.
+ */
+std::uint64_t Logger::ReadClock()
+{
+    std::uint64_t ticks = clock.Now();
+
+    if (clock.IsCalibrationDue(ticks) && clock.Calibrate() && binary_open)
+    {
+        std::lock_guard<std::mutex> lock(binary_mutex);
+        WriteBinaryClock();
+    }
+
+    return ticks;
+}
+
+/*
+ *  Logger::SetAsync
+ *
+ *  Description:
+ *      Enable or disable asynchronous logging.  When enabled, log messages
+ *      are placed into a bounded queue and written to the logging facility
+ *      by a background writer thread.
+ *
+ *  Parameters:
+ *      queue_capacity [in]
+ *          The maximum number of messages that may be queued, which is
+ *          rounded up to a power of two.  A value of zero will disable
+ *          asynchronous logging after emitting any queued messages.
+ *
+ *      policy [in]
+ *          The action taken when the queue is full.  By default, the thread
+ *          logging the message waits for space.  Threads that must not
+ *          block for long may use BlockWithTimeout or DropLowPriority with
+ *          a timeout, or one of the other policies that never wait.  A
+ *          sharded policy gives each logging thread its own queue, merging
+ *          messages in time order.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This function has no effect on child logger objects.  It should be
+ *      called before other threads begin logging, as changing the mode
+ *      while messages are being logged is not synchronized.  When messages
+ *      have been discarded, a Warning message noting the number discarded
+ *      is written before the next queued message.
+ */
+void Logger::SetAsync(std::size_t queue_capacity,
+                      const LogQueuePolicy &policy)
+{
+    // Just return if this is a child Logger object
+    if (parent_logger) return;
+
+    async_queue.Stop();
+
+    if (queue_capacity == 0) return;
+
+    async_queue.Start(queue_capacity,
+                      [this](LogRecord &record) { WriteRecord(record); },
+                      [this]() { return FlushSinksIfDue(); },
+                      policy,
+                      [this](LogRecord &next, std::uint64_t count)
+                      {
+                          WriteLog(LogLevel::Warning,
+                                   LogDropMarker(count),
+                                   false,
+                                   GetRecordTime(next));
+                      },
+                      [this](const LogRecord &record)
+                      {
+                          return LogQueueOrder(GetRecordTime(record));
+                      });
+}
+
+/*
+ *  Logger::GetDropCounts
+ *
+ *  Description:
+ *      Return the number of messages at each level discarded because the
+ *      asynchronous logging queue was full.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of messages discarded, indexed by level.
+ *
+ *  Comments:
+ *      Messages discarded by the queues of individual sinks are counted by
+ *      each sink (see LogSink::GetDropCounts()).
+ */
+LogDropCounts Logger::GetDropCounts() const
+{
+    return root_logger->async_queue.GetDropCounts();
+}
+
+/*
+ *  Logger::IsAsync
+ *
+ *  Description:
+ *      Indicates whether log messages are emitted from a background thread.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if logging is asynchronous, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool Logger::IsAsync() const
+{
+    // Root logger controls asynchronous logging
+    return root_logger->async_queue.IsRunning();
+}
+
+/*
+ *  Logger::SetClockSource
+ *
+ *  Description:
+ *      Set the clock read to time messages queued for the background writer
+ *      thread or written to the binary log.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The clock to read.  LogClockSource::Tsc and
+ *          LogClockSource::MonotonicCoarse record a raw value that is
+ *          converted to the time of day only when the message is written
+ *          or decoded.
+ *
+ *  Returns:
+ *      True if the clock was set, false if it is not available on this
+ *      system.
+ *
+ *  Comments:
+ *      The clock is that of the root logger and is calibrated against the
+ *      system time when set and every LogClock::Calibration_Interval.  Each
+ *      calibration is recorded in an open binary log.  Messages written
+ *      directly to the sinks are timed using the system time, as they are
+ *      formatted immediately.  This should be called before other threads
+ *      begin logging.
+ */
+bool Logger::SetClockSource(LogClockSource source)
+{
+    Logger &root = *root_logger;
+
+    if (!root.clock.SetSource(source)) return false;
+
+    std::lock_guard<std::mutex> lock(root.binary_mutex);
+    if (root.binary_open) root.WriteBinaryClock();
+
+    return true;
+}
+
+/*
+ *  Logger::GetClockSource
+ *
+ *  Description:
+ *      Return the clock read to time queued and binary messages.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The clock source.
+ *
+ *  Comments:
+ *      None.
+ */
+LogClockSource Logger::GetClockSource() const
+{
+    return root_logger->clock.GetSource();
+}
+
+/*
+ *  Logger::Flush
+ *
+ *  Description:
+ *      Wait until all queued log messages have been emitted by the
+ *      background writer thread and written to the logging facility.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Any messages queued by asynchronous sinks and output buffered
+ *      according to a file's flush policy are also written, as is the
+ *      summary of any run of repeated messages being coalesced.
+ */
+void Logger::Flush()
+{
+    if (root_logger != this)
+    {
+        root_logger->Flush();
+        return;
+    }
+
+    // Summarize repeated messages, then wait for the background writer
+    // thread to emit all queued messages
+    FlushRepeats();
+    async_queue.Flush();
+
+    // Write any messages queued or output buffered by each sink
+    std::shared_lock<std::shared_mutex> lock(sink_mutex);
+
+    if (facility_sink) facility_sink->Flush();
+    for (auto &sink : sinks) sink->Flush();
+}
+
+/*
+ *  Logger::EnableFlightRecorder
+ *
+ *  Description:
+ *      Retain the most recent messages at every level, including those
+ *      below the log level, in a fixed-size ring in memory.  The messages
+ *      not already written are emitted when a Critical message is logged or
+ *      when DumpFlightRecorder() is called.
+ *
+ *  Parameters:
+ *      capacity [in]
+ *          The number of messages to retain, which is rounded up to a power
+ *          of two.  A value of zero disables the flight recorder.
+ *
+ *      dump_on_fatal_signal [in]
+ *          Write the retained messages to standard error if the process
+ *          receives a fatal signal (e.g., SIGSEGV).
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This function has no effect on child logger objects.  Like
+ *      SetAsync(), it should be called before other threads begin logging.
+ *      While enabled, ShouldLog() is true at every level, so messages below
+ *      the log level are formatted, though not written.  Only the first
+ *      FlightRecorder::Max_Record_Length octets of each message are kept.
+ *      Messages logged with the binary logging macros are not retained.
+ */
+void Logger::EnableFlightRecorder(std::size_t capacity,
+                                  bool dump_on_fatal_signal)
+{
+    // Just return if this is a child Logger object
+    if (parent_logger) return;
+
+    flight_recording = false;
+    flight_recorder.reset();
+
+    if (capacity == 0) return;
+
+    flight_recorder = std::make_unique<FlightRecorder>(capacity);
+
+    if (dump_on_fatal_signal)
+    {
+        FlightRecorder::InstallSignalHandlers(flight_recorder.get(), 2);
     }
+
+    flight_recording = true;
 }
 
 /*
- *  Logger::GetLogLevel
+ *  Logger::DumpFlightRecorder
  *
  *  Description:
- *      Returns the current log level used by the logger.
+ *      Emit the messages retained by the flight recorder since it was last
+ *      dumped that were not written when logged, oldest first, each noting
+ *      the time it was logged.
  *
  *  Parameters:
  *      None.
  *
  *  Returns:
- *      The logger's current log level.
+ *      Nothing.
  *
  *  Comments:
- *      Note that if there is a parent logger, the ultimate log level used
- *      will be that of the root logger.  The child logger merely passes the
- *      messages to be logged to its parent and the root logger's log level
- *      ultimately determines what does and does not get logged.
+ *      The messages are given to EmitParts(), so a CustomLogger receives
+ *      them as it does other messages.  Each sink writes only those
+ *      messages at or above its own level.  The dumped messages are
+ *      enclosed by Info messages indicating the start and end of the dump.
  */
-LogLevel Logger::GetLogLevel() const
+void Logger::DumpFlightRecorder()
 {
-    return log_level;
+    if (root_logger != this)
+    {
+        root_logger->DumpFlightRecorder();
+        return;
+    }
+
+    if (!flight_recording) return;
+
+    auto records = flight_recorder->Drain();
+
+    // Messages already written are not written again
+    records.erase(std::remove_if(records.begin(),
+                                 records.end(),
+                                 [](const FlightRecord &record)
+                                 {
+                                     return record.written;
+                                 }),
+                  records.end());
+
+    EmitLog(LogLevel::Info,
+            "Flight recorder dump begins (" + std::to_string(records.size()) +
+                " messages)",
+            false);
+
+    std::string body;
+    for (const auto &record : records)
+    {
+        char timestamp[Max_Timestamp_Length];
+        std::size_t timestamp_length = FormatTimestamp(record.time, timestamp);
+        std::string_view text = record.text;
+
+        body.assign("(logged ");
+        body.append(timestamp, timestamp_length);
+        body += ") ";
+        body += text.substr(record.prefix_length);
+
+        EmitParts(record.level,
+                  text.substr(0, record.prefix_length),
+                  body,
+                  false,
+                  0,
+                  nullptr);
+    }
+
+    EmitLog(LogLevel::Info, "Flight recorder dump ends", false);
 }
 
 /*
- *  Logger::GetLogLevelString
+ *  Logger::EnableCoalescing
  *
  *  Description:
- *      Returns the current log level used by the logger.
+ *      Count messages that repeat the previous message logged by the same
+ *      component at the same level, rather than writing them.  When a run
+ *      of repeats ends, a line noting the number of repeats and the times
+ *      of the first and last is written in their place.
  *
  *  Parameters:
- *      None.
+ *      timeout [in]
+ *          A run of repeats is summarized once no repeat has been seen for
+ *          this long, or once it has lasted this long, in which case the
+ *          repeats that follow are counted anew.  A value of zero disables
+ *          coalescing after summarizing any runs of repeats.
  *
  *  Returns:
- *      The logger's current log level as a string
+ *      Nothing.
  *
  *  Comments:
- *      Note that if there is a parent logger, the ultimate log level used
- *      will be that of the root logger.  The child logger merely passes the
- *      messages to be logged to its parent and the root logger's log level
- *      ultimately determines what does and does not get logged.
+ *      This function has no effect on child logger objects.  Like
+ *      SetAsync(), it should be called before other threads begin logging.
+ *      Runs that have gone quiet are summarized when a message is next
+ *      logged or when Flush() is called.  Messages are compared by hash and
+ *      length, so a message differing from the previous one only in rare
+ *      cases may be counted as a repeat.
  */
-std::string Logger::GetLogLevelString() const
+void Logger::EnableCoalescing(std::chrono::milliseconds timeout)
 {
-    return LogLevelString(log_level);
+    // Just return if this is a child Logger object
+    if (parent_logger) return;
+
+    FlushRepeats();
+    coalescing = false;
+    coalescer.reset();
+
+    if (timeout.count() <= 0) return;
+
+    coalescer = std::make_unique<LogCoalescer>(timeout);
+    coalescing = true;
 }
 
 /*
- *  Logger::IsDebugging
+ *  Logger::Coalesce
  *
  *  Description:
- *      Check to see if debug messages are to be logged.
+ *      Count the message if it repeats the previous message logged by its
+ *      component at its level, first writing the summary of any run of
+ *      repeats that has ended.
  *
  *  Parameters:
- *      None.
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      prefix [in]
+ *          The component prefix to precede the message.
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *      console [in]
+ *          Is the message also to be written to the console?
  *
  *  Returns:
- *      True if the log level currently set would result in debug messages
- *      being logged.
+ *      True if the message repeats the previous one and is not to be
+ *      emitted, false otherwise.
  *
  *  Comments:
- *      Note that if there is a parent logger, the ultimate log level used
- *      will be that of the root logger.  The child logger merely passes the
- *      messages to be logged to its parent and the root logger's log level
- *      ultimately determines what does and does not get logged.  Thus, this
- *      function might return true if the child logger passes debug messages
- *      to the parent logger, but the messages would be discarded if the
- *      parent logger is not logging debug messages.
+ *      Called only on the root logger.
  */
-bool Logger::IsDebugging() const
+bool Logger::Coalesce(LogLevel level,
+                      std::string_view prefix,
+                      const std::string &message,
+                      bool console)
 {
-    return log_level >= LogLevel::Debug;
+    static thread_local std::vector<LogRepeat> ended;
+
+    ended.clear();
+
+    bool repeat = coalescer->IsRepeat(level,
+                                      prefix,
+                                      message,
+                                      console,
+                                      std::chrono::system_clock::now(),
+                                      ended);
+
+    if (!ended.empty()) WriteRepeats(ended);
+
+    return repeat;
 }
 
 /*
- *  Logger::Colorize
+ *  Logger::WriteRepeats
  *
  *  Description:
- *      Enable or disable colorized console output.
+ *      Emit a line summarizing each of the given runs of repeated messages,
+ *      such as "Last message repeated 12 times (first <time>, last <time>)",
+ *      with the level and component prefix of the repeated message.
  *
  *  Parameters:
- *      colorize_output [in]
- *          Indicates whether console output should be colorized or not.
+ *      repeats [in]
+ *          The runs of repeated messages.
  *
  *  Returns:
  *      Nothing.
  *
  *  Comments:
- *      Note.
+ *      The times are formatted as given to SetTimeFormat().
  */
-void Logger::Colorize(bool colorize_output)
+void Logger::WriteRepeats(const std::vector<LogRepeat> &repeats)
 {
-    // Color will be enabled only if possible
-    if (colorize_output && IsColorPossible())
-    {
-        colorize = true;
-    }
-    else
+    char timestamp[Max_Timestamp_Length];
+    LogTextBuffer buffer;
+    std::string &text = buffer.Get();
+
+    for (const auto &repeat : repeats)
     {
-        colorize = false;
+        text.assign("Last message repeated ");
+        text += std::to_string(repeat.count);
+        text += (repeat.count == 1) ? " time (first " : " times (first ";
+        text.append(timestamp, FormatTimestamp(repeat.first, timestamp));
+        text += ", last ";
+        text.append(timestamp, FormatTimestamp(repeat.last, timestamp));
+        text += ')';
+
+        EmitParts(repeat.level,
+                  repeat.prefix,
+                  text,
+                  repeat.console,
+                  0,
+                  nullptr);
     }
 }
 
 /*
- *  Logger::IsColorized
+ *  Logger::FlushRepeats
  *
  *  Description:
- *      Indicates whether logging is currently colorized or not.
+ *      Emit the summary of every run of repeated messages being coalesced.
  *
  *  Parameters:
  *      None.
  *
  *  Returns:
- *      True if logging output is in color, false otherwise.
+ *      Nothing.
  *
  *  Comments:
- *      Note.
+ *      Called only on the root logger.
  */
-bool Logger::IsColorized() const
+void Logger::FlushRepeats()
 {
-    // Parent logger controls color, if there is one
-    if (parent_logger) return parent_logger->IsColorized();
+    if (!coalescing) return;
 
-    return colorize;
+    std::vector<LogRepeat> ended;
+    coalescer->TakeAll(ended);
+    WriteRepeats(ended);
 }
 
 /*
- *  Logger::SetTimePrecision
+ *  Logger::EnableStats
  *
  *  Description:
- *      By default, the Logger produces timestamps using microsecond-level
- *      precision.  One may use this function to change that precision to
- *      milliseconds.
+ *      Enable or disable the collection of statistics returned by
+ *      GetStats().
  *
  *  Parameters:
- *      precision [in]
- *          The precision with which timestamps should be produced.
+ *      enable [in]
+ *          True to collect statistics, false to stop collecting them.
  *
  *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Statistics are retained while collection is disabled.  The queue
+ *      depth and drops are maintained even when statistics are not being
+ *      collected.
+ */
+void Logger::EnableStats(bool enable)
+{
+    root_logger->stats->Enable(enable);
+}
+
+/*
+ *  Logger::GetStats
+ *
+ *  Description:
+ *      Return the statistics describing the activity of the root Logger.
+ *
+ *  Parameters:
  *      None.
  *
+ *  Returns:
+ *      The messages logged and rejected at each level, the octets written
+ *      to each facility, the messages discarded at each level by the
+ *      Logger's queue and by the sinks' queues, the current and maximum
+ *      depth of the Logger's queue, and histograms of the time taken by
+ *      EmitLog() and of the time spent waiting for locks.
+ *
  *  Comments:
- *      Note.
+ *      Messages rejected by the logging macros before reaching the Logger
+ *      are not counted as filtered.  The octets written to sinks that are
+ *      not a logging facility (e.g., a CallbackSink) are counted under
+ *      LogFacility::None.
  */
-void Logger::SetTimePrecision(LogTimePrecision precision)
+LogStats Logger::GetStats()
 {
-    switch (precision)
+    if (root_logger != this) return root_logger->GetStats();
+
+    LogStats log_stats;
+
+    stats->Read(log_stats);
+
+    log_stats.drops = async_queue.GetDropCounts();
+    log_stats.queue_depth = async_queue.GetDepth();
+    log_stats.max_queue_depth = async_queue.GetMaxDepth();
+
+    std::shared_lock<std::shared_mutex> lock(sink_mutex);
+
+    auto add_drops = [&](const std::shared_ptr<LogSink> &sink)
     {
-        case LogTimePrecision::Milliseconds:
-            time_digits = 3;
-            time_modulo = 1'000;
-            break;
+        if (!sink) return;
 
-        case LogTimePrecision::Microseconds:
-            [[fallthrough]];
+        auto drops = sink->GetDropCounts();
+        for (std::size_t i = 0; i < drops.size(); i++)
+        {
+            log_stats.drops[i] += drops[i];
+        }
+    };
 
-        default:
-            time_digits = 6;
-            time_modulo = 1'000'000;
-            break;
-    }
+    add_drops(facility_sink);
+    for (auto &sink : sinks) add_drops(sink);
+    if (facility_sink != console_sink) add_drops(console_sink);
+
+    return log_stats;
 }
 
 /*
- *  Logger::GetLoggingStream
+ *  Logger::WriteRecord
  *
  *  Description:
- *      Return a reference to the logging output stream for the given
- *      log level.
+ *      Write a record removed from the message queue by the background
+ *      writer thread to the sinks.
  *
  *  Parameters:
- *      level [in]
- *          Log level of the output stream
+ *      record [in]
+ *          The record to write.  Binary records are converted to text.
  *
  *  Returns:
- *      A reference to the output stream for the given log level.
+ *      Nothing.
  *
  *  Comments:
- *      None.
+ *      Binary records are converted into one of the thread's reusable
+ *      buffers, so writing a record does not allocate memory.
  */
-std::ostream &Logger::GetLoggingStream(LogLevel level)
+void Logger::WriteRecord(LogRecord &record)
 {
-    switch (level)
+    std::string_view text = record.text.View();
+
+    auto time = GetRecordTime(record);
+
+    if (record.binary_format == nullptr)
     {
-        case LogLevel::Critical:
-            return critical;
-            break;
+        WriteLog(record.level,
+                 text,
+                 record.console,
+                 time,
+                 LogTextLayout{record.prefix_length,
+                               record.fields_length,
+                               record.site});
+        return;
+    }
 
-        case LogLevel::Error:
-            return error;
-            break;
+    // Convert binary messages to text
+    LogTextBuffer buffer;
+    buffer.Get().assign(text.substr(0, record.prefix_length));
+    AppendBinaryArguments(buffer.Get(),
+                          record.binary_format->format,
+                          text.substr(record.prefix_length));
+
+    WriteLog(record.level,
+             buffer.Get(),
+             record.console,
+             time,
+             LogTextLayout{record.prefix_length, 0});
+}
 
-        case LogLevel::Warning:
-            return warning;
-            break;
+/*
+ *  Logger::GetRecordTime
+ *
+ *  Description:
+ *      Return the time at which a queued record was logged, converting the
+ *      raw clock value recorded if the time was not set.
+ *
+ *  Parameters:
+ *      record [in]
+ *          The record removed from the queue.
+ *
+ *  Returns:
+ *      The time at which the record was logged.
+ *
+ *  Comments:
+ *      None.
+ */
+std::chrono::system_clock::time_point Logger::GetRecordTime(
+                                        const LogRecord &record) const
+{
+    if (record.time != std::chrono::system_clock::time_point{})
+    {
+        return record.time;
+    }
 
-        case LogLevel::Info:
-            return info;
-            break;
+    return clock.ToTime(record.clock_ticks);
+}
 
-        case LogLevel::Debug:
-            return debug;
-            break;
+/*
+ *  Logger::GetSyslogInterface
+ *
+ *  Description:
+ *      Return the interface through which syslog messages are sent.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The interface given to SetSyslogInterface() or this Logger, which
+ *      calls the system's syslog.
+ *
+ *  Comments:
+ *      None.
+ */
+SyslogInterface &Logger::GetSyslogInterface()
+{
+    if (syslog_interface) return *syslog_interface;
 
-        default:
-            return info;
-            break;
-    }
+    return *this;
 }
 
 /*
@@ -862,40 +2720,7 @@ std::ostream &Logger::GetLoggingStream(LogLevel level)
  */
 int Logger::MapLogLevelToSysLog(LogLevel level) const
 {
-#ifndef LOGGER_SYSLOG_ENABLED
-    return 0;
-#else
-    int priority;
-
-    switch (level)
-    {
-        case LogLevel::Critical:
-            priority = LOG_CRIT;
-            break;
-
-        case LogLevel::Error:
-            priority = LOG_ERR;
-            break;
-
-        case LogLevel::Warning:
-            priority = LOG_WARNING;
-            break;
-
-        case LogLevel::Info:
-            priority = LOG_INFO;
-            break;
-
-        case LogLevel::Debug:
-            priority = LOG_DEBUG;
-            break;
-
-        default:
-            priority = LOG_INFO;
-            break;
-    }
-
-    return priority;
-#endif
+    return SyslogSink::MapLogLevel(level);
 }
 
 /*
@@ -914,75 +2739,64 @@ int Logger::MapLogLevelToSysLog(LogLevel level) const
  *  Comments:
  *      None.
  */
-std::string Logger::LogLevelString(LogLevel level) const
+std::string_view Logger::LogLevelString(LogLevel level) const
 {
-    std::string log_level_string;
-
-    switch (level)
-    {
-        case LogLevel::Critical:
-            log_level_string = "CRITICAL";
-            break;
-
-        case LogLevel::Error:
-            log_level_string = "ERROR";
-            break;
-
-        case LogLevel::Warning:
-            log_level_string = "WARNING";
-            break;
-
-        case LogLevel::Info:
-            log_level_string = "INFO";
-            break;
-
-        case LogLevel::Debug:
-            log_level_string = "DEBUG";
-            break;
-
-        default:
-            log_level_string = "UNKNOWN";
-            break;
-    }
-
-    return log_level_string;
+    return LogLevelName(level);
 }
 
 /*
  *  Logger::GetTimestamp
  *
  *  Description:
- *      Return a string representing the current time down to milliseconds.
+ *      Return a string representing the given time down to milliseconds
+ *      or microseconds.
  *
  *  Parameters:
- *      None.
+ *      time [in]
+ *          The time to represent as a string.
  *
  *  Returns:
- *      A string representing the current time.
+ *      A string representing the given time.
  *
  *  Comments:
  *      None.
  */
-std::string Logger::GetTimestamp() const
+std::string Logger::GetTimestamp(
+    const std::chrono::system_clock::time_point &time) const
 {
-    std::ostringstream oss;
+    char buffer[Max_Timestamp_Length];
 
-    auto now = std::chrono::system_clock::now();
-    auto now_us = std::chrono::time_point_cast<std::chrono::microseconds>(now);
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    struct tm tm_result{};
-#ifdef _WIN32
-    localtime_s(&tm_result, &t);
-#else
-    localtime_r(&t, &tm_result);
-#endif
-    oss << std::put_time(&tm_result, "%FT%T")
-        << "."
-        << std::setfill('0')
-        << std::setw(time_digits)
-        << (now_us.time_since_epoch().count()) % time_modulo;
+    return std::string(buffer, FormatTimestamp(time, buffer));
+}
 
-    return oss.str();
+/*
+ *  Logger::FormatTimestamp
+ *
+ *  Description:
+ *      Write a string representing the given time down to milliseconds
+ *      or microseconds into the given buffer.
+ *
+ *  Parameters:
+ *      time [in]
+ *          The time to represent as a string.
+ *
+ *      buffer [out]
+ *          The buffer into which the timestamp is written, which must be
+ *          at least Max_Timestamp_Length octets in length.  The timestamp
+ *          is not NULL-terminated.
+ *
+ *  Returns:
+ *      The length of the timestamp written to the buffer.
+ *
+ *  Comments:
+ *      The timestamp uses the format and precision given to
+ *      SetTimeFormat() and SetTimePrecision().
+ */
+std::size_t Logger::FormatTimestamp(
+    const std::chrono::system_clock::time_point &time,
+    char *buffer) const
+{
+    return FormatLogTimestamp(time, time_format, time_precision, buffer);
 }
 
 /*
@@ -0,0 +1,567 @@
+/*
+ *  logger_handle.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This implements the LoggerHandle class, a lightweight component
+ *      logger that gives messages to a Logger.  The streams used with the
+ *      streaming interfaces are drawn from a pool belonging to each thread,
+ *      so a handle needs no stream buffers of its own.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <memory>
+#include <streambuf>
+#include <vector>
+#include "cantina/logger_handle.h"
+
+namespace cantina
+{
+
+namespace
+{
+
+// Stream buffer holding a message being streamed to a LoggerHandle
+class HandleStreamBuf : public std::streambuf
+{
+    public:
+        HandleStreamBuf() :
+            handle(nullptr),
+            level(LogLevel::Info),
+            console(false),
+            key(0)
+        {
+        }
+
+        LoggerHandle *handle;           // Handle to which to give messages
+        LogLevel level;                 // Level of the message
+        bool console;                   // Also log to the console
+        std::uint64_t key;              // Handle's stream identifier and
+                                        // the level and console flag
+        std::string text;               // Message being constructed
+
+    protected:
+        virtual int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                text.push_back(traits_type::to_char_type(c));
+            }
+
+            return traits_type::not_eof(c);
+        }
+
+        virtual std::streamsize xsputn(const char *c,
+                                       std::streamsize n) override
+        {
+            text.append(c, static_cast<std::size_t>(n));
+            return n;
+        }
+
+        virtual int sync() override;
+};
+
+// Stream and its buffer, which are reused from one message to the next
+struct HandleStream
+{
+    HandleStream() : stream(&buffer) {}
+
+    HandleStreamBuf buffer;
+    std::ostream stream;
+};
+
+// Streams belonging to the current thread
+struct ThreadStreams
+{
+    // Streams holding messages being constructed
+    std::vector<std::unique_ptr<HandleStream>> active;
+
+    // Streams available for reuse
+    std::vector<std::unique_ptr<HandleStream>> spare;
+};
+
+ThreadStreams &GetThreadStreams()
+{
+    static thread_local ThreadStreams thread_streams;
+    return thread_streams;
+}
+
+/*
+ *  HandleStreamBuf::sync
+ *
+ *  Description:
+ *      Give the message constructed in this buffer to the handle and return
+ *      the stream to the thread's pool.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Zero.
+ *
+ *  Comments:
+ *      The stream is returned to the pool before the message is logged so
+ *      that logging to other streams from within Log() is safe.  Streams
+ *      are never destroyed while the thread runs, as the pool grows only to
+ *      the number of messages the thread constructs at once.  The text's
+ *      allocated capacity is retained where possible.
+ */
+int HandleStreamBuf::sync()
+{
+    auto &streams = GetThreadStreams();
+    LoggerHandle *target = handle;
+    std::string message;
+
+    message.swap(text);
+    handle = nullptr;
+    key = 0;
+
+    for (auto it = streams.active.begin(); it != streams.active.end(); it++)
+    {
+        if (&(*it)->buffer != this) continue;
+        streams.spare.push_back(std::move(*it));
+        streams.active.erase(it);
+        break;
+    }
+
+    if (target) target->Log(level, message, console);
+
+    // Retain the capacity unless the stream was reused in the meantime
+    if (text.empty() && (text.capacity() < message.capacity()))
+    {
+        message.clear();
+        text.swap(message);
+    }
+
+    return 0;
+}
+
+} // namespace
+
+/*
+ *  NextStreamId
+ *
+ *  Description:
+ *      Return a unique identifier for the streams of a LoggerHandle.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A unique identifier.
+ *
+ *  Comments:
+ *      Identifiers are never reused, so a partial message streamed to a
+ *      destroyed handle is never given to a handle created at the same
+ *      address.
+ */
+static std::uint64_t NextStreamId()
+{
+    static std::atomic<std::uint64_t> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+ *  LoggerHandle::LoggerHandle
+ *
+ *  Description:
+ *      Constructor for a LoggerHandle giving messages to the given Logger.
+ *
+ *  Parameters:
+ *      component_name [in]
+ *          The name of the component to print in log messages.
+ *
+ *      parent_logger [in]
+ *          The Logger to which messages are given.
+ *
+ *      output_to_console [in]
+ *          Should log messages also be output to the console?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The handle initially has the log level of the parent Logger.
+ */
+LoggerHandle::LoggerHandle(const std::string &component_name,
+                           const LoggerPointer &parent_logger,
+                           bool output_to_console) :
+    parent_logger(parent_logger),
+    component_prefix(parent_logger->component_prefix),
+    component_path(parent_logger->component_path),
+    log_level(parent_logger->GetLogLevel()),
+    force_console(parent_logger->force_console || output_to_console),
+    stream_id(NextStreamId()),
+    info(this),
+    warning(this),
+    error(this),
+    critical(this),
+    debug(this),
+    console(this)
+{
+    if (!component_name.empty())
+    {
+        component_prefix += "[" + component_name + "] ";
+        if (!component_path.empty()) component_path += '.';
+        component_path += component_name;
+    }
+}
+
+/*
+ *  LoggerHandle::LoggerHandle
+ *
+ *  Description:
+ *      Constructor for a LoggerHandle nested within another LoggerHandle.
+ *
+ *  Parameters:
+ *      component_name [in]
+ *          The name of the component to print in log messages.
+ *
+ *      parent_handle [in]
+ *          The handle whose component prefix precedes this handle's and
+ *          whose Logger receives messages.
+ *
+ *      output_to_console [in]
+ *          Should log messages also be output to the console?
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The handle initially has the log level of the parent handle, but
+ *      does not follow later changes to it.
+ */
+LoggerHandle::LoggerHandle(const std::string &component_name,
+                           const LoggerHandle &parent_handle,
+                           bool output_to_console) :
+    parent_logger(parent_handle.parent_logger),
+    component_prefix(parent_handle.component_prefix),
+    component_path(parent_handle.component_path),
+    log_level(parent_handle.GetLogLevel()),
+    force_console(parent_handle.force_console || output_to_console),
+    stream_id(NextStreamId()),
+    info(this),
+    warning(this),
+    error(this),
+    critical(this),
+    debug(this),
+    console(this)
+{
+    if (!component_name.empty())
+    {
+        component_prefix += "[" + component_name + "] ";
+        if (!component_path.empty()) component_path += '.';
+        component_path += component_name;
+    }
+}
+
+/*
+ *  LoggerHandle::Log
+ *
+ *  Description:
+ *      This function will log messages.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for the message.
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *      console [in]
+ *          Log to the console in addition to the default LogFacility.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LoggerHandle::Log(LogLevel level,
+                       const std::string &message,
+                       bool console)
+{
+    bool written = IsLevelEnabled(level);
+    if (!written)
+    {
+        Logger *root_logger = parent_logger->root_logger;
+        root_logger->stats->CountFiltered(level);
+        if (!root_logger->flight_recording) return;
+    }
+
+    parent_logger->Dispatch(level,
+                            component_prefix,
+                            message,
+                            console || force_console,
+                            written);
+}
+
+/*
+ *  LoggerHandle::Log
+ *
+ *  Description:
+ *      This function will log messages using the LogLevel::INFO.
+ *
+ *  Parameters:
+ *      message [in]
+ *          The message to be logged.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LoggerHandle::Log(const std::string &message)
+{
+    Log(LogLevel::Info, message);
+}
+
+/*
+ *  LoggerHandle::Log
+ *
+ *  Description:
+ *      This function will log messages from the call site described by the
+ *      given LogSite, which is defined by the logging macros.
+ *
+ *  Parameters:
+ *      site [in]
+ *          The call site, which gives the logging level for the message.
+ *          It must remain valid until the message is written (e.g., it has
+ *          static storage duration).
+ *
+ *      message [in]
+ *          The message to be logged.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LoggerHandle::Log(const LogSite &site, const std::string &message)
+{
+    bool written = IsLevelEnabled(site.level);
+    if (!written)
+    {
+        Logger *root_logger = parent_logger->root_logger;
+        root_logger->stats->CountFiltered(site.level);
+        if (!root_logger->flight_recording) return;
+    }
+
+    parent_logger->Dispatch(site.level,
+                            component_prefix,
+                            message,
+                            force_console,
+                            written,
+                            0,
+                            &site);
+}
+
+/*
+ *  LoggerHandle::SetLogLevel
+ *
+ *  Description:
+ *      Set the most verbose level of messages logged by this handle.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The log level to set.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Messages must also pass the log levels of the parent Loggers.
+ */
+void LoggerHandle::SetLogLevel(LogLevel level)
+{
+    log_level = level;
+    parent_logger->root_logger->level_registry.AdvanceEpoch();
+}
+
+/*
+ *  LoggerHandle::GetLogLevel
+ *
+ *  Description:
+ *      Get the most verbose level of messages logged by this handle.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The log level.
+ *
+ *  Comments:
+ *      None.
+ */
+LogLevel LoggerHandle::GetLogLevel() const
+{
+    return log_level;
+}
+
+/*
+ *  LoggerHandle::IsDebugging
+ *
+ *  Description:
+ *      Determine whether debug messages are logged by this handle.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the log levels of the handle and its parent Loggers are all
+ *      LogLevel::Debug.
+ *
+ *  Comments:
+ *      A level given to the handle's component by
+ *      Logger::SetComponentLevels() takes precedence over the log levels.
+ */
+bool LoggerHandle::IsDebugging() const
+{
+    return GetEffectiveLevel() >= static_cast<int>(LogLevel::Debug);
+}
+
+/*
+ *  LoggerHandle::GetLoggingStream
+ *
+ *  Description:
+ *      Get the stream through which messages at the given level are logged.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for messages written to the stream.
+ *
+ *  Returns:
+ *      A reference to the stream, which is valid until std::flush is
+ *      written to it.
+ *
+ *  Comments:
+ *      None.
+ */
+std::ostream &LoggerHandle::GetLoggingStream(LogLevel level)
+{
+    return GetLoggingStream(level, false);
+}
+
+/*
+ *  LoggerHandle::GetLoggingStream
+ *
+ *  Description:
+ *      Get the calling thread's stream holding the message being streamed
+ *      to this handle at the given level, taking a stream from the thread's
+ *      pool if no such message is being constructed.
+ *
+ *  Parameters:
+ *      level [in]
+ *          The logging level for messages written to the stream.
+ *
+ *      console [in]
+ *          Log to the console in addition to the default LogFacility.
+ *
+ *  Returns:
+ *      A reference to the stream, which is valid until std::flush is
+ *      written to it.
+ *
+ *  Comments:
+ *      A stream taken from the pool has its formatting state restored to
+ *      the defaults, so manipulators used with one message do not affect
+ *      the next.
+ */
+std::ostream &LoggerHandle::GetLoggingStream(LogLevel level, bool console)
+{
+    auto &streams = GetThreadStreams();
+    std::uint64_t key = (stream_id << 4) |
+                        (static_cast<std::uint64_t>(level) << 1) |
+                        (console ? 1 : 0);
+
+    for (auto &stream : streams.active)
+    {
+        if (stream->buffer.key == key) return stream->stream;
+    }
+
+    if (streams.spare.empty())
+    {
+        streams.active.push_back(std::make_unique<HandleStream>());
+    }
+    else
+    {
+        streams.active.push_back(std::move(streams.spare.back()));
+        streams.spare.pop_back();
+    }
+
+    HandleStreamBuf &buffer = streams.active.back()->buffer;
+    buffer.handle = this;
+    buffer.level = level;
+    buffer.console = console;
+    buffer.key = key;
+
+    // Restore the default formatting state left by a previous message
+    std::ostream &stream = streams.active.back()->stream;
+    stream.clear();
+    stream.flags(std::ios_base::skipws | std::ios_base::dec);
+    stream.precision(6);
+    stream.width(0);
+    stream.fill(' ');
+
+    return stream;
+}
+
+/*
+ *  LoggerHandle::Flush
+ *
+ *  Description:
+ *      Wait until all queued log messages have been written.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LoggerHandle::Flush()
+{
+    parent_logger->Flush();
+}
+
+} // namespace cantina
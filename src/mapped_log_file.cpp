@@ -0,0 +1,487 @@
+/*
+ *  mapped_log_file.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the MappedLogFile class, which writes log
+ *      output into memory-mapped file segments.
+ *
+ *  Portability Issues:
+ *      Memory-mapped segments are supported only on POSIX systems.  On other
+ *      platforms, Open() will fail.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "cantina/mapped_log_file.h"
+
+namespace cantina
+{
+
+/*
+ *  MappedLogFile::MappedLogFile
+ *
+ *  Description:
+ *      Constructor for the MappedLogFile object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+MappedLogFile::MappedLogFile() :
+    segment_size(Default_Segment_Size),
+    next_sequence(0),
+    current(nullptr)
+{
+}
+
+/*
+ *  MappedLogFile::~MappedLogFile
+ *
+ *  Description:
+ *      Destructor for the MappedLogFile object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+MappedLogFile::~MappedLogFile()
+{
+    Close();
+    segments.clear();
+}
+
+/*
+ *  MappedLogFile::Open
+ *
+ *  Description:
+ *      Open the first segment of a memory-mapped log file.
+ *
+ *  Parameters:
+ *      base_name [in]
+ *          The name to which segment sequence numbers are appended.
+ *
+ *      segment_size [in]
+ *          The size of each segment.
+ *
+ *  Returns:
+ *      True if the first segment was opened, false otherwise.
+ *
+ *  Comments:
+ *      Existing segments are not overwritten; the first segment opened
+ *      is the first sequence number for which no segment exists.
+ */
+bool MappedLogFile::Open(const std::string &base_name,
+                         std::size_t segment_size)
+{
+    Close();
+
+#ifdef _WIN32
+    return false;
+#else
+    std::lock_guard<std::mutex> lock(segment_mutex);
+
+    this->base_name = base_name;
+    this->segment_size = std::max<std::size_t>(segment_size, 4096);
+
+    // Continue after any existing segments
+    next_sequence = 0;
+    while (access(SegmentName(base_name, next_sequence).c_str(), F_OK) == 0)
+    {
+        next_sequence++;
+    }
+
+    current = NewSegment();
+
+    return current != nullptr;
+#endif
+}
+
+/*
+ *  MappedLogFile::IsOpen
+ *
+ *  Description:
+ *      Indicates whether the file is open.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the file is open, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool MappedLogFile::IsOpen() const
+{
+    return current.load() != nullptr;
+}
+
+/*
+ *  MappedLogFile::Close
+ *
+ *  Description:
+ *      Close the file, truncating the current segment to its used length.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This waits for any thread still writing to a segment to finish.
+ *      The bookkeeping for each segment is retained until destruction,
+ *      since a thread that read the current segment just before it was
+ *      retired may still briefly refer to it.
+ */
+void MappedLogFile::Close()
+{
+    std::lock_guard<std::mutex> lock(segment_mutex);
+
+    Segment *segment = current.exchange(nullptr);
+    if (segment != nullptr) RetireSegment(segment);
+
+    // Wait for writers to finish with every segment
+    for (auto &retired : segments)
+    {
+        while (!retired->finalized) std::this_thread::yield();
+    }
+}
+
+/*
+ *  MappedLogFile::Write
+ *
+ *  Description:
+ *      Write a record made of the given parts into the current segment,
+ *      rolling to a new segment if the record does not fit.
+ *
+ *  Parameters:
+ *      parts [in]
+ *          The parts of the record to be written contiguously.
+ *
+ *      count [in]
+ *          The number of parts.
+ *
+ *      position [out]
+ *          If not nullptr, the segment and offset at which the record was
+ *          written.
+ *
+ *  Returns:
+ *      True if the record was written, false if the file is not open or
+ *      the record is larger than a segment.
+ *
+ *  Comments:
+ *      This function may be called from multiple threads concurrently.
+ *      Only rolling to a new segment takes a mutex.
+ */
+bool MappedLogFile::Write(const std::string_view *parts,
+                          std::size_t count,
+                          MappedLogPosition *position)
+{
+    std::size_t length = 0;
+
+    for (std::size_t i = 0; i < count; i++) length += parts[i].size();
+
+    if ((length == 0) || (length > segment_size)) return false;
+
+    while (true)
+    {
+        Segment *segment = current.load(std::memory_order_acquire);
+        if (segment == nullptr) return false;
+
+        // Register as a writer, backing off if the segment was retired
+        segment->writers.fetch_add(1);
+        if (segment->retired.load())
+        {
+            ReleaseSegment(segment);
+            continue;
+        }
+
+        std::size_t offset = segment->reserved.fetch_add(length);
+
+        if (offset + length <= segment->size)
+        {
+            char *p = segment->base + offset;
+            for (std::size_t i = 0; i < count; i++)
+            {
+                std::memcpy(p, parts[i].data(), parts[i].size());
+                p += parts[i].size();
+            }
+
+            if (position != nullptr) *position = {segment->sequence, offset};
+
+            ReleaseSegment(segment);
+            return true;
+        }
+
+        // The record crossing the end marks where the data ends
+        if (offset <= segment->size) segment->used = offset;
+
+        ReleaseSegment(segment);
+
+        // Roll to a new segment unless another thread already did
+        std::lock_guard<std::mutex> lock(segment_mutex);
+        if (current.load() == segment)
+        {
+            current = NewSegment();
+            RetireSegment(segment);
+        }
+    }
+}
+
+/*
+ *  MappedLogFile::WriteLine
+ *
+ *  Description:
+ *      Write a line of log output, appending a newline.
+ *
+ *  Parameters:
+ *      line [in]
+ *          The line to write.
+ *
+ *  Returns:
+ *      True if the line was written, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool MappedLogFile::WriteLine(std::string_view line)
+{
+    const std::string_view parts[2] = {line, "\n"};
+
+    return Write(parts, 2);
+}
+
+/*
+ *  MappedLogFile::SegmentName
+ *
+ *  Description:
+ *      Return the name of the segment with the given sequence number.
+ *
+ *  Parameters:
+ *      base_name [in]
+ *          The name to which segment sequence numbers are appended.
+ *
+ *      sequence [in]
+ *          The segment sequence number.
+ *
+ *  Returns:
+ *      The segment's file name.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string MappedLogFile::SegmentName(const std::string &base_name,
+                                       std::size_t sequence)
+{
+    std::string number = std::to_string(sequence);
+
+    if (number.length() < 6) number.insert(0, 6 - number.length(), '0');
+
+    return base_name + "." + number;
+}
+
+/*
+ *  MappedLogFile::NewSegment
+ *
+ *  Description:
+ *      Create, size, and map the next segment.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A pointer to the new segment or nullptr on failure.
+ *
+ *  Comments:
+ *      The segment_mutex must be held by the caller.
+ */
+MappedLogFile::Segment *MappedLogFile::NewSegment()
+{
+#ifdef _WIN32
+    return nullptr;
+#else
+    auto segment = std::make_unique<Segment>();
+    segment->sequence = next_sequence;
+    std::string filename = SegmentName(base_name, next_sequence++);
+
+    segment->fd = open(filename.c_str(),
+                       O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                       0644);
+    if (segment->fd < 0) return nullptr;
+
+    // Allocate the segment's blocks so that writes to the mapping do not
+    // fail for lack of space, falling back to a sparse file
+    bool allocated = false;
+#ifdef __linux__
+    allocated = posix_fallocate(segment->fd,
+                                0,
+                                static_cast<off_t>(segment_size)) == 0;
+#endif
+    if (!allocated &&
+        (ftruncate(segment->fd, static_cast<off_t>(segment_size)) != 0))
+    {
+        close(segment->fd);
+        unlink(filename.c_str());
+        return nullptr;
+    }
+
+    void *base = mmap(nullptr,
+                      segment_size,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED,
+                      segment->fd,
+                      0);
+    if (base == MAP_FAILED)
+    {
+        close(segment->fd);
+        unlink(filename.c_str());
+        return nullptr;
+    }
+
+    segment->base = static_cast<char *>(base);
+    segment->size = segment_size;
+    segment->used = segment_size;
+
+    segments.push_back(std::move(segment));
+
+    return segments.back().get();
+#endif
+}
+
+/*
+ *  MappedLogFile::RetireSegment
+ *
+ *  Description:
+ *      Mark a segment as no longer current, finalizing it if no thread
+ *      is writing to it.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The segment to retire.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If threads are still writing, the last to finish will finalize
+ *      the segment.
+ */
+void MappedLogFile::RetireSegment(Segment *segment)
+{
+    segment->retired = true;
+
+    if (segment->writers == 0) FinalizeSegment(segment);
+}
+
+/*
+ *  MappedLogFile::ReleaseSegment
+ *
+ *  Description:
+ *      Called when a thread has finished writing to a segment.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The segment the thread was writing.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void MappedLogFile::ReleaseSegment(Segment *segment)
+{
+    if ((segment->writers.fetch_sub(1) == 1) && segment->retired)
+    {
+        FinalizeSegment(segment);
+    }
+}
+
+/*
+ *  MappedLogFile::FinalizeSegment
+ *
+ *  Description:
+ *      Unmap a retired segment and truncate it to its used length.
+ *
+ *  Parameters:
+ *      segment [in]
+ *          The segment to finalize.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Only the first call for a given segment has any effect.
+ */
+void MappedLogFile::FinalizeSegment([[maybe_unused]] Segment *segment)
+{
+#ifndef _WIN32
+    if (segment->finalizing.exchange(true)) return;
+
+    std::size_t length = std::min(segment->used.load(),
+                                  segment->reserved.load());
+
+    munmap(segment->base, segment->size);
+    [[maybe_unused]] int result =
+        ftruncate(segment->fd, static_cast<off_t>(length));
+    close(segment->fd);
+
+    segment->finalized = true;
+#endif
+}
+
+} // namespace cantina
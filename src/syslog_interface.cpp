@@ -147,4 +147,24 @@ void SyslogInterface::syslog([[maybe_unused]] int priority,
 #endif
 }
 
+/*
+ *  flushlog()
+ *
+ *  Description:
+ *      Send any messages that an implementation has buffered.  The system's
+ *      syslog() does not buffer messages, so this does nothing.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void SyslogInterface::flushlog(void)
+{
+}
+
 } // namespace cantina
@@ -0,0 +1,721 @@
+/*
+ *  syslog_sender.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This module implements the SyslogSender class, which sends batches
+ *      of RFC 5424 syslog messages over a Unix datagram, UDP, or TCP
+ *      socket.
+ *
+ *  Portability Issues:
+ *      Only POSIX systems are supported.  Where sendmmsg() is unavailable,
+ *      each message in a batch is sent with its own sendmsg() call.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#ifdef LOGGER_SYSLOG_ENABLED
+#include <syslog.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "cantina/syslog_sender.h"
+
+namespace cantina
+{
+
+/*
+ *  SyslogSender::SyslogSender
+ *
+ *  Description:
+ *      Constructor for the SyslogSender object.
+ *
+ *  Parameters:
+ *      transport [in]
+ *          The transport used to send messages.
+ *
+ *      address [in]
+ *          The path of the Unix datagram socket or the host name or address
+ *          of the collector when using UDP or TCP.
+ *
+ *      port [in]
+ *          The port of the collector when using UDP or TCP.
+ *
+ *      batch_size [in]
+ *          The number of messages collected before they are sent.
+ *
+ *      max_batch_age [in]
+ *          The longest time the first message of a batch waits before the
+ *          batch is sent when another message is logged.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      No connection is made until openlog() is called.
+ */
+SyslogSender::SyslogSender(SyslogTransport transport,
+                           const std::string &address,
+                           std::uint16_t port,
+                           std::size_t batch_size,
+                           std::chrono::milliseconds max_batch_age) :
+    transport(transport),
+    address(address),
+    port(port),
+    batch_size(batch_size > 0 ? batch_size : 1),
+    max_batch_age(max_batch_age),
+    facility(0),
+    socket_fd(-1),
+    batch(this->batch_size),
+    batched(0),
+    timestamp_second(-1)
+{
+    // Allocate message storage once
+    for (auto &message : batch) message.reserve(Max_Message_Length);
+}
+
+/*
+ *  SyslogSender::~SyslogSender
+ *
+ *  Description:
+ *      Destructor for the SyslogSender object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Any batched messages are sent before the connection is closed.
+ */
+SyslogSender::~SyslogSender()
+{
+    SyslogSender::closelog();
+}
+
+/*
+ *  SyslogSender::openlog
+ *
+ *  Description:
+ *      Format the fixed fields of the RFC 5424 header and connect to the
+ *      collector.
+ *
+ *  Parameters:
+ *      ident [in]
+ *          The application name given with every message.
+ *
+ *      option [in]
+ *          If LOG_PID is given, the process ID is given with every message.
+ *          Other options are ignored.
+ *
+ *      facility [in]
+ *          Facility used for messages that do not specify one.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If the connection cannot be made now, another attempt is made when
+ *      messages are next sent.
+ */
+void SyslogSender::openlog([[maybe_unused]] const char *ident,
+                           [[maybe_unused]] int option,
+                           [[maybe_unused]] int facility)
+{
+#ifdef LOGGER_SYSLOG_ENABLED
+    std::lock_guard<std::mutex> lock(sender_mutex);
+
+    // Send anything batched for a previous connection
+    SendBatch();
+    Disconnect();
+
+    this->facility = (facility != 0) ? facility : LOG_USER;
+
+    // Format HOSTNAME APP-NAME PROCID MSGID STRUCTURED-DATA
+    char host_name[256] = {};
+    if ((gethostname(host_name, sizeof(host_name) - 1) != 0) || !*host_name)
+    {
+        std::strcpy(host_name, "-");
+    }
+
+    header = " ";
+    header += host_name;
+    header += ' ';
+    header += ((ident != nullptr) && *ident) ? std::string(ident, 0, 48)
+                                             : std::string("-");
+    header += ' ';
+    header += (option & LOG_PID) ? std::to_string(getpid()) : "-";
+    header += " - - ";
+
+    Connect();
+#endif
+}
+
+/*
+ *  SyslogSender::closelog
+ *
+ *  Description:
+ *      Send any batched messages and close the connection.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void SyslogSender::closelog(void)
+{
+    std::lock_guard<std::mutex> lock(sender_mutex);
+
+    // Nothing is sent once closed
+    if (header.empty()) return;
+
+    SendBatch();
+    Disconnect();
+    header.clear();
+}
+
+/*
+ *  SyslogSender::syslog
+ *
+ *  Description:
+ *      Format a message and add it to the batch, sending the batch if it
+ *      is full, the message is an Error or more severe, or the batch was
+ *      started at least max_batch_age ago.
+ *
+ *  Parameters:
+ *      priority [in]
+ *          The priority associated with this message, which may include
+ *          the facility.
+ *
+ *      format [in]
+ *          A format specifier like what is used with printf().
+ *
+ *      ... [in]
+ *          Variadic arguments used with the format specifier.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Messages longer than Max_Message_Length are truncated.  Messages
+ *      given before openlog() are discarded.  The age of the batch is
+ *      checked only here, so when no further message is logged, a partial
+ *      batch is held until flushlog() is called.
+ */
+void SyslogSender::syslog([[maybe_unused]] int priority,
+                          [[maybe_unused]] const char *format,
+                          ...)
+{
+#ifdef LOGGER_SYSLOG_ENABLED
+    std::lock_guard<std::mutex> lock(sender_mutex);
+
+    if (header.empty()) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (batched == 0) batch_start = now;
+
+    std::string &message = batch[batched];
+
+    // Add the facility if the priority does not include one
+    if ((priority & LOG_FACMASK) == 0) priority |= facility;
+
+    message = "<";
+    message += std::to_string(priority);
+    message += ">1 ";
+    AppendTimestamp(message);
+    message += header;
+
+    // Format the message text directly into the message storage
+    std::size_t offset = message.size();
+    std::size_t space =
+        (offset < Max_Message_Length) ? Max_Message_Length - offset : 0;
+    message.resize(offset + space);
+
+    std::va_list arguments;
+    va_start(arguments, format);
+    int length = std::vsnprintf(message.data() + offset,
+                                space + 1,
+                                format,
+                                arguments);
+    va_end(arguments);
+
+    if (length < 0) length = 0;
+    message.resize(offset + std::min(static_cast<std::size_t>(length), space));
+
+    batched++;
+
+    // Send if the batch is full or its messages should not wait
+    if ((batched == batch.size()) || (LOG_PRI(priority) <= LOG_ERR) ||
+        (now - batch_start >= max_batch_age))
+    {
+        SendBatch();
+    }
+#endif
+}
+
+/*
+ *  SyslogSender::flushlog
+ *
+ *  Description:
+ *      Send any batched messages.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void SyslogSender::flushlog(void)
+{
+    std::lock_guard<std::mutex> lock(sender_mutex);
+
+    SendBatch();
+}
+
+/*
+ *  SyslogSender::IsOpen
+ *
+ *  Description:
+ *      Indicates whether the sender is connected to the collector.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if connected, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool SyslogSender::IsOpen() const
+{
+    std::lock_guard<std::mutex> lock(sender_mutex);
+
+    return socket_fd >= 0;
+}
+
+/*
+ *  SyslogSender::Connect
+ *
+ *  Description:
+ *      Create a socket and connect it to the collector.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if connected, false otherwise.
+ *
+ *  Comments:
+ *      The sender mutex must be held by the caller.
+ */
+bool SyslogSender::Connect()
+{
+#ifndef LOGGER_SYSLOG_ENABLED
+    return false;
+#else
+    if (socket_fd >= 0) return true;
+
+    if (transport == SyslogTransport::UnixDatagram)
+    {
+        sockaddr_un socket_address{};
+        if (address.size() >= sizeof(socket_address.sun_path)) return false;
+        socket_address.sun_family = AF_UNIX;
+        std::memcpy(socket_address.sun_path, address.data(), address.size());
+
+        socket_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (socket_fd < 0) return false;
+
+        if (connect(socket_fd,
+                    reinterpret_cast<sockaddr *>(&socket_address),
+                    sizeof(socket_address)) != 0)
+        {
+            Disconnect();
+            return false;
+        }
+    }
+    else
+    {
+        addrinfo hints{};
+        addrinfo *addresses = nullptr;
+
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = (transport == SyslogTransport::TCP) ? SOCK_STREAM
+                                                                : SOCK_DGRAM;
+
+        if (getaddrinfo(address.c_str(),
+                        std::to_string(port).c_str(),
+                        &hints,
+                        &addresses) != 0)
+        {
+            return false;
+        }
+
+        // Use the first address to which a connection can be made
+        for (addrinfo *ai = addresses; ai != nullptr; ai = ai->ai_next)
+        {
+            socket_fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (socket_fd < 0) continue;
+            if (connect(socket_fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+            Disconnect();
+        }
+
+        freeaddrinfo(addresses);
+
+        if (socket_fd < 0) return false;
+    }
+
+    fcntl(socket_fd, F_SETFD, FD_CLOEXEC);
+
+#ifdef SO_NOSIGPIPE
+    // Avoid SIGPIPE if a TCP collector closes the connection
+    int enable = 1;
+    setsockopt(socket_fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+
+    return true;
+#endif
+}
+
+/*
+ *  SyslogSender::Disconnect
+ *
+ *  Description:
+ *      Close the socket.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The sender mutex must be held by the caller.
+ */
+void SyslogSender::Disconnect()
+{
+#ifdef LOGGER_SYSLOG_ENABLED
+    if (socket_fd >= 0) close(socket_fd);
+#endif
+
+    socket_fd = -1;
+}
+
+/*
+ *  SyslogSender::AppendTimestamp
+ *
+ *  Description:
+ *      Append the current time to the message as an RFC 5424 timestamp in
+ *      UTC with microsecond precision.
+ *
+ *  Parameters:
+ *      message [in/out]
+ *          The message to which the timestamp is appended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The date and time of day are formatted only when the second
+ *      changes.  The sender mutex must be held by the caller.
+ */
+void SyslogSender::AppendTimestamp(std::string &message)
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(now);
+    auto microseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - seconds);
+
+    if (seconds.count() != timestamp_second)
+    {
+        char buffer[32];
+        std::time_t time = static_cast<std::time_t>(seconds.count());
+        std::tm tm_time{};
+
+        gmtime_r(&time, &tm_time);
+        timestamp.assign(buffer,
+                         std::strftime(buffer,
+                                       sizeof(buffer),
+                                       "%Y-%m-%dT%H:%M:%S",
+                                       &tm_time));
+        timestamp_second = time;
+    }
+
+    char fraction[16];
+    int length = std::snprintf(fraction,
+                               sizeof(fraction),
+                               ".%06dZ",
+                               static_cast<int>(microseconds.count()));
+
+    message += timestamp;
+    message.append(fraction, static_cast<std::size_t>(length));
+}
+
+/*
+ *  SyslogSender::SendBatch
+ *
+ *  Description:
+ *      Send the batched messages, reconnecting once if the connection was
+ *      lost.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Messages not sent after reconnecting are discarded, as with
+ *      syslog().  The sender mutex must be held by the caller.
+ */
+void SyslogSender::SendBatch()
+{
+    if (batched == 0) return;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        if (!Connect()) break;
+
+        bool sent = (transport == SyslogTransport::TCP) ? SendStream()
+                                                        : SendDatagrams();
+        if (sent) break;
+
+        // Reconnect in case the collector was restarted
+        Disconnect();
+    }
+
+    batched = 0;
+}
+
+/*
+ *  SyslogSender::SendDatagrams
+ *
+ *  Description:
+ *      Send each batched message as a datagram.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if all messages were sent, false if the connection failed.
+ *
+ *  Comments:
+ *      Messages sent before a failure are removed from the batch so that
+ *      they are not sent again.
+ */
+bool SyslogSender::SendDatagrams()
+{
+#ifndef LOGGER_SYSLOG_ENABLED
+    return false;
+#else
+    std::size_t sent = 0;
+
+#ifdef __linux__
+    mmsghdr headers[Default_Batch_Size];
+    iovec vectors[Default_Batch_Size];
+
+    while (sent < batched)
+    {
+        unsigned count = static_cast<unsigned>(
+            std::min(batched - sent, Default_Batch_Size));
+
+        for (unsigned i = 0; i < count; i++)
+        {
+            std::string &message = batch[sent + i];
+            vectors[i].iov_base = message.data();
+            vectors[i].iov_len = message.size();
+            headers[i] = mmsghdr{};
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(socket_fd, headers, count, 0);
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        sent += static_cast<std::size_t>(result);
+    }
+#else
+    while (sent < batched)
+    {
+        std::string &message = batch[sent];
+        if (send(socket_fd, message.data(), message.size(), 0) < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        sent++;
+    }
+#endif
+
+    // Retain only those messages that were not sent
+    if (sent > 0)
+    {
+        for (std::size_t i = sent; i < batched; i++)
+        {
+            std::swap(batch[i - sent], batch[i]);
+        }
+        batched -= sent;
+    }
+
+    return batched == 0;
+#endif
+}
+
+/*
+ *  SyslogSender::SendStream
+ *
+ *  Description:
+ *      Send the batched messages over a TCP connection using octet-counting
+ *      framing, gathering each group of messages into a single write.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if all messages were sent, false if the connection failed.
+ *
+ *  Comments:
+ *      The length prefixes are formed apart from the messages, so messages
+ *      not sent are framed anew if sent again.  Messages sent in full
+ *      before a failure are removed from the batch so that they are not
+ *      sent again.  One sent only in part is sent again in full.
+ */
+bool SyslogSender::SendStream()
+{
+#ifndef LOGGER_SYSLOG_ENABLED
+    return false;
+#else
+    iovec vectors[Default_Batch_Size * 2];
+    char prefixes[Default_Batch_Size][24];
+    std::size_t sent = 0;
+    bool failed = false;
+
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags = MSG_NOSIGNAL;
+#endif
+
+    while ((sent < batched) && !failed)
+    {
+        std::size_t count = std::min(batched - sent, Default_Batch_Size);
+
+        // Precede each message with its length, as the framing requires
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::string &message = batch[sent + i];
+            int length = std::snprintf(prefixes[i],
+                                       sizeof(prefixes[i]),
+                                       "%zu ",
+                                       message.size());
+            vectors[i * 2].iov_base = prefixes[i];
+            vectors[i * 2].iov_len = static_cast<std::size_t>(length);
+            vectors[i * 2 + 1].iov_base = message.data();
+            vectors[i * 2 + 1].iov_len = message.size();
+        }
+
+        std::size_t first = 0;
+        std::size_t total = count * 2;
+
+        while (first < total)
+        {
+            msghdr header{};
+            header.msg_iov = &vectors[first];
+            header.msg_iovlen = total - first;
+
+            ssize_t result = sendmsg(socket_fd, &header, flags);
+            if (result < 0)
+            {
+                if (errno == EINTR) continue;
+                failed = true;
+                break;
+            }
+
+            // Advance past what was written
+            std::size_t written = static_cast<std::size_t>(result);
+            while ((first < total) && (written >= vectors[first].iov_len))
+            {
+                written -= vectors[first++].iov_len;
+            }
+            if (written > 0)
+            {
+                vectors[first].iov_base =
+                    static_cast<char *>(vectors[first].iov_base) + written;
+                vectors[first].iov_len -= written;
+            }
+        }
+
+        // Count the messages whose prefix and text were both written
+        sent += first / 2;
+    }
+
+    // Retain only those messages that were not sent
+    if (sent > 0)
+    {
+        for (std::size_t i = sent; i < batched; i++)
+        {
+            std::swap(batch[i - sent], batch[i]);
+        }
+        batched -= sent;
+    }
+
+    return batched == 0;
+#endif
+}
+
+} // namespace cantina
@@ -44,17 +44,66 @@
 //  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
 //  SPDX-License-Identifier: BSD-2-Clause
 
+#include <algorithm>
 #include <atomic>
 #include <iostream>
+#include <iomanip>
+#include <iterator>
 #include <cstdio>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <regex>
+#include <map>
+#include <cstring>
+#include <csignal>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+#ifdef LOGGER_ZLIB_ENABLED
+#include <zlib.h>
+#endif
 
 // Ensure that all logging levels are being logged here
 #undef LOGGER_LEVEL
 #define LOGGER_LEVEL LOGGER_LEVEL_DEBUG
 
 #include "cantina/logger.h"
+#include "cantina/logger_handle.h"
+#include "cantina/basic_logger.h"
+#include "cantina/binary_log_reader.h"
 #include "gtest/gtest.h"
 
+// Count heap allocations made by any thread while counting is enabled
+static std::atomic<bool> count_allocations = false;
+static std::atomic<std::size_t> allocation_count = 0;
+
+void *operator new(std::size_t size)
+{
+    if (count_allocations) allocation_count++;
+
+    if (void *memory = std::malloc(size ? size : 1)) return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
 namespace
 {
     using namespace cantina;
@@ -63,6 +112,51 @@ namespace
 
     std::atomic<unsigned> test_counter = 0;     // Unique logs files per test
 
+#ifdef LOGGER_ZLIB_ENABLED
+    // Decompress each gzip member of the given file
+    bool ReadGzipFile(const std::string &filename,
+                      std::string &text,
+                      unsigned &members)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+        char output[4096];
+        z_stream stream{};
+        int result = Z_OK;
+
+        text.clear();
+        members = 0;
+
+        if (inflateInit2(&stream, MAX_WBITS + 16) != Z_OK) return false;
+
+        stream.next_in = reinterpret_cast<Bytef *>(data.data());
+        stream.avail_in = static_cast<uInt>(data.size());
+        while ((stream.avail_in > 0) && (result != Z_DATA_ERROR))
+        {
+            stream.next_out = reinterpret_cast<Bytef *>(output);
+            stream.avail_out = sizeof(output);
+            result = inflate(&stream, Z_NO_FLUSH);
+            text.append(output, sizeof(output) - stream.avail_out);
+
+            // Continue with the next member
+            if (result == Z_STREAM_END)
+            {
+                members++;
+                inflateReset(&stream);
+            }
+            else if (result != Z_OK)
+            {
+                break;
+            }
+        }
+        inflateEnd(&stream);
+
+        return (stream.avail_in == 0) &&
+               (data.empty() || (result == Z_STREAM_END));
+    }
+#endif
+
     // The fixture for testing class Logger
     class LoggerTest : public ::testing::Test
     {
@@ -117,6 +211,300 @@ namespace
         ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
     }
 
+#ifndef _WIN32
+    // Test that each colorized console line is written with its escape
+    // sequences and newline as one unit
+    TEST_F(LoggerTest, ColorizedConsole)
+    {
+        const char *lines[] = {"\\S+ \\[CRITICAL\\] Critical message",
+                               "\\S+ \\[ERROR\\] Error message",
+                               "\\S+ \\[WARNING\\] Warning message",
+                               "\\S+ \\[INFO\\] Info message",
+                               "\\S+ \\[DEBUG\\] Debug message"};
+        const char *texts[] = {"Critical message",
+                               "Error message",
+                               "Warning message",
+                               "Info message",
+                               "Debug message"};
+        std::string received;
+        char buffer[1024];
+        ssize_t length;
+        int fds[2];
+
+        // Capture standard error through a pipe
+        ASSERT_EQ(pipe(fds), 0);
+        int saved_stderr = dup(STDERR_FILENO);
+        ASSERT_GE(saved_stderr, 0);
+        ASSERT_EQ(dup2(fds[1], STDERR_FILENO), STDERR_FILENO);
+        close(fds[1]);
+
+        // A sink is colorized even though standard error is not a terminal
+        // (the logger is not forced to the console, so each line is
+        // written only once)
+        auto console_logger = std::make_shared<Logger>(std::string("CLTST"));
+        auto console_sink = std::make_shared<ConsoleSink>(true);
+        console_logger->SetLogFacility(LogFacility::None);
+        console_logger->SetLogLevel(LogLevel::Debug);
+        ASSERT_TRUE(console_logger->AddSink(console_sink));
+        for (unsigned i = 0; i < 5; i++)
+        {
+            console_logger->Log(static_cast<LogLevel>(i), texts[i]);
+        }
+        console_logger->RemoveSink(console_sink);
+        console_sink.reset();
+
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+        while ((length = read(fds[0], buffer, sizeof(buffer))) > 0)
+        {
+            received.append(buffer, static_cast<std::size_t>(length));
+        }
+        close(fds[0]);
+
+        // Each line is the level's prefix, the line, and the suffix
+        std::size_t position = 0;
+        for (unsigned i = 0; i < 5; i++)
+        {
+            std::string_view prefix = ConsoleSink::Color_Prefix[i];
+            std::string_view suffix = ConsoleSink::Color_Suffix;
+            ASSERT_EQ(received.compare(position, prefix.size(), prefix), 0)
+                << received.substr(position);
+            position += prefix.size();
+
+            std::size_t end = received.find(suffix, position);
+            ASSERT_NE(end, std::string::npos);
+            std::string line = received.substr(position, end - position);
+            ASSERT_TRUE(std::regex_match(line, std::regex(lines[i]))) << line;
+            position = end + suffix.size();
+        }
+        ASSERT_EQ(position, received.size());
+    }
+#endif
+
+    // Count the lines presently in the given file
+    unsigned CountLines(const std::string &filename)
+    {
+        std::ifstream log_file(filename);
+        std::string log_line;
+        unsigned line_count = 0;
+
+        while (std::getline(log_file, log_line)) line_count++;
+
+        return line_count;
+    }
+
+    // Test writing to a file using a buffered flush policy
+    TEST_F(LoggerTest, FileFlushPolicy)
+    {
+        LogFlushPolicy flush_policy;
+        flush_policy.buffer_size = 64 * 1024;
+        flush_policy.flush_on_error = true;
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename, flush_policy);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        // Messages remain buffered
+        logger->Log("Test Log 1");
+        logger->Log(LogLevel::Warning, "Test Log 2");
+        ASSERT_EQ(CountLines(log_filename), 0);
+
+        // Errors cause buffered output to be written
+        logger->Log(LogLevel::Error, "Test Log 3");
+        ASSERT_EQ(CountLines(log_filename), 3);
+
+        // Flush() writes buffered output
+        logger->Log("Test Log 4");
+        ASSERT_EQ(CountLines(log_filename), 3);
+        logger->Flush();
+        ASSERT_EQ(CountLines(log_filename), 4);
+
+        // Changing the facility writes buffered output
+        logger->Log("Test Log 5");
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(CountLines(log_filename), 5);
+    }
+
+    // Test writing to a file using a flush interval with async logging
+    TEST_F(LoggerTest, FileFlushInterval)
+    {
+        LogFlushPolicy flush_policy;
+        flush_policy.buffer_size = 64 * 1024;
+        flush_policy.interval = std::chrono::milliseconds(10);
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename, flush_policy);
+        logger->SetAsync();
+
+        logger->Log("Test Log 1");
+
+        // The writer thread should write the message within the interval
+        for (unsigned i = 0; (i < 200) && (CountLines(log_filename) == 0); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_EQ(CountLines(log_filename), 1);
+    }
+
+    // Test writing to a file through io_uring (or write() where io_uring is
+    // not available) with a sync interval
+    TEST_F(LoggerTest, AsyncIOFile)
+    {
+        constexpr unsigned Message_Count = 2000;
+        LogFlushPolicy flush_policy;
+        flush_policy.buffer_size = 4096;
+        flush_policy.async_io = true;
+        flush_policy.sync_interval = std::chrono::milliseconds(1);
+
+        logger->SetLogFacility(LogFacility::File, log_filename, flush_policy);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        // Messages fill and submit several buffers, interleaved with a
+        // message larger than a buffer
+        for (unsigned i = 0; i < Message_Count; i++)
+        {
+            logger->Log("Async message " + std::to_string(i));
+            if (i == Message_Count / 2) logger->Log(std::string(10000, 'y'));
+        }
+
+        // Errors are written before Log() returns
+        logger->Log(LogLevel::Error, "Async error");
+        ASSERT_EQ(CountLines(log_filename), Message_Count + 2);
+
+        // Buffered output is written when the file is closed
+        logger->Log("Last message");
+        logger->SetLogFacility(LogFacility::None);
+
+        std::ifstream log_file(log_filename);
+        std::string log_line;
+        std::string last_line;
+        unsigned line_count = 0;
+        unsigned next = 0;
+        while (std::getline(log_file, log_line))
+        {
+            line_count++;
+            last_line = log_line;
+            if (log_line.find(std::string(10000, 'y')) != std::string::npos)
+            {
+                ASSERT_EQ(next, Message_Count / 2 + 1);
+                continue;
+            }
+            if (next < Message_Count)
+            {
+                ASSERT_NE(log_line.find("[INFO] Async message " +
+                                        std::to_string(next++)),
+                          std::string::npos);
+            }
+        }
+        ASSERT_EQ(next, Message_Count);
+        ASSERT_EQ(line_count, Message_Count + 3);
+        ASSERT_NE(last_line.find("[INFO] Last message"), std::string::npos);
+
+#ifndef _WIN32
+        // Output written through the ring to a pipe arrives in order
+        if (LogUring::IsAvailable())
+        {
+            int fds[2];
+            ASSERT_EQ(pipe(fds), 0);
+
+            LogUring uring;
+            ASSERT_TRUE(uring.Start(fds[1], 16, 2));
+            ASSERT_TRUE(uring.IsRunning());
+            std::string expected;
+            for (unsigned i = 0; i < 100; i++)
+            {
+                expected += std::to_string(i) + ",";
+                uring.Write(expected.data() + expected.size() -
+                                std::to_string(i).size() - 1,
+                            std::to_string(i).size() + 1);
+            }
+            uring.Write(std::string(100, 'z').data(), 100);
+            expected += std::string(100, 'z');
+            uring.Stop();
+            ASSERT_FALSE(uring.IsRunning());
+            close(fds[1]);
+
+            std::string received;
+            char data[256];
+            ssize_t length;
+            while ((length = read(fds[0], data, sizeof(data))) > 0)
+            {
+                received.append(data, static_cast<std::size_t>(length));
+            }
+            close(fds[0]);
+            ASSERT_EQ(received, expected);
+        }
+#endif
+    }
+
+#ifndef _WIN32
+    // Test writing to memory-mapped file segments from multiple threads
+    TEST_F(LoggerTest, MappedFile)
+    {
+        constexpr unsigned Thread_Count = 4;
+        constexpr unsigned Messages_Per_Thread = 250;
+        constexpr std::size_t Segment_Size = 8192;
+        std::vector<std::thread> threads;
+        std::size_t segment_count = 0;
+        unsigned line_count = 0;
+
+        // Use small segments so that several are produced
+        logger->SetSegmentSize(Segment_Size);
+        logger->SetLogFacility(LogFacility::MappedFile, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::MappedFile);
+
+        for (unsigned i = 0; i < Thread_Count; i++)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    for (unsigned j = 0; j < Messages_Per_Thread; j++)
+                    {
+                        logger->Log("Mapped message " + std::to_string(j));
+                    }
+                });
+        }
+
+        for (auto &thread : threads) thread.join();
+
+        // Changing the facility truncates the last segment
+        logger->SetLogFacility(LogFacility::None);
+
+        // Every segment holds only complete lines and no unused space
+        while (true)
+        {
+            std::string segment_name =
+                MappedLogFile::SegmentName(log_filename, segment_count);
+            std::ifstream segment(segment_name, std::ios::binary);
+            if (!segment.good()) break;
+
+            std::string contents((std::istreambuf_iterator<char>(segment)),
+                                 std::istreambuf_iterator<char>());
+            segment.close();
+            std::remove(segment_name.c_str());
+
+            ASSERT_LE(contents.size(), Segment_Size);
+            ASSERT_FALSE(contents.empty());
+            ASSERT_EQ(contents.back(), '\n');
+            ASSERT_EQ(contents.find('\0'), std::string::npos);
+
+            std::istringstream lines(contents);
+            std::string log_line;
+            while (std::getline(lines, log_line))
+            {
+                ASSERT_NE(log_line.find("[INFO] Mapped message "),
+                          std::string::npos);
+                line_count++;
+            }
+
+            segment_count++;
+        }
+
+        ASSERT_GT(segment_count, 1);
+        ASSERT_EQ(line_count, Thread_Count * Messages_Per_Thread);
+    }
+#endif
+
     // Test that the SetLogLevel() function
     TEST_F(LoggerTest, SetLogLevel)
     {
@@ -280,92 +668,2363 @@ namespace
         log_file.close();
     }
 
-    // Test logging using streaming operators
-    TEST_F(LoggerTest, LogStreams)
+    // Test that macros do not evaluate messages that will not be logged
+    TEST_F(LoggerTest, MacrosShortCircuit)
     {
-        std::string log_line;
+        unsigned evaluations = 0;
+        auto count = [&]() -> unsigned { return ++evaluations; };
 
-        // Set the log facility to log to a file
-        logger->SetLogFacility(LogFacility::File, log_filename);
-        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+        // Debug messages are not logged at the default log level
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Debug));
+        ASSERT_TRUE(logger->ShouldLog(LogLevel::Info));
 
-        // Set the log level to debugging
+        LOGGER_DEBUG(logger, "Evaluation " << count());
+        ASSERT_EQ(evaluations, 0);
+
+        // Once debugging is enabled, the message is evaluated
+        logger->SetLogFacility(LogFacility::File, log_filename);
         logger->SetLogLevel(LogLevel::Debug);
+        ASSERT_TRUE(logger->ShouldLog(LogLevel::Debug));
 
-        // Have logging use milliseconds
-        logger->SetTimePrecision(LogTimePrecision::Milliseconds);
+        LOGGER_DEBUG(logger, "Evaluation " << count());
+        ASSERT_EQ(evaluations, 1);
 
-        // Verify the log level is set
-        ASSERT_TRUE(logger->IsDebugging());
+        // Macros may be used as the body of an if statement
+        if (evaluations == 0)
+            LOGGER_INFO(logger, "Evaluation " << count());
+        else
+            LOGGER_INFO(logger, "Evaluation " << count());
+        ASSERT_EQ(evaluations, 2);
 
-        // Log using streaming operator
-        logger->info << "Test Log 1" << std::flush;
-        logger->debug << "Test Log 2" << std::flush;
-        logger->warning << "Test Log 3" << std::flush;
-        logger->error << "Test Log 4" << std::flush;
-        logger->critical << "Test Log 5" << std::flush;
-        logger->console << "Test log to console" << std::flush;
+        // Without a logging facility, no message is evaluated
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Critical));
 
-        // Now turn off logging and verify it is off
+        LOGGER_CRITICAL(logger, "Evaluation " << count());
+        ASSERT_EQ(evaluations, 2);
+    }
+
+    // Test writing messages to multiple sinks with their own log levels
+    TEST_F(LoggerTest, MultipleSinks)
+    {
+        std::string log_line;
+        std::string sink_filename = log_filename + ".sink";
+        std::vector<std::string> callback_lines;
+
+        // Log all levels to the log file and warnings to another file
+        logger->SetLogLevel(LogLevel::Debug);
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        auto file_sink = logger->AddSink(LogFacility::File,
+                                         LogLevel::Warning,
+                                         sink_filename);
+        ASSERT_TRUE(file_sink);
+
+        // Deliver errors to a callback from a background thread
+        auto callback_sink = std::make_shared<CallbackSink>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                callback_lines.push_back(message);
+            },
+            LogLevel::Error);
+        callback_sink->SetAsync();
+        ASSERT_TRUE(logger->AddSink(callback_sink));
+        ASSERT_TRUE(callback_sink->IsAsync());
+
+        // A sink may be given to only one logger
+        ASSERT_FALSE(logger->AddSink(callback_sink));
+
+        logger->Debug("Debug message");
+        logger->Warning("Warning message");
+        LOGGER_ERROR(logger, "Error " << 1);
+        logger->Flush();
+        ASSERT_EQ(callback_lines.size(), 1);
+        ASSERT_EQ(callback_lines[0], "Error 1");
+
+        // The remaining sinks reject messages below their levels
         logger->SetLogFacility(LogFacility::None);
-        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Info));
+        ASSERT_TRUE(logger->ShouldLog(LogLevel::Warning));
+        file_sink->SetLogLevel(LogLevel::Error);
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Warning));
+        LOGGER_CRITICAL(logger, "Critical message");
+
+        // Removing a sink writes messages queued for it
+        logger->RemoveSink(callback_sink);
+        ASSERT_EQ(callback_lines.size(), 2);
+        logger->Error("Not delivered");
+        logger->RemoveSink(file_sink);
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Critical));
+        ASSERT_EQ(callback_lines.size(), 2);
+        file_sink.reset();
 
-        // Check that the log file exists by opening it
         std::ifstream log_file(log_filename);
         ASSERT_TRUE(log_file.good());
         std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
-        std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[DEBUG]"), std::string::npos);
-        std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[WARNING]"), std::string::npos);
-        std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[ERROR]"), std::string::npos);
+        ASSERT_NE(log_line.find("[DEBUG] Debug message"), std::string::npos);
         std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[CRITICAL]"), std::string::npos);
+        ASSERT_NE(log_line.find("[WARNING] Warning message"),
+                  std::string::npos);
         std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
-        ASSERT_NE(log_line.find("log to console"), std::string::npos);
+        ASSERT_NE(log_line.find("[ERROR] Error 1"), std::string::npos);
         std::getline(log_file, log_line);
         ASSERT_TRUE(log_file.eof());
         log_file.close();
+
+        std::ifstream sink_file(sink_filename);
+        ASSERT_TRUE(sink_file.good());
+        std::getline(sink_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING] Warning message"),
+                  std::string::npos);
+        std::getline(sink_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] Error 1"), std::string::npos);
+        std::getline(sink_file, log_line);
+        ASSERT_NE(log_line.find("[CRITICAL] Critical message"),
+                  std::string::npos);
+        std::getline(sink_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] Not delivered"), std::string::npos);
+        std::getline(sink_file, log_line);
+        ASSERT_TRUE(sink_file.eof());
+        sink_file.close();
+
+        std::remove(sink_filename.c_str());
     }
 
-    // Test child logger output
-    TEST_F(LoggerTest, ChildLogger)
+    // Test retaining messages at every level and dumping them on Critical
+    TEST_F(LoggerTest, FlightRecorder)
     {
         std::string log_line;
+        auto child = std::make_shared<Logger>("CHLD", logger);
 
-        // Create the child logger
-        auto child_logger = std::make_shared<Logger>("CHLD", logger);
-
-        // Set the log facility to log to a file
         logger->SetLogFacility(LogFacility::File, log_filename);
-        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
-
-        // Set the log level to debugging
-        logger->SetLogLevel(LogLevel::Debug);
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Debug));
+        logger->EnableFlightRecorder(4);
+        ASSERT_TRUE(child->ShouldLog(LogLevel::Debug));
 
-        // Verify the log level is set
-        ASSERT_TRUE(logger->IsDebugging());
+        // Only the most recent four messages are retained
+        for (unsigned i = 1; i <= 6; i++)
+        {
+            LOGGER_DEBUG(child, "Debug " << i);
+        }
+        logger->Info("Info {}", 1);
+        logger->Critical("Critical {}", 1);
 
-        // Log using streaming operator
-        child_logger->info << "Test Log 1" << std::flush;
+        // An explicit dump includes only messages since the last dump
+        logger->DumpFlightRecorder();
+        logger->Debug("Debug {}", 7);
+        child->DumpFlightRecorder();
 
-        // Now turn off logging and verify it is off
+        logger->EnableFlightRecorder(0);
+        ASSERT_FALSE(logger->ShouldLog(LogLevel::Debug));
         logger->SetLogFacility(LogFacility::None);
-        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
 
-        // Check that the log file exists by opening it
+        // Messages already written are not dumped again
+        const std::vector<std::string> expected =
+        {
+            "\\[INFO\\] Info 1$",
+            "\\[CRITICAL\\] Critical 1$",
+            "\\[INFO\\] Flight recorder dump begins \\(2 messages\\)$",
+            "\\[DEBUG\\] \\[CHLD\\] \\(logged [0-9T:.-]+\\) Debug 5$",
+            "\\[DEBUG\\] \\[CHLD\\] \\(logged [0-9T:.-]+\\) Debug 6$",
+            "\\[INFO\\] Flight recorder dump ends$",
+            "\\[INFO\\] Flight recorder dump begins \\(0 messages\\)$",
+            "\\[INFO\\] Flight recorder dump ends$",
+            "\\[INFO\\] Flight recorder dump begins \\(1 messages\\)$",
+            "\\[DEBUG\\] \\(logged [0-9T:.-]+\\) Debug 7$",
+            "\\[INFO\\] Flight recorder dump ends$"
+        };
+
         std::ifstream log_file(log_filename);
         ASSERT_TRUE(log_file.good());
-        std::getline(log_file, log_line);
-        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
-        ASSERT_NE(log_line.find("[CHLD]"), std::string::npos);
+        for (const auto &pattern : expected)
+        {
+            std::getline(log_file, log_line);
+            ASSERT_TRUE(std::regex_search(log_line, std::regex(pattern)))
+                << log_line << " does not match " << pattern;
+        }
         std::getline(log_file, log_line);
         ASSERT_TRUE(log_file.eof());
         log_file.close();
+
+#ifndef _WIN32
+        // The retained messages are written upon a fatal signal
+        ASSERT_DEATH(
+            {
+                logger->EnableFlightRecorder(8, true);
+                LOGGER_DEBUG(child, "Before the crash");
+                std::raise(SIGSEGV);
+            },
+            "Flight recorder dump begins\n"
+            "[0-9T:.-]+Z \\[DEBUG\\] \\[CHLD\\] Before the crash\n"
+            "Flight recorder dump ends");
+#endif
+    }
+
+    // Test that a CustomLogger receives the flight recorder's dump
+    TEST_F(LoggerTest, FlightRecorderCustomLogger)
+    {
+        std::vector<std::pair<std::string, std::string>> messages;
+        auto custom_logger = std::make_shared<CustomLogger>(
+            [&](const LogMessageParts &parts)
+            {
+                messages.emplace_back(std::string(parts.prefix),
+                                      std::string(parts.body));
+            });
+        auto child = std::make_shared<Logger>("CHLD", custom_logger);
+
+        custom_logger->EnableFlightRecorder(8);
+        LOGGER_DEBUG(child, "Debug 1");
+        LOGGER_INFO(child, "Info 1");
+        LOGGER_CRITICAL(child, "Critical 1");
+
+        ASSERT_EQ(messages.size(), 5);
+        ASSERT_EQ(messages[0].first, "[CHLD] ");
+        ASSERT_EQ(messages[0].second, "Info 1");
+        ASSERT_EQ(messages[1].first, "[CHLD] ");
+        ASSERT_EQ(messages[1].second, "Critical 1");
+        ASSERT_EQ(messages[2].second,
+                  "Flight recorder dump begins (1 messages)");
+        ASSERT_EQ(messages[3].first, "[CHLD] ");
+        ASSERT_TRUE(std::regex_match(messages[3].second,
+                                     std::regex("\\(logged [0-9T:.-]+\\) "
+                                                "Debug 1")))
+            << messages[3].second;
+        ASSERT_EQ(messages[4].second, "Flight recorder dump ends");
+    }
+
+#ifndef _WIN32
+    // Test sending batches of RFC 5424 messages to a Unix datagram socket
+    TEST_F(LoggerTest, SyslogSender)
+    {
+        std::string socket_path = log_filename + ".sock";
+        std::vector<std::string> messages;
+        char buffer[SyslogSender::Max_Message_Length];
+
+        // Create the socket on which a collector would receive messages
+        int collector = socket(AF_UNIX, SOCK_DGRAM, 0);
+        ASSERT_GE(collector, 0);
+        sockaddr_un collector_address{};
+        collector_address.sun_family = AF_UNIX;
+        std::strcpy(collector_address.sun_path, socket_path.c_str());
+        ASSERT_EQ(bind(collector,
+                       reinterpret_cast<sockaddr *>(&collector_address),
+                       sizeof(collector_address)),
+                  0);
+
+        auto receive = [&]()
+        {
+            ssize_t length;
+            while ((length = recv(collector,
+                                  buffer,
+                                  sizeof(buffer),
+                                  MSG_DONTWAIT)) >= 0)
+            {
+                messages.emplace_back(buffer, length);
+            }
+        };
+
+        auto sender = std::make_shared<SyslogSender>(
+                                                SyslogTransport::UnixDatagram,
+                                                socket_path,
+                                                SyslogSender::Default_Port,
+                                                4);
+        ASSERT_TRUE(logger->SetSyslogInterface(sender));
+        logger->SetLogFacility(LogFacility::Syslog);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::Syslog);
+        ASSERT_TRUE(sender->IsOpen());
+
+        // The interface may not be changed while in use
+        ASSERT_FALSE(logger->SetSyslogInterface(nullptr));
+
+        // Messages are sent only once the batch is full
+        for (unsigned i = 1; i <= 3; i++) logger->Info("Message {}", i);
+        receive();
+        ASSERT_TRUE(messages.empty());
+        logger->Info("Message {}", 4);
+        receive();
+        ASSERT_EQ(messages.size(), 4);
+
+        // Errors are sent immediately, as is anything flushed
+        logger->Info("Message {}", 5);
+        logger->Error("Message {}", 6);
+        receive();
+        ASSERT_EQ(messages.size(), 6);
+        logger->Warning("Message {}", 7);
+        logger->Flush();
+        receive();
+        ASSERT_EQ(messages.size(), 7);
+
+        // A partial batch is sent once it has been held for its maximum
+        // age, when another message is logged
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_FALSE(sender->IsOpen());
+        ASSERT_TRUE(logger->SetSyslogInterface(nullptr));
+        auto aging_sender = std::make_shared<SyslogSender>(
+                                                SyslogTransport::UnixDatagram,
+                                                socket_path,
+                                                SyslogSender::Default_Port,
+                                                4,
+                                                std::chrono::milliseconds(20));
+        ASSERT_TRUE(logger->SetSyslogInterface(aging_sender));
+        logger->SetLogFacility(LogFacility::Syslog);
+        logger->Info("Message {}", 8);
+        receive();
+        ASSERT_EQ(messages.size(), 7);
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        logger->Info("Message {}", 9);
+        receive();
+        ASSERT_EQ(messages.size(), 9);
+
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_TRUE(logger->SetSyslogInterface(nullptr));
+
+        // Verify the RFC 5424 header (facility LOG_DAEMON)
+        const std::regex header(R"(<(\d+)>1 \d{4}-\d\d-\d\dT\d\d:\d\d:)"
+                                R"(\d\d\.\d{6}Z \S+ \S+ \d+ - - (.*))");
+        const int priorities[] = {30, 30, 30, 30, 30, 27, 28, 30, 30};
+        for (unsigned i = 0; i < messages.size(); i++)
+        {
+            std::smatch match;
+            ASSERT_TRUE(std::regex_match(messages[i], match, header))
+                << messages[i];
+            ASSERT_EQ(std::stoi(match[1]), priorities[i]);
+            ASSERT_EQ(match[2], "Message " + std::to_string(i + 1));
+        }
+
+        close(collector);
+        std::remove(socket_path.c_str());
+    }
+
+    // Test resending framed messages over TCP after the collector restarts
+    TEST_F(LoggerTest, SyslogSenderStream)
+    {
+        std::vector<std::string> messages;
+        std::string received;
+        char buffer[SyslogSender::Max_Message_Length];
+        ssize_t length;
+
+        // Listen for connections on a local port
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_GE(listener, 0);
+        sockaddr_in listener_address{};
+        socklen_t address_length = sizeof(listener_address);
+        listener_address.sin_family = AF_INET;
+        listener_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(bind(listener,
+                       reinterpret_cast<sockaddr *>(&listener_address),
+                       sizeof(listener_address)),
+                  0);
+        ASSERT_EQ(listen(listener, 4), 0);
+        ASSERT_EQ(getsockname(listener,
+                              reinterpret_cast<sockaddr *>(&listener_address),
+                              &address_length),
+                  0);
+
+        auto sender = std::make_shared<SyslogSender>(
+                                            SyslogTransport::TCP,
+                                            "127.0.0.1",
+                                            ntohs(listener_address.sin_port),
+                                            2);
+        ASSERT_TRUE(logger->SetSyslogInterface(sender));
+        logger->SetLogFacility(LogFacility::Syslog);
+        ASSERT_TRUE(sender->IsOpen());
+
+        // The first connection receives a full batch
+        int connection = accept(listener, nullptr, nullptr);
+        ASSERT_GE(connection, 0);
+        logger->Info("Message {}", 1);
+        logger->Info("Message {}", 2);
+        while ((received.find("Message 2") == std::string::npos) &&
+               ((length = recv(connection, buffer, sizeof(buffer), 0)) > 0))
+        {
+            received.append(buffer, static_cast<std::size_t>(length));
+        }
+
+        // Restarting the collector loses what is sent before the sender
+        // learns of it, but the batch that fails is sent again
+        close(connection);
+        logger->Info("Message {}", 3);
+        logger->Flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        logger->Info("Message {}", 4);
+        logger->Info("Message {}", 5);
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_TRUE(logger->SetSyslogInterface(nullptr));
+
+        connection = accept(listener, nullptr, nullptr);
+        ASSERT_GE(connection, 0);
+        while ((length = recv(connection, buffer, sizeof(buffer), 0)) > 0)
+        {
+            received.append(buffer, static_cast<std::size_t>(length));
+        }
+        close(connection);
+        close(listener);
+
+        // Each message is framed once by its length
+        std::size_t position = 0;
+        while (position < received.size())
+        {
+            std::size_t space = received.find(' ', position);
+            ASSERT_NE(space, std::string::npos);
+            std::size_t message_length =
+                std::stoul(received.substr(position, space - position));
+            ASSERT_LE(space + 1 + message_length, received.size());
+            messages.push_back(received.substr(space + 1, message_length));
+            position = space + 1 + message_length;
+        }
+
+        ASSERT_GE(messages.size(), 4);
+        const std::regex message(R"(<\d+>1 \S+ \S+ \S+ \S+ - - (.*))");
+        std::vector<std::string> texts;
+        for (const auto &text : messages)
+        {
+            std::smatch match;
+            ASSERT_TRUE(std::regex_match(text, match, message)) << text;
+            texts.push_back(match[1]);
+        }
+        ASSERT_EQ(texts[0], "Message 1");
+        ASSERT_EQ(texts[1], "Message 2");
+        ASSERT_EQ(texts[texts.size() - 2], "Message 4");
+        ASSERT_EQ(texts[texts.size() - 1], "Message 5");
+    }
+#endif
+
+    // Test the policies applied when the asynchronous queue is full
+    TEST_F(LoggerTest, QueueOverflowPolicies)
+    {
+        std::atomic<bool> started = false;
+        std::atomic<bool> proceed = false;
+        std::vector<std::string> messages;
+
+        // Deliver messages to a callback that waits until told to proceed
+        auto callback_sink = std::make_shared<CallbackSink>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                started = true;
+                while (!proceed)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                messages.push_back(message);
+            });
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_TRUE(logger->AddSink(callback_sink));
+
+        // Log one message to occupy the writer, then more than will fit
+        auto overflow = [&]()
+        {
+            started = false;
+            proceed = false;
+            messages.clear();
+
+            logger->Info("Message {}", 0);
+            while (!started) std::this_thread::yield();
+
+            for (unsigned i = 1; i <= 6; i++) logger->Info("Message {}", i);
+            logger->Warning("Message {}", 7);
+
+            proceed = true;
+            logger->Flush();
+            logger->SetAsync(0);
+        };
+
+        const std::vector<std::pair<LogOverflowPolicy,
+                                    std::vector<unsigned>>> cases =
+        {
+            {LogOverflowPolicy::DropNewest, {1, 2, 3, 4}},
+            {LogOverflowPolicy::BlockWithTimeout, {1, 2, 3, 4}},
+            {LogOverflowPolicy::DropOldest, {4, 5, 6, 7}},
+            {LogOverflowPolicy::DropLowPriority, {1, 2, 3, 7}}
+        };
+
+        LogDropCounts total{};
+        for (const auto &[overflow_policy, kept] : cases)
+        {
+            LogQueuePolicy policy;
+            policy.overflow = overflow_policy;
+            policy.timeout = std::chrono::milliseconds(2);
+
+            auto start = std::chrono::steady_clock::now();
+            logger->SetAsync(4, policy);
+            overflow();
+            ASSERT_LT(std::chrono::steady_clock::now() - start,
+                      std::chrono::seconds(1));
+
+            std::vector<std::string> expected =
+            {
+                "Message 0",
+                "Dropped 3 messages"
+            };
+            for (auto i : kept)
+            {
+                expected.push_back("Message " + std::to_string(i));
+            }
+            ASSERT_EQ(messages, expected);
+
+            // The Warning is dropped only when Debug and Info are not
+            bool warning_kept = (kept.back() == 7);
+            total[static_cast<std::size_t>(LogLevel::Info)] +=
+                warning_kept ? 3 : 2;
+            total[static_cast<std::size_t>(LogLevel::Warning)] +=
+                warning_kept ? 0 : 1;
+            ASSERT_EQ(logger->GetDropCounts(), total);
+        }
+
+        // A sink's own queue applies its policy in the same way
+        LogQueuePolicy policy;
+        policy.overflow = LogOverflowPolicy::DropNewest;
+        callback_sink->SetAsync(4, policy);
+        started = false;
+        proceed = false;
+        messages.clear();
+        logger->Info("Message {}", 0);
+        while (!started) std::this_thread::yield();
+        for (unsigned i = 1; i <= 7; i++) logger->Info("Message {}", i);
+        proceed = true;
+        logger->Flush();
+        ASSERT_EQ(messages.size(), 6);
+        ASSERT_EQ(messages[1], "Dropped 3 messages");
+        ASSERT_EQ(callback_sink->GetDropCounts()[
+                      static_cast<std::size_t>(LogLevel::Info)],
+                  3);
+
+        logger->RemoveSink(callback_sink);
+    }
+
+    // Test the statistics collected by the root logger
+    TEST_F(LoggerTest, Stats)
+    {
+        auto index = [](auto value) { return static_cast<std::size_t>(value); };
+        std::size_t callback_bytes = 0;
+
+        // Write to a file and to a callback sink wanting Warning and above
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        auto callback_sink = std::make_shared<CallbackSink>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                callback_bytes += message.size();
+            },
+            LogLevel::Warning);
+        ASSERT_TRUE(logger->AddSink(callback_sink));
+
+        // Nothing is counted until statistics are enabled
+        logger->Info("Not counted");
+        logger->EnableStats();
+
+        auto child = std::make_shared<Logger>("Child", logger);
+        for (unsigned i = 0; i < 3; i++) logger->Info("Message {}", i);
+        logger->Debug("Filtered {}", 1);
+        logger->Log(LogLevel::Debug, "Filtered 2");
+        logger->warning << "Warning" << std::flush;
+        child->Error("Error");
+
+        // Log from several threads, each updating its own shard
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < 4; i++)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    for (unsigned j = 0; j < 250; j++) child->Info("Thread");
+                });
+        }
+        for (auto &thread : threads) thread.join();
+
+        // Disabling statistics stops counting without losing the counts
+        logger->EnableStats(false);
+        logger->Error("Not counted");
+        logger->EnableStats();
+
+        LogStats stats = child->GetStats();
+        ASSERT_EQ(stats.messages[index(LogLevel::Info)], 1003);
+        ASSERT_EQ(stats.messages[index(LogLevel::Warning)], 1);
+        ASSERT_EQ(stats.messages[index(LogLevel::Error)], 1);
+        ASSERT_EQ(stats.messages[index(LogLevel::Debug)], 0);
+        ASSERT_EQ(stats.filtered[index(LogLevel::Debug)], 2);
+        ASSERT_EQ(stats.filtered[index(LogLevel::Info)], 0);
+        ASSERT_EQ(stats.emit_time.count, 1005);
+        ASSERT_GT(stats.emit_time.total.count(), 0);
+        ASSERT_GT(stats.emit_time.Percentile(0.99).count(), 0);
+        ASSERT_LE(stats.emit_time.Percentile(0.5),
+                  stats.emit_time.Percentile(0.99));
+        ASSERT_EQ(stats.drops, LogDropCounts{});
+        ASSERT_EQ(stats.queue_depth, 0);
+
+        // Each line written to a sink is counted with the newline the sink
+        // appends; the test logger also writes every line to the console
+        std::size_t callback_lines = 2;
+        ASSERT_GT(stats.bytes[index(LogFacility::None)],
+                  callback_bytes + callback_lines);
+        ASSERT_EQ(stats.bytes[index(LogFacility::Console)],
+                  stats.bytes[index(LogFacility::File)]);
+
+        logger->RemoveSink(callback_sink);
+        logger->SetLogFacility(LogFacility::None);
+
+        // The file also holds the lines logged while not collecting
+        std::ifstream log_file(log_filename);
+        std::string log_line;
+        std::uint64_t counted_bytes = 0;
+        while (std::getline(log_file, log_line))
+        {
+            if (log_line.find("Not counted") != std::string::npos) continue;
+            counted_bytes += log_line.size() + 1;
+        }
+        ASSERT_EQ(stats.bytes[index(LogFacility::File)], counted_bytes);
+
+        // The writer thread records the depth of the queue
+        ASSERT_TRUE(logger->AddSink(std::make_shared<CallbackSink>(
+            [](LogLevel, const std::string &, bool) {})));
+        logger->SetAsync(64);
+        for (unsigned i = 0; i < 8; i++) logger->Info("Async {}", i);
+        logger->Flush();
+        stats = logger->GetStats();
+        ASSERT_GE(stats.max_queue_depth, 1);
+        ASSERT_LE(stats.max_queue_depth, 8);
+        ASSERT_EQ(stats.messages[index(LogLevel::Info)], 1011);
+        logger->SetAsync(0);
+    }
+
+    // Test the CustomLogger receiving each message's text or parts
+    TEST_F(LoggerTest, CustomLoggerParts)
+    {
+        std::vector<std::string> texts;
+        auto text_logger = std::make_shared<CustomLogger>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                texts.push_back(message);
+            });
+        auto text_child = std::make_shared<Logger>("Comp", text_logger);
+        text_child->Info("Formatted {}", 1);
+        text_child->Log(LogLevel::Warning, "Logged");
+        ASSERT_EQ(texts,
+                  (std::vector<std::string>{"[Comp] Formatted 1",
+                                            "[Comp] Logged"}));
+
+        struct Received
+        {
+            LogLevel level;
+            std::chrono::system_clock::time_point time;
+            std::string prefix;
+            std::string body;
+        };
+        std::vector<Received> received;
+        auto parts_logger = std::make_shared<CustomLogger>(
+            [&](const LogMessageParts &parts)
+            {
+                received.push_back(Received{parts.level,
+                                            parts.time,
+                                            std::string(parts.prefix),
+                                            std::string(parts.body)});
+            });
+        auto child = std::make_shared<Logger>("Comp", parts_logger);
+        auto grandchild = std::make_shared<Logger>("Sub", child);
+
+        auto before = std::chrono::system_clock::now();
+        parts_logger->Info("Root {}", 1);
+        child->Info("Formatted {}", 2);
+        grandchild->Log(LogLevel::Error, "Logged");
+        grandchild->warning << "Streamed " << 3 << std::flush;
+        LOGGER_INFO_BINARY(child, "Binary {}", 4);
+        auto after = std::chrono::system_clock::now();
+
+        const std::vector<std::pair<std::string, std::string>> expected =
+        {
+            {"", "Root 1"},
+            {"[Comp] ", "Formatted 2"},
+            {"[Comp] [Sub] ", "Logged"},
+            {"[Comp] [Sub] ", "Streamed 3"},
+            {"[Comp] ", "Binary 4"}
+        };
+        ASSERT_EQ(received.size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); i++)
+        {
+            ASSERT_EQ(received[i].prefix, expected[i].first);
+            ASSERT_EQ(received[i].body, expected[i].second);
+            ASSERT_GE(received[i].time, before);
+            ASSERT_LE(received[i].time, after);
+        }
+        ASSERT_EQ(received[2].level, LogLevel::Error);
+        ASSERT_EQ(received[3].level, LogLevel::Warning);
+
+        // Messages below the log level are not delivered
+        child->Debug("Filtered");
+        ASSERT_EQ(received.size(), expected.size());
+    }
+
+    // Test the CustomLogger receiving batches on a background thread
+    TEST_F(LoggerTest, CustomLoggerBatches)
+    {
+        std::mutex mutex;
+        std::vector<std::size_t> batch_sizes;
+        std::vector<std::string> messages;
+        std::thread::id caller = std::this_thread::get_id();
+        std::atomic<bool> other_thread = true;
+
+        auto custom_logger = std::make_shared<CustomLogger>(
+            [&](const LogMessageParts *parts, std::size_t count)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (std::this_thread::get_id() == caller) other_thread = false;
+                batch_sizes.push_back(count);
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    messages.push_back(std::string(parts[i].prefix) +
+                                       std::string(parts[i].body));
+                }
+            },
+            64,
+            4);
+        auto child = std::make_shared<Logger>("Comp", custom_logger);
+
+        std::vector<std::string> expected;
+        for (unsigned i = 0; i < 10; i++)
+        {
+            child->Info("Message {}", i);
+            expected.push_back("[Comp] Message " + std::to_string(i));
+        }
+        std::string long_body(LogRecordText::Inline_Capacity * 2, 'x');
+        child->Log(LogLevel::Info, long_body);
+        expected.push_back("[Comp] " + long_body);
+
+        // Flushing a child flushes the batches of the root CustomLogger
+        child->Flush();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_TRUE(other_thread);
+        ASSERT_EQ(messages, expected);
+        for (auto size : batch_sizes)
+        {
+            ASSERT_GE(size, 1);
+            ASSERT_LE(size, 4);
+        }
+        ASSERT_EQ(custom_logger->GetBatchDropCounts(), LogDropCounts{});
+    }
+
+    // Test that logging does not allocate memory once buffers are warm
+    TEST_F(LoggerTest, SteadyStateAllocations)
+    {
+        auto root = std::make_shared<Logger>(false);
+        auto child = std::make_shared<Logger>("Media", root);
+        const std::string message = "Message held in a std::string";
+
+        root->SetLogFacility(LogFacility::File, log_filename);
+
+        auto log_messages = [&](unsigned count)
+        {
+            for (unsigned i = 0; i < count; i++)
+            {
+                root->Info("Formatted {}", i);
+                child->Info("Formatted {} with a prefix", i);
+                child->info << "Streamed " << i << std::flush;
+                child->Log(LogLevel::Warning, message);
+                LOGGER_INFO_BINARY(child, "Binary {} {}", i, 2.5);
+                LOGGER_INFO(child, "Macro " << i << ' ' << message);
+            }
+        };
+
+        auto count_while_logging = [&]() -> std::size_t
+        {
+            log_messages(100);
+            root->Flush();
+
+            allocation_count = 0;
+            count_allocations = true;
+            log_messages(100);
+            root->Flush();
+            count_allocations = false;
+
+            return allocation_count;
+        };
+
+        // Messages written on the calling thread
+        ASSERT_EQ(count_while_logging(), 0);
+
+        // Messages queued for the writer thread and queued for a sink
+        root->SetAsync(1024);
+        ASSERT_EQ(count_while_logging(), 0);
+
+        auto callback_sink = std::make_shared<CallbackSink>(
+            [](LogLevel, const std::string &, bool) {});
+        ASSERT_TRUE(root->AddSink(callback_sink));
+        callback_sink->SetAsync(1024);
+        ASSERT_EQ(count_while_logging(), 0);
+
+        // Messages written with their source locations
+        root->ShowSourceLocation();
+        ASSERT_EQ(count_while_logging(), 0);
+        root->ShowSourceLocation(false);
+
+        root->RemoveSink(callback_sink);
+        root->SetAsync(0);
+        root->SetLogFacility(LogFacility::None);
+    }
+
+    // Test the rate limiting and sampling macros
+    TEST_F(LoggerTest, LimitedMacros)
+    {
+        std::string log_line;
+        unsigned evaluations = 0;
+        auto count = [&]() -> unsigned { return ++evaluations; };
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        for (unsigned i = 0; i < 10; i++)
+        {
+            LOGGER_WARNING_EVERY_N(logger, 3, "Every " << i);
+        }
+
+        for (unsigned i = 0; i < 5; i++)
+        {
+            LOGGER_INFO_FIRST_N(logger, 2, "First " << count());
+        }
+        ASSERT_EQ(evaluations, 2);
+
+        // Two messages per second allows a burst of two messages
+        auto limited = [&](const std::string &text)
+        {
+            LOGGER_ERROR_RATE_LIMITED(logger, 2, "Limited " << text);
+        };
+        for (unsigned i = 0; i < 100; i++) limited(std::to_string(i));
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        limited("again");
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING] Every 0"), std::string::npos);
+        ASSERT_EQ(log_line.find("suppressed"), std::string::npos);
+        for (unsigned i = 3; i < 10; i += 3)
+        {
+            std::getline(log_file, log_line);
+            ASSERT_NE(log_line.find("[WARNING] Every " + std::to_string(i) +
+                                    " (suppressed 2 messages)"),
+                      std::string::npos);
+        }
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] First 1"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] First 2"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] Limited 0"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] Limited 1"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] Limited again "
+                                "(suppressed 98 messages)"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test logging using streaming operators
+    TEST_F(LoggerTest, LogStreams)
+    {
+        std::string log_line;
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        // Set the log level to debugging
+        logger->SetLogLevel(LogLevel::Debug);
+
+        // Have logging use milliseconds
+        logger->SetTimePrecision(LogTimePrecision::Milliseconds);
+
+        // Verify the log level is set
+        ASSERT_TRUE(logger->IsDebugging());
+
+        // Log using streaming operator
+        logger->info << "Test Log 1" << std::flush;
+        logger->debug << "Test Log 2" << std::flush;
+        logger->warning << "Test Log 3" << std::flush;
+        logger->error << "Test Log 4" << std::flush;
+        logger->critical << "Test Log 5" << std::flush;
+        logger->console << "Test log to console" << std::flush;
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[DEBUG]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[CRITICAL]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
+        ASSERT_NE(log_line.find("log to console"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test the timestamp formats and precision
+    TEST_F(LoggerTest, TimeFormat)
+    {
+        std::string log_line;
+        const std::regex iso_micro(
+            R"(^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{6} \[INFO\] .*)");
+        const std::regex iso_milli(
+            R"(^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3} \[INFO\] .*)");
+        const std::regex epoch_milli(R"(^\d{10,}\.\d{3} \[INFO\] .*)");
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        logger->Log("Local time");
+        logger->SetTimeFormat(LogTimeFormat::UTC);
+        logger->Log("UTC time");
+        logger->SetTimePrecision(LogTimePrecision::Milliseconds);
+        logger->Log("UTC time in milliseconds");
+        logger->SetTimeFormat(LogTimeFormat::Epoch);
+        logger->Log("Epoch time in milliseconds");
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(std::regex_match(log_line, iso_micro));
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(std::regex_match(log_line, iso_micro));
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(std::regex_match(log_line, iso_milli));
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(std::regex_match(log_line, epoch_milli));
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test formatting times before the epoch
+    TEST_F(LoggerTest, PreEpochTimestamp)
+    {
+        char buffer[Max_Timestamp_Length];
+        auto format = [&](std::int64_t microseconds,
+                          LogTimeFormat time_format,
+                          LogTimePrecision precision)
+        {
+            std::chrono::system_clock::time_point time(
+                std::chrono::duration_cast<
+                    std::chrono::system_clock::duration>(
+                    std::chrono::microseconds(microseconds)));
+            return std::string(
+                buffer,
+                FormatLogTimestamp(time, time_format, precision, buffer));
+        };
+
+        ASSERT_EQ(format(-500'000,
+                         LogTimeFormat::UTC,
+                         LogTimePrecision::Microseconds),
+                  "1969-12-31T23:59:59.500000");
+        ASSERT_EQ(format(-1'000'000,
+                         LogTimeFormat::UTC,
+                         LogTimePrecision::Microseconds),
+                  "1969-12-31T23:59:59.000000");
+        ASSERT_EQ(format(-1'250'000,
+                         LogTimeFormat::UTC,
+                         LogTimePrecision::Milliseconds),
+                  "1969-12-31T23:59:58.750");
+        ASSERT_EQ(format(-500'000,
+                         LogTimeFormat::Epoch,
+                         LogTimePrecision::Microseconds),
+                  "-0.500000");
+        ASSERT_EQ(format(-1'250'000,
+                         LogTimeFormat::Epoch,
+                         LogTimePrecision::Milliseconds),
+                  "-1.250");
+        ASSERT_EQ(format(-1'000'000,
+                         LogTimeFormat::Epoch,
+                         LogTimePrecision::Microseconds),
+                  "-1.000000");
+        ASSERT_EQ(format(1'250'000,
+                         LogTimeFormat::Epoch,
+                         LogTimePrecision::Microseconds),
+                  "1.250000");
+    }
+
+    // Test child logger output
+    TEST_F(LoggerTest, ChildLogger)
+    {
+        std::string log_line;
+
+        // Create the child logger
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        // Set the log level to debugging
+        logger->SetLogLevel(LogLevel::Debug);
+
+        // Verify the log level is set
+        ASSERT_TRUE(logger->IsDebugging());
+
+        // Log using streaming operator
+        child_logger->info << "Test Log 1" << std::flush;
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
+        ASSERT_NE(log_line.find("[CHLD]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test asynchronous logging from multiple threads
+    TEST_F(LoggerTest, AsyncLog)
+    {
+        constexpr unsigned Thread_Count = 4;
+        constexpr unsigned Messages_Per_Thread = 250;
+        std::vector<std::thread> threads;
+        std::string log_line;
+        unsigned line_count = 0;
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        // Use a small queue so that producers must wait for space
+        logger->SetAsync(16);
+        ASSERT_TRUE(logger->IsAsync());
+
+        // Child loggers defer to the root logger
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+        ASSERT_TRUE(child_logger->IsAsync());
+
+        for (unsigned i = 0; i < Thread_Count; i++)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    for (unsigned j = 0; j < Messages_Per_Thread; j++)
+                    {
+                        child_logger->Log("Async message " +
+                                          std::to_string(j));
+                    }
+                });
+        }
+
+        for (auto &thread : threads) thread.join();
+
+        // Changing the facility will emit all queued messages first
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that every message was written to the file
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        while (std::getline(log_file, log_line))
+        {
+            ASSERT_NE(log_line.find("[INFO] [CHLD] Async message"),
+                      std::string::npos);
+            line_count++;
+        }
+        ASSERT_EQ(line_count, Thread_Count * Messages_Per_Thread);
+        log_file.close();
+
+        // Disable asynchronous logging
+        logger->SetAsync(0);
+        ASSERT_FALSE(logger->IsAsync());
+    }
+
+    // Test that queued messages are written when the logger is destroyed
+    TEST_F(LoggerTest, AsyncDestructor)
+    {
+        std::string log_line;
+
+        {
+            auto async_logger = std::make_shared<Logger>("ASYN");
+            async_logger->SetLogFacility(LogFacility::File, log_filename);
+            async_logger->SetAsync();
+
+            async_logger->Log("Test Log 1");
+            async_logger->Log(LogLevel::Warning, "Test Log 2");
+        }
+
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING]"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test that a sharded queue merges messages from each thread in order
+    TEST_F(LoggerTest, ShardedAsync)
+    {
+        constexpr unsigned Thread_Count = 4;
+        constexpr unsigned Messages_Per_Thread = 250;
+        std::vector<std::thread> threads;
+        std::vector<unsigned> next_message(Thread_Count, 0);
+        std::string log_line;
+        std::string last_time;
+        unsigned line_count = 0;
+        LogQueuePolicy policy;
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        logger->SetTimeFormat(LogTimeFormat::UTC);
+
+        // Give each thread a small queue so that it must wait for space
+        policy.sharded = true;
+        policy.reorder_window = std::chrono::milliseconds(100);
+        logger->SetAsync(16, policy);
+        ASSERT_TRUE(logger->IsAsync());
+
+        for (unsigned i = 0; i < Thread_Count; i++)
+        {
+            threads.emplace_back(
+                [&, i]()
+                {
+                    for (unsigned j = 0; j < Messages_Per_Thread; j++)
+                    {
+                        logger->Log("Thread " + std::to_string(i) +
+                                    " message " + std::to_string(j));
+                    }
+                });
+        }
+
+        for (auto &thread : threads) thread.join();
+
+        // Messages from a thread that has exited are written on Flush()
+        std::thread(
+            [&]() { logger->Log(LogLevel::Warning, "Last message"); })
+            .join();
+        logger->Flush();
+
+        logger->SetLogFacility(LogFacility::None);
+
+        // Every message is written once, in time order
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        while (std::getline(log_file, log_line))
+        {
+            ASSERT_GE(log_line.substr(0, 26), last_time);
+            last_time = log_line.substr(0, 26);
+            line_count++;
+            if (line_count > Thread_Count * Messages_Per_Thread) break;
+
+            auto position = log_line.find("[INFO] Thread ");
+            ASSERT_NE(position, std::string::npos);
+            unsigned thread = std::stoul(log_line.substr(position + 14));
+            ASSERT_LT(thread, Thread_Count);
+            auto message = log_line.substr(log_line.find(" message ") + 9);
+            ASSERT_EQ(std::stoul(message), next_message[thread]++);
+        }
+        ASSERT_EQ(line_count, Thread_Count * Messages_Per_Thread + 1);
+        ASSERT_NE(log_line.find("[WARNING] Last message"), std::string::npos);
+        ASSERT_FALSE(std::getline(log_file, log_line));
+        log_file.close();
+
+        // Disable asynchronous logging
+        logger->SetAsync(0);
+        ASSERT_FALSE(logger->IsAsync());
+    }
+
+#ifdef LOGGER_ZLIB_ENABLED
+    // Test that compressed file output is written as complete frames
+    TEST_F(LoggerTest, CompressedFile)
+    {
+        constexpr unsigned Message_Count = 100;
+        LogFlushPolicy policy;
+        unsigned members = 0;
+        std::string text;
+
+        policy.compression = LogCompression::Gzip;
+        logger->SetLogFacility(LogFacility::File, log_filename, policy);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        // Messages are held until a block is compressed
+        for (unsigned i = 0; i < Message_Count; i++)
+        {
+            logger->Log("Compressed message " + std::to_string(i));
+        }
+        ASSERT_TRUE(ReadGzipFile(log_filename, text, members));
+        ASSERT_TRUE(text.empty());
+
+        // An Error message completes the frame so it may be recovered
+        logger->Log(LogLevel::Error, "Failure");
+        ASSERT_TRUE(ReadGzipFile(log_filename, text, members));
+        ASSERT_EQ(members, 1);
+        ASSERT_EQ(std::count(text.begin(), text.end(), '\n'),
+                  Message_Count + 1);
+        ASSERT_NE(text.find("[INFO] Compressed message 99\n"),
+                  std::string::npos);
+        ASSERT_NE(text.find("[ERROR] Failure\n"), std::string::npos);
+
+        // Messages larger than a block are compressed as a frame of their
+        // own, and held messages are written when the file is closed
+        logger->Log("Last message");
+        logger->Log(std::string(LogFile::Default_Block_Size, 'x'));
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_TRUE(ReadGzipFile(log_filename, text, members));
+        ASSERT_EQ(members, 3);
+        ASSERT_NE(text.find("[INFO] Last message\n"), std::string::npos);
+        ASSERT_NE(text.find(std::string(LogFile::Default_Block_Size, 'x')),
+                  std::string::npos);
+
+        // A format that is not available prevents the file being opened
+        for (auto compression : {LogCompression::Zstd, LogCompression::Lz4})
+        {
+            if (LogCompressor::IsAvailable(compression)) continue;
+
+            policy.compression = compression;
+            logger->SetLogFacility(LogFacility::File, log_filename, policy);
+            ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+        }
+    }
+#endif
+
+    // Test that consecutive repeats of a message are summarized
+    TEST_F(LoggerTest, CoalesceRepeats)
+    {
+        std::vector<std::string> lines;
+        std::string log_line;
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        logger->EnableCoalescing(std::chrono::seconds(10));
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+
+        // Runs of each component and level are counted independently
+        for (unsigned i = 0; i < 100; i++)
+        {
+            child_logger->Log(LogLevel::Error, "Disk full");
+            if (i % 10 == 0) logger->Log("Still running");
+        }
+        child_logger->Log(LogLevel::Warning, "Disk full");
+        child_logger->Log(LogLevel::Error, "Disk cleaned");
+
+        // Flush() summarizes the run in progress
+        logger->Log("Idle");
+        logger->Log("Idle");
+        logger->Flush();
+
+        // A quiet run is summarized when the next message is logged, and
+        // the same message is then written in full
+        logger->EnableCoalescing(std::chrono::milliseconds(20));
+        child_logger->Log("Retrying");
+        child_logger->Log("Retrying");
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        logger->Log("Waiting");
+        child_logger->Log("Retrying");
+
+        // Disabling coalescing summarizes nothing further
+        logger->EnableCoalescing(std::chrono::milliseconds(0));
+        logger->Log("Waiting");
+        logger->SetLogFacility(LogFacility::None);
+
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        while (std::getline(log_file, log_line)) lines.push_back(log_line);
+        log_file.close();
+
+        const std::vector<std::string> expected = {
+            "[ERROR] [CHLD] Disk full",
+            "[INFO] Still running",
+            "[WARNING] [CHLD] Disk full",
+            "[ERROR] [CHLD] Last message repeated 99 times (first ",
+            "[ERROR] [CHLD] Disk cleaned",
+            "[INFO] Last message repeated 9 times (first ",
+            "[INFO] Idle",
+            "[INFO] Last message repeated 1 time (first ",
+            "[INFO] [CHLD] Retrying",
+            "[INFO] [CHLD] Last message repeated 1 time (first ",
+            "[INFO] Waiting",
+            "[INFO] [CHLD] Retrying",
+            "[INFO] Waiting"};
+        ASSERT_EQ(lines.size(), expected.size());
+        for (std::size_t i = 0; i < lines.size(); i++)
+        {
+            ASSERT_NE(lines[i].find(expected[i]), std::string::npos)
+                << lines[i];
+        }
+        ASSERT_NE(lines[3].find(", last "), std::string::npos);
+    }
+
+    // Test that destroying a CustomLogger summarizes a pending run
+    TEST_F(LoggerTest, CoalesceRepeatsCustomLogger)
+    {
+        std::vector<std::string> messages;
+        std::vector<std::string> batched;
+
+        auto custom_logger = std::make_shared<CustomLogger>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                messages.push_back(message);
+            });
+        custom_logger->EnableCoalescing(std::chrono::seconds(10));
+        custom_logger->Log("Retrying");
+        custom_logger->Log("Retrying");
+        custom_logger->Log("Retrying");
+        custom_logger.reset();
+
+        ASSERT_EQ(messages.size(), 2);
+        ASSERT_EQ(messages[0], "Retrying");
+        ASSERT_EQ(messages[1].find("Last message repeated 2 times (first "),
+                  0)
+            << messages[1];
+
+        // The summary also reaches a batch callback
+        auto batch_logger = std::make_shared<CustomLogger>(
+            [&](const LogMessageParts *parts, std::size_t count)
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    batched.emplace_back(parts[i].body);
+                }
+            });
+        batch_logger->EnableCoalescing(std::chrono::seconds(10));
+        batch_logger->Log("Retrying");
+        batch_logger->Log("Retrying");
+        batch_logger.reset();
+
+        ASSERT_EQ(batched.size(), 2);
+        ASSERT_EQ(batched[0], "Retrying");
+        ASSERT_EQ(batched[1].find("Last message repeated 1 time (first "), 0)
+            << batched[1];
+    }
+
+    // Sink policy retaining each message for inspection
+    struct CaptureSinkPolicy
+    {
+        void Write(const LogMessage &message)
+        {
+            lines.emplace_back(message.line);
+            texts.emplace_back(message.text);
+        }
+
+        void Flush() { flushes++; }
+
+        std::vector<std::string> lines;
+        std::vector<std::string> texts;
+        unsigned flushes = 0;
+    };
+
+    // Test a logger whose sink, format, and minimum level are fixed at
+    // compile time
+    TEST_F(LoggerTest, BasicLoggerPolicies)
+    {
+        std::vector<std::string> lines;
+        std::string log_line;
+
+        using WarningLogger = BasicLogger<LogFileSinkPolicy,
+                                          LogTextFormatPolicy<>,
+                                          LogLevel::Warning>;
+
+        // Levels beyond the minimum are rejected at compile time
+        static_assert(WarningLogger::Compiled_Level == LogLevel::Warning);
+
+        {
+            WarningLogger file_logger(log_filename);
+            ASSERT_TRUE(file_logger.GetSink().IsOpen());
+            file_logger.SetLogLevel(LogLevel::Debug);
+            ASSERT_FALSE(file_logger.ShouldLog<LogLevel::Info>());
+            ASSERT_TRUE(file_logger.ShouldLog<LogLevel::Warning>());
+
+            file_logger.Debug("Debug {}", 1);
+            file_logger.Info("Info {}", 2);
+            file_logger.Warning("Warning {}", 3);
+            file_logger.Error("Error {} of {}", 4, "five");
+            file_logger.Log(LogLevel::Info, "Runtime info");
+            file_logger.Log(LogLevel::Critical, "Runtime critical");
+
+            // The run-time level filters within the compiled bound
+            file_logger.SetLogLevel(LogLevel::Error);
+            file_logger.Warning("Filtered {}", 6);
+            file_logger.Critical("Critical {}", 7);
+        }
+
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        while (std::getline(log_file, log_line)) lines.push_back(log_line);
+        log_file.close();
+
+        const std::vector<std::string> expected = {
+            "[WARNING] Warning 3",
+            "[ERROR] Error 4 of five",
+            "[CRITICAL] Runtime critical",
+            "[CRITICAL] Critical 7"};
+        ASSERT_EQ(lines.size(), expected.size());
+        std::regex line_regex(
+            R"(^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{6} \[[A-Z]+\] .+$)");
+        for (std::size_t i = 0; i < lines.size(); i++)
+        {
+            ASSERT_TRUE(std::regex_match(lines[i], line_regex)) << lines[i];
+            ASSERT_NE(lines[i].find(expected[i]), std::string::npos)
+                << lines[i];
+        }
+
+        // JSON lines carry the message text separately for the sink
+        BasicLogger<CaptureSinkPolicy,
+                    LogJsonFormatPolicy<LogTimeFormat::UTC,
+                                        LogTimePrecision::Milliseconds>>
+            json_logger;
+        json_logger.Info("Quoted \"{}\"", "value");
+        json_logger.Debug("Not logged");
+        json_logger.Flush();
+
+        auto &sink = json_logger.GetSink();
+        ASSERT_EQ(sink.lines.size(), 1u);
+        ASSERT_EQ(sink.texts[0], "Quoted \"value\"");
+        ASSERT_NE(sink.lines[0].find("\"level\":\"INFO\""),
+                  std::string::npos) << sink.lines[0];
+        ASSERT_NE(sink.lines[0].find(R"("msg":"Quoted \"value\"")"),
+                  std::string::npos) << sink.lines[0];
+        std::regex json_regex(R"(^\{"time":"[-0-9T:]+\.\d{3}",.*\}$)");
+        ASSERT_TRUE(std::regex_match(sink.lines[0], json_regex))
+            << sink.lines[0];
+        ASSERT_EQ(sink.flushes, 1u);
+    }
+
+    // Test that streaming from multiple threads does not interleave messages
+    TEST_F(LoggerTest, LogStreamsThreaded)
+    {
+        constexpr unsigned Thread_Count = 4;
+        constexpr unsigned Messages_Per_Thread = 250;
+        std::vector<std::thread> threads;
+        std::string log_line;
+        unsigned line_count = 0;
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        for (unsigned i = 0; i < Thread_Count; i++)
+        {
+            threads.emplace_back(
+                [&, i]()
+                {
+                    for (unsigned j = 0; j < Messages_Per_Thread; j++)
+                    {
+                        // Write each message in several pieces
+                        logger->info << "Thread " << i << " message "
+                                     << j << " end" << std::flush;
+                    }
+                });
+        }
+
+        for (auto &thread : threads) thread.join();
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Every line must be a complete message from a single thread
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        while (std::getline(log_file, log_line))
+        {
+            auto position = log_line.find("[INFO] Thread ");
+            ASSERT_NE(position, std::string::npos);
+            ASSERT_NE(log_line.find(" message ", position), std::string::npos);
+            ASSERT_EQ(log_line.substr(log_line.length() - 4), " end");
+            ASSERT_EQ(log_line.find("Thread", position + 14),
+                      std::string::npos);
+            line_count++;
+        }
+        ASSERT_EQ(line_count, Thread_Count * Messages_Per_Thread);
+        log_file.close();
+    }
+
+    // Test that stream formatting state belongs to one thread and message
+    TEST_F(LoggerTest, LogStreamsFormatState)
+    {
+        std::vector<std::string> messages;
+        std::mutex messages_mutex;
+        auto custom_logger = std::make_shared<CustomLogger>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                std::lock_guard<std::mutex> lock(messages_mutex);
+                messages.push_back(message);
+            });
+
+        // A manipulator given by one thread does not affect another
+        custom_logger->info << std::hex << std::setw(6) << std::setfill('0');
+        std::thread([&]() { custom_logger->info << 255 << std::flush; })
+            .join();
+        custom_logger->info << 255 << std::flush;
+
+        // Nor does it affect the thread's next message
+        custom_logger->info << 10 << std::flush;
+        custom_logger->GetLoggingStream(LogLevel::Info)
+            << std::showpos << 1 << std::flush;
+        custom_logger->info << 1 << std::flush;
+
+        ASSERT_EQ(messages,
+                  std::vector<std::string>({"255", "0000ff", "10", "+1", "1"}));
+    }
+
+    // Test output from a hierarchy of child loggers
+    TEST_F(LoggerTest, NestedChildLogger)
+    {
+        std::string log_line;
+
+        // Create a chain of child loggers
+        auto foo_logger = std::make_shared<Logger>("Foo", logger);
+        auto bar_logger = std::make_shared<Logger>("Bar", foo_logger);
+        auto baz_logger = std::make_shared<Logger>("Baz", bar_logger);
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(baz_logger->GetLogFacility(), LogFacility::File);
+
+        // Enable debugging everywhere except the intermediate logger
+        logger->SetLogLevel(LogLevel::Debug);
+        baz_logger->SetLogLevel(LogLevel::Debug);
+
+        baz_logger->info << "Test Log 1" << std::flush;
+        baz_logger->debug << "Test Log 2" << std::flush;  // Should not output
+        bar_logger->Log(LogLevel::Warning, "Test Log 3");
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(baz_logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] [Foo] [Bar] [Baz] Test Log 1"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING] [Foo] [Bar] Test Log 3"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test lightweight component logger handles
+    TEST_F(LoggerTest, LoggerHandle)
+    {
+        auto foo_logger = std::make_shared<Logger>("Foo", logger);
+        LoggerHandle session("Session", foo_logger);
+        LoggerHandle stream("Stream", session);
+        LoggerHandle other("Other", logger);
+
+        ASSERT_LT(sizeof(LoggerHandle) * 8, sizeof(Logger));
+
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        logger->SetLogLevel(LogLevel::Debug);
+
+        session.info << "Streamed " << 1 << std::flush;
+        session.Info("Formatted {}", 2);
+        stream.Log(LogLevel::Warning, "Logged 3");
+
+        // Messages streamed to different handles at once remain separate
+        session.info << "Interleaved ";
+        other.info << "Other " << 4 << std::flush;
+        session.info << 5 << std::flush;
+
+        // The handle's level and that of each parent Logger must pass
+        stream.debug << "Filtered by handle" << std::flush;
+        stream.SetLogLevel(LogLevel::Debug);
+        ASSERT_FALSE(stream.IsDebugging());
+        ASSERT_FALSE(stream.ShouldLog(LogLevel::Debug));
+        stream.debug << "Filtered by Foo" << std::flush;
+        foo_logger->SetLogLevel(LogLevel::Debug);
+        ASSERT_TRUE(stream.IsDebugging());
+        stream.Debug("Debug {}", 6);
+        ASSERT_TRUE(stream.ShouldLog(LogLevel::Debug));
+        ASSERT_FALSE(session.ShouldLog(LogLevel::Debug));
+
+        LOGGER_ERROR(&stream, "Macro " << 7);
+        LOGGER_INFO_BINARY(&session, "Binary {}", 8);
+        session.Flush();
+
+        logger->SetLogFacility(LogFacility::None);
+
+        const std::vector<std::string> expected =
+        {
+            "[INFO] [Foo] [Session] Streamed 1",
+            "[INFO] [Foo] [Session] Formatted 2",
+            "[WARNING] [Foo] [Session] [Stream] Logged 3",
+            "[INFO] [Other] Other 4",
+            "[INFO] [Foo] [Session] Interleaved 5",
+            "[DEBUG] [Foo] [Session] [Stream] Debug 6",
+            "[ERROR] [Foo] [Session] [Stream] Macro 7",
+            "[INFO] [Foo] [Session] Binary 8"
+        };
+        std::ifstream log_file(log_filename);
+        std::string log_line;
+        for (const auto &text : expected)
+        {
+            ASSERT_TRUE(std::getline(log_file, log_line));
+            ASSERT_NE(log_line.find(text), std::string::npos) << log_line;
+        }
+        ASSERT_FALSE(std::getline(log_file, log_line));
+    }
+
+    // Test that a handle's pooled stream does not keep formatting state
+    TEST_F(LoggerTest, LoggerHandleFormatState)
+    {
+        std::vector<std::string> messages;
+        auto custom_logger = std::make_shared<CustomLogger>(
+            [&](LogLevel, const std::string &message, bool)
+            {
+                messages.push_back(message);
+            });
+        custom_logger->SetLogLevel(LogLevel::Debug);
+        LoggerHandle h1("H1", custom_logger);
+        LoggerHandle h2("H2", custom_logger);
+        h2.SetLogLevel(LogLevel::Debug);
+
+        h1.info << std::hex << std::setw(4) << std::setfill('*') << 255
+                << std::flush;
+        h2.debug << 10 << std::flush;
+        h1.info << std::boolalpha << true << std::flush;
+        h1.info << true << std::flush;
+
+        ASSERT_EQ(messages,
+                  std::vector<std::string>({"[H1] **ff",
+                                            "[H2] 10",
+                                            "[H1] true",
+                                            "[H1] 1"}));
+    }
+
+    // Test log levels given by component path
+    TEST_F(LoggerTest, ComponentLevels)
+    {
+        auto foo_logger = std::make_shared<Logger>("Foo", logger);
+        auto bar_logger = std::make_shared<Logger>("Bar", foo_logger);
+        auto barn_logger = std::make_shared<Logger>("Barn", foo_logger);
+        LoggerHandle connection("Conn", bar_logger);
+
+        ASSERT_EQ(bar_logger->GetComponentPath(), "Foo.Bar");
+        ASSERT_EQ(connection.GetComponentPath(), "Foo.Bar.Conn");
+
+        // Invalid levels leave the levels unchanged
+        ASSERT_FALSE(logger->SetComponentLevels("Foo=verbose"));
+        ASSERT_FALSE(logger->SetComponentLevels("Foo"));
+        ASSERT_EQ(logger->GetComponentLevels(), "");
+
+        logger->SetLogFacility(LogFacility::File, log_filename);
+
+        // Without rules, the levels of the parents also limit a logger
+        bar_logger->SetLogLevel(LogLevel::Debug);
+        ASSERT_FALSE(bar_logger->ShouldLog(LogLevel::Debug));
+        ASSERT_FALSE(bar_logger->IsDebugging());
+        bar_logger->Debug("Filtered {}", 1);
+        logger->SetLogLevel(LogLevel::Debug);
+        foo_logger->SetLogLevel(LogLevel::Debug);
+        ASSERT_TRUE(bar_logger->ShouldLog(LogLevel::Debug));
+        ASSERT_TRUE(connection.ShouldLog(LogLevel::Info));
+        logger->SetLogLevel(LogLevel::Info);
+        ASSERT_FALSE(bar_logger->ShouldLog(LogLevel::Debug));
+        foo_logger->SetLogLevel(LogLevel::Info);
+        bar_logger->SetLogLevel(LogLevel::Info);
+
+        // Levels apply to loggers constructed before they are set
+        ASSERT_TRUE(foo_logger->SetComponentLevels(
+            "Foo.Bar.*=debug, *=warning"));
+        ASSERT_EQ(logger->GetComponentLevels(), "Foo.Bar=DEBUG, *=WARNING");
+        ASSERT_TRUE(bar_logger->IsDebugging());
+        ASSERT_TRUE(connection.IsDebugging());
+        ASSERT_FALSE(foo_logger->ShouldLog(LogLevel::Info));
+        ASSERT_FALSE(barn_logger->IsDebugging());
+
+        bar_logger->Debug("Bar {}", 2);
+        connection.debug << "Connection " << 3 << std::flush;
+        foo_logger->Info("Filtered {}", 4);
+        barn_logger->Debug("Filtered {}", 5);
+        LOGGER_WARNING(barn_logger, "Barn " << 6);
+
+        // Loggers constructed later also use the levels
+        auto later_logger = std::make_shared<Logger>("Later", bar_logger);
+        LOGGER_DEBUG(later_logger, "Later " << 7);
+
+        // Removing the levels restores those given to SetLogLevel()
+        ASSERT_TRUE(logger->SetComponentLevels(""));
+        bar_logger->Debug("Filtered {}", 8);
+        connection.Debug("Filtered {}", 9);
+        foo_logger->Info("Foo {}", 10);
+
+        logger->SetLogFacility(LogFacility::None);
+
+        const std::vector<std::string> expected =
+        {
+            "[DEBUG] [Foo] [Bar] Bar 2",
+            "[DEBUG] [Foo] [Bar] [Conn] Connection 3",
+            "[WARNING] [Foo] [Barn] Barn 6",
+            "[DEBUG] [Foo] [Bar] [Later] Later 7",
+            "[INFO] [Foo] Foo 10"
+        };
+        std::ifstream log_file(log_filename);
+        std::string log_line;
+        for (const auto &text : expected)
+        {
+            ASSERT_TRUE(std::getline(log_file, log_line));
+            ASSERT_NE(log_line.find(text), std::string::npos) << log_line;
+        }
+        ASSERT_FALSE(std::getline(log_file, log_line));
+    }
+
+    // Test structured fields written as text and as JSON Lines
+    TEST_F(LoggerTest, StructuredFields)
+    {
+        auto foo_logger = std::make_shared<Logger>("Foo", logger);
+        auto bar_logger = std::make_shared<Logger>("Bar", foo_logger);
+        LoggerHandle connection("Conn", bar_logger);
+        const std::string peer = "a \"b\"";
+        char array[8] = "def";
+        const char *null_pointer = nullptr;
+
+        logger->SetLogFacility(LogFacility::File, log_filename);
+
+        LOGGER_INFO_KV(bar_logger, "rx", "seq", 5, "bytes", 100u,
+                       "peer", peer, "ok", true, "ratio", 0.5);
+
+        logger->SetOutputFormat(LogOutputFormat::JsonLines);
+        ASSERT_EQ(bar_logger->GetOutputFormat(), LogOutputFormat::JsonLines);
+
+        LOGGER_INFO_KV(bar_logger, "rx", "seq", 5, "bytes", 100u,
+                       "peer", peer, "ok", true, "ratio", 0.5);
+        logger->Info("Tab\tand \"quotes\" {}", '\x01');
+        LOGGER_WARNING_KV(&connection, "slow", "ms", 12,
+                          "name", array, "none", null_pointer);
+        LOGGER_INFO_BINARY(bar_logger, "Binary {}", 8);
+        LOGGER_DEBUG_KV(bar_logger, "Filtered", "x", 1);
+
+        // Fields and components are retained by the asynchronous queue
+        logger->SetAsync();
+        LOGGER_ERROR_KV(foo_logger, "async", "limit",
+                        std::numeric_limits<double>::infinity(),
+                        "name", "x\ny");
+        logger->Flush();
+        logger->SetAsync(0);
+
+        logger->SetOutputFormat(LogOutputFormat::Text);
+        logger->SetLogFacility(LogFacility::None);
+
+        const std::vector<std::string> expected =
+        {
+            "[INFO] [Foo] [Bar] rx seq=5 bytes=100 peer=\"a \\\"b\\\"\" "
+                "ok=true ratio=0.5",
+            "\",\"level\":\"INFO\",\"component\":[\"Foo\",\"Bar\"],"
+                "\"msg\":\"rx\",\"seq\":5,\"bytes\":100,"
+                "\"peer\":\"a \\\"b\\\"\",\"ok\":true,\"ratio\":0.5}",
+            "\",\"level\":\"INFO\",\"msg\":"
+                "\"Tab\\tand \\\"quotes\\\" \\u0001\"}",
+            "\",\"level\":\"WARNING\","
+                "\"component\":[\"Foo\",\"Bar\",\"Conn\"],"
+                "\"msg\":\"slow\",\"ms\":12,\"name\":\"def\","
+                "\"none\":null}",
+            "\",\"level\":\"INFO\",\"component\":[\"Foo\",\"Bar\"],"
+                "\"msg\":\"Binary 8\"}",
+            "\",\"level\":\"ERROR\",\"component\":[\"Foo\"],"
+                "\"msg\":\"async\",\"limit\":\"inf\",\"name\":\"x\\ny\"}"
+        };
+        std::ifstream log_file(log_filename);
+        std::string log_line;
+        for (std::size_t i = 0; i < expected.size(); i++)
+        {
+            ASSERT_TRUE(std::getline(log_file, log_line));
+            ASSERT_NE(log_line.find(expected[i]), std::string::npos)
+                << log_line;
+            if (i > 0)
+            {
+                ASSERT_EQ(log_line.rfind("{\"time\":\"", 0), 0) << log_line;
+                ASSERT_EQ(log_line.size(),
+                          log_line.find(expected[i]) + expected[i].size());
+            }
+        }
+        ASSERT_FALSE(std::getline(log_file, log_line));
+    }
+
+    // Test call site descriptors defined by the logging macros
+    TEST_F(LoggerTest, CallSites)
+    {
+        auto foo_logger = std::make_shared<Logger>("Foo", logger);
+        std::vector<LogMessageParts> received;
+
+        constexpr LogSite site = LOGGER_SITE(LogLevel::Info);
+        static_assert(site.file == "test_logger.cpp");
+        static_assert(LogSiteFunction("int ns::Foo<int>::Bar(int) const") ==
+                      "ns::Foo<int>::Bar");
+        static_assert(LogSiteFunction("void f()::<lambda()>") == "f");
+        ASSERT_NE(site.function.find("TestBody"), std::string_view::npos);
+
+        logger->SetLogFacility(LogFacility::File, log_filename);
+
+        LOGGER_INFO(foo_logger, "Hidden " << 1);
+        logger->ShowSourceLocation();
+        ASSERT_TRUE(foo_logger->IsShowingSourceLocation());
+        std::uint32_t first_line = __LINE__ + 1;
+        LOGGER_INFO(foo_logger, "Shown " << std::hex << 255);
+        LOGGER_WARNING(logger, "Reset " << 255);
+        logger->Info("No site");
+
+        logger->SetOutputFormat(LogOutputFormat::JsonLines);
+        LOGGER_INFO_KV(foo_logger, "json", "x", 1);
+        logger->SetOutputFormat(LogOutputFormat::Text);
+
+        logger->ShowSourceLocation(false);
+        logger->SetLogFacility(LogFacility::None);
+
+        const std::string file_line = "test_logger.cpp:";
+        const std::vector<std::string> expected =
+        {
+            "[INFO] [Foo] Hidden 1",
+            "[INFO] " + file_line + std::to_string(first_line) +
+                " [Foo] Shown ff",
+            "[WARNING] " + file_line + std::to_string(first_line + 1) +
+                " Reset 255",
+            "[INFO] No site",
+            "\"component\":[\"Foo\"],\"file\":\"test_logger.cpp\",\"line\":" +
+                std::to_string(first_line + 5) + ",\"function\":\""
+        };
+        std::ifstream log_file(log_filename);
+        std::string log_line;
+        for (const auto &text : expected)
+        {
+            ASSERT_TRUE(std::getline(log_file, log_line));
+            ASSERT_NE(log_line.find(text), std::string::npos) << log_line;
+        }
+        ASSERT_NE(log_line.find("TestBody\",\"msg\":\"json\",\"x\":1}"),
+                  std::string::npos) << log_line;
+        ASSERT_FALSE(std::getline(log_file, log_line));
+
+        // The site is given to a CustomLogger without showing locations
+        auto custom_logger = std::make_shared<CustomLogger>(
+            [&](const LogMessageParts &parts) { received.push_back(parts); });
+        auto child_logger = std::make_shared<Logger>("Child", custom_logger);
+        std::uint32_t custom_line = __LINE__ + 1;
+        LOGGER_ERROR(child_logger, "Custom");
+        custom_logger->Error("Formatted");
+
+        ASSERT_EQ(received.size(), 2);
+        ASSERT_NE(received[0].site, nullptr);
+        ASSERT_EQ(received[0].site->line, custom_line);
+        ASSERT_EQ(received[0].site->file, "test_logger.cpp");
+        ASSERT_EQ(received[0].site->level, LogLevel::Error);
+        ASSERT_EQ(received[0].body, "Custom");
+        ASSERT_EQ(received[1].site, nullptr);
+    }
+
+    // Test timing queued and binary messages using a raw clock
+    TEST_F(LoggerTest, ClockSources)
+    {
+        const std::string formats_name =
+            log_filename + std::string(Binary_Formats_Suffix);
+        const LogClockSource sources[] =
+        {
+            LogClockSource::Tsc,
+            LogClockSource::MonotonicCoarse
+        };
+        auto now = []()
+        {
+            return std::chrono::duration<double>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        };
+
+        ASSERT_EQ(logger->GetClockSource(), LogClockSource::System);
+        ASSERT_TRUE(LogClock::IsAvailable(LogClockSource::System));
+
+        for (auto source : sources)
+        {
+            if (!LogClock::IsAvailable(source))
+            {
+                ASSERT_FALSE(logger->SetClockSource(source));
+                continue;
+            }
+            ASSERT_TRUE(logger->SetClockSource(source));
+            ASSERT_EQ(logger->GetClockSource(), source);
+
+            // Queued messages are converted by the writer thread
+            logger->SetLogFacility(LogFacility::File, log_filename);
+            logger->SetTimeFormat(LogTimeFormat::Epoch);
+            logger->SetAsync();
+            double before = now();
+            logger->Info("Queued");
+            LOGGER_INFO_BINARY(logger, "Binary {}", 1);
+            logger->Flush();
+            double after = now();
+            logger->SetAsync(0);
+            logger->SetLogFacility(LogFacility::None);
+
+            std::ifstream log_file(log_filename);
+            std::string log_line;
+            double previous = 0.0;
+            for (int i = 0; i < 2; i++)
+            {
+                ASSERT_TRUE(std::getline(log_file, log_line));
+                double seconds = std::stod(log_line);
+                ASSERT_GE(seconds, before - 0.1) << log_line;
+                ASSERT_LE(seconds, after + 0.1) << log_line;
+                ASSERT_GE(seconds, previous) << log_line;
+                previous = seconds;
+            }
+            ASSERT_FALSE(std::getline(log_file, log_line));
+            log_file.close();
+            std::remove(log_filename.c_str());
+
+#ifndef _WIN32
+            // Binary messages are decoded using the clock record
+            logger->SetLogFacility(LogFacility::File, log_filename);
+            ASSERT_TRUE(logger->SetBinaryLog(log_filename));
+            before = now();
+            LOGGER_WARNING_BINARY(logger, "Binary {}", 2);
+            after = now();
+            ASSERT_TRUE(logger->SetBinaryLog());
+            logger->SetLogFacility(LogFacility::None);
+
+            std::ifstream formats_file(formats_name, std::ios::binary);
+            std::string contents(
+                (std::istreambuf_iterator<char>(formats_file)),
+                std::istreambuf_iterator<char>());
+            formats_file.close();
+            std::remove(formats_name.c_str());
+
+            BinaryRecordHeader header;
+            BinaryClockBody body;
+            ASSERT_GE(contents.size(), sizeof(header) + sizeof(body));
+            std::memcpy(&header, contents.data(), sizeof(header));
+            std::memcpy(&body, contents.data() + sizeof(header), sizeof(body));
+            ASSERT_EQ(header.type,
+                      static_cast<std::uint8_t>(BinaryRecordType::Clock));
+            ASSERT_EQ(header.level, static_cast<std::uint8_t>(source));
+            LogClockCalibration calibration{body.ticks,
+                                            header.timestamp,
+                                            body.nanoseconds_per_tick};
+
+            std::string segment_name =
+                MappedLogFile::SegmentName(log_filename, 0);
+            std::ifstream segment(segment_name, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(segment),
+                            std::istreambuf_iterator<char>());
+            segment.close();
+            std::remove(segment_name.c_str());
+
+            ASSERT_GE(contents.size(), sizeof(header));
+            std::memcpy(&header, contents.data(), sizeof(header));
+            ASSERT_EQ(header.type,
+                      static_cast<std::uint8_t>(BinaryRecordType::Message));
+            double seconds = static_cast<double>(calibration.ToNanoseconds(
+                static_cast<std::uint64_t>(header.timestamp))) / 1e9;
+            ASSERT_GE(seconds, before - 0.1);
+            ASSERT_LE(seconds, after + 0.1);
+#endif
+        }
+
+        ASSERT_TRUE(logger->SetClockSource(LogClockSource::System));
+        ASSERT_EQ(logger->GetClockSource(), LogClockSource::System);
+    }
+
+    // Test logging using format strings
+    TEST_F(LoggerTest, LogFormat)
+    {
+        std::string log_line;
+        std::string name = "abc";
+        char array[8] = "def";
+        const char *null_pointer = nullptr;
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        logger->Info("seq={} len={} name={}", 5, 10u, name);
+        logger->Info("array={} pointer={}", array, null_pointer);
+        logger->Debug("Test Log {}", 2);            // Should not output
+        child_logger->Warning("{} {{}} {} {}", -1.5, true, 'x');
+        child_logger->Error("level={} text={}", LogLevel::Error, "text");
+        logger->Critical("No arguments");
+#ifndef __cpp_consteval
+        // Without compile-time checks, unused placeholders are reproduced
+        logger->Info("missing={}");
+#endif
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] seq=5 len=10 name=abc"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] array=def pointer=(null)"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING] [CHLD] -1.5 {} true x"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] [CHLD] level=1 text=text"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[CRITICAL] No arguments"), std::string::npos);
+#ifndef __cpp_consteval
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] missing={}"), std::string::npos);
+#endif
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+    // Test that binary messages are converted to text without a binary log
+    TEST_F(LoggerTest, BinaryLogText)
+    {
+        std::string log_line;
+        char array[8] = "def";
+        const char *null_pointer = nullptr;
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+
+        // Set the log facility to log to a file
+        logger->SetLogFacility(LogFacility::File, log_filename);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::File);
+
+        LOGGER_INFO_BINARY(logger, "seq={} len={} name={}", 5, 10u, "abc");
+        LOGGER_INFO_BINARY(logger, "array={} pointer={}", array, null_pointer);
+        LOGGER_DEBUG_BINARY(logger, "Test Log {}", 2);  // Should not output
+        LOGGER_WARNING_BINARY(child_logger, "{} {{}} {}", -1.5, true);
+
+        // Conversion is deferred to the writer thread when asynchronous
+        logger->SetAsync();
+        LOGGER_ERROR_BINARY(child_logger, "char={} missing={}", 'x');
+        LOGGER_CRITICAL_BINARY(logger, "No arguments");
+
+        // Now turn off logging and verify it is off
+        logger->SetLogFacility(LogFacility::None);
+        ASSERT_EQ(logger->GetLogFacility(), LogFacility::None);
+
+        // Check that the log file exists by opening it
+        std::ifstream log_file(log_filename);
+        ASSERT_TRUE(log_file.good());
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] seq=5 len=10 name=abc"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[INFO] array=def pointer=(null)"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[WARNING] [CHLD] -1.5 {} true"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[ERROR] [CHLD] char=x missing={}"),
+                  std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_NE(log_line.find("[CRITICAL] No arguments"), std::string::npos);
+        std::getline(log_file, log_line);
+        ASSERT_TRUE(log_file.eof());
+        log_file.close();
+    }
+
+#ifndef _WIN32
+    // Test writing binary messages to a binary log and decoding them
+    TEST_F(LoggerTest, BinaryLogFile)
+    {
+        const std::string formats_name =
+            log_filename + std::string(Binary_Formats_Suffix);
+        std::map<std::uint64_t, std::string> formats;
+        std::vector<std::string> messages;
+
+        ASSERT_TRUE(logger->SetBinaryLog(log_filename));
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+
+        for (int i = 0; i < 3; i++)
+        {
+            LOGGER_INFO_BINARY(child_logger, "Binary {} of {}", i, 3);
+        }
+        LOGGER_DEBUG_BINARY(logger, "Test Log {}", 1);  // Should not output
+        LOGGER_WARNING_BINARY(logger, "Name: {}", std::string("test"));
+
+        ASSERT_TRUE(logger->SetBinaryLog());
+
+        // Each format is recorded once, and the first message is indexed
+        std::ifstream formats_file(formats_name, std::ios::binary);
+        ASSERT_TRUE(formats_file.good());
+        std::string contents((std::istreambuf_iterator<char>(formats_file)),
+                             std::istreambuf_iterator<char>());
+        formats_file.close();
+        std::remove(formats_name.c_str());
+
+        unsigned index_records = 0;
+        for (std::size_t offset = 0; offset < contents.size();)
+        {
+            BinaryRecordHeader header;
+            BinaryFormatBody body;
+            std::memcpy(&header, contents.data() + offset, sizeof(header));
+            if (header.type ==
+                static_cast<std::uint8_t>(BinaryRecordType::Index))
+            {
+                BinaryIndexBody index;
+                ASSERT_EQ(header.length, sizeof(header) + sizeof(index));
+                std::memcpy(&index,
+                            contents.data() + offset + sizeof(header),
+                            sizeof(index));
+                ASSERT_EQ(header.format_id, 0u);
+                ASSERT_EQ(index.offset, 0u);
+                index_records++;
+                offset += header.length;
+                continue;
+            }
+            std::memcpy(&body,
+                        contents.data() + offset + sizeof(header),
+                        sizeof(body));
+            ASSERT_EQ(header.type,
+                      static_cast<std::uint8_t>(BinaryRecordType::Format));
+            ASSERT_EQ(header.length,
+                      sizeof(header) + sizeof(body) + body.file_length +
+                          body.format_length);
+            formats[header.format_id] =
+                contents.substr(offset + sizeof(header) + sizeof(body) +
+                                    body.file_length,
+                                body.format_length);
+            offset += header.length;
+        }
+        ASSERT_EQ(formats.size(), 2);
+        ASSERT_EQ(index_records, 1u);
+
+        // Decode the messages using the format records
+        std::string segment_name = MappedLogFile::SegmentName(log_filename, 0);
+        std::ifstream segment(segment_name, std::ios::binary);
+        ASSERT_TRUE(segment.good());
+        contents.assign(std::istreambuf_iterator<char>(segment),
+                        std::istreambuf_iterator<char>());
+        segment.close();
+        std::remove(segment_name.c_str());
+
+        for (std::size_t offset = 0; offset < contents.size();)
+        {
+            BinaryRecordHeader header;
+            std::memcpy(&header, contents.data() + offset, sizeof(header));
+            ASSERT_EQ(header.type,
+                      static_cast<std::uint8_t>(BinaryRecordType::Message));
+            ASSERT_EQ(formats.count(header.format_id), 1);
+            std::string_view record(contents.data() + offset + sizeof(header),
+                                    header.length - sizeof(header));
+            messages.push_back(
+                std::string(record.substr(0, header.prefix_length)) +
+                DecodeBinaryArguments(formats[header.format_id],
+                                      record.substr(header.prefix_length)));
+            offset += header.length;
+        }
+
+        ASSERT_EQ(messages.size(), 4);
+        ASSERT_EQ(messages[0], "[CHLD] Binary 0 of 3");
+        ASSERT_EQ(messages[2], "[CHLD] Binary 2 of 3");
+        ASSERT_EQ(messages[3], "Name: test");
+    }
+
+    // Test that a component prefix too long for its length field is
+    // truncated without misaligning the records that follow
+    TEST_F(LoggerTest, BinaryLogLongPrefix)
+    {
+        const std::string formats_name =
+            log_filename + std::string(Binary_Formats_Suffix);
+        std::vector<std::string> messages;
+        std::string contents;
+
+        ASSERT_TRUE(logger->SetBinaryLog(log_filename));
+        auto long_logger =
+            std::make_shared<Logger>(std::string(70000, 'L'), logger);
+
+        LOGGER_INFO_BINARY(long_logger, "Long {}", 1);
+        LOGGER_INFO_BINARY(logger, "After {}", 2);
+
+        ASSERT_TRUE(logger->SetBinaryLog());
+        std::remove(formats_name.c_str());
+
+        std::string segment_name = MappedLogFile::SegmentName(log_filename, 0);
+        std::ifstream segment(segment_name, std::ios::binary);
+        ASSERT_TRUE(segment.good());
+        contents.assign(std::istreambuf_iterator<char>(segment),
+                        std::istreambuf_iterator<char>());
+        segment.close();
+        std::remove(segment_name.c_str());
+
+        std::size_t offset = 0;
+        while ((offset + sizeof(BinaryRecordHeader)) <= contents.size())
+        {
+            BinaryRecordHeader header;
+            std::memcpy(&header, contents.data() + offset, sizeof(header));
+            if (header.length == 0) break;
+            ASSERT_EQ(header.type,
+                      static_cast<std::uint8_t>(BinaryRecordType::Message));
+            ASSERT_LE(offset + header.length, contents.size());
+            std::string_view record(contents.data() + offset + sizeof(header),
+                                    header.length - sizeof(header));
+            messages.push_back(
+                DecodeBinaryArguments(messages.empty() ? "Long {}" :
+                                                         "After {}",
+                                      record.substr(header.prefix_length)));
+            if (messages.size() == 1)
+            {
+                ASSERT_EQ(header.prefix_length, UINT16_MAX);
+            }
+            offset += header.length;
+        }
+
+        ASSERT_EQ(messages.size(), 2);
+        ASSERT_EQ(messages[0], "Long 1");
+        ASSERT_EQ(messages[1], "After 2");
+    }
+
+    // Test reading a binary log by time, level, and component, and
+    // following a binary log while it is written
+    TEST_F(LoggerTest, BinaryLogReader)
+    {
+        const std::string formats_name =
+            log_filename + std::string(Binary_Formats_Suffix);
+        constexpr unsigned Message_Count = 12000;
+        std::int64_t range_start = 0;
+        std::int64_t range_end = 0;
+        std::vector<BinaryLogEntry> entries;
+        BinaryLogReader reader;
+        BinaryLogFilter filter;
+        auto now = []()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        };
+        auto collect = [&](std::size_t, std::vector<BinaryLogEntry> &read)
+        {
+            entries.insert(entries.end(), read.begin(), read.end());
+        };
+
+        logger->SetSegmentSize(256 * 1024);
+        ASSERT_TRUE(logger->SetBinaryLog(log_filename));
+        auto child_logger = std::make_shared<Logger>("CHLD", logger);
+
+        for (unsigned i = 0; i < Message_Count; i++)
+        {
+            if (i == 4000) range_start = now();
+            if (i % 100 == 0)
+            {
+                LOGGER_WARNING_BINARY(child_logger, "Warning {}", i);
+            }
+            else
+            {
+                LOGGER_INFO_BINARY(logger, "Message {} of {}", i, 0);
+            }
+            if (i == 4999) range_end = now();
+        }
+
+        // Read the log while it is still open
+        ASSERT_TRUE(reader.Open(log_filename));
+        ASSERT_GE(reader.GetSegmentCount(), 2u);
+        std::size_t segment = reader.GetSegmentCount() - 1;
+        std::size_t offset = reader.Read(filter, collect);
+        ASSERT_EQ(entries.size(), Message_Count);
+        ASSERT_EQ(entries[1].text, "Message 1 of 0");
+        ASSERT_LT(offset, reader.GetSegmentSize(segment));
+
+        // Messages with formats not yet read are read after Refresh()
+        for (int i = 0; i < 3; i++) LOGGER_INFO_BINARY(logger, "Tail {}", i);
+        entries.clear();
+        ASSERT_EQ(reader.ReadSegment(segment,
+                                     offset,
+                                     BinaryLogReader::End_Offset,
+                                     filter,
+                                     entries,
+                                     true),
+                  offset);
+        ASSERT_TRUE(entries.empty());
+        reader.Refresh();
+        offset = reader.ReadSegment(segment,
+                                    offset,
+                                    BinaryLogReader::End_Offset,
+                                    filter,
+                                    entries,
+                                    true);
+        ASSERT_EQ(entries.size(), 3u);
+        ASSERT_EQ(entries[2].text, "Tail 2");
+        ASSERT_EQ(entries[2].level, LogLevel::Info);
+
+        // Closing the log truncates the last segment after the messages
+        ASSERT_TRUE(logger->SetBinaryLog());
+        ASSERT_EQ(reader.GetSegmentSize(segment), offset);
+
+        // Select messages by level and component, using one thread
+        ASSERT_TRUE(reader.Open(log_filename));
+        entries.clear();
+        filter.level = LogLevel::Warning;
+        filter.component = "CHLD";
+        reader.Read(filter, collect, 1);
+        ASSERT_EQ(entries.size(), Message_Count / 100);
+        for (std::size_t i = 0; i < entries.size(); i++)
+        {
+            ASSERT_EQ(entries[i].prefix, "[CHLD] ");
+            ASSERT_EQ(entries[i].text, "Warning " + std::to_string(i * 100));
+        }
+        entries.clear();
+        filter.component = "CHLD.Other";
+        reader.Read(filter, collect, 1);
+        ASSERT_TRUE(entries.empty());
+
+        // Select messages by time, using a thread per segment
+        filter = BinaryLogFilter{};
+        filter.start = range_start;
+        filter.end = range_end;
+        reader.Read(filter, collect, 4);
+        std::vector<bool> found(Message_Count);
+        for (auto &entry : entries)
+        {
+            ASSERT_GE(entry.time, range_start);
+            ASSERT_LE(entry.time, range_end);
+            unsigned number = static_cast<unsigned>(
+                std::stoul(entry.text.substr(entry.text.find(' ') + 1)));
+            ASSERT_LT(number, Message_Count);
+            found[number] = true;
+        }
+        for (unsigned i = 4000; i < 5000; i++) ASSERT_TRUE(found[i]) << i;
+
+        // The index lets reading start well into a segment
+        std::size_t begin;
+        std::size_t stop;
+        filter.start = now();
+        filter.end = filter.start;
+        reader.Seek(0, filter, begin, stop);
+        ASSERT_GT(begin, 0u);
+        ASSERT_EQ(stop, BinaryLogReader::End_Offset);
+        filter.start = range_start;
+        reader.Seek(segment, filter, begin, stop);
+        ASSERT_EQ(begin, 0u);
+
+        for (std::size_t i = 0; i < reader.GetSegmentCount(); i++)
+        {
+            std::remove(MappedLogFile::SegmentName(log_filename, i).c_str());
+        }
+        std::remove(formats_name.c_str());
     }
+#endif
 
     // Test forward and reverse log level mappings
     TEST_F(LoggerTest, ForwardAndReverseMappings)
@@ -0,0 +1,529 @@
+/*
+ *  logdump.cpp
+ *
+ *  Copyright (C) 2026
+ *  Cisco Systems, Inc.
+ *  All Rights Reserved.
+ *
+ *  Description:
+ *      This program decodes a binary log written by a Logger (see
+ *      Logger::SetBinaryLog()) and writes its messages as text lines of the
+ *      same form as those the Logger writes to a file.  Segments are
+ *      decoded in parallel, and the index records in the formats file are
+ *      used to read only the parts of each segment that hold messages in
+ *      the requested time range.
+ *
+ *      Usage: cantina-logdump [-s start] [-e end] [-l level] [-c component]
+ *                             [-t threads] [-u] [-f] base_name
+ *          -s  Write messages logged at or after the given time
+ *          -e  Write messages logged at or before the given time
+ *          -l  Write messages at the given level or more severe
+ *          -c  Write messages from the given component (e.g., Foo.Bar)
+ *          -t  Number of segments decoded at once (default is one per
+ *              processor)
+ *          -u  Read and write times in UTC rather than local time
+ *          -f  Follow the log, writing messages as they are logged
+ *
+ *      Times are given as "YYYY-MM-DDTHH:MM[:SS[.fraction]]", as
+ *      "HH:MM[:SS[.fraction]]" on the date of the log's first message, or
+ *      as "@seconds" since the epoch.  The base name is that given to
+ *      SetBinaryLog().  When following, the program polls for new messages
+ *      until interrupted.
+ *
+ *  Portability Issues:
+ *      None.
+ *
+ *  License:
+ *      BSD 2-Clause License
+ *
+ *      Copyright (c) 2022, Cisco Systems
+ *      All rights reserved.
+ *
+ *      Redistribution and use in source and binary forms, with or without
+ *      modification, are permitted provided that the following conditions are
+ *      met:
+ *
+ *      1. Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *
+ *      2. Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *
+ *      THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *      IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ *      TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ *      PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *      HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *      SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *      LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *      DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *      THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *      (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *      OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//  SPDX-FileCopyrightText: 2022 Cisco Systems, Inc.
+//  SPDX-License-Identifier: BSD-2-Clause
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cantina/binary_log_reader.h"
+#include "cantina/log_format.h"
+#include "cantina/log_level_registry.h"
+
+namespace
+{
+
+// Interval at which a followed log is checked for new messages
+constexpr std::chrono::milliseconds Follow_Interval{200};
+
+// Nanoseconds in a second and in a day
+constexpr std::int64_t Nanoseconds_Per_Second = 1000000000;
+constexpr std::int64_t Seconds_Per_Day = 86400;
+
+// Command-line options
+struct DumpOptions
+{
+    std::string base_name;              // Name given to SetBinaryLog()
+    std::string start;                  // Earliest time, as given
+    std::string end;                    // Latest time, as given
+    std::string level;                  // Least severe level, as given
+    std::string component;              // Component path
+    unsigned threads = 0;               // Segments decoded at once
+    bool utc = false;                   // Use UTC rather than local time?
+    bool follow = false;                // Follow the log?
+};
+
+/*
+ *  DaysFromCivil
+ *
+ *  Description:
+ *      Return the number of days from the epoch to a date in the
+ *      proleptic Gregorian calendar.
+ *
+ *  Parameters:
+ *      year [in]
+ *          The year.
+ *
+ *      month [in]
+ *          The month (1 to 12).
+ *
+ *      day [in]
+ *          The day of the month (1 to 31).
+ *
+ *  Returns:
+ *      The number of days since 1970-01-01.
+ *
+ *  Comments:
+ *      This avoids timegm(), which is not available on every platform.
+ */
+std::int64_t DaysFromCivil(int year, int month, int day)
+{
+    year -= (month <= 2) ? 1 : 0;
+
+    std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    std::int64_t year_of_era = year - era * 400;
+    std::int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 +
+                               day - 1;
+    std::int64_t day_of_era = year_of_era * 365 + year_of_era / 4 -
+                              year_of_era / 100 + day_of_year;
+
+    return era * 146097 + day_of_era - 719468;
+}
+
+/*
+ *  ToSeconds
+ *
+ *  Description:
+ *      Convert a date and time to seconds since the epoch.
+ *
+ *  Parameters:
+ *      date [in]
+ *          The date and time, of which tm_year, tm_mon, tm_mday, tm_hour,
+ *          tm_min, and tm_sec are used.
+ *
+ *      utc [in]
+ *          Whether the time is in UTC rather than local time.
+ *
+ *  Returns:
+ *      The number of seconds since the epoch.
+ *
+ *  Comments:
+ *      None.
+ */
+std::int64_t ToSeconds(struct tm date, bool utc)
+{
+    if (!utc)
+    {
+        date.tm_isdst = -1;
+        return static_cast<std::int64_t>(std::mktime(&date));
+    }
+
+    return DaysFromCivil(date.tm_year + 1900, date.tm_mon + 1, date.tm_mday) *
+               Seconds_Per_Day +
+           date.tm_hour * 3600 + date.tm_min * 60 + date.tm_sec;
+}
+
+/*
+ *  ToDate
+ *
+ *  Description:
+ *      Convert a time to the date and time of day.
+ *
+ *  Parameters:
+ *      time [in]
+ *          The time in nanoseconds since the epoch.
+ *
+ *      utc [in]
+ *          Whether to give the date in UTC rather than local time.
+ *
+ *  Returns:
+ *      The date and time of day.
+ *
+ *  Comments:
+ *      None.
+ */
+struct tm ToDate(std::int64_t time, bool utc)
+{
+    std::time_t t = static_cast<std::time_t>(time / Nanoseconds_Per_Second);
+    struct tm date{};
+
+#ifdef _WIN32
+    if (utc)
+    {
+        gmtime_s(&date, &t);
+    }
+    else
+    {
+        localtime_s(&date, &t);
+    }
+#else
+    if (utc)
+    {
+        gmtime_r(&t, &date);
+    }
+    else
+    {
+        localtime_r(&t, &date);
+    }
+#endif
+
+    return date;
+}
+
+/*
+ *  ParseTime
+ *
+ *  Description:
+ *      Parse a time given on the command line.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The time as given (see the description of the program).
+ *
+ *      utc [in]
+ *          Whether the time is in UTC rather than local time.
+ *
+ *      reader [in]
+ *          The reader of the log, whose first message gives the date of a
+ *          time given without one.
+ *
+ *      time [out]
+ *          The time in nanoseconds since the epoch.
+ *
+ *  Returns:
+ *      True if the time was parsed, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ParseTime(const std::string &text,
+               bool utc,
+               const cantina::BinaryLogReader &reader,
+               std::int64_t &time)
+{
+    struct tm date{};
+    const char *clock = text.c_str();
+    int hour = 0;
+    int minute = 0;
+    double seconds = 0.0;
+    char *end;
+
+    if (text.empty()) return false;
+
+    if (text[0] == '@')
+    {
+        seconds = std::strtod(text.c_str() + 1, &end);
+        if ((*end != '\0') || (end == text.c_str() + 1)) return false;
+        time = static_cast<std::int64_t>(seconds * Nanoseconds_Per_Second);
+        return true;
+    }
+
+    // A date precedes the time of day if the text contains a hyphen
+    if (text.find('-') != std::string::npos)
+    {
+        int year;
+        int month;
+        int day;
+        int length = 0;
+
+        if ((std::sscanf(clock, "%d-%d-%d%n", &year, &month, &day, &length) !=
+             3) ||
+            ((clock[length] != 'T') && (clock[length] != ' ')))
+        {
+            return false;
+        }
+        date.tm_year = year - 1900;
+        date.tm_mon = month - 1;
+        date.tm_mday = day;
+        clock += length + 1;
+    }
+    else
+    {
+        std::int64_t start_time;
+
+        if (!reader.GetStartTime(start_time)) return false;
+        date = ToDate(start_time, utc);
+    }
+
+    int length = 0;
+    if ((std::sscanf(clock, "%d:%d%n", &hour, &minute, &length) != 2) ||
+        (hour < 0) || (hour > 23) || (minute < 0) || (minute > 59))
+    {
+        return false;
+    }
+    clock += length;
+    if (*clock == ':')
+    {
+        seconds = std::strtod(clock + 1, &end);
+        if ((end == clock + 1) || (seconds < 0.0) || (seconds >= 61.0))
+        {
+            return false;
+        }
+        clock = end;
+    }
+    if (*clock != '\0') return false;
+
+    date.tm_hour = hour;
+    date.tm_min = minute;
+    date.tm_sec = static_cast<int>(seconds);
+
+    time = ToSeconds(date, utc) * Nanoseconds_Per_Second +
+           static_cast<std::int64_t>((seconds - date.tm_sec) *
+                                     Nanoseconds_Per_Second);
+
+    return true;
+}
+
+/*
+ *  WriteEntries
+ *
+ *  Description:
+ *      Write decoded messages to standard output as text lines.
+ *
+ *  Parameters:
+ *      entries [in]
+ *          The messages to write.
+ *
+ *      utc [in]
+ *          Whether to write times in UTC rather than local time.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteEntries(const std::vector<cantina::BinaryLogEntry> &entries,
+                  bool utc)
+{
+    std::string line;
+    char timestamp[cantina::Max_Timestamp_Length];
+
+    for (const auto &entry : entries)
+    {
+        std::chrono::system_clock::time_point time(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(entry.time)));
+
+        line.assign(timestamp,
+                    cantina::FormatLogTimestamp(
+                        time,
+                        utc ? cantina::LogTimeFormat::UTC :
+                              cantina::LogTimeFormat::LocalTime,
+                        cantina::LogTimePrecision::Microseconds,
+                        timestamp));
+        line += " [";
+        line += cantina::LogLevelName(entry.level);
+        line += "] ";
+        line += entry.prefix;
+        line += entry.text;
+        line += '\n';
+
+        std::fwrite(line.data(), 1, line.size(), stdout);
+    }
+}
+
+/*
+ *  ParseOptions
+ *
+ *  Description:
+ *      Parse the command-line options.
+ *
+ *  Parameters:
+ *      argc [in]
+ *          The number of command-line arguments.
+ *
+ *      argv [in]
+ *          The command-line arguments.
+ *
+ *      options [out]
+ *          The parsed options.
+ *
+ *  Returns:
+ *      True if the options were parsed, false otherwise.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ParseOptions(int argc, char *argv[], DumpOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+
+        if ((option == "-s") && (i + 1 < argc))
+        {
+            options.start = argv[++i];
+        }
+        else if ((option == "-e") && (i + 1 < argc))
+        {
+            options.end = argv[++i];
+        }
+        else if ((option == "-l") && (i + 1 < argc))
+        {
+            options.level = argv[++i];
+        }
+        else if ((option == "-c") && (i + 1 < argc))
+        {
+            options.component = argv[++i];
+        }
+        else if ((option == "-t") && (i + 1 < argc))
+        {
+            options.threads =
+                static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (option == "-u")
+        {
+            options.utc = true;
+        }
+        else if (option == "-f")
+        {
+            options.follow = true;
+        }
+        else if ((option[0] != '-') && options.base_name.empty())
+        {
+            options.base_name = option;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !options.base_name.empty();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    DumpOptions options;
+    cantina::BinaryLogReader reader;
+    cantina::BinaryLogFilter filter;
+
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-s start] [-e end] [-l level] [-c component]"
+                  << " [-t threads] [-u] [-f] base_name" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!reader.Open(options.base_name))
+    {
+        std::cerr << "Unable to open binary log: " << options.base_name
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!options.start.empty() &&
+        !ParseTime(options.start, options.utc, reader, filter.start))
+    {
+        std::cerr << "Invalid start time: " << options.start << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!options.end.empty() &&
+        !ParseTime(options.end, options.utc, reader, filter.end))
+    {
+        std::cerr << "Invalid end time: " << options.end << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!options.level.empty() &&
+        !cantina::ParseLogLevel(options.level, filter.level))
+    {
+        std::cerr << "Invalid log level: " << options.level << std::endl;
+        return EXIT_FAILURE;
+    }
+    filter.component = options.component;
+
+    std::size_t offset = reader.Read(
+        filter,
+        [&](std::size_t, std::vector<cantina::BinaryLogEntry> &entries)
+        {
+            WriteEntries(entries, options.utc);
+        },
+        options.threads);
+    std::fflush(stdout);
+
+    if (!options.follow) return EXIT_SUCCESS;
+
+    // Continue with the last segment, moving to each new segment once the
+    // Logger has finished with the previous one
+    std::size_t segment = reader.GetSegmentCount();
+    if (segment > 0) segment--;
+    std::vector<cantina::BinaryLogEntry> entries;
+
+    while (true)
+    {
+        reader.Refresh();
+
+        entries.clear();
+        offset = reader.ReadSegment(segment,
+                                    offset,
+                                    cantina::BinaryLogReader::End_Offset,
+                                    filter,
+                                    entries,
+                                    true);
+        WriteEntries(entries, options.utc);
+        std::fflush(stdout);
+
+        if ((segment + 1 < reader.GetSegmentCount()) &&
+            (offset >= reader.GetSegmentSize(segment)))
+        {
+            segment++;
+            offset = 0;
+            continue;
+        }
+
+        std::this_thread::sleep_for(Follow_Interval);
+    }
+}